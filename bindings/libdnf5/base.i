@@ -24,6 +24,7 @@
 %{
     #include "libdnf/logger/memory_buffer_logger.hpp"
     #include "libdnf/base/base.hpp"
+    #include "libdnf/base/metrics.hpp"
     #include "libdnf/base/transaction.hpp"
     #include "libdnf/base/transaction_package.hpp"
     #include "libdnf/base/goal.hpp"
@@ -58,6 +59,10 @@
 %template(BaseWeakPtr) libdnf::WeakPtr<libdnf::Base, false>;
 %template(VarsWeakPtr) libdnf::WeakPtr<libdnf::Vars, false>;
 
+%include "libdnf/base/metrics.hpp"
+%template(MetricsWeakPtr) libdnf::WeakPtr<libdnf::base::Metrics, false>;
+%template(VectorMetricsSpan) std::vector<libdnf::base::MetricsSpan>;
+
 %include "libdnf/base/base.hpp"
 %ignore libdnf::base::TransactionError;
 %include "libdnf/base/transaction.hpp"
@@ -21,6 +21,7 @@
 %{
     #include "libdnf/common/weak_ptr.hpp"
 %}
+%ignore libdnf::WeakPtrControlBlock;
 %include "libdnf/common/weak_ptr.hpp"
 #if defined(SWIGPYTHON)
 %extend libdnf::WeakPtr {
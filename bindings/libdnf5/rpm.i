@@ -8,6 +8,7 @@
 
 %include <exception.i>
 %include <std_string.i>
+%include <std_string_view.i>
 %include <std_vector.i>
 
 %include <shared.i>
@@ -30,6 +31,7 @@
     #include "libdnf/rpm/checksum.hpp"
     #include "libdnf/rpm/nevra.hpp"
     #include "libdnf/rpm/package.hpp"
+    #include "libdnf/rpm/package_columns.hpp"
     #include "libdnf/rpm/package_query.hpp"
     #include "libdnf/rpm/package_sack.hpp"
     #include "libdnf/rpm/package_set.hpp"
@@ -60,6 +62,19 @@
 %rename(value) libdnf::rpm::ReldepListIterator::operator*();
 %include "libdnf/rpm/reldep_list_iterator.hpp"
 %include "libdnf/rpm/reldep_list.hpp"
+// the views are valid only while the pool is unchanged, the bindings use the copying getters
+%ignore libdnf::rpm::Package::get_name_view;
+%ignore libdnf::rpm::Package::get_epoch_view;
+%ignore libdnf::rpm::Package::get_version_view;
+%ignore libdnf::rpm::Package::get_release_view;
+%ignore libdnf::rpm::Package::get_arch_view;
+%ignore libdnf::rpm::Package::get_evr_view;
+%ignore libdnf::rpm::Package::get_repo_id_view;
+%ignore libdnf::rpm::Package::get_summary_view;
+%ignore libdnf::rpm::Package::get_url_view;
+%ignore libdnf::rpm::Package::get_license_view;
+%ignore libdnf::rpm::Package::append_nevra;
+%ignore libdnf::rpm::Package::append_full_nevra;
 %include "libdnf/rpm/package.hpp"
 
 %rename(next) libdnf::rpm::PackageSetIterator::operator++();
@@ -73,6 +88,33 @@
 add_iterator(PackageSet)
 add_iterator(ReldepList)
 
+%ignore libdnf::rpm::PackageColumnsError;
+%template(VectorInt) std::vector<int>;
+%template(VectorUInt32) std::vector<uint32_t>;
+%template(VectorUInt64) std::vector<uint64_t>;
+%include "libdnf/rpm/package_columns.hpp"
+#if defined(SWIGPYTHON)
+// Native byte order copies of the column arrays made by one memcpy,
+// e.g. memoryview(columns.get_numbers_buffer("installsize")).cast("Q")
+%extend libdnf::rpm::PackageColumns {
+    PyObject * get_ids_buffer() const {
+        const auto & ids = $self->get_ids();
+        return PyBytes_FromStringAndSize(
+            reinterpret_cast<const char *>(ids.data()), static_cast<Py_ssize_t>(ids.size() * sizeof(int)));
+    }
+    PyObject * get_string_indexes_buffer(const std::string & attribute) const {
+        const auto & indexes = $self->get_string_indexes(attribute);
+        return PyBytes_FromStringAndSize(
+            reinterpret_cast<const char *>(indexes.data()), static_cast<Py_ssize_t>(indexes.size() * sizeof(uint32_t)));
+    }
+    PyObject * get_numbers_buffer(const std::string & attribute) const {
+        const auto & numbers = $self->get_numbers(attribute);
+        return PyBytes_FromStringAndSize(
+            reinterpret_cast<const char *>(numbers.data()), static_cast<Py_ssize_t>(numbers.size() * sizeof(uint64_t)));
+    }
+}
+#endif
+
 %feature("director") TransactionCallbacks;
 %include "libdnf/rpm/transaction_callbacks.hpp"
 wrap_unique_ptr(TransactionCallbacksUniquePtr, libdnf::rpm::TransactionCallbacks);
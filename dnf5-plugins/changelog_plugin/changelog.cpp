@@ -21,6 +21,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <libdnf/conf/const.hpp>
 #include <libdnf/conf/option_string.hpp>
+#include <libdnf/repo/repo_query.hpp>
+#include <libdnf/rpm/changelog_reader.hpp>
 #include <libdnf/rpm/package.hpp>
 #include <libdnf/rpm/package_query.hpp>
 
@@ -106,7 +108,13 @@ void ChangelogCommand::configure() {
     auto & context = get_context();
     context.set_load_system_repo(true);
     context.set_load_available_repos(Context::LoadAvailableRepos::ENABLED);
-    context.base.get_config().optional_metadata_types().add(libdnf::OPTIONAL_METADATA_TYPES);
+    // The changelogs are read only for the shown packages directly from the "other" metadata files,
+    // the files are downloaded but not loaded into the sack.
+    libdnf::repo::RepoQuery repos(context.base);
+    repos.filter_enabled(true);
+    for (auto & repo : repos) {
+        repo->set_download_only_metadata_types({libdnf::METADATA_TYPE_OTHER});
+    }
 }
 
 void ChangelogCommand::run() {
@@ -156,8 +164,22 @@ void ChangelogCommand::run() {
         by_srpm[pkg.get_source_name() + '/' + pkg.get_evr()].push_back(pkg);
     }
 
-    libdnf::rpm::PackageQuery installed(full_package_query);
-    installed.filter_installed();
+    // changelogs of the first package of each source package and of the installed versions for `--upgrades`
+    libdnf::rpm::PackageSet changelog_packages(ctx.base);
+    for (auto & [name, packages] : by_srpm) {
+        changelog_packages.add(packages[0]);
+    }
+    std::map<std::string, std::vector<libdnf::rpm::Package>> installed_by_name;
+    if (upgrades) {
+        libdnf::rpm::PackageQuery installed(full_package_query);
+        installed.filter_installed();
+        for (auto pkg : installed) {
+            installed_by_name[pkg.get_name()].push_back(pkg);
+            changelog_packages.add(pkg);
+        }
+    }
+    auto all_changelogs = libdnf::rpm::read_changelogs(changelog_packages);
+
     for (auto & [name, packages] : by_srpm) {
         // Print header
         std::cout << "Changelogs for ";
@@ -173,7 +195,7 @@ void ChangelogCommand::run() {
         }
         std::cout << std::endl;
 
-        auto changelogs = packages[0].get_changelogs();
+        auto changelogs = std::move(all_changelogs.at(packages[0]));
         std::sort(
             changelogs.begin(),
             changelogs.end(),
@@ -183,13 +205,14 @@ void ChangelogCommand::run() {
 
         // filter changelog
         if (upgrades) {
-            libdnf::rpm::PackageQuery query(installed);
-            query.filter_name({packages[0].get_name()});
             time_t newest_timestamp = 0;
-            for (auto pkg : query) {
-                for (auto & chlog : pkg.get_changelogs()) {
-                    if (chlog.timestamp > newest_timestamp) {
-                        newest_timestamp = chlog.timestamp;
+            if (auto installed_it = installed_by_name.find(packages[0].get_name());
+                installed_it != installed_by_name.end()) {
+                for (const auto & pkg : installed_it->second) {
+                    for (auto & chlog : all_changelogs.at(pkg)) {
+                        if (chlog.timestamp > newest_timestamp) {
+                            newest_timestamp = chlog.timestamp;
+                        }
                     }
                 }
             }
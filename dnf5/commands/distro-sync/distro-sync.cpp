@@ -19,6 +19,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "distro-sync.hpp"
 
+#include <libdnf/conf/const.hpp>
 #include <libdnf/conf/option_string.hpp>
 
 namespace dnf5 {
@@ -55,6 +56,7 @@ void DistroSyncCommand::configure() {
     auto & context = get_context();
     context.set_load_system_repo(true);
     context.set_load_available_repos(Context::LoadAvailableRepos::ENABLED);
+    context.set_unused_metadata_types({libdnf::METADATA_TYPE_FILELISTS, libdnf::METADATA_TYPE_OTHER});
 }
 
 void DistroSyncCommand::run() {
@@ -19,6 +19,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "downgrade.hpp"
 
+#include <libdnf/conf/const.hpp>
+
 namespace dnf5 {
 
 using namespace libdnf::cli;
@@ -56,6 +58,7 @@ void DowngradeCommand::configure() {
     auto & context = get_context();
     context.set_load_system_repo(true);
     context.set_load_available_repos(Context::LoadAvailableRepos::ENABLED);
+    context.set_unused_metadata_types({libdnf::METADATA_TYPE_FILELISTS, libdnf::METADATA_TYPE_OTHER});
 }
 
 void DowngradeCommand::run() {
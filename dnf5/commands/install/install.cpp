@@ -76,6 +76,7 @@ void InstallCommand::configure() {
     }
 
     context.set_load_available_repos(Context::LoadAvailableRepos::ENABLED);
+    context.set_unused_metadata_types({libdnf::METADATA_TYPE_FILELISTS, libdnf::METADATA_TYPE_OTHER});
 }
 
 void InstallCommand::run() {
@@ -20,15 +20,21 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "repoquery.hpp"
 
 #include "libdnf-cli/output/repoquery.hpp"
+#include "utils/bgettext/bgettext-mark-domain.h"
 
 #include <libdnf/advisory/advisory_query.hpp>
 #include <libdnf/conf/const.hpp>
 #include <libdnf/conf/option_string.hpp>
+#include <libdnf/rpm/dependency_closure.hpp>
 #include <libdnf/rpm/package.hpp>
+#include <libdnf/rpm/package_formatter.hpp>
 #include <libdnf/rpm/package_query.hpp>
 #include <libdnf/rpm/package_set.hpp>
 
 #include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace dnf5 {
 
@@ -84,6 +90,18 @@ void RepoqueryCommand::set_argument_parser() {
     nevra->set_const_value("true");
     nevra->link_value(nevra_option);
 
+    queryformat_option = dynamic_cast<libdnf::OptionString *>(
+        parser.add_init_value(std::unique_ptr<libdnf::OptionString>(new libdnf::OptionString(""))));
+
+    auto queryformat = parser.add_new_named_arg("queryformat");
+    queryformat->set_long_name("queryformat");
+    queryformat->set_description(
+        "display packages in the given format, e.g. \"%{name} %{evr} %{repoid}\\n\". Tags can be aligned to "
+        "a field width: \"%-20{name}\"");
+    queryformat->set_has_value(true);
+    queryformat->set_arg_value_help("QUERYFORMAT");
+    queryformat->link_value(queryformat_option);
+
     auto keys =
         parser.add_new_positional_arg("keys_to_match", ArgumentParser::PositionalArg::UNLIMITED, nullptr, nullptr);
     keys->set_description("List of keys to match");
@@ -103,6 +121,7 @@ void RepoqueryCommand::set_argument_parser() {
     });
 
     info->add_conflict_argument(*nevra);
+    info->add_conflict_argument(*queryformat);
 
     whatdepends_option = dynamic_cast<libdnf::OptionStringList *>(
         parser.add_init_value(std::make_unique<libdnf::OptionStringList>(std::vector<std::string>(), "", false, ",")));
@@ -212,6 +231,23 @@ void RepoqueryCommand::set_argument_parser() {
         "Limit the resulting set to installed duplicate packages (i.e. more package versions for  the  same  name and "
         "architecture). Installonly packages are excluded from this set.",
         false);
+    recursive = std::make_unique<libdnf::cli::session::BoolOption>(
+        *this,
+        "recursive",
+        '\0',
+        "This option is stackable with --whatrequires or --whatdepends only. Extend the resulting set recursively "
+        "with the packages that depend on the packages in the set.",
+        false);
+    tree = std::make_unique<libdnf::cli::session::BoolOption>(
+        *this,
+        "tree",
+        '\0',
+        "Display the resulting packages as trees of their dependencies. Used with --whatrequires or --whatdepends, "
+        "the trees consist of the packages depending on the resulting packages, recursively. Combined with "
+        "--recursive, the matched packages are the roots of the trees.",
+        false);
+    // the trees have their own output format
+    tree->arg->add_conflict_argument(*queryformat);
 
     advisory_name = std::make_unique<AdvisoryOption>(*this);
     advisory_security = std::make_unique<SecurityOption>(*this);
@@ -226,6 +262,7 @@ void RepoqueryCommand::set_argument_parser() {
     cmd.register_named_arg(installed);
     cmd.register_named_arg(info);
     cmd.register_named_arg(nevra);
+    cmd.register_named_arg(queryformat);
     cmd.register_named_arg(whatdepends);
     cmd.register_named_arg(whatconflicts);
     cmd.register_named_arg(whatprovides);
@@ -240,6 +277,11 @@ void RepoqueryCommand::set_argument_parser() {
 
 void RepoqueryCommand::configure() {
     auto & context = get_context();
+    if (recursive->get_value() && whatrequires_option->get_value().empty() &&
+        whatdepends_option->get_value().empty()) {
+        throw libdnf::cli::ArgumentParserMissingDependentArgumentError(
+            M_("Option --recursive should be used with --whatrequires or --whatdepends"));
+    }
     context.update_repo_metadata_from_specs(pkg_specs);
     only_system_repo_needed = installed_option->get_value() || duplicates->get_value();
     context.set_load_system_repo(only_system_repo_needed);
@@ -281,6 +323,41 @@ static libdnf::rpm::PackageSet resolve_nevras_to_packges(
     return resolved_nevras_set;
 }
 
+// Extends `packages` by the packages from `universe` that depend on them, directly or indirectly.
+static void add_reverse_dependency_closure(
+    libdnf::rpm::PackageQuery & packages, const libdnf::rpm::PackageQuery & universe, bool weak_deps) {
+    libdnf::rpm::DependencyClosureSettings settings;
+    settings.with_recommends = weak_deps;
+    settings.with_suggests = weak_deps;
+    settings.with_supplements = weak_deps;
+    settings.with_enhances = weak_deps;
+    settings.reverse = true;
+    packages |= libdnf::rpm::DependencyClosure(universe, settings).compute(packages);
+}
+
+// Prints every root of the `closure` followed by the indented tree of the packages reached through it.
+static void print_dependency_tree(const libdnf::rpm::DependencyClosure & closure) {
+    std::string output;
+    // depth-first walk, every item contains the prefix of the package line and the package
+    std::vector<std::pair<std::string, libdnf::rpm::Package>> stack;
+    auto roots = closure.get_roots();
+    for (auto it = roots.rbegin(); it != roots.rend(); ++it) {
+        stack.emplace_back("", *it);
+    }
+    while (!stack.empty()) {
+        auto [prefix, package] = std::move(stack.back());
+        stack.pop_back();
+        output.append(prefix).append(package.get_full_nevra()).push_back('\n');
+
+        auto children = closure.get_children(package);
+        auto child_prefix = prefix.empty() ? std::string(" |-- ") : "     " + prefix;
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            stack.emplace_back(child_prefix, *it);
+        }
+    }
+    std::cout << output;
+}
+
 void RepoqueryCommand::run() {
     auto & ctx = get_context();
 
@@ -300,6 +377,7 @@ void RepoqueryCommand::run() {
     if (advisories.has_value()) {
         full_package_query.filter_advisories(advisories.value(), libdnf::sack::QueryCmp::GTE);
     }
+    const auto universe_query = full_package_query;
 
     if (!whatdepends_option->get_value().empty()) {
         auto matched_reldeps = libdnf::rpm::ReldepList(ctx.base);
@@ -348,7 +426,10 @@ void RepoqueryCommand::run() {
             suggests_pkg_query.filter_suggests(pkgs_from_resolved_nevras, libdnf::sack::QueryCmp::EQ);
             dependsquery |= suggests_pkg_query;
         }
-        //TODO(amatej): add recurisve option call
+        // With --tree the dependants are shown as the subtrees of the matched packages, which stay the roots.
+        if (recursive->get_value() && !tree->get_value()) {
+            add_reverse_dependency_closure(dependsquery, full_package_query, true);
+        }
 
         full_package_query = dependsquery;
     }
@@ -363,6 +444,7 @@ void RepoqueryCommand::run() {
         }
     }
     if (!whatrequires_option->get_value().empty()) {
+        const auto universe = full_package_query;
         if (exactdeps->get_value()) {
             full_package_query.filter_requires(whatrequires_option->get_value(), libdnf::sack::QueryCmp::GLOB);
         } else {
@@ -372,7 +454,9 @@ void RepoqueryCommand::run() {
 
             full_package_query.filter_requires(whatrequires_option->get_value(), libdnf::sack::QueryCmp::GLOB);
             full_package_query |= requires_resolved;
-            //TODO(amatej): add recurisve option call
+        }
+        if (recursive->get_value() && !tree->get_value()) {
+            add_reverse_dependency_closure(full_package_query, universe, false);
         }
     }
     if (!whatobsoletes_option->get_value().empty()) {
@@ -445,15 +529,30 @@ void RepoqueryCommand::run() {
         }
     }
 
-    if (info_option->get_value()) {
+    if (tree->get_value()) {
+        // The packages are looked up among the packages the query started from, before the what* filters.
+        libdnf::rpm::DependencyClosureSettings settings;
+        settings.reverse = !whatrequires_option->get_value().empty() || !whatdepends_option->get_value().empty();
+        if (!whatdepends_option->get_value().empty()) {
+            settings.with_recommends = true;
+            settings.with_suggests = true;
+            settings.with_supplements = true;
+            settings.with_enhances = true;
+        }
+        libdnf::rpm::DependencyClosure closure(universe_query, settings);
+        closure.compute(result_pset);
+        print_dependency_tree(closure);
+    } else if (info_option->get_value()) {
         for (auto package : result_pset) {
             libdnf::cli::output::print_package_info_table(package);
             std::cout << '\n';
         }
     } else {
-        for (auto package : result_pset) {
-            std::cout << package.get_full_nevra() << '\n';
-        }
+        // The formatter is compiled once and writes the whole set in large blocks,
+        // the default output is the same as with "%{full_nevra}\n".
+        const auto & queryformat = queryformat_option->get_value();
+        libdnf::rpm::PackageFormatter formatter(queryformat.empty() ? "%{full_nevra}\n" : queryformat);
+        formatter.format(result_pset, std::cout);
     }
 }
 
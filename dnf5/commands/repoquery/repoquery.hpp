@@ -25,6 +25,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <dnf5/context.hpp>
 #include <libdnf/conf/option_bool.hpp>
+#include <libdnf/conf/option_string.hpp>
 
 #include <memory>
 #include <vector>
@@ -49,6 +50,7 @@ private:
     libdnf::OptionBool * installed_option{nullptr};
     libdnf::OptionBool * info_option{nullptr};
     libdnf::OptionBool * nevra_option{nullptr};
+    libdnf::OptionString * queryformat_option{nullptr};
     std::vector<std::string> pkg_specs;
     std::vector<libdnf::rpm::Package> cmdline_packages;
 
@@ -64,6 +66,8 @@ private:
 
     std::unique_ptr<libdnf::cli::session::BoolOption> exactdeps{nullptr};
     std::unique_ptr<libdnf::cli::session::BoolOption> duplicates{nullptr};
+    std::unique_ptr<libdnf::cli::session::BoolOption> recursive{nullptr};
+    std::unique_ptr<libdnf::cli::session::BoolOption> tree{nullptr};
 
     std::unique_ptr<AdvisoryOption> advisory_name{nullptr};
     std::unique_ptr<SecurityOption> advisory_security{nullptr};
@@ -20,10 +20,22 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "search.hpp"
 
-#include <libdnf/conf/option_string.hpp>
+#include "utils/bgettext/bgettext-mark-domain.h"
+#include "utils/string.hpp"
 
+#include <fmt/format.h>
+#include <libdnf-cli/exception.hpp>
+#include <libdnf-cli/tty.hpp>
+#include <libdnf/conf/option_string.hpp>
+#include <libdnf/rpm/package_query.hpp>
+#include <strings.h>
 
-namespace fs = std::filesystem;
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <map>
+#include <string>
+#include <tuple>
 
 
 namespace dnf5 {
@@ -32,6 +44,64 @@ namespace dnf5 {
 using namespace libdnf::cli;
 
 
+namespace {
+
+using PackageQueryFilter =
+    void (libdnf::rpm::PackageQuery::*)(const std::vector<std::string> &, libdnf::sack::QueryCmp);
+
+/// Package attribute searched for the keywords.
+struct SearchAttribute {
+    const char * label;
+    // ranking weight of a match, the same as in dnf4
+    int weight;
+    PackageQueryFilter filter;
+};
+
+// Attributes in descending order of importance. Only name and summary are searched by default.
+const std::array<SearchAttribute, 4> SEARCH_ATTRIBUTES{{
+    {"Name", 7, &libdnf::rpm::PackageQuery::filter_name},
+    {"Summary", 4, &libdnf::rpm::PackageQuery::filter_summary},
+    {"Description", 2, &libdnf::rpm::PackageQuery::filter_description},
+    {"URL", 1, &libdnf::rpm::PackageQuery::filter_url},
+}};
+constexpr std::size_t DEFAULT_SEARCH_ATTRIBUTES_COUNT = 2;
+
+
+struct PackageMatch {
+    int weight{0};
+    // the package name is equal to one of the keywords
+    bool exact_name{false};
+    // bit mask of the matched attributes (indexes to SEARCH_ATTRIBUTES)
+    unsigned attributes{0};
+    // sorted indexes of the matched keywords
+    std::vector<std::size_t> keywords;
+
+    // Matches sharing the same section are printed under a common header
+    auto section_key() const { return std::tie(exact_name, attributes, keywords); }
+};
+
+
+std::string section_header(const PackageMatch & match, const std::vector<std::string> & keywords) {
+    std::vector<std::string> labels;
+    for (std::size_t idx = 0; idx < SEARCH_ATTRIBUTES.size(); ++idx) {
+        if (match.attributes & (1u << idx)) {
+            labels.emplace_back(SEARCH_ATTRIBUTES[idx].label);
+        }
+    }
+    std::vector<std::string> matched_keywords;
+    for (auto idx : match.keywords) {
+        matched_keywords.push_back(keywords[idx]);
+    }
+    return fmt::format(
+        "{} {}Matched: {}",
+        libdnf::utils::string::join(labels, " & "),
+        match.exact_name ? "Exactly " : "",
+        libdnf::utils::string::join(matched_keywords, ", "));
+}
+
+}  // namespace
+
+
 void SearchCommand::set_parent_command() {
     auto * arg_parser_parent_cmd = get_session().get_argument_parser().get_root_command();
     auto * arg_parser_this_cmd = get_argument_parser_command();
@@ -49,19 +119,117 @@ void SearchCommand::set_argument_parser() {
     patterns = parser.add_new_values();
     auto patterns_arg = parser.add_new_positional_arg(
         "patterns",
-        ArgumentParser::PositionalArg::UNLIMITED,
+        ArgumentParser::PositionalArg::AT_LEAST_ONE,
         parser.add_init_value(std::unique_ptr<libdnf::Option>(new libdnf::OptionString(nullptr))),
         patterns);
     patterns_arg->set_description("Patterns");
     cmd.register_positional_arg(patterns_arg);
+
+    search_all = std::make_unique<libdnf::cli::session::BoolOption>(
+        *this,
+        "all",
+        '\0',
+        "Search also package description and URL. Packages matching any of the patterns are listed.",
+        false);
+    show_duplicates = std::make_unique<libdnf::cli::session::BoolOption>(
+        *this, "showduplicates", '\0', "Show all versions of the matching packages, not only the latest ones.", false);
 }
 
+void SearchCommand::configure() {
+    auto & context = get_context();
+    context.set_load_system_repo(true);
+    context.set_load_available_repos(Context::LoadAvailableRepos::ENABLED);
+}
 
 void SearchCommand::run() {
-    // auto & ctx = get_context();
-    // auto & package_sack = *ctx.base.get_rpm_package_sack();
+    auto & ctx = get_context();
 
-    // TODO(dmach): implement
+    std::vector<std::string> keywords;
+    for (auto & pattern : *patterns) {
+        keywords.push_back(dynamic_cast<libdnf::OptionString *>(pattern.get())->get_value());
+    }
+
+    libdnf::rpm::PackageQuery base_query(ctx.base);
+    if (!show_duplicates->get_value()) {
+        base_query.filter_latest_evr();
+    }
+
+    // Substring matching of the attributes is served by the repositories' search indexes
+    const std::size_t attributes_count =
+        search_all->get_value() ? SEARCH_ATTRIBUTES.size() : DEFAULT_SEARCH_ATTRIBUTES_COUNT;
+    std::map<libdnf::rpm::Package, PackageMatch> matches;
+    for (std::size_t keyword_idx = 0; keyword_idx < keywords.size(); ++keyword_idx) {
+        const auto & keyword = keywords[keyword_idx];
+        for (std::size_t attribute_idx = 0; attribute_idx < attributes_count; ++attribute_idx) {
+            const auto & attribute = SEARCH_ATTRIBUTES[attribute_idx];
+            libdnf::rpm::PackageQuery query(base_query);
+            (query.*attribute.filter)({keyword}, libdnf::sack::QueryCmp::ICONTAINS);
+            for (const auto & package : query) {
+                auto & match = matches.try_emplace(package).first->second;
+                auto weight = attribute.weight;
+                // the name view is null-terminated
+                if (attribute_idx == 0 && strcasecmp(package.get_name_view().data(), keyword.c_str()) == 0) {
+                    weight *= 2;
+                    match.exact_name = true;
+                }
+                match.weight += weight;
+                match.attributes |= 1u << attribute_idx;
+                if (match.keywords.empty() || match.keywords.back() != keyword_idx) {
+                    match.keywords.push_back(keyword_idx);
+                }
+            }
+        }
+    }
+
+    // Prefer packages matching all the keywords. Packages matching only some of them are listed
+    // with --all or if no package matches all the keywords.
+    std::vector<std::pair<libdnf::rpm::Package, PackageMatch>> results;
+    for (auto & [package, match] : matches) {
+        if (match.keywords.size() == keywords.size()) {
+            results.emplace_back(package, match);
+        }
+    }
+    if (search_all->get_value() || results.empty()) {
+        results.assign(matches.begin(), matches.end());
+    }
+
+    if (results.empty()) {
+        throw libdnf::cli::CommandExitError(1, M_("No matches found."));
+    }
+
+    std::sort(results.begin(), results.end(), [](const auto & lhs, const auto & rhs) {
+        if (lhs.second.weight != rhs.second.weight) {
+            return lhs.second.weight > rhs.second.weight;
+        }
+        if (lhs.second.section_key() != rhs.second.section_key()) {
+            return lhs.second.section_key() > rhs.second.section_key();
+        }
+        auto lhs_name = lhs.first.get_name_view();
+        auto rhs_name = rhs.first.get_name_view();
+        if (lhs_name != rhs_name) {
+            return lhs_name < rhs_name;
+        }
+        return lhs.first < rhs.first;
+    });
+
+    const int width = libdnf::cli::tty::get_width();
+    const PackageMatch * section = nullptr;
+    std::string line;
+    for (const auto & [package, match] : results) {
+        if (!section || section->section_key() != match.section_key()) {
+            auto header = " " + section_header(match, keywords) + " ";
+            std::cout << fmt::format("{:=^{}}", header, width) << '\n';
+            section = &match;
+        }
+        line.clear();
+        if (show_duplicates->get_value()) {
+            package.append_nevra(line);
+        } else {
+            line.append(package.get_name_view()).append(1, '.').append(package.get_arch_view());
+        }
+        line.append(" : ").append(package.get_summary_view()).append(1, '\n');
+        std::cout << line;
+    }
 }
 
 
@@ -36,10 +36,13 @@ public:
     explicit SearchCommand(Context & context) : Command(context, "search") {}
     void set_parent_command() override;
     void set_argument_parser() override;
+    void configure() override;
     void run() override;
 
 private:
     std::vector<std::unique_ptr<libdnf::Option>> * patterns{nullptr};
+    std::unique_ptr<libdnf::cli::session::BoolOption> search_all{nullptr};
+    std::unique_ptr<libdnf::cli::session::BoolOption> show_duplicates{nullptr};
 };
 
 
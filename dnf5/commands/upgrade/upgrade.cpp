@@ -86,6 +86,7 @@ void UpgradeCommand::configure() {
         context.base.get_config().optional_metadata_types().add_item(libdnf::METADATA_TYPE_UPDATEINFO);
     }
     context.set_load_available_repos(Context::LoadAvailableRepos::ENABLED);
+    context.set_unused_metadata_types({libdnf::METADATA_TYPE_FILELISTS, libdnf::METADATA_TYPE_OTHER});
 }
 
 void UpgradeCommand::run() {
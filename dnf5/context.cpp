@@ -42,10 +42,12 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <algorithm>
 #include <cctype>
 #include <iostream>
+#include <mutex>
 #include <regex>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <utility>
 
@@ -236,6 +238,7 @@ void Context::update_repo_metadata_from_specs(const std::vector<std::string> & p
     for (auto & spec : pkg_specs) {
         if (libdnf::utils::is_file_pattern(spec)) {
             base.get_config().optional_metadata_types().add_item(libdnf::METADATA_TYPE_FILELISTS);
+            filelists_required = true;
             return;
         }
     }
@@ -256,6 +259,12 @@ void Context::load_repos(bool load_system) {
     print_info("Updating and loading repositories:");
     base.get_repo_sack()->update_and_load_enabled_repos(load_system);
     print_info("Repositories loaded.");
+
+    auto released_metadata_types = unused_metadata_types;
+    if (filelists_required) {
+        released_metadata_types.erase(libdnf::METADATA_TYPE_FILELISTS);
+    }
+    base.get_repo_sack()->release_metadata(released_metadata_types);
 }
 
 void download_packages(const std::vector<libdnf::rpm::Package> & packages, const char * dest_dir) {
@@ -310,6 +319,7 @@ public:
         [[maybe_unused]] const libdnf::rpm::TransactionItem & item,
         uint64_t amount,
         [[maybe_unused]] uint64_t total) override {
+        std::lock_guard<std::mutex> lock(mutex);
         active_progress_bar->set_ticks(static_cast<int64_t>(amount));
         if (is_time_to_print()) {
             multi_progress_bar.print();
@@ -317,6 +327,7 @@ public:
     }
 
     void install_start(const libdnf::rpm::TransactionItem & item, uint64_t total) override {
+        std::lock_guard<std::mutex> lock(mutex);
         const char * msg{nullptr};
         switch (item.get_action()) {
             case libdnf::transaction::TransactionItemAction::UPGRADE:
@@ -348,10 +359,12 @@ public:
         [[maybe_unused]] const libdnf::rpm::TransactionItem & item,
         [[maybe_unused]] uint64_t amount,
         [[maybe_unused]] uint64_t total) override {
+        std::lock_guard<std::mutex> lock(mutex);
         multi_progress_bar.print();
     }
 
     void transaction_progress(uint64_t amount, [[maybe_unused]] uint64_t total) override {
+        std::lock_guard<std::mutex> lock(mutex);
         active_progress_bar->set_ticks(static_cast<int64_t>(amount));
         if (is_time_to_print()) {
             multi_progress_bar.print();
@@ -359,10 +372,12 @@ public:
     }
 
     void transaction_start(uint64_t total) override {
+        std::lock_guard<std::mutex> lock(mutex);
         new_progress_bar(static_cast<int64_t>(total), "Prepare transaction");
     }
 
     void transaction_stop([[maybe_unused]] uint64_t total) override {
+        std::lock_guard<std::mutex> lock(mutex);
         active_progress_bar->set_ticks(static_cast<int64_t>(total));
         multi_progress_bar.print();
     }
@@ -371,6 +386,7 @@ public:
         [[maybe_unused]] const libdnf::rpm::TransactionItem & item,
         uint64_t amount,
         [[maybe_unused]] uint64_t total) override {
+        std::lock_guard<std::mutex> lock(mutex);
         active_progress_bar->set_ticks(static_cast<int64_t>(amount));
         if (is_time_to_print()) {
             multi_progress_bar.print();
@@ -378,6 +394,7 @@ public:
     }
 
     void uninstall_start(const libdnf::rpm::TransactionItem & item, uint64_t total) override {
+        std::lock_guard<std::mutex> lock(mutex);
         const char * msg{nullptr};
         if (item.get_action() == libdnf::transaction::TransactionItemAction::REMOVE ||
             item.get_action() == libdnf::transaction::TransactionItemAction::REPLACED) {
@@ -393,11 +410,13 @@ public:
         [[maybe_unused]] const libdnf::rpm::TransactionItem & item,
         [[maybe_unused]] uint64_t amount,
         [[maybe_unused]] uint64_t total) override {
+        std::lock_guard<std::mutex> lock(mutex);
         multi_progress_bar.print();
     }
 
 
     void unpack_error(const libdnf::rpm::TransactionItem & item) override {
+        std::lock_guard<std::mutex> lock(mutex);
         active_progress_bar->add_message(
             libdnf::cli::progressbar::MessageType::ERROR, "Unpack errro: " + item.get_package().get_full_nevra());
         active_progress_bar->set_state(libdnf::cli::progressbar::ProgressBarState::ERROR);
@@ -405,6 +424,7 @@ public:
     }
 
     void cpio_error(const libdnf::rpm::TransactionItem & item) override {
+        std::lock_guard<std::mutex> lock(mutex);
         active_progress_bar->add_message(
             libdnf::cli::progressbar::MessageType::ERROR, "Cpio error: " + item.get_package().get_full_nevra());
         active_progress_bar->set_state(libdnf::cli::progressbar::ProgressBarState::ERROR);
@@ -416,6 +436,7 @@ public:
         libdnf::rpm::Nevra nevra,
         libdnf::rpm::TransactionCallbacks::ScriptType type,
         uint64_t return_code) override {
+        std::lock_guard<std::mutex> lock(mutex);
         active_progress_bar->add_message(
             libdnf::cli::progressbar::MessageType::ERROR,
             fmt::format(
@@ -430,10 +451,34 @@ public:
         [[maybe_unused]] const libdnf::rpm::TransactionItem * item,
         libdnf::rpm::Nevra nevra,
         libdnf::rpm::TransactionCallbacks::ScriptType type) override {
+        std::lock_guard<std::mutex> lock(mutex);
         active_progress_bar->add_message(
             libdnf::cli::progressbar::MessageType::INFO,
             fmt::format("Running {} scriptlet: {}", script_type_to_string(type), to_full_nevra_string(nevra)));
         multi_progress_bar.print();
+        script_output_lines = 0;
+    }
+
+    void script_output(
+        [[maybe_unused]] const libdnf::rpm::TransactionItem * item,
+        [[maybe_unused]] libdnf::rpm::Nevra nevra,
+        [[maybe_unused]] libdnf::rpm::TransactionCallbacks::ScriptType type,
+        std::string_view output) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        // the output is shown while the scriptlet runs, the whole output of a chatty scriptlet is in the scriptlet log
+        auto lines = output;
+        while (!lines.empty() && script_output_lines <= MAX_SCRIPT_OUTPUT_LINES) {
+            auto line_end = lines.find('\n');
+            auto line = lines.substr(0, line_end);
+            lines.remove_prefix(line_end == std::string_view::npos ? lines.size() : line_end + 1);
+            if (++script_output_lines > MAX_SCRIPT_OUTPUT_LINES) {
+                active_progress_bar->add_message(
+                    libdnf::cli::progressbar::MessageType::INFO, "... more scriptlet output in the scriptlet log");
+            } else {
+                active_progress_bar->add_message(libdnf::cli::progressbar::MessageType::INFO, std::string(line));
+            }
+        }
+        multi_progress_bar.print();
     }
 
     void script_stop(
@@ -441,6 +486,7 @@ public:
         libdnf::rpm::Nevra nevra,
         libdnf::rpm::TransactionCallbacks::ScriptType type,
         [[maybe_unused]] uint64_t return_code) override {
+        std::lock_guard<std::mutex> lock(mutex);
         active_progress_bar->add_message(
             libdnf::cli::progressbar::MessageType::INFO,
             fmt::format("Stop {} scriptlet: {}", script_type_to_string(type), to_full_nevra_string(nevra)));
@@ -455,6 +501,7 @@ public:
     }
 
     void verify_progress(uint64_t amount, [[maybe_unused]] uint64_t total) override {
+        std::lock_guard<std::mutex> lock(mutex);
         active_progress_bar->set_ticks(static_cast<int64_t>(amount));
         if (is_time_to_print()) {
             multi_progress_bar.print();
@@ -462,10 +509,12 @@ public:
     }
 
     void verify_start([[maybe_unused]] uint64_t total) override {
+        std::lock_guard<std::mutex> lock(mutex);
         new_progress_bar(static_cast<int64_t>(total), "Verify package files");
     }
 
     void verify_stop([[maybe_unused]] uint64_t total) override {
+        std::lock_guard<std::mutex> lock(mutex);
         active_progress_bar->set_ticks(static_cast<int64_t>(total));
         multi_progress_bar.print();
     }
@@ -498,8 +547,15 @@ private:
 
     static std::chrono::time_point<std::chrono::steady_clock> prev_print_time;
 
+    // maximal number of output lines of one scriptlet shown
+    static constexpr std::size_t MAX_SCRIPT_OUTPUT_LINES = 100;
+
+    // script_output() is called from the thread reading the scriptlet output, concurrently with the other
+    // callbacks, the mutex guards the progress bars and their printing
+    std::mutex mutex;
     libdnf::cli::progressbar::MultiProgressBar multi_progress_bar;
     libdnf::cli::progressbar::DownloadProgressBar * active_progress_bar{nullptr};
+    std::size_t script_output_lines{0};  // output lines of the running scriptlet
 };
 
 std::chrono::time_point<std::chrono::steady_clock> RpmTransCB::prev_print_time = std::chrono::steady_clock::now();
@@ -634,12 +690,17 @@ bool Context::check_gpg_signatures(const libdnf::base::Transaction & transaction
 
 
 void Context::download_and_run(libdnf::base::Transaction & transaction) {
-    download_packages(transaction, nullptr);
+    {
+        libdnf::base::Metrics::Span download_span(*base.get_metrics(), "dnf5.download");
+        download_packages(transaction, nullptr);
+    }
 
     std::cout << std::endl << "Verifying PGP signatures" << std::endl;
+    libdnf::base::Metrics::Span signatures_span(*base.get_metrics(), "dnf5.check_signatures");
     if (!check_gpg_signatures(transaction)) {
         throw libdnf::cli::CommandExitError(1, M_("Signature verification failed"));
     }
+    signatures_span.finish();
 
     std::cout << std::endl << "Running transaction" << std::endl;
 
@@ -32,6 +32,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <filesystem>
 #include <memory>
 #include <optional>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -107,6 +108,25 @@ public:
     void set_load_available_repos(LoadAvailableRepos which) { load_available_repos = which; }
     LoadAvailableRepos get_load_available_repos() const noexcept { return load_available_repos; }
 
+    /// Sets the types of the repository metadata (the `optional_metadata_types` values) the command does not use
+    /// after the repositories are loaded. Their memory is released by `load_repos()`, they are loaded again from
+    /// the solv cache when accessed. The filelists required by file package specs are kept.
+    void set_unused_metadata_types(std::set<std::string> types) { unused_metadata_types = std::move(types); }
+    const std::set<std::string> & get_unused_metadata_types() const noexcept { return unused_metadata_types; }
+
+    /// Set to true to print a summary of timings of the work phases to standard error at the end of the run.
+    void set_print_timings(bool print_timings) { this->print_timings = print_timings; }
+    bool get_print_timings() const noexcept { return print_timings; }
+
+    /// Sets path of the file the collected timings are written to in JSON format. Empty path disables writing.
+    void set_timings_json_path(const std::string & path) { timings_json_path = path; }
+    const std::string & get_timings_json_path() const noexcept { return timings_json_path; }
+
+    /// Sets path of the file the collected timings are written to in Chrome trace event format.
+    /// Empty path disables writing.
+    void set_timings_trace_path(const std::string & path) { timings_trace_path = path; }
+    const std::string & get_timings_trace_path() const noexcept { return timings_trace_path; }
+
 private:
     /// If quiet mode is not active, it will print `msg` to standard output.
     void print_info(const char * msg);
@@ -126,6 +146,13 @@ private:
 
     bool load_system_repo{false};
     LoadAvailableRepos load_available_repos{LoadAvailableRepos::NONE};
+
+    std::set<std::string> unused_metadata_types;
+    bool filelists_required{false};
+
+    bool print_timings{false};
+    std::string timings_json_path;
+    std::string timings_trace_path;
 };
 
 
@@ -34,8 +34,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "commands/remove/remove.hpp"
 #include "commands/repo/repo.hpp"
 #include "commands/repoquery/repoquery.hpp"
-// TODO(jmracek) The search commnd is not yet implemented
-// #include "commands/search/search.hpp"
+#include "commands/search/search.hpp"
 #include "commands/swap/swap.hpp"
 #include "commands/upgrade/upgrade.hpp"
 #include "dnf5/context.hpp"
@@ -88,6 +87,85 @@ void register_group_with_args(
     command.register_group(&group);
 }
 
+
+void write_timings_file(const std::string & path, const std::string & content) {
+    std::ofstream stream(path);
+    if (!stream.is_open()) {
+        throw std::runtime_error(fmt::format("Cannot open file \"{}\": {}", path, strerror(errno)));
+    }
+    stream << content << std::endl;
+}
+
+
+void print_timings(const libdnf::base::Metrics & metrics) {
+    constexpr int label_width = 60;
+    auto spans = metrics.get_spans();
+    std::vector<std::size_t> depths(spans.size(), 0);
+
+    std::cerr << fmt::format(
+                     "{:<{}} {:>10} {:>10} {:>10}", "Timings:", label_width, "wall [ms]", "cpu [ms]", "rss [KiB]")
+              << std::endl;
+    for (std::size_t idx = 0; idx < spans.size(); ++idx) {
+        const auto & span = spans[idx];
+        if (span.parent >= 0) {
+            depths[idx] = depths[static_cast<std::size_t>(span.parent)] + 1;
+        }
+        if (!span.finished) {
+            continue;
+        }
+        auto label = std::string(2 * (depths[idx] + 1), ' ') + span.name;
+        if (!span.detail.empty()) {
+            label += " (" + span.detail + ")";
+        }
+        std::cerr << fmt::format(
+                         "{:<{}} {:>10.1f} {:>10.1f} {:>+10}",
+                         label,
+                         label_width,
+                         static_cast<double>(span.wall_us) / 1000,
+                         static_cast<double>(span.cpu_us) / 1000,
+                         span.rss_delta_kb)
+                  << std::endl;
+    }
+
+    auto counters = metrics.get_counters();
+    if (!counters.empty()) {
+        std::cerr << "Counters:" << std::endl;
+        for (const auto & [name, value] : counters) {
+            std::cerr << fmt::format("  {:<{}} {:>10}", name, label_width - 2, value) << std::endl;
+        }
+    }
+}
+
+
+// Reports the collected timings as requested by the command line options when it goes out of scope.
+// Being a guard, it reports the timings also when the command fails.
+class TimingsReporter {
+public:
+    explicit TimingsReporter(Context & context) : context(context) {}
+    ~TimingsReporter();
+
+private:
+    Context & context;
+};
+
+
+TimingsReporter::~TimingsReporter() {
+    try {
+        auto & metrics = *context.base.get_metrics();
+        if (!context.get_timings_json_path().empty()) {
+            write_timings_file(context.get_timings_json_path(), metrics.to_json());
+        }
+        if (!context.get_timings_trace_path().empty()) {
+            write_timings_file(context.get_timings_trace_path(), metrics.to_chrome_trace());
+        }
+        if (context.get_print_timings()) {
+            print_timings(metrics);
+        }
+    } catch (const std::exception & ex) {
+        std::cerr << "Failed to report timings: " << ex.what() << std::endl;
+    }
+}
+
 }  // namespace
 
 
@@ -438,6 +516,50 @@ void RootCommand::set_argument_parser() {
         global_options_group->register_argument(debug_solver);
     }
 
+    {
+        auto timings = parser.add_new_named_arg("timings");
+        timings->set_long_name("timings");
+        timings->set_description("Print timings of the work phases to standard error at the end of the run");
+        timings->set_parse_hook_func([&ctx](
+                                         [[maybe_unused]] ArgumentParser::NamedArg * arg,
+                                         [[maybe_unused]] const char * option,
+                                         [[maybe_unused]] const char * value) {
+            ctx.set_print_timings(true);
+            return true;
+        });
+        global_options_group->register_argument(timings);
+
+        auto timings_json = parser.add_new_named_arg("timings-json");
+        timings_json->set_long_name("timings-json");
+        timings_json->set_has_value(true);
+        timings_json->set_arg_value_help("FILE");
+        timings_json->set_description("Write timings of the work phases to FILE in JSON format");
+        timings_json->set_parse_hook_func(
+            [&ctx](
+                [[maybe_unused]] ArgumentParser::NamedArg * arg,
+                [[maybe_unused]] const char * option,
+                const char * value) {
+                ctx.set_timings_json_path(value);
+                return true;
+            });
+        global_options_group->register_argument(timings_json);
+
+        auto timings_trace = parser.add_new_named_arg("timings-trace");
+        timings_trace->set_long_name("timings-trace");
+        timings_trace->set_has_value(true);
+        timings_trace->set_arg_value_help("FILE");
+        timings_trace->set_description("Write timings of the work phases to FILE in Chrome trace event format");
+        timings_trace->set_parse_hook_func(
+            [&ctx](
+                [[maybe_unused]] ArgumentParser::NamedArg * arg,
+                [[maybe_unused]] const char * option,
+                const char * value) {
+                ctx.set_timings_trace_path(value);
+                return true;
+            });
+        global_options_group->register_argument(timings_trace);
+    }
+
     {
         auto version = parser.add_new_named_arg("version");
         version->set_long_name("version");
@@ -486,8 +608,7 @@ static void add_commands(Context & context) {
     context.add_and_initialize_command(std::make_unique<MarkCommand>(context));
 
     context.add_and_initialize_command(std::make_unique<RepoqueryCommand>(context));
-    // TODO(jmracek) The search commnd is not yet implemented
-    // context.add_and_initialize_command(std::make_unique<SearchCommand>(context));
+    context.add_and_initialize_command(std::make_unique<SearchCommand>(context));
 
     context.add_and_initialize_command(std::make_unique<GroupCommand>(context));
     context.add_and_initialize_command(std::make_unique<EnvironmentCommand>(context));
@@ -637,11 +758,17 @@ int main(int argc, char * argv[]) try {
 
     auto command = context.get_selected_command();
 
+    auto & metrics = *base.get_metrics();
+    dnf5::TimingsReporter timings_reporter(context);
+    libdnf::base::Metrics::Span run_span(metrics, "dnf5.run");
+
     try {
         command->pre_configure();
 
         // Load main configuration
+        libdnf::base::Metrics::Span load_config_span(metrics, "dnf5.load_config");
         base.load_config_from_file();
+        load_config_span.finish();
 
         // Try to open the current directory to see if we have
         // read and execute access. If not, chdir to /
@@ -669,15 +796,18 @@ int main(int argc, char * argv[]) try {
         // Write messages from memory buffer logger to stream logger
         dynamic_cast<libdnf::MemoryBufferLogger &>(*logger).write_to_logger(log_router);
 
+        libdnf::base::Metrics::Span setup_span(metrics, "dnf5.setup");
         base.setup();
 
         base.get_repo_sack()->create_repos_from_system_configuration();
+        setup_span.finish();
 
         context.apply_repository_setopts();
 
         // Run selected command
         command->configure();
         {
+            libdnf::base::Metrics::Span load_repos_span(metrics, "dnf5.load_repos");
             if (context.get_load_available_repos() != dnf5::Context::LoadAvailableRepos::NONE) {
                 context.load_repos(context.get_load_system_repo());
             } else if (context.get_load_system_repo()) {
@@ -689,7 +819,10 @@ int main(int argc, char * argv[]) try {
 
         command->load_additional_packages();
 
-        command->run();
+        {
+            libdnf::base::Metrics::Span command_span(metrics, "dnf5.command_run");
+            command->run();
+        }
         if (auto goal = context.get_goal(false)) {
             context.set_transaction(goal->resolve());
 
@@ -714,6 +847,7 @@ int main(int argc, char * argv[]) try {
                 throw libdnf::cli::AbortedByUserError();
             }
 
+            libdnf::base::Metrics::Span download_and_run_span(metrics, "dnf5.download_and_run");
             context.download_and_run(*context.get_transaction());
         }
     } catch (libdnf::cli::ArgumentParserMissingCommandError & ex) {
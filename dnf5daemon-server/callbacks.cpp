@@ -278,6 +278,21 @@ void DbusTransactionCB::script_stop(
     }
 }
 
+void DbusTransactionCB::script_output(
+    const libdnf::rpm::TransactionItem * /*item*/,
+    libdnf::rpm::Nevra nevra,
+    libdnf::rpm::TransactionCallbacks::ScriptType type,
+    std::string_view output) {
+    try {
+        auto signal = create_signal_pkg(
+            dnfdaemon::INTERFACE_RPM, dnfdaemon::SIGNAL_TRANSACTION_SCRIPT_OUTPUT, to_full_nevra_string(nevra));
+        signal << static_cast<int>(type);
+        signal << std::string(output);
+        dbus_object->emitSignal(signal);
+    } catch (...) {
+    }
+}
+
 void DbusTransactionCB::elem_progress(const libdnf::rpm::TransactionItem & item, uint64_t amount, uint64_t total) {
     try {
         auto signal = create_signal_pkg(
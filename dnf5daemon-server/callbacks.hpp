@@ -28,6 +28,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <chrono>
 #include <string>
+#include <string_view>
 
 class Session;
 
@@ -142,6 +143,11 @@ public:
         libdnf::rpm::Nevra nevra,
         libdnf::rpm::TransactionCallbacks::ScriptType type,
         uint64_t return_code) override;
+    void script_output(
+        const libdnf::rpm::TransactionItem * item,
+        libdnf::rpm::Nevra nevra,
+        libdnf::rpm::TransactionCallbacks::ScriptType type,
+        std::string_view output) override;
     void script_error(
         const libdnf::rpm::TransactionItem * item,
         libdnf::rpm::Nevra nevra,
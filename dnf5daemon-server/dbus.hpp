@@ -76,6 +76,7 @@ const char * const SIGNAL_TRANSACTION_ACTION_PROGRESS = "transaction_action_prog
 const char * const SIGNAL_TRANSACTION_ACTION_STOP = "transaction_action_stop";
 const char * const SIGNAL_TRANSACTION_SCRIPT_START = "transaction_script_start";
 const char * const SIGNAL_TRANSACTION_SCRIPT_STOP = "transaction_script_stop";
+const char * const SIGNAL_TRANSACTION_SCRIPT_OUTPUT = "transaction_script_output";
 const char * const SIGNAL_TRANSACTION_SCRIPT_ERROR = "transaction_script_error";
 const char * const SIGNAL_TRANSACTION_UNPACK_ERROR = "transaction_unpack_error";
 const char * const SIGNAL_TRANSACTION_ELEM_PROGRESS = "transaction_elem_progress";
@@ -0,0 +1,278 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "refresh_scheduler.hpp"
+
+#include <libdnf/base/goal.hpp>
+#include <libdnf/logger/stream_logger.hpp>
+#include <libdnf/repo/download_callbacks.hpp>
+#include <libdnf/repo/package_downloader.hpp>
+#include <libdnf/repo/repo_callbacks.hpp>
+#include <libdnf/repo/repo_query.hpp>
+#include <libdnf/transaction/transaction_item.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// delay of the first refresh after the daemon start, the same as the dnf-makecache.timer uses
+constexpr std::chrono::seconds FIRST_REFRESH_DELAY = std::chrono::minutes(10);
+// how often the configuration is checked again when the background refresh is disabled
+constexpr std::chrono::seconds DISABLED_CHECK_INTERVAL = std::chrono::hours(1);
+// LR_CB_ABORT of librepo, aborts the running download
+constexpr int ABORT_DOWNLOAD = 1;
+
+namespace {
+
+// aborts the metadata downloads when the scheduler is stopping
+class StoppableRepoCallbacks : public libdnf::repo::RepoCallbacks {
+public:
+    explicit StoppableRepoCallbacks(const std::atomic<bool> & stopping) : stopping(stopping) {}
+
+    int progress([[maybe_unused]] double total_to_download, [[maybe_unused]] double downloaded) override {
+        return stopping ? ABORT_DOWNLOAD : 0;
+    }
+
+private:
+    const std::atomic<bool> & stopping;
+};
+
+// aborts the package downloads when the scheduler is stopping
+class StoppableDownloadCallbacks : public libdnf::repo::DownloadCallbacks {
+public:
+    explicit StoppableDownloadCallbacks(const std::atomic<bool> & stopping) : stopping(stopping) {}
+
+    int progress(
+        [[maybe_unused]] void * user_cb_data,
+        [[maybe_unused]] double total_to_download,
+        [[maybe_unused]] double downloaded) override {
+        return stopping ? ABORT_DOWNLOAD : 0;
+    }
+
+private:
+    const std::atomic<bool> & stopping;
+};
+
+}  // namespace
+
+RefreshScheduler::RefreshScheduler(sdbus::IConnection & connection) : connection(connection) {}
+
+RefreshScheduler::~RefreshScheduler() {
+    stop();
+}
+
+void RefreshScheduler::start() {
+    worker = std::thread(&RefreshScheduler::run, this);
+}
+
+void RefreshScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(stop_mutex);
+        stopping = true;
+    }
+    stop_condition.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void RefreshScheduler::run() {
+    auto delay = FIRST_REFRESH_DELAY;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(stop_mutex);
+            if (stop_condition.wait_for(lock, delay, [this]() { return stopping.load(); })) {
+                return;
+            }
+        }
+        try {
+            delay = refresh();
+        } catch (const std::exception & ex) {
+            std::cerr << "Background metadata refresh failed: " << ex.what() << std::endl;
+            delay = DISABLED_CHECK_INTERVAL;
+        }
+    }
+}
+
+std::chrono::seconds RefreshScheduler::refresh() {
+    // the configuration is loaded again for every run, the same way the sessions load it
+    std::vector<std::unique_ptr<libdnf::Logger>> loggers;
+    loggers.emplace_back(std::make_unique<libdnf::StdCStreamLogger>(std::cerr));
+    libdnf::Base base(std::move(loggers));
+    base.load_config_from_file();
+    base.setup();
+    base.set_download_callbacks(std::make_unique<StoppableDownloadCallbacks>(stopping));
+
+    auto & config = base.get_config();
+    auto & logger = *base.get_logger();
+    const auto interval = config.metadata_timer_sync().get_value();
+    if (interval <= 0) {
+        logger.debug("Background metadata refresh is disabled by metadata_timer_sync");
+        return DISABLED_CHECK_INTERVAL;
+    }
+    if (is_on_battery()) {
+        logger.info("Background metadata refresh skipped, the system is running on a battery");
+        return std::chrono::seconds(interval);
+    }
+    if (is_network_metered()) {
+        logger.info("Background metadata refresh skipped, the network connection is metered");
+        return std::chrono::seconds(interval);
+    }
+
+    base.get_repo_sack()->create_repos_from_system_configuration();
+    libdnf::repo::RepoQuery enabled_repos(base);
+    enabled_repos.filter_enabled(true);
+    enabled_repos.filter_type(libdnf::repo::Repo::Type::AVAILABLE);
+    for (auto & repo : enabled_repos) {
+        repo->set_callbacks(std::make_unique<StoppableRepoCallbacks>(stopping));
+    }
+
+    // refresh the metadata which expire before the next run now, not in the foreground
+    std::vector<libdnf::repo::RepoWeakPtr> due_repos;
+    for (auto & repo : enabled_repos) {
+        try {
+            repo->read_metadata_cache();
+        } catch (const std::runtime_error &) {
+            // no usable cache
+            due_repos.push_back(repo);
+            continue;
+        }
+        if (repo->get_config().metadata_expire().get_value() >= 0 &&
+            (repo->is_expired() || repo->get_expires_in() <= interval)) {
+            due_repos.push_back(repo);
+        }
+    }
+    std::stable_sort(due_repos.begin(), due_repos.end(), [](const auto & lhs, const auto & rhs) {
+        if (lhs->get_priority() != rhs->get_priority()) {
+            return lhs->get_priority() < rhs->get_priority();
+        }
+        return lhs->get_cost() < rhs->get_cost();
+    });
+
+    std::size_t refreshed = 0;
+    for (auto & repo : due_repos) {
+        if (stopping) {
+            return std::chrono::seconds(interval);
+        }
+        try {
+            // The repository cache locks exclude the sessions of this daemon as well as other processes,
+            // a session loading the repository meanwhile waits for the refreshed metadata.
+            repo->expire();
+            repo->fetch_metadata();
+            ++refreshed;
+        } catch (const std::runtime_error & ex) {
+            if (!stopping) {
+                logger.warning("Background refresh of repository \"{}\" failed: {}", repo->get_id(), ex.what());
+            }
+        }
+    }
+
+    const bool prefetch = config.prefetch_upgrades().get_value();
+    if (stopping) {
+        return std::chrono::seconds(interval);
+    }
+    if (refreshed > 0 || prefetch) {
+        // loading the repositories writes their solv caches
+        try {
+            base.get_repo_sack()->update_and_load_enabled_repos(prefetch);
+        } catch (const std::runtime_error & ex) {
+            if (!stopping) {
+                logger.warning("Background loading of repositories failed: {}", ex.what());
+            }
+            return std::chrono::seconds(interval);
+        }
+    }
+    logger.info("Background metadata refresh finished, {} repositories refreshed", refreshed);
+
+    if (prefetch && !stopping) {
+        try {
+            prefetch_upgrades(base);
+        } catch (const std::runtime_error & ex) {
+            if (!stopping) {
+                logger.warning("Background download of upgrades failed: {}", ex.what());
+            }
+        }
+    }
+
+    return std::chrono::seconds(interval);
+}
+
+void RefreshScheduler::prefetch_upgrades(libdnf::Base & base) {
+    libdnf::Goal goal(base);
+    goal.add_rpm_upgrade();
+    auto transaction = goal.resolve();
+    if (stopping) {
+        return;
+    }
+    if (transaction.get_problems() != libdnf::GoalProblem::NO_PROBLEM) {
+        base.get_logger()->info("Upgrades are not downloaded in the background, they cannot be resolved");
+        return;
+    }
+
+    libdnf::repo::PackageDownloader downloader;
+    std::size_t packages = 0;
+    for (auto & tspkg : transaction.get_transaction_packages()) {
+        if (transaction_item_action_is_inbound(tspkg.get_action())) {
+            downloader.add(tspkg.get_package());
+            ++packages;
+        }
+    }
+    // a failed package is downloaded again by the transaction, do not stop the others
+    downloader.download(false, true);
+    base.get_logger()->info("Background download of upgrades finished, {} packages downloaded", packages);
+}
+
+bool RefreshScheduler::is_on_battery() {
+    // the system runs on a battery when it has mains power supplies and none of them is online
+    bool has_mains = false;
+    std::error_code ec;
+    for (const auto & supply : std::filesystem::directory_iterator("/sys/class/power_supply", ec)) {
+        std::string type;
+        std::ifstream(supply.path() / "type") >> type;
+        if (type != "Mains") {
+            continue;
+        }
+        has_mains = true;
+        int online = 0;
+        std::ifstream(supply.path() / "online") >> online;
+        if (online != 0) {
+            return false;
+        }
+    }
+    return has_mains;
+}
+
+bool RefreshScheduler::is_network_metered() {
+    // NMMetered values of the NetworkManager
+    const uint32_t NM_METERED_YES = 1;
+    const uint32_t NM_METERED_GUESS_YES = 3;
+    try {
+        auto nm_proxy =
+            sdbus::createProxy(connection, "org.freedesktop.NetworkManager", "/org/freedesktop/NetworkManager");
+        nm_proxy->finishRegistration();
+        auto metered = nm_proxy->getProperty("Metered").onInterface("org.freedesktop.NetworkManager").get<uint32_t>();
+        return metered == NM_METERED_YES || metered == NM_METERED_GUESS_YES;
+    } catch (const sdbus::Error &) {
+        // NetworkManager is not running, the connection is not known to be metered
+        return false;
+    }
+}
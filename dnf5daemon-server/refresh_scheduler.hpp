@@ -0,0 +1,63 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DNF5DAEMON_SERVER_REFRESH_SCHEDULER_HPP
+#define DNF5DAEMON_SERVER_REFRESH_SCHEDULER_HPP
+
+#include <libdnf/base/base.hpp>
+#include <sdbus-c++/sdbus-c++.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Refreshes the repository metadata in the background, so that the sessions find up-to-date metadata
+// and solv caches instead of downloading them in the foreground.
+//
+// Every `metadata_timer_sync` seconds the metadata of the enabled repositories which expire before the next run
+// are refreshed, repositories with higher priority first. The refresh is skipped while the system runs
+// on a battery or on a metered network connection. With `prefetch_upgrades` enabled, the available upgrades
+// are resolved and their packages are downloaded to the cache as well.
+class RefreshScheduler {
+public:
+    explicit RefreshScheduler(sdbus::IConnection & connection);
+    ~RefreshScheduler();
+
+    void start();
+    // stop the scheduler and wait for the running refresh to finish, its downloads are aborted
+    void stop();
+
+private:
+    void run();
+    // refresh the metadata once, returns delay of the next run
+    std::chrono::seconds refresh();
+    void prefetch_upgrades(libdnf::Base & base);
+    bool is_on_battery();
+    bool is_network_metered();
+
+    sdbus::IConnection & connection;
+    std::mutex stop_mutex;
+    std::condition_variable stop_condition;
+    std::atomic<bool> stopping{false};
+    std::thread worker;
+};
+
+#endif
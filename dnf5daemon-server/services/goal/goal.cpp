@@ -203,6 +203,9 @@ sdbus::MethodReply Goal::do_transaction(sdbus::MethodCall & call) {
                 static_cast<std::underlying_type_t<libdnf::base::Transaction::TransactionRunResult>>(rpm_result)));
     }
 
+    // keep the loaded system repository in sync with the rpmdb for the following requests in the session
+    session.get_base()->get_repo_sack()->update_system_repo(*transaction);
+
     // TODO(mblaha): clean up downloaded packages after successfull transaction
 
     auto reply = call.createReply();
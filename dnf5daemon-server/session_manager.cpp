@@ -34,9 +34,12 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 SessionManager::SessionManager() {
     connection = sdbus::createSystemBusConnection(dnfdaemon::DBUS_NAME);
     dbus_register();
+    refresh_scheduler = std::make_unique<RefreshScheduler>(*connection);
+    refresh_scheduler->start();
 }
 
 SessionManager::~SessionManager() {
+    refresh_scheduler->stop();
     dbus_object->unregister();
     threads_manager.finish();
 }
@@ -154,9 +157,13 @@ void SessionManager::shut_down() {
     if (active) {
         // prevent opening a new session
         active = false;
-        std::lock_guard<std::mutex> lock(sessions_mutex);
-        // wait for current sessions to finish and delete them
-        sessions.clear();
+        // wait for the running background refresh to finish, the sessions are not blocked meanwhile
+        refresh_scheduler->stop();
+        {
+            std::lock_guard<std::mutex> lock(sessions_mutex);
+            // wait for current sessions to finish and delete them
+            sessions.clear();
+        }
         // leave the main event loop
         connection->leaveEventLoop();
     }
@@ -20,6 +20,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef DNF5DAEMON_SERVER_SESSIONMANAGER_HPP
 #define DNF5DAEMON_SERVER_SESSIONMANAGER_HPP
 
+#include "refresh_scheduler.hpp"
 #include "session.hpp"
 #include "threads_manager.hpp"
 
@@ -44,6 +45,7 @@ private:
     ThreadsManager threads_manager;
     std::unique_ptr<sdbus::IObject> dbus_object;
     std::unique_ptr<sdbus::IProxy> name_changed_proxy;
+    std::unique_ptr<RefreshScheduler> refresh_scheduler;
     std::mutex active_mutex;
     bool active = true;
 
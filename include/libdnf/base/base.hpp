@@ -21,6 +21,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #define LIBDNF_BASE_BASE_HPP
 
 #include "libdnf/base/base_weak.hpp"
+#include "libdnf/base/metrics.hpp"
 #include "libdnf/common/impl_ptr.hpp"
 #include "libdnf/common/weak_ptr.hpp"
 #include "libdnf/comps/comps.hpp"
@@ -79,6 +80,10 @@ public:
     repo::RepoSackWeakPtr get_repo_sack() { return repo_sack.get_weak_ptr(); }
     rpm::PackageSackWeakPtr get_rpm_package_sack() { return rpm_package_sack.get_weak_ptr(); }
 
+    /// Gets timings of the work phases (loading repositories, resolving, running transaction, ...) and counters
+    /// (e.g. downloaded bytes) collected during the lifetime of the Base.
+    base::MetricsWeakPtr get_metrics() { return base::MetricsWeakPtr(&metrics, &metrics_guard); }
+
     /// Loads libdnf plugins, vars from environment, varsdirs and installroot (releasever, arch).
     /// To prevent differences between configuration and internal Base settings, following configurations
     /// will be locked: installroot, varsdir.
@@ -135,6 +140,7 @@ private:
     ImplPtr<Impl> p_impl;
 
     LogRouter log_router;
+    base::Metrics metrics;
     ConfigMain config;
     repo::RepoSack repo_sack;
     rpm::PackageSack rpm_package_sack;
@@ -147,6 +153,7 @@ private:
 
     WeakPtrGuard<LogRouter, false> log_router_gurad;
     WeakPtrGuard<Vars, false> vars_gurad;
+    WeakPtrGuard<base::Metrics, false> metrics_guard;
 };
 
 }  // namespace libdnf
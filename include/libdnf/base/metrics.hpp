@@ -0,0 +1,122 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF_BASE_METRICS_HPP
+#define LIBDNF_BASE_METRICS_HPP
+
+#include "libdnf/common/weak_ptr.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace libdnf::base {
+
+/// Measured phase of the work, e.g. loading of a repository or resolving of a goal.
+struct MetricsSpan {
+    /// Name of the phase. Names are dot separated, the first part is the area (e.g. "repo.load").
+    std::string name;
+    /// Optional detail distinguishing spans with the same name, e.g. id of the loaded repository.
+    std::string detail;
+    /// Index of the enclosing span (started earlier in the same thread) in `Metrics::get_spans()`, -1 if none.
+    int parent{-1};
+    /// Sequential number of the thread that measured the span, the first thread using the metrics gets 0.
+    unsigned thread{0};
+    /// Start of the span in microseconds since the metrics were created or cleared.
+    int64_t start_us{0};
+    /// Wall clock duration in microseconds.
+    int64_t wall_us{0};
+    /// CPU time consumed by the measuring thread in microseconds.
+    int64_t cpu_us{0};
+    /// Change of the process resident set size in KiB. Other threads contribute as well.
+    int64_t rss_delta_kb{0};
+    /// `false` if the span is still running, durations are not set then.
+    bool finished{false};
+};
+
+
+/// Collects timings of the work phases (spans) and named counters (e.g. downloaded bytes).
+/// Spans are recorded in the order they were started. All methods are thread safe.
+class Metrics {
+public:
+    /// Measures a span from its construction until `finish()` is called or the object is destroyed.
+    /// Spans started in the same thread while the span is running become its children.
+    class Span {
+    public:
+        Span(Metrics & metrics, const std::string & name, const std::string & detail = {});
+        ~Span();
+
+        Span(const Span &) = delete;
+        Span & operator=(const Span &) = delete;
+
+        /// Stops the measurement. Subsequent calls do nothing.
+        void finish();
+
+    private:
+        Metrics * metrics;
+        std::size_t index;
+        uint64_t generation;
+        std::chrono::steady_clock::time_point start;
+        int64_t cpu_start_us;
+        int64_t rss_start_kb;
+        bool running{true};
+    };
+
+    Metrics();
+    ~Metrics();
+
+    /// Adds `value` to the counter `name`. The counter is created if it does not exist.
+    void add_counter(const std::string & name, int64_t value);
+
+    /// @return The value of the counter `name`, 0 if the counter does not exist.
+    int64_t get_counter(const std::string & name) const;
+
+    /// @return All counters.
+    std::map<std::string, int64_t> get_counters() const;
+
+    /// @return Copy of all spans in the order they were started.
+    std::vector<MetricsSpan> get_spans() const;
+
+    /// @return Sum of wall clock durations of finished spans named `name` in microseconds.
+    int64_t get_total_wall_us(const std::string & name) const;
+
+    /// Removes all spans and counters. Running `Span` objects are not recorded when they finish.
+    void clear();
+
+    /// @return Spans and counters serialized as a JSON object `{"spans": [...], "counters": {...}}`.
+    std::string to_json() const;
+
+    /// @return Spans and counters in the Chrome trace event format (loadable by chrome://tracing or Perfetto).
+    std::string to_chrome_trace() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> p_impl;
+};
+
+
+using MetricsWeakPtr = WeakPtr<Metrics, false>;
+
+}  // namespace libdnf::base
+
+#endif  // LIBDNF_BASE_METRICS_HPP
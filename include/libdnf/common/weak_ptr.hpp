@@ -22,8 +22,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "exception.hpp"
 
+#include <atomic>
+#include <cstddef>
 #include <mutex>
-#include <unordered_set>
+#include <utility>
 
 
 namespace libdnf {
@@ -32,8 +34,26 @@ template <typename TPtr, bool ptr_owner>
 struct WeakPtr;
 
 
-/// WeakPtrGuard is a resource guard. WeakPtr instances register itself to the resource guard.
-/// And the resource guard invalidates the registered WeakPtrs when the resource is unusable
+/// Shared state of a WeakPtrGuard and the WeakPtrs created from it.
+/// The block is reference counted by the guard and by all valid WeakPtrs. Invalidation only clears
+/// the `alive` flag, the WeakPtrs release the block themselves, so copying and destroying a WeakPtr
+/// never needs to touch the guard.
+struct WeakPtrControlBlock {
+    std::atomic<bool> alive{true};
+    std::atomic<std::size_t> refs{1};  // the guard holds one reference
+
+    void add_ref() noexcept { refs.fetch_add(1, std::memory_order_relaxed); }
+
+    void release() noexcept {
+        if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+};
+
+
+/// WeakPtrGuard is a resource guard. WeakPtr instances created from the guard share its control block.
+/// And the resource guard invalidates the WeakPtrs when the resource is unusable
 /// (eg. its dependecny was released).
 /// Note on thread safety:
 /// Destroying the WeakPtrGuard while simultaneously using its WeakPtrs in another thread is not safe
@@ -43,54 +63,56 @@ struct WeakPtrGuard {
 public:
     using TWeakPtr = WeakPtr<TPtr, weak_ptr_is_owner>;
 
-    WeakPtrGuard() = default;
+    WeakPtrGuard() : block(new WeakPtrControlBlock) {}
     WeakPtrGuard(const WeakPtrGuard &) = delete;
     WeakPtrGuard(WeakPtrGuard && src) noexcept = delete;
-    ~WeakPtrGuard() { clear(); }
+    ~WeakPtrGuard() {
+        block->alive.store(false, std::memory_order_release);
+        block->release();
+    }
 
     WeakPtrGuard & operator=(const WeakPtrGuard & src) = delete;
     WeakPtrGuard & operator=(WeakPtrGuard && src) noexcept = delete;
 
     /// Returns true if the guard is empty, false otherwise.
-    bool empty() const noexcept {
-        std::lock_guard<std::mutex> guard(registered_weak_ptrs_mutex);
-        return registered_weak_ptrs.empty();
-    }
+    bool empty() const noexcept { return size() == 0; }
 
-    /// Returns the number of registered weak pointers.
+    /// Returns the number of valid weak pointers.
     size_t size() const noexcept {
-        std::lock_guard<std::mutex> guard(registered_weak_ptrs_mutex);
-        return registered_weak_ptrs.size();
+        std::lock_guard<std::mutex> guard(block_mutex);
+        return block->refs.load(std::memory_order_relaxed) - 1;
     }
 
-    /// Deregisters and invalidates all registered weak pointers. After this call, size() returns zero.
+    /// Invalidates all weak pointers. After this call, size() returns zero.
     void clear() noexcept {
-        std::lock_guard<std::mutex> guard(registered_weak_ptrs_mutex);
-        for (auto it : registered_weak_ptrs) {
-            it->invalidate_guard();
-        }
-        registered_weak_ptrs.clear();
+        auto * fresh_block = new WeakPtrControlBlock;
+        std::lock_guard<std::mutex> guard(block_mutex);
+        block->alive.store(false, std::memory_order_release);
+        block->release();
+        block = fresh_block;
     }
 
 private:
     friend TWeakPtr;
-    void register_ptr(TWeakPtr * weak_ptr) {
-        std::lock_guard<std::mutex> guard(registered_weak_ptrs_mutex);
-        registered_weak_ptrs.insert(weak_ptr);
-    }
-    void unregister_ptr(TWeakPtr * weak_ptr) noexcept {
-        std::lock_guard<std::mutex> guard(registered_weak_ptrs_mutex);
-        registered_weak_ptrs.erase(weak_ptr);
+
+    /// Returns the current control block with a reference added for the caller.
+    /// Only creating a WeakPtr from the guard locks the mutex, copies share the block of their source.
+    WeakPtrControlBlock * acquire_block() const noexcept {
+        std::lock_guard<std::mutex> guard(block_mutex);
+        block->add_ref();
+        return block;
     }
-    std::unordered_set<TWeakPtr *> registered_weak_ptrs;
-    mutable std::mutex registered_weak_ptrs_mutex;
+
+    WeakPtrControlBlock * block;
+    mutable std::mutex block_mutex;  // protects replacing `block` by clear()
 };
 
 
-/// WeakPtr is a "smart" pointer. It contains a pointer to resource and to guard of resource.
+/// WeakPtr is a "smart" pointer. It contains a pointer to resource and to the control block of the resource guard.
 /// WeakPtr pointer can be owner of the resource. However, the resource itself may depend on another resource.
-/// WeakPtr registers/unregisters itself at the guard of resource. And the resource guard invalidates
-/// the registered WeakPtrs when the resource is unusable (eg. its dependecny was released).
+/// WeakPtr holds a reference to the control block shared with the guard of resource. And the resource guard
+/// invalidates the WeakPtrs when the resource is unusable (eg. its dependecny was released).
+/// Copying and destroying a WeakPtr costs one atomic operation on the control block.
 /// Note on thread safety:
 /// It is safe to create, access and destroy WeakPtrs in multiple threads simultaneously.
 template <typename TPtr, bool ptr_owner>
@@ -98,43 +120,30 @@ struct WeakPtr {
 public:
     using TWeakPtrGuard = WeakPtrGuard<TPtr, ptr_owner>;
 
-    WeakPtr() : ptr(nullptr), guard(nullptr) {}
+    WeakPtr() : ptr(nullptr), block(nullptr) {}
 
-    WeakPtr(TPtr * ptr, TWeakPtrGuard * guard) : ptr(ptr), guard(guard) {
+    WeakPtr(TPtr * ptr, TWeakPtrGuard * guard) : ptr(ptr), block(nullptr) {
         libdnf_assert(guard != nullptr, "When initializing WeakPtr with a pointer, guard cannot be nullptr");
-        guard->register_ptr(this);
+        block = guard->acquire_block();
     }
 
     // TODO(jrohel): Want we to allow copying invalid WeakPtr?
-    WeakPtr(const WeakPtr & src) : guard(src.guard) {
+    WeakPtr(const WeakPtr & src) : ptr(nullptr), block(nullptr) {
         if constexpr (ptr_owner) {
             ptr = src.ptr ? new TPtr(*src.ptr) : nullptr;
         } else {
             ptr = src.ptr;
         }
-        if (is_valid()) {
-            guard->register_ptr(this);
-        }
+        // the reference is taken after the copy of the resource, a throwing copy must not leak it
+        block = src.acquire_block();
     }
 
     // TODO(jrohel): Want we to allow moving invalid WeakPtr?
     template <typename T = TPtr, typename std::enable_if<sizeof(T) && ptr_owner, int>::type = 0>
-    WeakPtr(WeakPtr && src) : guard(src.guard) {
-        if (src.is_valid()) {
-            src.guard->unregister_ptr(&src);
-        }
-        src.guard = nullptr;
-        ptr = src.ptr;
-        src.ptr = nullptr;
-        if (is_valid()) {
-            guard->register_ptr(this);
-        }
-    }
+    WeakPtr(WeakPtr && src) : ptr(std::exchange(src.ptr, nullptr)), block(std::exchange(src.block, nullptr)) {}
 
     ~WeakPtr() {
-        if (is_valid()) {
-            guard->unregister_ptr(this);
-        }
+        release_block();
         if constexpr (ptr_owner) {
             delete ptr;
         }
@@ -142,64 +151,33 @@ public:
 
     // TODO(jrohel): Want we to allow copying invalid WeakPtr?
     WeakPtr & operator=(const WeakPtr & src) {
-        if (guard == src.guard) {
-            if (this == &src) {
-                return *this;
-            }
-            if constexpr (ptr_owner) {
-                delete ptr;
-                ptr = src.ptr ? new TPtr(*src.ptr) : nullptr;
-            } else {
-                ptr = src.ptr;
-            }
+        if (this == &src) {
+            return *this;
+        }
+        if constexpr (ptr_owner) {
+            // copy the resource first, a throwing copy leaves this WeakPtr unchanged
+            auto * src_ptr = src.ptr ? new TPtr(*src.ptr) : nullptr;
+            delete ptr;
+            ptr = src_ptr;
         } else {
-            if (is_valid()) {
-                guard->unregister_ptr(this);
-            }
-            guard = src.guard;
-            if constexpr (ptr_owner) {
-                delete ptr;
-                ptr = src.ptr ? new TPtr(*src.ptr) : nullptr;
-            } else {
-                ptr = src.ptr;
-            }
-            if (is_valid()) {
-                guard->register_ptr(this);
-            }
+            ptr = src.ptr;
         }
+        auto * src_block = src.acquire_block();
+        release_block();
+        block = src_block;
         return *this;
     }
 
     // TODO(jrohel): Want we to allow moving invalid WeakPtr?
     template <typename T = TPtr, typename std::enable_if<sizeof(T) && ptr_owner, int>::type = 0>
     WeakPtr & operator=(WeakPtr && src) {
-        if (guard == src.guard) {
-            if (this == &src) {
-                return *this;
-            }
-            if (src.is_valid()) {
-                src.guard->unregister_ptr(&src);
-            }
-            src.guard = nullptr;
-            delete ptr;
-            ptr = src.ptr;
-            src.ptr = nullptr;
-        } else {
-            if (is_valid()) {
-                guard->unregister_ptr(this);
-            }
-            if (src.is_valid()) {
-                src.guard->unregister_ptr(&src);
-            }
-            guard = src.guard;
-            src.guard = nullptr;
-            delete ptr;
-            ptr = src.ptr;
-            src.ptr = nullptr;
-            if (is_valid()) {
-                guard->register_ptr(this);
-            }
+        if (this == &src) {
+            return *this;
         }
+        release_block();
+        block = std::exchange(src.block, nullptr);
+        delete ptr;
+        ptr = std::exchange(src.ptr, nullptr);
         return *this;
     }
 
@@ -216,10 +194,12 @@ public:
     }
 
     /// Checks if managed object is valid.
-    bool is_valid() const noexcept { return guard; }
+    bool is_valid() const noexcept { return block && block->alive.load(std::memory_order_acquire); }
 
     /// Checks if the other WeakPtr instance has the same WeakPtrGuard.
-    bool has_same_guard(const WeakPtr & other) const noexcept { return guard == other.guard; }
+    bool has_same_guard(const WeakPtr & other) const noexcept {
+        return (is_valid() ? block : nullptr) == (other.is_valid() ? other.block : nullptr);
+    }
 
     TPtr & operator*() const { return *get(); }
     bool operator==(const WeakPtr & other) const { return ptr == other.ptr; }
@@ -230,11 +210,25 @@ public:
     bool operator>=(const WeakPtr & other) const { return ptr >= other.ptr; }
 
 private:
-    friend TWeakPtrGuard;
-    void invalidate_guard() noexcept { guard = nullptr; }
+    /// Returns the control block with a reference added for the caller, nullptr if the WeakPtr is invalid.
+    WeakPtrControlBlock * acquire_block() const noexcept {
+        if (!is_valid()) {
+            return nullptr;
+        }
+        block->add_ref();
+        return block;
+    }
+
+    /// Drops the reference to the control block. An invalidated block is freed by its last WeakPtr.
+    void release_block() noexcept {
+        if (block) {
+            block->release();
+            block = nullptr;
+        }
+    }
 
     TPtr * ptr;
-    TWeakPtrGuard * guard;
+    WeakPtrControlBlock * block;
 };
 
 }  // namespace libdnf
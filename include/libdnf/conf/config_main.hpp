@@ -104,6 +104,8 @@ public:
 
     OptionStringList & tsflags();
     const OptionStringList & tsflags() const;
+    OptionEnum<std::string> & test_transaction();
+    const OptionEnum<std::string> & test_transaction() const;
     OptionBool & assumeyes();
     const OptionBool & assumeyes() const;
     OptionBool & assumeno();
@@ -128,6 +130,8 @@ public:
     const OptionBool & allow_vendor_change() const;
     OptionSeconds & metadata_timer_sync();
     const OptionSeconds & metadata_timer_sync() const;
+    OptionBool & prefetch_upgrades();
+    const OptionBool & prefetch_upgrades() const;
     OptionStringList & disable_excludes();
     const OptionStringList & disable_excludes() const;
     OptionEnum<std::string> & multilib_policy();  // :api
@@ -207,6 +211,12 @@ public:
     const OptionBool & protect_running_kernel() const;
     OptionBool & build_cache();
     const OptionBool & build_cache() const;
+    OptionBool & solver_cache();
+    const OptionBool & solver_cache() const;
+    OptionNumber<std::uint32_t> & download_mirrors();
+    const OptionNumber<std::uint32_t> & download_mirrors() const;
+    OptionNumber<std::uint32_t> & query_threads();
+    const OptionNumber<std::uint32_t> & query_threads() const;
 
     // Repo main config
     OptionNumber<std::uint32_t> & retries();
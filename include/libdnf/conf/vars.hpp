@@ -22,6 +22,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libdnf/base/base_weak.hpp"
 
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
@@ -61,7 +62,7 @@ public:
     /// @return The substituted text
     std::string substitute(const std::string & text) const;
 
-    const std::map<std::string, Variable> & get_variables() const { return variables; }
+    const std::map<std::string, Variable, std::less<>> & get_variables() const { return variables; }
 
     /// @brief Set particular variable to a value
     ///
@@ -120,7 +121,8 @@ private:
     void load_from_env();
 
     BaseWeakPtr base;
-    std::map<std::string, Variable> variables;
+    // the transparent comparator allows lookups by std::string_view without a temporary std::string
+    std::map<std::string, Variable, std::less<>> variables;
 };
 
 }  // namespace libdnf
@@ -33,6 +33,12 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf/rpm/package.hpp"
 
 #include <memory>
+#include <set>
+
+
+namespace libdnf::base {
+class SolverCache;
+}
 
 
 namespace libdnf::comps {
@@ -206,6 +212,12 @@ public:
     /// @replaces libdnf:repo/Repo.hpp:method:Repo.getMetadataPath(const std::string & metadataType)
     std::string get_metadata_path(const std::string & metadata_type);
 
+    /// Sets types of optional metadata that are downloaded in addition to the `optional_metadata_types`
+    /// configuration option, but are not loaded into the sacks. The files can be read on demand,
+    /// e.g. "other" by `libdnf::rpm::read_changelogs()`.
+    /// @param metadata_types metadata types (other, filelists, ...)
+    void set_download_only_metadata_types(const std::set<std::string> & metadata_types);
+
     /// Mark whatever is in the current cache expired.
     /// This repo instance will alway try to fetch a fresh metadata after this
     /// method is called.
@@ -347,10 +359,20 @@ private:
     friend class FileDownloader;
     friend class PackageDownloader;
     friend class solv::Pool;
+    friend class base::SolverCache;
 
     void make_solv_repo();
 
-    void load_available_repo();
+    /// Parses the primary metadata of the fetched available repository without accessing the shared pool.
+    /// Can run in parallel with the loading of other repositories.
+    /// @return The parsed metadata to pass to `load()`, or nullptr if the solv cache file is used instead.
+    std::shared_ptr<const std::string> parse_primary() const;
+
+    /// Same as `load()`, the primary metadata of an available repository are taken from `primary_solv`
+    /// returned by `parse_primary()` if it is not nullptr.
+    void load(const std::shared_ptr<const std::string> & primary_solv);
+
+    void load_available_repo(const std::shared_ptr<const std::string> & primary_solv);
     void load_system_repo();
 
     void internalize();
@@ -28,6 +28,15 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf/common/weak_ptr.hpp"
 #include "libdnf/logger/logger.hpp"
 
+#include <set>
+#include <string>
+
+
+namespace libdnf::base {
+
+class Transaction;
+
+}  // namespace libdnf::base
 
 namespace libdnf::repo {
 
@@ -93,6 +102,16 @@ public:
     std::map<std::string, libdnf::rpm::Package> add_cmdline_packages(
         const std::vector<std::string> & paths, bool calculate_checksum = false);
 
+    /// Updates the loaded system repository after `transaction` changed the rpmdb instead of reloading it.
+    ///
+    /// Only the packages of the transaction are re-read from the rpmdb: packages erased from the rpmdb
+    /// are removed from the repository and the newly installed headers are added. The removed packages,
+    /// including the outbound packages of the `transaction`, must not be used after the call.
+    /// Does nothing if the system repository is not loaded.
+    /// @param transaction The transaction that was run.
+    /// @since 5.0
+    void update_system_repo(const libdnf::base::Transaction & transaction);
+
     /// @return `true` if the system repository has been initialized (via `get_system_repo()`).
     bool has_system_repo() const noexcept { return system_repo; }
 
@@ -124,6 +143,17 @@ public:
     /// @param repos The repositories to update and load
     void update_and_load_repos(libdnf::repo::RepoQuery & repos);
 
+    /// Releases the memory of the loaded metadata of the `metadata_types` (the same values as in
+    /// the `optional_metadata_types` option) which are not going to be used. The released metadata
+    /// are loaded again from the solv cache files when they are accessed. Only the "filelists", "other"
+    /// and "presto" metadata parsed in this session and having a valid solv cache file are released,
+    /// the metadata loaded from the solv cache files are read on demand already. The estimated memory use
+    /// of the repositories and of their metadata keys is logged at the debug level.
+    ///
+    /// @param metadata_types The types of the metadata to release
+    /// @since 5.0
+    void release_metadata(const std::set<std::string> & metadata_types);
+
     RepoSackWeakPtr get_weak_ptr() { return RepoSackWeakPtr(this, &sack_guard); }
 
     /// @return The `Base` object to which this object belongs.
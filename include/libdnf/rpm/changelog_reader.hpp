@@ -0,0 +1,45 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF_RPM_CHANGELOG_READER_HPP
+#define LIBDNF_RPM_CHANGELOG_READER_HPP
+
+#include "package.hpp"
+#include "package_set.hpp"
+
+#include <map>
+#include <vector>
+
+
+namespace libdnf::rpm {
+
+/// Reads changelogs of the `packages`.
+///
+/// Changelogs of packages from available repositories whose "other" metadata are not loaded
+/// into the sack (see `optional_metadata_types` and `Repo::set_download_only_metadata_types()`) are read
+/// directly from the downloaded "other" metadata file. The file is streamed and only the entries of
+/// the `packages` are parsed, the reading of a repository stops once all its requested packages are found.
+/// Changelogs of other packages are taken from the sack, see `Package::get_changelogs()`.
+/// @return Changelogs of the packages in the order they are stored in the metadata.
+std::map<Package, std::vector<Changelog>> read_changelogs(const PackageSet & packages);
+
+}  // namespace libdnf::rpm
+
+#endif  // LIBDNF_RPM_CHANGELOG_READER_HPP
@@ -0,0 +1,90 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF_RPM_DEPENDENCY_CLOSURE_HPP
+#define LIBDNF_RPM_DEPENDENCY_CLOSURE_HPP
+
+#include "package.hpp"
+#include "package_set.hpp"
+
+#include <memory>
+#include <vector>
+
+
+namespace libdnf::rpm {
+
+struct DependencyClosureSettings {
+public:
+    /// Follow the regular and the pre-install requires
+    bool with_requires{true};
+    /// Follow the weak dependencies
+    bool with_recommends{false};
+    bool with_suggests{false};
+    bool with_supplements{false};
+    bool with_enhances{false};
+
+    /// Collect the packages that depend on the packages (e.g. `repoquery --whatrequires --recursive`)
+    /// instead of the packages they depend on
+    bool reverse{false};
+
+    /// Maximal distance of a package from the roots, 0 is unlimited
+    unsigned max_depth{0};
+};
+
+
+/// Computes the transitive dependency closure of packages.
+///
+/// The closure is expanded breadth-first, a dependency of a package is resolved to its providers
+/// by the libsolv whatprovides index. The reverse direction uses an index of the dependants built
+/// once per `DependencyClosure` object, the cost of a closure is then linear in the number of its
+/// dependency edges. Every package of the closure is reached from exactly one parent, the packages
+/// with their parents form a forest that can be printed as a tree (`repoquery --tree`).
+class DependencyClosure {
+public:
+    /// @param universe  Packages that can be part of the closure, dependencies are resolved only to them.
+    /// @param settings  The dependency kinds and the direction to follow.
+    DependencyClosure(const PackageSet & universe, const DependencyClosureSettings & settings);
+    ~DependencyClosure();
+
+    DependencyClosure(const DependencyClosure & src) = delete;
+    DependencyClosure & operator=(const DependencyClosure & src) = delete;
+    DependencyClosure(DependencyClosure && src) noexcept;
+    DependencyClosure & operator=(DependencyClosure && src) noexcept;
+
+    /// Computes the closure of `roots`. The roots are part of the closure even if they are not in the universe.
+    /// The previously computed closure is replaced.
+    /// @return All packages of the closure including the roots.
+    PackageSet compute(const PackageSet & roots);
+
+    /// @return The roots of the last computed closure.
+    std::vector<Package> get_roots() const;
+
+    /// @return Packages of the last computed closure that were reached through `package`, in the order
+    ///         of their ids. Empty if `package` is not part of the closure.
+    std::vector<Package> get_children(const Package & package) const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> p_impl;
+};
+
+}  // namespace libdnf::rpm
+
+#endif  // LIBDNF_RPM_DEPENDENCY_CLOSURE_HPP
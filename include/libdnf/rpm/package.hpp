@@ -22,12 +22,14 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #define LIBDNF_RPM_PACKAGE_HPP
 
 #include "checksum.hpp"
+#include "nevra.hpp"
 #include "reldep_list.hpp"
 
 #include "libdnf/repo/repo_weak.hpp"
 #include "libdnf/transaction/transaction_item_reason.hpp"
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 
@@ -239,6 +241,66 @@ public:
     // @replaces libdnf:libdnf/hy-package.h:function:dnf_package_get_description(DnfPackage * pkg)
     std::string get_description() const;
 
+    // NON-ALLOCATING ACCESSORS
+    //
+    // The returned views point to strings stored in the package pool. They are valid until the pool changes
+    // (repositories are loaded or removed). The views of name, arch and evr are null-terminated.
+    // The summary, URL and license are looked up in the repodata, which libsolv can page or load lazily,
+    // so their views are valid only until the next attribute lookup of any package. Copy them to keep them.
+    // There is no view of the description, libsolv keeps it in paged storage and the page can be reused.
+
+    /// @return RPM package Name (`RPMTAG_NAME`) without copying it from the pool.
+    /// @since 5.0
+    std::string_view get_name_view() const;
+
+    /// @return RPM package Epoch (`RPMTAG_EPOCH`) without copying it from the pool, "0" if the package has no epoch.
+    /// @since 5.0
+    std::string_view get_epoch_view() const;
+
+    /// @return RPM package Version (`RPMTAG_VERSION`) without copying it from the pool.
+    /// @since 5.0
+    std::string_view get_version_view() const;
+
+    /// @return RPM package Release (`RPMTAG_RELEASE`) without copying it from the pool.
+    /// @since 5.0
+    std::string_view get_release_view() const;
+
+    /// @return RPM package Arch (`RPMTAG_ARCH`) without copying it from the pool.
+    /// @since 5.0
+    std::string_view get_arch_view() const;
+
+    /// @return RPM package EVR (Epoch:Version-Release) without copying it from the pool.
+    /// @since 5.0
+    std::string_view get_evr_view() const;
+
+    /// @return Id of the repository the package belongs to without copying it.
+    /// @since 5.0
+    std::string_view get_repo_id_view() const;
+
+    /// @return RPM package Summary (`RPMTAG_SUMMARY`) without copying it from the pool.
+    ///         Valid only until the next attribute lookup.
+    /// @since 5.0
+    std::string_view get_summary_view() const;
+
+    /// @return RPM package URL (`RPMTAG_URL`) without copying it from the pool.
+    ///         Valid only until the next attribute lookup.
+    /// @since 5.0
+    std::string_view get_url_view() const;
+
+    /// @return RPM package License (`RPMTAG_LICENSE`) without copying it from the pool.
+    ///         Valid only until the next attribute lookup.
+    /// @since 5.0
+    std::string_view get_license_view() const;
+
+    /// Appends RPM package NEVRA (the same as `get_nevra()`) to `buffer`.
+    /// Reusing one buffer for many packages avoids allocating a new string for each of them.
+    /// @since 5.0
+    void append_nevra(std::string & buffer) const;
+
+    /// Appends RPM package NEVRA with the Epoch always present (the same as `get_full_nevra()`) to `buffer`.
+    /// @since 5.0
+    void append_full_nevra(std::string & buffer) const;
+
     // DEPENDENCIES
 
     /// @return List of RPM package Provides (`RPMTAG_PROVIDENAME`, `RPMTAG_PROVIDEFLAGS`, `RPMTAG_PROVIDEVERSION`).
@@ -473,6 +535,8 @@ protected:
 
 private:
     friend class PackageSetIterator;
+    friend class DependencyClosure;
+    friend class PackageFormatter;
     friend class PackageSack;
     friend class libdnf::repo::Repo;
     friend class libdnf::Goal;
@@ -499,6 +563,17 @@ inline bool Package::operator!=(const Package & other) const noexcept {
     return id != other.id || base != other.base;
 }
 
+#ifndef SWIG
+
+/// Specializations of the NEVRA comparators comparing the pool strings without copying them.
+template <>
+bool cmp_nevra<Package>(const Package & lhs, const Package & rhs);
+
+template <>
+bool cmp_naevr<Package>(const Package & lhs, const Package & rhs);
+
+#endif
+
 }  // namespace libdnf::rpm
 
 #endif  // LIBDNF_RPM_PACKAGE_HPP
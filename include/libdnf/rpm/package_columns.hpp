@@ -0,0 +1,102 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF_RPM_PACKAGE_COLUMNS_HPP
+#define LIBDNF_RPM_PACKAGE_COLUMNS_HPP
+
+#include "package_set.hpp"
+
+#include "libdnf/common/exception.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace libdnf::rpm {
+
+class PackageColumnsError : public Error {
+public:
+    using Error::Error;
+    const char * get_domain_name() const noexcept override { return "libdnf::rpm"; }
+    const char * get_name() const noexcept override { return "PackageColumnsError"; }
+};
+
+
+/// Attributes of all packages of a package set exported column by column.
+///
+/// A string attribute is stored as a table of its distinct values and an index into the table for each
+/// package. A number attribute is stored as an array with a value for each package. The packages are
+/// in the order of their ids, `get_ids()` returns the ids. The whole set is read by the constructor,
+/// so the language bindings get all the packages in one call instead of creating a Package object
+/// and calling a getter for each package and attribute.
+/// The attribute names are the same as the tags of PackageFormatter, see `get_string_attributes()`
+/// and `get_number_attributes()`.
+class PackageColumns {
+public:
+    /// Reads `attributes` of all `packages`.
+    /// @throw PackageColumnsError if an attribute is unknown
+    PackageColumns(const PackageSet & packages, const std::vector<std::string> & attributes);
+    ~PackageColumns();
+
+    PackageColumns(const PackageColumns & src);
+    PackageColumns(PackageColumns && src) noexcept;
+    PackageColumns & operator=(const PackageColumns & src);
+    PackageColumns & operator=(PackageColumns && src) noexcept;
+
+    /// @return The number of packages.
+    std::size_t size() const noexcept;
+
+    /// @return The exported attributes in the order they were requested.
+    const std::vector<std::string> & get_attributes() const noexcept;
+
+    /// @return The ids of the packages, `PackageId(ids[i])` is the package in row `i`.
+    const std::vector<int> & get_ids() const noexcept;
+
+    /// @return `true` if `attribute` is exported as numbers, `false` if as strings.
+    /// @throw PackageColumnsError if `attribute` was not exported
+    bool is_number(const std::string & attribute) const;
+
+    /// @return The distinct values of the string `attribute`, in the order of their first occurrence.
+    /// @throw PackageColumnsError if `attribute` was not exported or is not a string attribute
+    const std::vector<std::string> & get_strings(const std::string & attribute) const;
+
+    /// @return Index into `get_strings(attribute)` for each package.
+    /// @throw PackageColumnsError if `attribute` was not exported or is not a string attribute
+    const std::vector<uint32_t> & get_string_indexes(const std::string & attribute) const;
+
+    /// @return The value of the number `attribute` for each package.
+    /// @throw PackageColumnsError if `attribute` was not exported or is not a number attribute
+    const std::vector<uint64_t> & get_numbers(const std::string & attribute) const;
+
+    /// @return The names of the supported string attributes.
+    static std::vector<std::string> get_string_attributes();
+
+    /// @return The names of the supported number attributes.
+    static std::vector<std::string> get_number_attributes();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> p_impl;
+};
+
+}  // namespace libdnf::rpm
+
+#endif  // LIBDNF_RPM_PACKAGE_COLUMNS_HPP
@@ -0,0 +1,82 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF_RPM_PACKAGE_FORMATTER_HPP
+#define LIBDNF_RPM_PACKAGE_FORMATTER_HPP
+
+#include "package.hpp"
+#include "package_set.hpp"
+
+#include "libdnf/common/exception.hpp"
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace libdnf::rpm {
+
+class PackageFormatterError : public Error {
+public:
+    using Error::Error;
+    const char * get_domain_name() const noexcept override { return "libdnf::rpm"; }
+    const char * get_name() const noexcept override { return "PackageFormatterError"; }
+};
+
+
+/// Formats packages according to a query format string, e.g. "%{name}-%{evr}.%{arch} %{repoid}\n".
+///
+/// The format consists of literal text and tags in the form of `%{tag}`, optionally with a field width
+/// `%20{tag}` (right aligned) or `%-20{tag}` (left aligned) of at most 4096. `%%` is a literal percent sign, `\n`, `\t`
+/// and `\\` are replaced by a newline, a tab and a backslash. The format is compiled once by the constructor,
+/// formatting then reads the package attributes directly from the package pool into the output buffer.
+class PackageFormatter {
+public:
+    /// Compiles the query format.
+    /// @throw PackageFormatterError if the format is malformed, contains an unknown tag or a too wide field
+    explicit PackageFormatter(const std::string & format);
+    ~PackageFormatter();
+
+    PackageFormatter(const PackageFormatter & src);
+    PackageFormatter(PackageFormatter && src) noexcept;
+    PackageFormatter & operator=(const PackageFormatter & src);
+    PackageFormatter & operator=(PackageFormatter && src) noexcept;
+
+    /// Appends the formatted `package` to `output`.
+    void format(const Package & package, std::string & output) const;
+
+    /// @return The formatted `package`.
+    std::string format(const Package & package) const;
+
+    /// Writes the formatted `packages` to `output` in the order of their ids.
+    /// The output is buffered, it is written in large blocks.
+    void format(const PackageSet & packages, std::ostream & output) const;
+
+    /// @return The names of the supported tags.
+    static std::vector<std::string> get_tags();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> p_impl;
+};
+
+}  // namespace libdnf::rpm
+
+#endif  // LIBDNF_RPM_PACKAGE_FORMATTER_HPP
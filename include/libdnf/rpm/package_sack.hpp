@@ -60,8 +60,15 @@ class ModuleSack;
 
 }  // namespace libdnf::module
 
+namespace libdnf::repo {
+
+class RepoSack;
+
+}  // namespace libdnf::repo
+
 namespace libdnf::rpm::solv {
 
+class GoalPrivate;
 class SolvPrivate;
 
 }  // namespace libdnf::rpm::solv
@@ -154,9 +161,11 @@ private:
     friend Reldep;
     friend class ReldepList;
     friend class repo::Repo;
+    friend class repo::RepoSack;
     friend class PackageQuery;
     friend class Transaction;
     friend libdnf::Swdb;
+    friend solv::GoalPrivate;
     friend solv::SolvPrivate;
     friend libdnf::advisory::Advisory;
     friend libdnf::advisory::AdvisorySack;
@@ -154,6 +154,9 @@ public:
 
 private:
     friend PackageSetIterator;
+    friend class DependencyClosure;
+    friend class PackageColumns;
+    friend class PackageFormatter;
     friend class PackageQuery;
     friend class PackageSack;
     friend class Transaction;
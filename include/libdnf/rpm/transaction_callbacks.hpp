@@ -24,6 +24,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf/rpm/nevra.hpp"
 
 #include <cstdint>
+#include <string>
+#include <string_view>
 
 namespace libdnf::base {
 
@@ -83,6 +85,13 @@ public:
     virtual void script_error(const TransactionItem * item, Nevra nevra, ScriptType type, uint64_t return_code) {}
     virtual void script_start(const TransactionItem * item, Nevra nevra, ScriptType type) {}
     virtual void script_stop(const TransactionItem * item, Nevra nevra, ScriptType type, uint64_t return_code) {}
+    /// Output of a running scriptlet, called between `script_start()` and `script_stop()` for every batch
+    /// of lines the scriptlet wrote. It is called from the thread reading the scriptlet output, the rest
+    /// of the output from the thread running the transaction before `script_stop()`. The calls are serialized
+    /// with each other, but not with the other callbacks, they can run concurrently. Implementations must
+    /// synchronize the state they share with the other callbacks, e.g. a progress bar being printed.
+    /// @param output  lines written by the scriptlet to stdout and stderr, valid only during the call
+    virtual void script_output(const TransactionItem * item, Nevra nevra, ScriptType type, std::string_view output) {}
     virtual void elem_progress(const TransactionItem & item, uint64_t amount, uint64_t total) {}
     virtual void verify_progress(uint64_t amount, uint64_t total) {}
     virtual void verify_start(uint64_t total) {}
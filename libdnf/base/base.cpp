@@ -50,9 +50,12 @@ Base::Base(std::vector<std::unique_ptr<Logger>> && loggers)
     load_defaults();
 }
 
-Base::~Base() = default;
+Base::~Base() {
+    // The writer logs failures, finish the writes before the logger is destroyed
+    p_impl->solv_cache_writer.flush();
+}
 
-Base::Impl::Impl(const libdnf::BaseWeakPtr & base) : rpm_advisory_sack(base), plugins(*base) {}
+Base::Impl::Impl(const libdnf::BaseWeakPtr & base) : rpm_advisory_sack(base), plugins(*base), solv_cache_writer(base) {}
 
 void Base::lock() {
     locked_base_mutex.lock();
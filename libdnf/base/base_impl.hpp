@@ -23,6 +23,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "../advisory/advisory_sack.hpp"
 #include "plugin/plugins.hpp"
+#include "repo/solv_cache_writer.hpp"
 #include "system/state.hpp"
 
 #include "libdnf/base/base.hpp"
@@ -56,6 +57,8 @@ public:
 
     plugin::Plugins & get_plugins() { return plugins; }
 
+    repo::SolvCacheWriter & get_solv_cache_writer() { return solv_cache_writer; }
+
 private:
     friend class Base;
     Impl(const libdnf::BaseWeakPtr & base);
@@ -77,6 +80,9 @@ private:
     libdnf::advisory::AdvisorySack rpm_advisory_sack;
 
     plugin::Plugins plugins;
+
+    // Writes the solv cache files in the background. Flushed by ~Base() while the logger is still alive.
+    repo::SolvCacheWriter solv_cache_writer;
 };
 
 
@@ -27,6 +27,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "rpm/solv/goal_private.hpp"
 #include "solv/id_queue.hpp"
 #include "solv/pool.hpp"
+#include "solver_cache.hpp"
 #include "transaction_impl.hpp"
 #include "utils/bgettext/bgettext-mark-domain.h"
 #include "utils/string.hpp"
@@ -37,10 +38,14 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf/rpm/package_query.hpp"
 #include "libdnf/rpm/reldep.hpp"
 #include "libdnf/utils/patterns.hpp"
+#include "libdnf/utils/to_underlying.hpp"
 
 #include <filesystem>
 #include <iostream>
 #include <map>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 namespace {
 
@@ -58,6 +63,43 @@ namespace libdnf {
 
 namespace {
 
+// Minimal number of install (remove) specs in a goal for which the Goal::Impl::SpecIndex is built.
+// For a few specs resolving them one by one is cheaper than building the index.
+constexpr std::size_t SPEC_INDEX_MIN_SPECS = 8;
+
+
+// Adds the job settings to the solver cache key.
+// Returns false for settings that cannot be identified, the goal is not cached then.
+bool add_settings_to_key(base::SolverCacheKey & key, const GoalJobSettings & settings) {
+    if (settings.advisory_filter) {
+        return false;
+    }
+    key.add(settings.ignore_case);
+    key.add(settings.with_nevra);
+    key.add(settings.with_provides);
+    key.add(settings.with_filenames);
+    key.add(static_cast<int64_t>(settings.nevra_forms.size()));
+    for (auto form : settings.nevra_forms) {
+        key.add(utils::to_underlying(form));
+    }
+    key.add(settings.group_with_id);
+    key.add(settings.group_with_name);
+    key.add(settings.report_hint);
+    key.add(utils::to_underlying(settings.strict));
+    key.add(utils::to_underlying(settings.best));
+    key.add(utils::to_underlying(settings.clean_requirements_on_remove));
+    for (const auto * repo_ids : {&settings.from_repo_ids, &settings.to_repo_ids}) {
+        key.add(static_cast<int64_t>(repo_ids->size()));
+        for (const auto & repo_id : *repo_ids) {
+            key.add(repo_id);
+        }
+    }
+    key.add(
+        settings.group_package_types ? static_cast<int64_t>(utils::to_underlying(*settings.group_package_types)) : -1);
+    return true;
+}
+
+
 inline bool name_arch_compare_lower_solvable(const Solvable * first, const Solvable * second) {
     if (first->name != second->name) {
         return first->name < second->name;
@@ -80,12 +122,49 @@ public:
     GoalProblem add_group_specs_to_goal(base::Transaction & transaction);
     GoalProblem add_reason_change_specs_to_goal(base::Transaction & transaction);
 
+    /// Index of package names used to resolve plain name and NEVRA specs of a long list of specs.
+    ///
+    /// `PackageQuery::resolve_pkg_spec()` works with maps of the size of the whole pool and every spec
+    /// needs its own copy of the query, resolving thousands of specs one by one is O(specs * pool).
+    /// The index is built in a single pass over the packages of a query and shared by all specs,
+    /// resolving a spec then costs only the packages of the matching names.
+    class SpecIndex {
+    public:
+        explicit SpecIndex(const rpm::PackageQuery & packages);
+
+        /// Resolves `spec` the same way as `resolve_pkg_spec(spec, settings, false)` on a copy of the indexed query.
+        /// @return The matching NEVRA with the matching packages in `result`, or an empty optional if the spec
+        ///         is not a plain name or NEVRA or does not match any indexed package. The spec has to be resolved
+        ///         by `resolve_pkg_spec()` then, it also looks at provides and files.
+        std::optional<rpm::Nevra> resolve(
+            const std::string & spec, const ResolveSpecSettings & settings, rpm::PackageQuery & result) const;
+
+    private:
+        BaseWeakPtr base;
+        std::unordered_map<Id, std::vector<Id>> name_to_ids;
+    };
+
     std::pair<GoalProblem, libdnf::solv::IdQueue> add_install_to_goal(
         base::Transaction & transaction, GoalAction action, const std::string & spec, GoalJobSettings & settings);
+    /// Variant sharing the `base_query` and optionally the `spec_index` of it among a batch of specs.
+    std::pair<GoalProblem, libdnf::solv::IdQueue> add_install_to_goal(
+        base::Transaction & transaction,
+        GoalAction action,
+        const std::string & spec,
+        GoalJobSettings & settings,
+        const rpm::PackageQuery & base_query,
+        const SpecIndex * spec_index);
     void add_provide_install_to_goal(const std::string & spec, GoalJobSettings & settings);
     GoalProblem add_reinstall_to_goal(
         base::Transaction & transaction, const std::string & spec, GoalJobSettings & settings);
     void add_remove_to_goal(base::Transaction & transaction, const std::string & spec, GoalJobSettings & settings);
+    /// Variant sharing the query of `installed` packages and optionally the `spec_index` of it among a batch of specs.
+    void add_remove_to_goal(
+        base::Transaction & transaction,
+        const std::string & spec,
+        GoalJobSettings & settings,
+        const rpm::PackageQuery & installed,
+        const SpecIndex * spec_index);
     void add_up_down_distrosync_to_goal(
         base::Transaction & transaction,
         GoalAction action,
@@ -122,6 +201,10 @@ public:
     /// files are stored for being later downloaded and added to command line repo.
     void add_spec(GoalAction action, const std::string & spec, const GoalJobSettings & settings);
 
+    /// Adds the goal (specs, packages and settings) to the solver cache key.
+    /// @return `false` if the goal cannot be cached, e.g. it contains groups or local rpm files.
+    bool add_to_solver_cache_key(base::SolverCacheKey & key);
+
     /// Add all (remote or local) rpm paths to the goal.
     /// Remote URLs are first downloaded and all the paths are inserted into
     /// cmdline repo.
@@ -414,11 +497,40 @@ GoalProblem Goal::Impl::add_specs_to_goal(base::Transaction & transaction) {
     auto sack = base->get_rpm_package_sack();
     auto & cfg_main = base->get_config();
     auto ret = GoalProblem::NO_PROBLEM;
+
+    // The pool does not change while the specs are added, the queries (and for long lists of specs
+    // the indexes of their package names) are computed once and shared by all specs.
+    std::size_t install_specs_count = 0;
+    std::size_t remove_specs_count = 0;
+    for (const auto & [action, spec, settings] : rpm_specs) {
+        if (action == GoalAction::INSTALL || action == GoalAction::INSTALL_BY_GROUP) {
+            ++install_specs_count;
+        } else if (action == GoalAction::REMOVE) {
+            ++remove_specs_count;
+        }
+    }
+    std::optional<rpm::PackageQuery> install_query;
+    std::optional<SpecIndex> install_spec_index;
+    std::optional<rpm::PackageQuery> remove_query;
+    std::optional<SpecIndex> remove_spec_index;
+
     for (auto & [action, spec, settings] : rpm_specs) {
         switch (action) {
             case GoalAction::INSTALL:
             case GoalAction::INSTALL_BY_GROUP: {
-                auto [problem, idqueue] = add_install_to_goal(transaction, action, spec, settings);
+                if (!install_query) {
+                    install_query.emplace(base);
+                    if (install_specs_count >= SPEC_INDEX_MIN_SPECS) {
+                        install_spec_index.emplace(*install_query);
+                    }
+                }
+                auto [problem, idqueue] = add_install_to_goal(
+                    transaction,
+                    action,
+                    spec,
+                    settings,
+                    *install_query,
+                    install_spec_index ? &*install_spec_index : nullptr);
                 rpm_goal.add_transaction_user_installed(idqueue);
                 ret |= problem;
             } break;
@@ -429,7 +541,15 @@ GoalProblem Goal::Impl::add_specs_to_goal(base::Transaction & transaction) {
                 ret |= add_reinstall_to_goal(transaction, spec, settings);
                 break;
             case GoalAction::REMOVE:
-                add_remove_to_goal(transaction, spec, settings);
+                if (!remove_query) {
+                    remove_query.emplace(base);
+                    remove_query->filter_installed();
+                    if (remove_specs_count >= SPEC_INDEX_MIN_SPECS) {
+                        remove_spec_index.emplace(*remove_query);
+                    }
+                }
+                add_remove_to_goal(
+                    transaction, spec, settings, *remove_query, remove_spec_index ? &*remove_spec_index : nullptr);
                 break;
             case GoalAction::DISTRO_SYNC:
             case GoalAction::DOWNGRADE:
@@ -554,8 +674,71 @@ GoalProblem Goal::Impl::add_reason_change_specs_to_goal(base::Transaction & tran
     return ret;
 }
 
+Goal::Impl::SpecIndex::SpecIndex(const rpm::PackageQuery & packages) : base(packages.get_base()) {
+    auto & pool = get_rpm_pool(base);
+    for (auto package_id : *packages.p_impl) {
+        name_to_ids[pool.id2solvable(package_id)->name].push_back(package_id);
+    }
+}
+
+std::optional<rpm::Nevra> Goal::Impl::SpecIndex::resolve(
+    const std::string & spec, const ResolveSpecSettings & settings, rpm::PackageQuery & result) const {
+    if (!settings.with_nevra || !settings.nevra_forms.empty() || settings.ignore_case ||
+        utils::is_glob_pattern(spec.c_str())) {
+        return std::nullopt;
+    }
+
+    std::vector<rpm::Nevra> nevras;
+    try {
+        nevras = rpm::Nevra::parse(spec, rpm::Nevra::get_default_pkg_spec_forms());
+    } catch (const rpm::NevraIncorrectInputError &) {
+        return std::nullopt;
+    }
+
+    // Mirrors the exact match of PackageQuery::PQImpl::filter_nevra() without source packages
+    auto & pool = get_rpm_pool(base);
+    const Id src_arch = pool.str2id("src", false);
+    for (auto & nevra : nevras) {
+        if (nevra.get_name().empty()) {
+            return std::nullopt;
+        }
+        auto it = name_to_ids.find(pool.str2id(nevra.get_name().c_str(), false));
+        if (it == name_to_ids.end()) {
+            continue;
+        }
+        const auto & epoch = nevra.get_epoch();
+        const auto & version = nevra.get_version();
+        const auto & release = nevra.get_release();
+        const auto & arch = nevra.get_arch();
+        for (auto package_id : it->second) {
+            if ((src_arch != 0 && pool.id2solvable(package_id)->arch == src_arch) ||
+                (!arch.empty() && arch != pool.get_arch(package_id)) ||
+                (!epoch.empty() && epoch != pool.get_epoch(package_id)) ||
+                (!version.empty() && version != pool.get_version(package_id)) ||
+                (!release.empty() && release != pool.get_release(package_id))) {
+                continue;
+            }
+            result.p_impl->add_unsafe(package_id);
+        }
+        if (!result.empty()) {
+            return nevra;
+        }
+    }
+    return std::nullopt;
+}
+
 std::pair<GoalProblem, libdnf::solv::IdQueue> Goal::Impl::add_install_to_goal(
     base::Transaction & transaction, GoalAction action, const std::string & spec, GoalJobSettings & settings) {
+    return add_install_to_goal(transaction, action, spec, settings, rpm::PackageQuery(base), nullptr);
+}
+
+std::pair<GoalProblem, libdnf::solv::IdQueue> Goal::Impl::add_install_to_goal(
+    base::Transaction & transaction,
+    GoalAction action,
+    const std::string & spec,
+    GoalJobSettings & settings,
+    const rpm::PackageQuery & base_query,
+    const SpecIndex * spec_index) {
     auto sack = base->get_rpm_package_sack();
     auto & pool = get_rpm_pool(base);
     auto & cfg_main = base->get_config();
@@ -565,10 +748,19 @@ std::pair<GoalProblem, libdnf::solv::IdQueue> Goal::Impl::add_install_to_goal(
 
     auto multilib_policy = cfg_main.multilib_policy().get_value();
     libdnf::solv::IdQueue result_queue;
-    rpm::PackageQuery base_query(base);
 
-    rpm::PackageQuery query(base_query);
-    auto nevra_pair = query.resolve_pkg_spec(spec, settings, false);
+    rpm::PackageQuery query(base, rpm::PackageQuery::ExcludeFlags::APPLY_EXCLUDES, true);
+    std::pair<bool, rpm::Nevra> nevra_pair;
+    std::optional<rpm::Nevra> indexed_nevra;
+    if (spec_index) {
+        indexed_nevra = spec_index->resolve(spec, settings, query);
+    }
+    if (indexed_nevra) {
+        nevra_pair = {true, std::move(*indexed_nevra)};
+    } else {
+        query = base_query;
+        nevra_pair = query.resolve_pkg_spec(spec, settings, false);
+    }
     if (!nevra_pair.first) {
         auto problem = transaction.p_impl->report_not_found(action, spec, settings, strict);
         if (strict) {
@@ -1148,12 +1340,26 @@ void Goal::Impl::add_rpms_to_goal(base::Transaction & transaction) {
 
 void Goal::Impl::add_remove_to_goal(
     base::Transaction & transaction, const std::string & spec, GoalJobSettings & settings) {
+    rpm::PackageQuery installed(base);
+    installed.filter_installed();
+    add_remove_to_goal(transaction, spec, settings, installed, nullptr);
+}
+
+void Goal::Impl::add_remove_to_goal(
+    base::Transaction & transaction,
+    const std::string & spec,
+    GoalJobSettings & settings,
+    const rpm::PackageQuery & installed,
+    const SpecIndex * spec_index) {
     bool clean_requirements_on_remove = settings.resolve_clean_requirements_on_remove(base->get_config());
-    rpm::PackageQuery query(base);
-    query.filter_installed();
 
-    auto nevra_pair = query.resolve_pkg_spec(spec, settings, false);
-    if (!nevra_pair.first) {
+    rpm::PackageQuery query(base, rpm::PackageQuery::ExcludeFlags::APPLY_EXCLUDES, true);
+    bool found = spec_index && spec_index->resolve(spec, settings, query);
+    if (!found) {
+        query = installed;
+        found = query.resolve_pkg_spec(spec, settings, false).first;
+    }
+    if (!found) {
         transaction.p_impl->report_not_found(GoalAction::REMOVE, spec, settings, false);
         return;
     }
@@ -1531,7 +1737,58 @@ bool Goal::get_allow_erasing() const {
     return p_impl->allow_erasing;
 }
 
+bool Goal::Impl::add_to_solver_cache_key(base::SolverCacheKey & key) {
+    // Groups need the comps objects, local files the command line repository. Neither is cached.
+    if (!group_specs.empty() || !rpm_filepaths.empty()) {
+        return false;
+    }
+
+    key.add(allow_erasing);
+    key.add(static_cast<int64_t>(module_enable_specs.size()));
+    for (const auto & spec : module_enable_specs) {
+        key.add(spec);
+    }
+    key.add(static_cast<int64_t>(rpm_specs.size()));
+    for (const auto & [action, spec, settings] : rpm_specs) {
+        key.add(utils::to_underlying(action));
+        key.add(spec);
+        if (!add_settings_to_key(key, settings)) {
+            return false;
+        }
+    }
+    key.add(static_cast<int64_t>(rpm_reason_change_specs.size()));
+    for (const auto & [reason, spec, group_id, settings] : rpm_reason_change_specs) {
+        key.add(utils::to_underlying(reason));
+        key.add(spec);
+        key.add(group_id.value_or(""));
+        if (!add_settings_to_key(key, settings)) {
+            return false;
+        }
+    }
+    // Package ids are covered by the state of the pool, see `SolverCache::add_state()`.
+    key.add(static_cast<int64_t>(rpm_ids.size()));
+    for (const auto & [action, ids, settings] : rpm_ids) {
+        key.add(utils::to_underlying(action));
+        key.add(static_cast<int64_t>(ids.size()));
+        for (auto id : ids) {
+            key.add(id);
+        }
+        if (!add_settings_to_key(key, settings)) {
+            return false;
+        }
+    }
+
+    auto & cfg_main = base->get_config();
+    if (cfg_main.protect_running_kernel().get_value()) {
+        key.add(base->get_rpm_package_sack()->p_impl->get_running_kernel_id().id);
+    }
+    return true;
+}
+
 base::Transaction Goal::resolve() {
+    auto & metrics = *p_impl->base->get_metrics();
+    base::Metrics::Span resolve_span(metrics, "goal.resolve");
+
     p_impl->rpm_goal = rpm::solv::GoalPrivate(p_impl->base);
 
     p_impl->add_paths_to_goal();
@@ -1541,18 +1798,38 @@ base::Transaction Goal::resolve() {
     auto ret = GoalProblem::NO_PROBLEM;
 
     sack->p_impl->recompute_considered_in_pool();
+
+    auto & cfg_main = p_impl->base->get_config();
+    std::optional<base::SolverCache> solver_cache;
+    std::string solver_cache_digest;
+    // The solver debug data are written only by a resolve which runs the solver
+    if (cfg_main.solver_cache().get_value() && !cfg_main.debug_solver().get_value()) {
+        base::SolverCacheKey key;
+        if (p_impl->add_to_solver_cache_key(key) && base::SolverCache(p_impl->base).add_state(key)) {
+            solver_cache.emplace(p_impl->base);
+            solver_cache_digest = key.get_digest();
+            auto items = solver_cache->load(solver_cache_digest);
+            if (items && transaction.p_impl->set_transaction(*items)) {
+                metrics.add_counter("goal.solver_cache_hits", 1);
+                return transaction;
+            }
+            metrics.add_counter("goal.solver_cache_misses", 1);
+        }
+    }
+
     sack->p_impl->make_provides_ready();
     // TODO(jmracek) Apply modules first
     // TODO(jmracek) Apply comps second or later
     // TODO(jmracek) Reset rpm_goal, setup rpm-goal flags according to conf, (allow downgrade), obsoletes, vendor, ...
+    base::Metrics::Span specs_span(metrics, "goal.add_specs");
     ret |= p_impl->add_specs_to_goal(transaction);
     p_impl->add_rpms_to_goal(transaction);
 
     ret |= p_impl->add_group_specs_to_goal(transaction);
 
     ret |= p_impl->add_reason_change_specs_to_goal(transaction);
+    specs_span.finish();
 
-    auto & cfg_main = p_impl->base->get_config();
     // Set goal flags
     p_impl->rpm_goal.set_allow_vendor_change(cfg_main.allow_vendor_change().get_value());
     p_impl->rpm_goal.set_allow_erasing(p_impl->allow_erasing);
@@ -1591,7 +1868,10 @@ base::Transaction Goal::resolve() {
         p_impl->rpm_goal.set_installonly_limit(cfg_main.installonly_limit().get_value());
     }
 
-    ret |= p_impl->rpm_goal.resolve();
+    {
+        base::Metrics::Span solve_span(metrics, "goal.solve");
+        ret |= p_impl->rpm_goal.resolve();
+    }
 
     // Write debug solver data
     if (cfg_main.debug_solver().get_value()) {
@@ -1615,6 +1895,12 @@ base::Transaction Goal::resolve() {
 
     transaction.p_impl->set_transaction(p_impl->rpm_goal, ret);
 
+    // Only clean results are cached, the resolve logs and problems refer to the goal's jobs.
+    if (solver_cache && transaction.p_impl->problems == GoalProblem::NO_PROBLEM &&
+        transaction.p_impl->resolve_logs.empty() && transaction.p_impl->groups.empty()) {
+        solver_cache->store(solver_cache_digest, transaction.p_impl->get_solver_cache_items());
+    }
+
     return transaction;
 }
 
@@ -0,0 +1,305 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libdnf/base/metrics.hpp"
+
+#include <json.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+
+namespace libdnf::base {
+
+namespace {
+
+int64_t thread_cpu_time_us() noexcept {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0;
+    }
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+
+// Current resident set size of the process, 0 if it cannot be determined.
+int64_t rss_kb() noexcept {
+    auto * statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) {
+        return 0;
+    }
+    long size;
+    long resident;
+    int ret = std::fscanf(statm, "%ld %ld", &size, &resident);
+    std::fclose(statm);
+    if (ret != 2) {
+        return 0;
+    }
+    return static_cast<int64_t>(resident) * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+
+std::string json_to_string(json_object * root) {
+    std::string ret = json_object_to_json_string_ext(root, JSON_C_TO_STRING_PRETTY | JSON_C_TO_STRING_NOSLASHESCAPE);
+    json_object_put(root);
+    return ret;
+}
+
+}  // namespace
+
+
+class Metrics::Impl {
+public:
+    struct ThreadState {
+        unsigned number;
+        std::vector<std::size_t> open_spans;
+    };
+
+    int64_t since_epoch_us(std::chrono::steady_clock::time_point time_point) const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(time_point - epoch).count();
+    }
+
+    ThreadState & get_thread_state() {
+        auto [it, inserted] = threads.try_emplace(std::this_thread::get_id());
+        if (inserted) {
+            it->second.number = next_thread_number++;
+        }
+        return it->second;
+    }
+
+    mutable std::mutex mutex;
+    std::chrono::steady_clock::time_point epoch{std::chrono::steady_clock::now()};
+    uint64_t generation{0};
+    std::vector<MetricsSpan> spans;
+    std::map<std::string, int64_t> counters;
+    std::unordered_map<std::thread::id, ThreadState> threads;
+    unsigned next_thread_number{0};
+};
+
+
+Metrics::Span::Span(Metrics & metrics, const std::string & name, const std::string & detail)
+    : metrics(&metrics),
+      start(std::chrono::steady_clock::now()),
+      cpu_start_us(thread_cpu_time_us()),
+      rss_start_kb(rss_kb()) {
+    auto & impl = *metrics.p_impl;
+    std::lock_guard<std::mutex> lock(impl.mutex);
+    auto & thread_state = impl.get_thread_state();
+
+    MetricsSpan span;
+    span.name = name;
+    span.detail = detail;
+    if (!thread_state.open_spans.empty()) {
+        span.parent = static_cast<int>(thread_state.open_spans.back());
+    }
+    span.thread = thread_state.number;
+    span.start_us = impl.since_epoch_us(start);
+
+    index = impl.spans.size();
+    generation = impl.generation;
+    impl.spans.push_back(std::move(span));
+    thread_state.open_spans.push_back(index);
+}
+
+
+Metrics::Span::~Span() {
+    finish();
+}
+
+
+void Metrics::Span::finish() {
+    if (!running) {
+        return;
+    }
+    running = false;
+
+    const auto wall = std::chrono::steady_clock::now() - start;
+    const auto cpu_us = thread_cpu_time_us() - cpu_start_us;
+    const auto rss_delta_kb = rss_kb() - rss_start_kb;
+
+    auto & impl = *metrics->p_impl;
+    std::lock_guard<std::mutex> lock(impl.mutex);
+    if (generation != impl.generation) {
+        // the metrics were cleared while the span was running
+        return;
+    }
+
+    auto & span = impl.spans[index];
+    span.wall_us = std::chrono::duration_cast<std::chrono::microseconds>(wall).count();
+    span.cpu_us = cpu_us;
+    span.rss_delta_kb = rss_delta_kb;
+    span.finished = true;
+
+    // Spans are usually finished in the reverse order, but do not rely on it.
+    auto & open_spans = impl.get_thread_state().open_spans;
+    auto it = std::find(open_spans.rbegin(), open_spans.rend(), index);
+    if (it != open_spans.rend()) {
+        open_spans.erase(std::next(it).base());
+    }
+}
+
+
+Metrics::Metrics() : p_impl(std::make_unique<Impl>()) {}
+
+Metrics::~Metrics() = default;
+
+
+void Metrics::add_counter(const std::string & name, int64_t value) {
+    std::lock_guard<std::mutex> lock(p_impl->mutex);
+    p_impl->counters[name] += value;
+}
+
+
+int64_t Metrics::get_counter(const std::string & name) const {
+    std::lock_guard<std::mutex> lock(p_impl->mutex);
+    auto it = p_impl->counters.find(name);
+    return it != p_impl->counters.end() ? it->second : 0;
+}
+
+
+std::map<std::string, int64_t> Metrics::get_counters() const {
+    std::lock_guard<std::mutex> lock(p_impl->mutex);
+    return p_impl->counters;
+}
+
+
+std::vector<MetricsSpan> Metrics::get_spans() const {
+    std::lock_guard<std::mutex> lock(p_impl->mutex);
+    return p_impl->spans;
+}
+
+
+int64_t Metrics::get_total_wall_us(const std::string & name) const {
+    std::lock_guard<std::mutex> lock(p_impl->mutex);
+    int64_t total = 0;
+    for (const auto & span : p_impl->spans) {
+        if (span.finished && span.name == name) {
+            total += span.wall_us;
+        }
+    }
+    return total;
+}
+
+
+void Metrics::clear() {
+    std::lock_guard<std::mutex> lock(p_impl->mutex);
+    ++p_impl->generation;
+    p_impl->epoch = std::chrono::steady_clock::now();
+    p_impl->spans.clear();
+    p_impl->counters.clear();
+    for (auto & [thread_id, thread_state] : p_impl->threads) {
+        thread_state.open_spans.clear();
+    }
+}
+
+
+std::string Metrics::to_json() const {
+    std::lock_guard<std::mutex> lock(p_impl->mutex);
+
+    auto * root = json_object_new_object();
+    auto * spans = json_object_new_array();
+    for (const auto & span : p_impl->spans) {
+        auto * item = json_object_new_object();
+        json_object_object_add(item, "name", json_object_new_string(span.name.c_str()));
+        if (!span.detail.empty()) {
+            json_object_object_add(item, "detail", json_object_new_string(span.detail.c_str()));
+        }
+        json_object_object_add(item, "parent", json_object_new_int(span.parent));
+        json_object_object_add(item, "thread", json_object_new_int64(span.thread));
+        json_object_object_add(item, "start_us", json_object_new_int64(span.start_us));
+        json_object_object_add(item, "finished", json_object_new_boolean(span.finished));
+        if (span.finished) {
+            json_object_object_add(item, "wall_us", json_object_new_int64(span.wall_us));
+            json_object_object_add(item, "cpu_us", json_object_new_int64(span.cpu_us));
+            json_object_object_add(item, "rss_delta_kb", json_object_new_int64(span.rss_delta_kb));
+        }
+        json_object_array_add(spans, item);
+    }
+    json_object_object_add(root, "spans", spans);
+
+    auto * counters = json_object_new_object();
+    for (const auto & [name, value] : p_impl->counters) {
+        json_object_object_add(counters, name.c_str(), json_object_new_int64(value));
+    }
+    json_object_object_add(root, "counters", counters);
+
+    return json_to_string(root);
+}
+
+
+std::string Metrics::to_chrome_trace() const {
+    std::lock_guard<std::mutex> lock(p_impl->mutex);
+
+    const auto pid = static_cast<int32_t>(getpid());
+    int64_t end_us = 0;
+
+    auto * events = json_object_new_array();
+    for (const auto & span : p_impl->spans) {
+        if (!span.finished) {
+            continue;
+        }
+        end_us = std::max(end_us, span.start_us + span.wall_us);
+
+        auto * event = json_object_new_object();
+        json_object_object_add(event, "name", json_object_new_string(span.name.c_str()));
+        json_object_object_add(event, "cat", json_object_new_string("libdnf"));
+        json_object_object_add(event, "ph", json_object_new_string("X"));
+        json_object_object_add(event, "ts", json_object_new_int64(span.start_us));
+        json_object_object_add(event, "dur", json_object_new_int64(span.wall_us));
+        json_object_object_add(event, "pid", json_object_new_int(pid));
+        json_object_object_add(event, "tid", json_object_new_int64(span.thread));
+        auto * args = json_object_new_object();
+        if (!span.detail.empty()) {
+            json_object_object_add(args, "detail", json_object_new_string(span.detail.c_str()));
+        }
+        json_object_object_add(args, "cpu_us", json_object_new_int64(span.cpu_us));
+        json_object_object_add(args, "rss_delta_kb", json_object_new_int64(span.rss_delta_kb));
+        json_object_object_add(event, "args", args);
+        json_object_array_add(events, event);
+    }
+
+    // Counters are not bound to time, they are reported as a single sample at the end of the trace.
+    if (!p_impl->counters.empty()) {
+        auto * event = json_object_new_object();
+        json_object_object_add(event, "name", json_object_new_string("counters"));
+        json_object_object_add(event, "ph", json_object_new_string("C"));
+        json_object_object_add(event, "ts", json_object_new_int64(end_us));
+        json_object_object_add(event, "pid", json_object_new_int(pid));
+        json_object_object_add(event, "tid", json_object_new_int(0));
+        auto * args = json_object_new_object();
+        for (const auto & [name, value] : p_impl->counters) {
+            json_object_object_add(args, name.c_str(), json_object_new_int64(value));
+        }
+        json_object_object_add(event, "args", args);
+        json_object_array_add(events, event);
+    }
+
+    auto * root = json_object_new_object();
+    json_object_object_add(root, "traceEvents", events);
+    json_object_object_add(root, "displayTimeUnit", json_object_new_string("ms"));
+
+    return json_to_string(root);
+}
+
+}  // namespace libdnf::base
@@ -0,0 +1,306 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "solver_cache.hpp"
+
+#include "repo/solv_repo.hpp"
+#include "solv/pool.hpp"
+#include "utils/fs/binary_io.hpp"
+#include "utils/fs/file.hpp"
+#include "utils/fs/temp.hpp"
+
+#include "libdnf/base/base.hpp"
+#include "libdnf/rpm/package_query.hpp"
+#include "libdnf/utils/to_underlying.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <system_error>
+
+
+namespace libdnf::base {
+
+namespace fs = libdnf::utils::fs;
+
+
+namespace {
+
+// Name of the directory in the cachedir with the cached transactions
+constexpr const char * SOLVER_CACHE_DIR = "solver";
+
+// Maximal number of cached transactions, the least recently stored ones are removed
+constexpr std::size_t SOLVER_CACHE_MAX_ENTRIES = 32;
+
+
+void write_package_keys(fs::File & file, const std::vector<SolverCache::PackageKey> & keys) {
+    fs::write_u64(file, keys.size());
+    for (const auto & key : keys) {
+        fs::write_string(file, key.repo_id);
+        fs::write_string(file, key.nevra);
+    }
+}
+
+
+bool read_package_keys(fs::File & file, std::vector<SolverCache::PackageKey> & keys, uint64_t file_size) {
+    uint64_t count;
+    if (!fs::read_u64(file, count) || count > file_size) {
+        return false;
+    }
+    keys.resize(count);
+    for (auto & key : keys) {
+        if (!fs::read_string(file, key.repo_id, file_size) || !fs::read_string(file, key.nevra, file_size)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+
+SolverCacheKey::SolverCacheKey() : chksum(solv_chksum_create(REPOKEY_TYPE_SHA256)) {}
+
+
+SolverCacheKey::~SolverCacheKey() {
+    if (chksum) {
+        solv_chksum_free(chksum, nullptr);
+    }
+}
+
+
+void SolverCacheKey::add(std::string_view value) {
+    add(static_cast<int64_t>(value.size()));
+    solv_chksum_add(chksum, value.data(), static_cast<int>(value.size()));
+}
+
+
+void SolverCacheKey::add(int64_t value) {
+    solv_chksum_add(chksum, &value, sizeof(value));
+}
+
+
+std::string SolverCacheKey::get_digest() {
+    int len;
+    const auto * digest = solv_chksum_get(chksum, &len);
+    std::string hex;
+    hex.reserve(static_cast<std::size_t>(len) * 2);
+    for (int i = 0; i < len; ++i) {
+        static constexpr const char * HEX_DIGITS = "0123456789abcdef";
+        hex.push_back(HEX_DIGITS[digest[i] >> 4]);
+        hex.push_back(HEX_DIGITS[digest[i] & 0xf]);
+    }
+    return hex;
+}
+
+
+SolverCache::SolverCache(const BaseWeakPtr & base) : base(base) {}
+
+
+bool SolverCache::add_state(SolverCacheKey & key) const {
+    auto & config = base->get_config();
+    // Excludes and includes, including the modular filtering, are covered by the considered map below.
+    const Option * options[] = {
+        &config.best(),
+        &config.clean_requirements_on_remove(),
+        &config.install_weak_deps(),
+        &config.allow_vendor_change(),
+        &config.protected_packages(),
+        &config.protect_running_kernel(),
+        &config.installonlypkgs(),
+        &config.installonly_limit(),
+        &config.skip_broken(),
+        &config.strict(),
+        &config.obsoletes(),
+        &config.multilib_policy(),
+        &config.ignorearch()};
+    for (const auto * option : options) {
+        key.add(option->get_value_string());
+    }
+
+    // The architectures of the pool, they decide which packages are installable
+    const auto & vars = *base->get_vars();
+    for (const auto * name : {"arch", "basearch"}) {
+        key.add(vars.contains(name) ? vars.get_value(name) : std::string_view());
+    }
+
+    auto & pool = get_rpm_pool(base);
+    auto nsolvables = pool.get_nsolvables();
+    key.add(nsolvables);
+    if (pool.is_considered_map_active()) {
+        const auto & map = pool.get_considered_map().get_map();
+        auto size = std::min(static_cast<std::size_t>(map.size), (static_cast<std::size_t>(nsolvables) + 7) / 8);
+        key.add(std::string_view(reinterpret_cast<const char *>(map.map), size));
+    } else {
+        key.add(-1);
+    }
+
+    // Solvable ids are part of the key (considered map), they are stable only for the same repositories
+    // loaded in the same order with the same metadata.
+    ::Repo * solv_repo;
+    Id repo_id;
+    FOR_REPOS(repo_id, solv_repo) {
+        if (!solv_repo->appdata) {
+            return false;
+        }
+        auto & repo = *static_cast<repo::Repo *>(solv_repo->appdata);
+        key.add(repo.get_id());
+        key.add(solv_repo->start);
+        key.add(solv_repo->end);
+        key.add(solv_repo->nsolvables);
+        key.add(solv_repo->priority);
+        key.add(solv_repo->subpriority);
+        switch (repo.get_type()) {
+            case repo::Repo::Type::AVAILABLE: {
+                const auto & checksum = repo.solv_repo->checksum;
+                if (std::all_of(std::begin(checksum), std::end(checksum), [](unsigned char c) { return c == 0; })) {
+                    // not loaded from repository metadata
+                    return false;
+                }
+                key.add(std::string_view(reinterpret_cast<const char *>(checksum), sizeof(checksum)));
+                break;
+            }
+            case repo::Repo::Type::SYSTEM:
+                // covered by the installed packages below
+                break;
+            case repo::Repo::Type::COMMANDLINE:
+                if (solv_repo->nsolvables > 0) {
+                    return false;
+                }
+                break;
+        }
+    }
+
+    // The installed packages as they were read from rpmdb, with their reasons from the system state.
+    rpm::PackageQuery installed(base, rpm::PackageQuery::ExcludeFlags::IGNORE_EXCLUDES);
+    installed.filter_installed();
+    for (const auto & pkg : installed) {
+        key.add(pkg.get_full_nevra());
+        key.add(static_cast<int64_t>(pkg.get_install_time()));
+        key.add(utils::to_underlying(pkg.get_reason()));
+    }
+    return true;
+}
+
+
+std::optional<std::vector<SolverCache::Item>> SolverCache::load(const std::string & digest) const {
+    const auto path = get_path(digest);
+    std::error_code ec;
+    const auto file_size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+
+    try {
+        fs::File file(path, "r");
+
+        std::array<char, SOLVER_CACHE_MAGIC.size()> magic;
+        std::array<char, SOLVER_CACHE_VERSION.size()> version;
+        if (file.read(magic.data(), magic.size()) != magic.size() || magic != SOLVER_CACHE_MAGIC ||
+            file.read(version.data(), version.size()) != version.size() || version != SOLVER_CACHE_VERSION) {
+            return std::nullopt;
+        }
+
+        uint64_t nitems;
+        if (!fs::read_u64(file, nitems) || nitems > file_size) {
+            return std::nullopt;
+        }
+        std::vector<Item> items(nitems);
+        for (auto & item : items) {
+            uint64_t action;
+            uint64_t reason;
+            uint64_t has_group_id;
+            if (!fs::read_u64(file, action) || !fs::read_u64(file, reason) ||
+                !fs::read_string(file, item.package.repo_id, file_size) ||
+                !fs::read_string(file, item.package.nevra, file_size) ||
+                !read_package_keys(file, item.replaces, file_size) ||
+                !read_package_keys(file, item.replaced_by, file_size) || !fs::read_u64(file, has_group_id)) {
+                return std::nullopt;
+            }
+            item.action = static_cast<TransactionPackage::Action>(action);
+            item.reason = static_cast<TransactionPackage::Reason>(reason);
+            if (has_group_id) {
+                std::string group_id;
+                if (!fs::read_string(file, group_id, file_size)) {
+                    return std::nullopt;
+                }
+                item.reason_change_group_id = std::move(group_id);
+            }
+        }
+        return items;
+    } catch (const std::exception & ex) {
+        base->get_logger()->debug("Cannot read solver cache file \"{}\": {}", path.native(), ex.what());
+        return std::nullopt;
+    }
+}
+
+
+void SolverCache::store(const std::string & digest, const std::vector<Item> & items) const {
+    const auto path = get_path(digest);
+    try {
+        const auto dir = path.parent_path();
+        std::filesystem::create_directories(dir);
+
+        // keep the cache bounded, remove the least recently stored transactions
+        std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> entries;
+        for (const auto & entry : std::filesystem::directory_iterator(dir)) {
+            if (entry.is_regular_file()) {
+                entries.emplace_back(entry.last_write_time(), entry.path());
+            }
+        }
+        if (entries.size() >= SOLVER_CACHE_MAX_ENTRIES) {
+            std::sort(entries.begin(), entries.end());
+            for (std::size_t idx = 0; idx <= entries.size() - SOLVER_CACHE_MAX_ENTRIES; ++idx) {
+                std::filesystem::remove(entries[idx].second);
+            }
+        }
+
+        auto tmp_file = fs::TempFile(dir, path.filename());
+        auto & file = tmp_file.open_as_file("w+");
+
+        // The cache is local, integers are stored in native byte order.
+        file.write(SOLVER_CACHE_MAGIC.data(), SOLVER_CACHE_MAGIC.size());
+        file.write(SOLVER_CACHE_VERSION.data(), SOLVER_CACHE_VERSION.size());
+        fs::write_u64(file, items.size());
+        for (const auto & item : items) {
+            fs::write_u64(file, utils::to_underlying(item.action));
+            fs::write_u64(file, utils::to_underlying(item.reason));
+            fs::write_string(file, item.package.repo_id);
+            fs::write_string(file, item.package.nevra);
+            write_package_keys(file, item.replaces);
+            write_package_keys(file, item.replaced_by);
+            fs::write_u64(file, item.reason_change_group_id ? 1 : 0);
+            if (item.reason_change_group_id) {
+                fs::write_string(file, *item.reason_change_group_id);
+            }
+        }
+
+        tmp_file.close();
+        std::filesystem::rename(tmp_file.get_path(), path);
+        tmp_file.release();
+    } catch (const std::exception & ex) {
+        base->get_logger()->warning("Cannot write solver cache file \"{}\": {}", path.native(), ex.what());
+    }
+}
+
+
+std::filesystem::path SolverCache::get_path(const std::string & digest) const {
+    return std::filesystem::path(base->get_config().cachedir().get_value()) / SOLVER_CACHE_DIR / digest;
+}
+
+}  // namespace libdnf::base
@@ -0,0 +1,112 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF_BASE_SOLVER_CACHE_HPP
+#define LIBDNF_BASE_SOLVER_CACHE_HPP
+
+#include "libdnf/base/base_weak.hpp"
+#include "libdnf/base/transaction_package.hpp"
+
+extern "C" {
+#include <solv/chksum.h>
+}
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace libdnf::base {
+
+static const constexpr std::array<char, 4> SOLVER_CACHE_MAGIC{'\0', 'd', 's', 'c'};
+static const constexpr std::array<char, 4> SOLVER_CACHE_VERSION{'\0', '1', '.', '0'};
+
+
+/// Digest of everything a resolve depends on. Every value is added with its length, so the
+/// concatenation of different sequences of values never gives the same digest.
+class SolverCacheKey {
+public:
+    SolverCacheKey();
+    ~SolverCacheKey();
+
+    SolverCacheKey(const SolverCacheKey &) = delete;
+    SolverCacheKey & operator=(const SolverCacheKey &) = delete;
+
+    void add(std::string_view value);
+    void add(int64_t value);
+
+    /// @return Hex encoded digest of the added values. No values can be added afterwards.
+    std::string get_digest();
+
+private:
+    Chksum * chksum;
+};
+
+
+/// Persistent cache of resolved transactions.
+///
+/// Tools repeatedly resolving the same goal against unchanged metadata and system (e.g. checking
+/// for upgrades) can skip the job construction and the solver. A transaction is stored under
+/// the digest of the goal, the relevant configuration, the repositories and the installed packages,
+/// see `add_state()`. Only its packages are stored, identified by the repository id and NEVRA.
+class SolverCache {
+public:
+    struct PackageKey {
+        std::string repo_id;
+        std::string nevra;
+    };
+
+    struct Item {
+        TransactionPackage::Action action;
+        TransactionPackage::Reason reason;
+        PackageKey package;
+        std::vector<PackageKey> replaces;
+        std::vector<PackageKey> replaced_by;
+        std::optional<std::string> reason_change_group_id;
+    };
+
+    explicit SolverCache(const BaseWeakPtr & base);
+
+    /// Adds the state the resolve depends on besides the goal itself: the solver related configuration,
+    /// the architecture, the considered (not excluded) packages, the loaded repositories with their metadata checksums,
+    /// the installed packages and their reasons.
+    /// @return `false` if the state cannot be identified (e.g. packages from the command line are loaded),
+    ///         the result must not be cached then.
+    bool add_state(SolverCacheKey & key) const;
+
+    /// @return The items stored under `digest`, or empty optional if there are none or the cache file is damaged.
+    std::optional<std::vector<Item>> load(const std::string & digest) const;
+
+    /// Stores `items` under `digest`. The cache is best effort, errors are only logged.
+    void store(const std::string & digest, const std::vector<Item> & items) const;
+
+private:
+    std::filesystem::path get_path(const std::string & digest) const;
+
+    BaseWeakPtr base;
+};
+
+}  // namespace libdnf::base
+
+#endif  // LIBDNF_BASE_SOLVER_CACHE_HPP
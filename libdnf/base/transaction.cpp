@@ -42,7 +42,6 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <iostream>
 #include <ranges>
 #include <string_view>
-#include <thread>
 
 
 namespace libdnf::base {
@@ -314,6 +313,86 @@ void Transaction::Impl::set_transaction(rpm::solv::GoalPrivate & solved_goal, Go
 }
 
 
+bool Transaction::Impl::set_transaction(const std::vector<SolverCache::Item> & items) {
+    std::vector<std::string> nevras;
+    for (const auto & item : items) {
+        nevras.push_back(item.package.nevra);
+        for (const auto & key : item.replaces) {
+            nevras.push_back(key.nevra);
+        }
+        for (const auto & key : item.replaced_by) {
+            nevras.push_back(key.nevra);
+        }
+    }
+
+    // <repo_id, nevra> -> package
+    std::map<std::pair<std::string, std::string>, rpm::Package> key_to_package;
+    rpm::PackageQuery query(base, rpm::PackageQuery::ExcludeFlags::IGNORE_EXCLUDES);
+    query.filter_nevra(nevras);
+    for (const auto & pkg : query) {
+        key_to_package.emplace(std::make_pair(pkg.get_repo_id(), pkg.get_full_nevra()), pkg);
+    }
+
+    auto find_package = [&key_to_package](const SolverCache::PackageKey & key) -> const rpm::Package * {
+        auto it = key_to_package.find({key.repo_id, key.nevra});
+        return it == key_to_package.end() ? nullptr : &it->second;
+    };
+
+    std::vector<TransactionPackage> cached_packages;
+    cached_packages.reserve(items.size());
+    for (const auto & item : items) {
+        const auto * pkg = find_package(item.package);
+        if (!pkg) {
+            return false;
+        }
+        TransactionPackage tspkg(*pkg, item.action, item.reason, item.reason_change_group_id);
+        for (const auto & key : item.replaces) {
+            const auto * replaced = find_package(key);
+            if (!replaced) {
+                return false;
+            }
+            tspkg.replaces.push_back(*replaced);
+        }
+        for (const auto & key : item.replaced_by) {
+            const auto * replaced_by = find_package(key);
+            if (!replaced_by) {
+                return false;
+            }
+            tspkg.replaced_by.push_back(*replaced_by);
+        }
+        cached_packages.push_back(std::move(tspkg));
+    }
+
+    problems = GoalProblem::NO_PROBLEM;
+    packages = std::move(cached_packages);
+    return true;
+}
+
+
+std::vector<SolverCache::Item> Transaction::Impl::get_solver_cache_items() const {
+    auto to_key = [](const rpm::Package & pkg) {
+        return SolverCache::PackageKey{pkg.get_repo_id(), pkg.get_full_nevra()};
+    };
+
+    std::vector<SolverCache::Item> items;
+    items.reserve(packages.size());
+    for (const auto & tspkg : packages) {
+        auto & item = items.emplace_back();
+        item.action = tspkg.get_action();
+        item.reason = tspkg.get_reason();
+        item.package = to_key(tspkg.get_package());
+        for (const auto & pkg : tspkg.get_replaces()) {
+            item.replaces.push_back(to_key(pkg));
+        }
+        for (const auto & pkg : tspkg.get_replaced_by()) {
+            item.replaced_by.push_back(to_key(pkg));
+        }
+        item.reason_change_group_id = tspkg.get_reason_change_group_id();
+    }
+    return items;
+}
+
+
 TransactionPackage Transaction::Impl::make_transaction_package(
     Id id,
     TransactionPackage::Action action,
@@ -356,37 +435,6 @@ TransactionPackage Transaction::Impl::make_transaction_package(
     return tspkg;
 }
 
-// Reads the output of scriptlets from the file descriptor and processes them.
-static void process_scriptlets_output(int fd, Logger * logger) {
-    try {
-        char buf[512];
-        do {
-            auto len = read(fd, buf, sizeof(buf));
-            if (len > 0) {
-                std::string_view str(buf, static_cast<size_t>(len));
-                std::string_view::size_type start = 0;
-                do {
-                    auto end = str.find('\n', start);
-                    logger->info("[scriptlet] {}", str.substr(start, end - start));
-                    if (end == std::string_view::npos) {
-                        break;
-                    }
-                    start = end + 1;
-                } while (start < str.size());
-            } else {
-                if (len == -1) {
-                    logger->error("Transaction::Run: Cannot read scriptlet output from pipe: {}", std::strerror(errno));
-                }
-                break;
-            }
-        } while (true);
-    } catch (const std::exception & ex) {
-        // The thread must not throw exceptions.
-        logger->error("Transaction::Run: Exception while processing scriptlet output: {}", ex.what());
-    }
-    close(fd);
-}
-
 Transaction::TransactionRunResult Transaction::Impl::run(
     std::unique_ptr<libdnf::rpm::TransactionCallbacks> && callbacks,
     const std::string & description,
@@ -403,6 +451,12 @@ Transaction::TransactionRunResult Transaction::Impl::run(
     }
 
     auto & config = base->get_config();
+    auto & metrics = *base->get_metrics();
+    Metrics::Span run_span(metrics, "transaction.run");
+
+    // start reading package headers, they are not needed before the rpm transaction is filled
+    libdnf::rpm::Transaction rpm_transaction(base);
+    rpm_transaction.preload_headers(*transaction);
 
     // acquire the lock
     std::filesystem::path lock_file_path = config.installroot().get_value();
@@ -415,7 +469,7 @@ Transaction::TransactionRunResult Transaction::Impl::run(
     }
 
     // fill and check the rpm transaction
-    libdnf::rpm::Transaction rpm_transaction(base);
+    Metrics::Span check_span(metrics, "transaction.check");
     rpm_transaction.fill(*transaction);
     if (!rpm_transaction.check()) {
         auto problems = rpm_transaction.get_problems();
@@ -424,6 +478,7 @@ Transaction::TransactionRunResult Transaction::Impl::run(
         }
         return TransactionRunResult::ERROR_CHECK;
     }
+    check_span.finish();
 
     rpmtransFlags rpm_transaction_flags{RPMTRANS_FLAG_NONE};
     for (const auto & tsflag : config.tsflags().get_value()) {
@@ -446,28 +501,38 @@ Transaction::TransactionRunResult Transaction::Impl::run(
         }
     }
 
-    // Run rpm transaction test
-    rpm_transaction.set_flags(rpm_transaction_flags | RPMTRANS_FLAG_TEST);
-    //TODO(jrohel): Do we want callbacks for transaction test?
-    //rpm_transaction.set_callbacks(std::move(callbacks));
-    auto ret = rpm_transaction.run();
-    if (ret != 0) {
-        auto problems = rpm_transaction.get_problems();
-        for (auto it = problems.begin(); it != problems.end(); ++it) {
-            transaction_problems.emplace_back((*it).to_string());
+    // The test run of the rpm transaction finds file conflicts and disk space problems before the history
+    // record is started and the plugins are notified. The real run does the same checks before it changes
+    // anything, with test_transaction=never they are the only ones.
+    const bool test_only = (rpm_transaction_flags & RPMTRANS_FLAG_TEST) != 0;
+    int ret = 0;
+    if (test_only || config.test_transaction().get_value() == "always") {
+        // Run rpm transaction test
+        rpm_transaction.set_flags(rpm_transaction_flags | RPMTRANS_FLAG_TEST);
+        //TODO(jrohel): Do we want callbacks for transaction test?
+        //rpm_transaction.set_callbacks(std::move(callbacks));
+        Metrics::Span test_span(metrics, "transaction.test");
+        ret = rpm_transaction.run();
+        test_span.finish();
+        if (ret != 0) {
+            auto problems = rpm_transaction.get_problems();
+            for (auto it = problems.begin(); it != problems.end(); ++it) {
+                transaction_problems.emplace_back((*it).to_string());
+            }
+            return TransactionRunResult::ERROR_RPM_RUN;
         }
-        return TransactionRunResult::ERROR_RPM_RUN;
-    }
 
-    // With RPMTRANS_FLAG_TEST return just before anything is stored permanently
-    if (rpm_transaction_flags & RPMTRANS_FLAG_TEST) {
-        return TransactionRunResult::SUCCESS;
+        // With RPMTRANS_FLAG_TEST return just before anything is stored permanently
+        if (test_only) {
+            return TransactionRunResult::SUCCESS;
+        }
     }
 
     auto & plugins = base->p_impl->get_plugins();
     plugins.pre_transaction(*transaction);
 
     // start history db transaction
+    Metrics::Span history_start_span(metrics, "transaction.history_start");
     auto db_transaction = libdnf::transaction::Transaction(base);
     // save history db transaction id
     history_db_id = db_transaction.get_id();
@@ -514,38 +579,44 @@ Transaction::TransactionRunResult Transaction::Impl::run(
     auto time = std::chrono::system_clock::now().time_since_epoch();
     db_transaction.set_dt_start(std::chrono::duration_cast<std::chrono::seconds>(time).count());
     db_transaction.start();
+    history_start_span.finish();
 
 
-    auto logger = base->get_logger().get();
-    int pipe_out_from_scriptlets[2];
-    if (pipe(pipe_out_from_scriptlets) == -1) {
-        logger->error("Transaction::Run: Cannot create pipe: {}", std::strerror(errno));
+    // The output of RPM scriptlets is appended to a dedicated log next to the main log.
+    auto scriptlet_log_path = std::filesystem::path(config.installroot().get_value());
+    scriptlet_log_path += config.logdir().get_value();
+    scriptlet_log_path /= "dnf5-scriptlets.log";
+    libdnf::rpm::ScriptletOutput scriptlet_output(*base->get_logger(), scriptlet_log_path);
+    auto script_out_fd = scriptlet_output.start();
+    if (script_out_fd == -1) {
         return TransactionRunResult::ERROR_RPM_RUN;
     }
 
-    // This thread processes the output of RPM scriptlets.
-    std::thread thread_processes_scriptlets_output(process_scriptlets_output, pipe_out_from_scriptlets[0], logger);
-
     // Set file descriptor for output of scriptlets in transaction.
-    rpm_transaction.set_script_out_fd(pipe_out_from_scriptlets[1]);
+    rpm_transaction.set_script_out_fd(script_out_fd);
     // set_script_out_fd() copies the file descriptor using dup(). Closing the original fd.
-    close(pipe_out_from_scriptlets[1]);
+    close(script_out_fd);
+    rpm_transaction.set_scriptlet_output(&scriptlet_output);
 
     rpm_transaction.set_callbacks(std::move(callbacks));
     rpm_transaction.set_flags(rpm_transaction_flags);
 
     // execute rpm transaction
+    Metrics::Span rpm_span(metrics, "transaction.rpm");
     ret = rpm_transaction.run();
+    rpm_span.finish();
 
-    // Reset/close file descriptor for output of RPM scriptlets. Required to end thread_processes_scriptlets_output.
+    // Reset/close file descriptor for output of RPM scriptlets. Required to end reading of the scriptlet output.
     rpm_transaction.set_script_out_fd(-1);
+    rpm_transaction.set_scriptlet_output(nullptr);
 
-    thread_processes_scriptlets_output.join();
+    scriptlet_output.finish();
 
     // TODO(mblaha): Handle ret == -1 and ret > 0, fill problems list
 
     if (ret == 0) {
         // set the new system state
+        Metrics::Span system_state_span(metrics, "transaction.system_state");
         auto & system_state = base->p_impl->get_system_state();
 
         rpm::PackageQuery installed_query(base, rpm::PackageQuery::ExcludeFlags::IGNORE_EXCLUDES);
@@ -643,6 +714,7 @@ Transaction::TransactionRunResult Transaction::Impl::run(
     }
 
     // finish history db transaction
+    Metrics::Span history_finish_span(metrics, "transaction.history_finish");
     time = std::chrono::system_clock::now().time_since_epoch();
     db_transaction.set_dt_end(std::chrono::duration_cast<std::chrono::seconds>(time).count());
     // TODO(jrohel): Also save the rpm db cookie to system state.
@@ -650,6 +722,7 @@ Transaction::TransactionRunResult Transaction::Impl::run(
     db_transaction.set_rpmdb_version_end(rpm_transaction.get_db_cookie());
     db_transaction.finish(
         ret == 0 ? libdnf::transaction::TransactionState::OK : libdnf::transaction::TransactionState::ERROR);
+    history_finish_span.finish();
 
     plugins.post_transaction(*transaction);
 
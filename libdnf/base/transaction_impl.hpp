@@ -22,6 +22,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 
 #include "rpm/solv/goal_private.hpp"
+#include "solver_cache.hpp"
 
 #include "libdnf/base/transaction.hpp"
 #include "libdnf/base/transaction_group.hpp"
@@ -51,6 +52,13 @@ public:
     /// Set transaction according resolved goal and problems to EventLog
     void set_transaction(rpm::solv::GoalPrivate & solved_goal, GoalProblem problems);
 
+    /// Set transaction according to the packages of a transaction stored by SolverCache
+    /// @return `false` if a package of the stored transaction is not available anymore
+    bool set_transaction(const std::vector<SolverCache::Item> & items);
+
+    /// @return The packages of the transaction in the form stored by SolverCache
+    std::vector<SolverCache::Item> get_solver_cache_items() const;
+
     TransactionPackage make_transaction_package(
         Id id,
         TransactionPackage::Action action,
@@ -200,6 +200,7 @@ class ConfigMain::Impl {
                                                   }};
 
     OptionStringList tsflags{std::vector<std::string>{}};
+    OptionEnum<std::string> test_transaction{"always", {"always", "never"}};
     OptionBool assumeyes{false};
     OptionBool assumeno{false};
     OptionBool check_config_file_age{true};
@@ -212,6 +213,7 @@ class ConfigMain::Impl {
     OptionBool exit_on_lock{false};
     OptionBool allow_vendor_change{true};
     OptionSeconds metadata_timer_sync{60 * 60 * 3};  // 3 hours
+    OptionBool prefetch_upgrades{false};
     OptionStringList disable_excludes{std::vector<std::string>{}};
     OptionEnum<std::string> multilib_policy{"best", {"best", "all"}};  // :api
     OptionBool best{false};                                            // :api
@@ -277,6 +279,9 @@ class ConfigMain::Impl {
     OptionBool countme{false};
     OptionBool protect_running_kernel{true};
     OptionBool build_cache{true};
+    OptionBool solver_cache{false};
+    OptionNumber<std::uint32_t> download_mirrors{0};
+    OptionNumber<std::uint32_t> query_threads{1};
 
     // Repo main config
 
@@ -398,6 +403,7 @@ ConfigMain::Impl::Impl(Config & owner) : owner(owner) {
         [&](Option::Priority priority, const std::string & value) { option_T_list_append(tsflags, priority, value); },
         nullptr,
         true);
+    owner.opt_binds().add("test_transaction", test_transaction);
 
     owner.opt_binds().add("assumeyes", assumeyes);
     owner.opt_binds().add("assumeno", assumeno);
@@ -411,6 +417,7 @@ ConfigMain::Impl::Impl(Config & owner) : owner(owner) {
     owner.opt_binds().add("exit_on_lock", exit_on_lock);
     owner.opt_binds().add("allow_vendor_change", allow_vendor_change);
     owner.opt_binds().add("metadata_timer_sync", metadata_timer_sync);
+    owner.opt_binds().add("prefetch_upgrades", prefetch_upgrades);
     owner.opt_binds().add("disable_excludes", disable_excludes);
     owner.opt_binds().add("multilib_policy", multilib_policy);
     owner.opt_binds().add("best", best);
@@ -449,6 +456,9 @@ ConfigMain::Impl::Impl(Config & owner) : owner(owner) {
     owner.opt_binds().add("countme", countme);
     owner.opt_binds().add("protect_running_kernel", protect_running_kernel);
     owner.opt_binds().add("build_cache", build_cache);
+    owner.opt_binds().add("solver_cache", solver_cache);
+    owner.opt_binds().add("download_mirrors", download_mirrors);
+    owner.opt_binds().add("query_threads", query_threads);
 
     // Repo main config
 
@@ -750,6 +760,13 @@ const OptionStringList & ConfigMain::tsflags() const {
     return p_impl->tsflags;
 }
 
+OptionEnum<std::string> & ConfigMain::test_transaction() {
+    return p_impl->test_transaction;
+}
+const OptionEnum<std::string> & ConfigMain::test_transaction() const {
+    return p_impl->test_transaction;
+}
+
 OptionBool & ConfigMain::assumeyes() {
     return p_impl->assumeyes;
 }
@@ -834,6 +851,13 @@ const OptionSeconds & ConfigMain::metadata_timer_sync() const {
     return p_impl->metadata_timer_sync;
 }
 
+OptionBool & ConfigMain::prefetch_upgrades() {
+    return p_impl->prefetch_upgrades;
+}
+const OptionBool & ConfigMain::prefetch_upgrades() const {
+    return p_impl->prefetch_upgrades;
+}
+
 OptionStringList & ConfigMain::disable_excludes() {
     return p_impl->disable_excludes;
 }
@@ -1110,6 +1134,27 @@ const OptionBool & ConfigMain::build_cache() const {
     return p_impl->build_cache;
 }
 
+OptionBool & ConfigMain::solver_cache() {
+    return p_impl->solver_cache;
+}
+const OptionBool & ConfigMain::solver_cache() const {
+    return p_impl->solver_cache;
+}
+
+OptionNumber<std::uint32_t> & ConfigMain::download_mirrors() {
+    return p_impl->download_mirrors;
+}
+const OptionNumber<std::uint32_t> & ConfigMain::download_mirrors() const {
+    return p_impl->download_mirrors;
+}
+
+OptionNumber<std::uint32_t> & ConfigMain::query_threads() {
+    return p_impl->query_threads;
+}
+const OptionNumber<std::uint32_t> & ConfigMain::query_threads() const {
+    return p_impl->query_threads;
+}
+
 // Repo main config
 OptionNumber<std::uint32_t> & ConfigMain::retries() {
     return p_impl->retries;
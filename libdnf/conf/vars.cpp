@@ -36,6 +36,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <filesystem>
 #include <memory>
 #include <optional>
+#include <string_view>
 
 #define ASCII_LOWERCASE "abcdefghijklmnopqrstuvwxyz"
 #define ASCII_UPPERCASE "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
@@ -171,52 +172,76 @@ static std::optional<std::string> detect_release(const BaseWeakPtr & base, const
 Vars::Vars(Base & base) : Vars(base.get_weak_ptr()) {}
 
 
-std::string Vars::substitute(const std::string & text) const {
-    std::string res = text;
-
-    if (variables.empty()) {
-        return res;
-    }
+namespace {
 
-    auto start = res.find_first_of('$');
+/// Splits `text` into literal segments and references to variables ("$name" or "${name}").
+/// Calls `on_literal(begin, length)` for literal text and `on_variable(name, begin, length)` for every
+/// reference, `begin` and `length` are the position of the whole reference in `text`.
+/// Variables are not resolved here. A reference to an unknown variable is kept in the text as it is.
+template <typename OnLiteral, typename OnVariable>
+void split_variables(const std::string & text, OnLiteral on_literal, OnVariable on_variable) {
+    std::size_t literal_begin = 0;
+    auto start = text.find_first_of('$');
     while (start != std::string::npos) {
         auto variable = start + 1;
-        if (variable >= res.length()) {
+        if (variable >= text.length()) {
             break;
         }
         bool bracket;
-        if (res[variable] == '{') {
+        if (text[variable] == '{') {
             bracket = true;
-            if (++variable >= res.length()) {
+            if (++variable >= text.length()) {
                 break;
             }
         } else {
             bracket = false;
         }
-        auto it = std::find_if_not(res.begin() + static_cast<long>(variable), res.end(), [](char c) {
+        auto it = std::find_if_not(text.begin() + static_cast<long>(variable), text.end(), [](char c) {
             return std::isalnum(c) != 0 || c == '_';
         });
-        if (bracket && it == res.end()) {
+        if (bracket && it == text.end()) {
             break;
         }
-        auto past_variable = static_cast<unsigned long>(std::distance(res.begin(), it));
+        auto past_variable = static_cast<std::size_t>(std::distance(text.begin(), it));
         if (bracket && *it != '}') {
-            start = res.find_first_of('$', past_variable);
+            start = text.find_first_of('$', past_variable);
             continue;
         }
-        auto subst = variables.find(res.substr(variable, past_variable - variable));
-        if (subst != variables.end()) {
-            if (bracket) {
-                ++past_variable;
-            }
-            auto & subst_str = subst->second.value;
-            res.replace(start, past_variable - start, subst_str);
-            start = res.find_first_of('$', start + subst_str.length());
-        } else {
-            start = res.find_first_of('$', past_variable);
+        auto past_reference = bracket ? past_variable + 1 : past_variable;
+        if (start > literal_begin) {
+            on_literal(literal_begin, start - literal_begin);
         }
+        on_variable(
+            std::string_view(text).substr(variable, past_variable - variable), start, past_reference - start);
+        literal_begin = past_reference;
+        start = text.find_first_of('$', past_reference);
+    }
+    if (literal_begin < text.length()) {
+        on_literal(literal_begin, text.length() - literal_begin);
+    }
+}
+
+}  // namespace
+
+
+std::string Vars::substitute(const std::string & text) const {
+    if (variables.empty()) {
+        return text;
     }
 
+    std::string res;
+    res.reserve(text.length());
+    split_variables(
+        text,
+        [&](std::size_t begin, std::size_t length) { res.append(text, begin, length); },
+        [&](std::string_view name, std::size_t begin, std::size_t length) {
+            auto subst = variables.find(name);
+            if (subst != variables.end()) {
+                res.append(subst->second.value);
+            } else {
+                res.append(text, begin, length);
+            }
+        });
     return res;
 }
 
@@ -258,14 +283,17 @@ void Vars::detect_vars(const std::string & installroot) {
         }
     }
 
+    // "arch" is missing if it was not detected, the lookup must not create it
+    const auto arch_it = variables.find("arch");
+    const char * arch_value = arch_it != variables.end() ? arch_it->second.value.c_str() : "";
     it = variables.find("basearch");
     if (it == variables.end()) {
-        const char * base_arch = get_base_arch(variables["arch"].value.c_str());
+        const char * base_arch = get_base_arch(arch_value);
         if (base_arch) {
             variables.insert({"basearch", {base_arch, Priority::AUTO}});
         }
     } else if (it->second.priority <= Priority::AUTO) {
-        const char * base_arch = get_base_arch(variables["arch"].value.c_str());
+        const char * base_arch = get_base_arch(arch_value);
         if (base_arch) {
             it->second.value = base_arch;
             it->second.priority = Priority::AUTO;
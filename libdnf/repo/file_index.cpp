@@ -0,0 +1,355 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "file_index.hpp"
+
+#include "utils/fs/binary_io.hpp"
+#include "utils/fs/file.hpp"
+#include "utils/fs/temp.hpp"
+
+extern "C" {
+#include <solv/knownid.h>
+}
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+
+namespace libdnf::repo {
+
+namespace fs = libdnf::utils::fs;
+
+
+namespace {
+
+/// Splits `path` after its last '/' into a directory and a basename.
+std::pair<std::string_view, std::string_view> split_path(std::string_view path) {
+    const auto dir_len = path.rfind('/') + 1;  // 0 if there is no '/'
+    return {path.substr(0, dir_len), path.substr(dir_len)};
+}
+
+
+/// Returns the first index in range [first, last) for which `pred` is `false`.
+/// The indexes for which `pred` is `true` must precede all the others.
+template <typename Pred>
+std::size_t partition_point(std::size_t first, std::size_t last, Pred pred) {
+    auto count = last - first;
+    while (count > 0) {
+        const auto step = count / 2;
+        const auto mid = first + step;
+        if (pred(mid)) {
+            first = mid + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+
+/// Collects distinct strings and assigns them temporary ids in the order of insertion.
+class StringCollector {
+public:
+    uint32_t add(std::string_view value) {
+        auto [it, inserted] = ids.try_emplace(std::string(value), static_cast<uint32_t>(ids.size()));
+        return it->second;
+    }
+
+    std::size_t size() const noexcept { return ids.size(); }
+
+    /// Writes the sorted strings to `chars` and `offsets`. Returns the sorted index of each temporary id.
+    std::vector<uint32_t> sort(std::vector<char> & chars, std::vector<uint32_t> & offsets) const {
+        std::vector<const std::pair<const std::string, uint32_t> *> sorted;
+        sorted.reserve(ids.size());
+        for (const auto & item : ids) {
+            sorted.push_back(&item);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const auto * lhs, const auto * rhs) {
+            return lhs->first < rhs->first;
+        });
+
+        std::vector<uint32_t> sorted_indexes(ids.size());
+        offsets.clear();
+        offsets.reserve(ids.size() + 1);
+        chars.clear();
+        for (std::size_t idx = 0; idx < sorted.size(); ++idx) {
+            offsets.push_back(static_cast<uint32_t>(chars.size()));
+            chars.insert(chars.end(), sorted[idx]->first.begin(), sorted[idx]->first.end());
+            sorted_indexes[sorted[idx]->second] = static_cast<uint32_t>(idx);
+        }
+        offsets.push_back(static_cast<uint32_t>(chars.size()));
+        return sorted_indexes;
+    }
+
+private:
+    std::unordered_map<std::string, uint32_t> ids;
+};
+
+
+/// Checks that `offsets` has `count` + 1 non-decreasing items from 0 to `end`.
+bool valid_offsets(const std::vector<uint32_t> & offsets, std::size_t count, std::size_t end) {
+    return offsets.size() == count + 1 && offsets.front() == 0 && offsets.back() == end &&
+           std::is_sorted(offsets.begin(), offsets.end());
+}
+
+}  // namespace
+
+
+std::size_t FileIndex::StringTable::lower_bound(std::string_view value) const {
+    return partition_point(0, size(), [this, value](std::size_t idx) { return get(idx) < value; });
+}
+
+
+std::pair<std::size_t, std::size_t> FileIndex::StringTable::prefix_range(std::string_view prefix) const {
+    const auto first = lower_bound(prefix);
+    const auto last = partition_point(
+        first, size(), [this, prefix](std::size_t idx) { return get(idx).substr(0, prefix.size()) == prefix; });
+    return {first, last};
+}
+
+
+void FileIndex::build(solv::Pool & pool, ::Repo * repo, Id start, Id end) {
+    StringCollector dir_collector;
+    StringCollector basename_collector;
+    std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> entries;
+
+    Dataiterator di;
+    dataiterator_init(&di, *pool, repo, 0, SOLVABLE_FILELIST, nullptr, SEARCH_FILES | SEARCH_COMPLETE_FILELIST);
+    while (dataiterator_step(&di) != 0) {
+        if (di.solvid < start || di.solvid >= end || !pool.is_package(di.solvid)) {
+            continue;
+        }
+        const auto [dir, basename] = split_path(di.kv.str);
+        entries.emplace_back(
+            dir_collector.add(dir), basename_collector.add(basename), static_cast<uint32_t>(di.solvid - start));
+    }
+    dataiterator_free(&di);
+
+    dirs = StringTable();
+    basenames = StringTable();
+    const auto dir_indexes = dir_collector.sort(dirs.chars, dirs.offsets);
+    const auto basename_indexes = basename_collector.sort(basenames.chars, basenames.offsets);
+    for (auto & [dir, basename, solvable] : entries) {
+        dir = dir_indexes[dir];
+        basename = basename_indexes[basename];
+    }
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+    dir_first_entry.assign(dirs.size() + 1, 0);
+    entry_basenames.clear();
+    entry_basenames.reserve(entries.size());
+    entry_solvables.clear();
+    entry_solvables.reserve(entries.size());
+    for (const auto & [dir, basename, solvable] : entries) {
+        ++dir_first_entry[dir + 1];
+        entry_basenames.push_back(basename);
+        entry_solvables.push_back(solvable);
+    }
+    // turn the counts of entries of the directories into the offsets of their first entries
+    for (std::size_t idx = 1; idx < dir_first_entry.size(); ++idx) {
+        dir_first_entry[idx] += dir_first_entry[idx - 1];
+    }
+
+    indexed_start = start;
+    indexed_end = end;
+}
+
+
+void FileIndex::add_entries(std::size_t first, std::size_t last, libdnf::solv::SolvMap & result) const {
+    for (std::size_t idx = first; idx < last; ++idx) {
+        result.add_unsafe(indexed_start + static_cast<Id>(entry_solvables[idx]));
+    }
+}
+
+
+std::pair<std::size_t, std::size_t> FileIndex::find_entries(
+    std::size_t dir_idx, std::size_t first_basename, std::size_t last_basename) const {
+    const std::size_t dir_first = dir_first_entry[dir_idx];
+    const std::size_t dir_last = dir_first_entry[dir_idx + 1];
+    const auto first = partition_point(
+        dir_first, dir_last, [this, first_basename](std::size_t idx) { return entry_basenames[idx] < first_basename; });
+    const auto last = partition_point(
+        first, dir_last, [this, last_basename](std::size_t idx) { return entry_basenames[idx] < last_basename; });
+    return {first, last};
+}
+
+
+void FileIndex::add_matches(std::string_view path, libdnf::solv::SolvMap & matches) const {
+    const auto [dir, basename] = split_path(path);
+    const auto dir_idx = dirs.lower_bound(dir);
+    if (dir_idx == dirs.size() || dirs.get(dir_idx) != dir) {
+        return;
+    }
+    const auto basename_idx = basenames.lower_bound(basename);
+    if (basename_idx == basenames.size() || basenames.get(basename_idx) != basename) {
+        return;
+    }
+    const auto [first, last] = find_entries(dir_idx, basename_idx, basename_idx + 1);
+    add_entries(first, last, matches);
+}
+
+
+bool FileIndex::add_glob_candidates(std::string_view pattern, libdnf::solv::SolvMap & candidates) const {
+    // The wildcards match also '/', the prefix is the only part of the pattern that narrows the paths
+    const auto prefix = pattern.substr(0, pattern.find_first_of("*?[\\"));
+    if (prefix.empty() || prefix == "/") {
+        return false;
+    }
+
+    // A path starts with the prefix if it is in the directory of the prefix and its basename starts with
+    // the rest of the prefix, or if its directory starts with the whole prefix.
+    const auto [prefix_dir, prefix_basename] = split_path(prefix);
+    const auto dir_idx = dirs.lower_bound(prefix_dir);
+    if (dir_idx < dirs.size() && dirs.get(dir_idx) == prefix_dir) {
+        const auto [first_basename, last_basename] = basenames.prefix_range(prefix_basename);
+        const auto [first, last] = find_entries(dir_idx, first_basename, last_basename);
+        add_entries(first, last, candidates);
+    }
+
+    const auto [first_dir, last_dir] = dirs.prefix_range(prefix);
+    add_entries(dir_first_entry[first_dir], dir_first_entry[last_dir], candidates);
+    return true;
+}
+
+
+void FileIndex::write(
+    const std::filesystem::path & path, const unsigned char * checksum, std::size_t checksum_len) const {
+    const auto parent_dir = path.parent_path();
+    std::filesystem::create_directory(parent_dir);
+
+    auto tmp_file = fs::TempFile(parent_dir, path.filename());
+    auto & file = tmp_file.open_as_file("w+");
+
+    // The index is a local cache, integers are stored in native byte order.
+    file.write(FILE_INDEX_MAGIC.data(), FILE_INDEX_MAGIC.size());
+    file.write(FILE_INDEX_VERSION.data(), FILE_INDEX_VERSION.size());
+    fs::write_u32(file, static_cast<uint32_t>(checksum_len));
+    file.write(checksum, checksum_len);
+    fs::write_u32(file, static_cast<uint32_t>(indexed_end - indexed_start));
+    for (const auto * table : {&dirs, &basenames}) {
+        fs::write_u32(file, static_cast<uint32_t>(table->size()));
+        fs::write_u32(file, static_cast<uint32_t>(table->chars.size()));
+        fs::write_vector(file, table->offsets);
+        fs::write_vector(file, table->chars);
+    }
+    fs::write_u32(file, static_cast<uint32_t>(entry_solvables.size()));
+    fs::write_vector(file, dir_first_entry);
+    fs::write_vector(file, entry_basenames);
+    fs::write_vector(file, entry_solvables);
+
+    tmp_file.close();
+    std::filesystem::rename(tmp_file.get_path(), path);
+    tmp_file.release();
+}
+
+
+bool FileIndex::load(
+    const std::filesystem::path & path,
+    const unsigned char * checksum,
+    std::size_t checksum_len,
+    Id start,
+    Id end) {
+    if (!std::filesystem::exists(path)) {
+        return false;
+    }
+    const auto file_size = std::filesystem::file_size(path);
+    fs::File file(path, "r");
+
+    std::array<char, FILE_INDEX_MAGIC.size()> magic;
+    std::array<char, FILE_INDEX_VERSION.size()> version;
+    if (!fs::read_exact(file, magic.data(), magic.size()) || magic != FILE_INDEX_MAGIC ||
+        !fs::read_exact(file, version.data(), version.size()) || version != FILE_INDEX_VERSION) {
+        return false;
+    }
+
+    uint32_t stored_checksum_len;
+    if (!fs::read_u32(file, stored_checksum_len) || stored_checksum_len != checksum_len) {
+        return false;
+    }
+    std::vector<unsigned char> stored_checksum;
+    if (!fs::read_vector(file, stored_checksum, checksum_len) ||
+        memcmp(stored_checksum.data(), checksum, checksum_len) != 0) {
+        return false;
+    }
+
+    uint32_t nsolvables;
+    if (!fs::read_u32(file, nsolvables) || nsolvables != static_cast<uint32_t>(end - start)) {
+        return false;
+    }
+
+    std::array<StringTable, 2> tables;
+    for (auto & table : tables) {
+        uint32_t nstrings;
+        uint32_t nchars;
+        if (!fs::read_u32(file, nstrings) || !fs::read_u32(file, nchars)) {
+            return false;
+        }
+        // guard against allocating nonsense sizes from a damaged file
+        if (static_cast<uintmax_t>(nstrings) * sizeof(uint32_t) + nchars > file_size) {
+            return false;
+        }
+        if (!fs::read_vector(file, table.offsets, nstrings + 1) || !fs::read_vector(file, table.chars, nchars) ||
+            !valid_offsets(table.offsets, nstrings, nchars)) {
+            return false;
+        }
+    }
+    auto & [loaded_dirs, loaded_basenames] = tables;
+
+    uint32_t nentries;
+    if (!fs::read_u32(file, nentries) || static_cast<uintmax_t>(nentries) * 2 * sizeof(uint32_t) > file_size) {
+        return false;
+    }
+    std::vector<uint32_t> loaded_dir_first_entry;
+    std::vector<uint32_t> loaded_entry_basenames;
+    std::vector<uint32_t> loaded_entry_solvables;
+    if (!fs::read_vector(file, loaded_dir_first_entry, loaded_dirs.size() + 1) ||
+        !fs::read_vector(file, loaded_entry_basenames, nentries) ||
+        !fs::read_vector(file, loaded_entry_solvables, nentries) ||
+        !valid_offsets(loaded_dir_first_entry, loaded_dirs.size(), nentries)) {
+        return false;
+    }
+    // the values are used as indexes, out of range ones would access memory outside of the tables and maps
+    const auto nbasenames = loaded_basenames.size();
+    if (std::any_of(
+            loaded_entry_basenames.begin(),
+            loaded_entry_basenames.end(),
+            [nbasenames](uint32_t basename) { return basename >= nbasenames; }) ||
+        std::any_of(
+            loaded_entry_solvables.begin(),
+            loaded_entry_solvables.end(),
+            [nsolvables](uint32_t solvable) { return solvable >= nsolvables; })) {
+        return false;
+    }
+
+    dirs = std::move(loaded_dirs);
+    basenames = std::move(loaded_basenames);
+    dir_first_entry = std::move(loaded_dir_first_entry);
+    entry_basenames = std::move(loaded_entry_basenames);
+    entry_solvables = std::move(loaded_entry_solvables);
+    indexed_start = start;
+    indexed_end = end;
+    return true;
+}
+
+}  // namespace libdnf::repo
@@ -0,0 +1,119 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF_REPO_FILE_INDEX_HPP
+#define LIBDNF_REPO_FILE_INDEX_HPP
+
+#include "solv/pool.hpp"
+#include "solv/solv_map.hpp"
+
+#include <solv/repo.h>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+namespace libdnf::repo {
+
+static const constexpr std::array<char, 4> FILE_INDEX_MAGIC{'\0', 'd', 'f', 'i'};
+static const constexpr std::array<char, 4> FILE_INDEX_VERSION{'\0', '1', '.', '0'};
+
+
+/// Index of the file paths of the packages of a single repository.
+///
+/// A path is split after its last '/' into a directory (with the trailing '/') and a basename. Both
+/// are stored in sorted tables of distinct strings and the paths are referenced by their indexes.
+/// The entries (directory, basename, solvable) are sorted, so a path is found by a binary search of
+/// the directory and the basename in the tables and of the basename in the entries of the directory.
+/// A glob is looked up by its literal prefix: the directories starting with the prefix form
+/// a continuous range of the directory table and, within the directory of the prefix, the basenames
+/// starting with the rest of the prefix form a continuous range of the basename table.
+class FileIndex {
+public:
+    /// Indexes files of package solvables of `repo` in range [start, end).
+    /// The files are read the same way as by the file filters of PackageQuery.
+    void build(solv::Pool & pool, ::Repo * repo, Id start, Id end);
+
+    /// Loads the index from a cache file written by `write()`.
+    /// @return `false` if the file is missing or was written for different metadata.
+    bool load(
+        const std::filesystem::path & path,
+        const unsigned char * checksum,
+        std::size_t checksum_len,
+        Id start,
+        Id end);
+
+    /// Writes the index to `path`. The `checksum` identifies the repository metadata the index was built from.
+    void write(const std::filesystem::path & path, const unsigned char * checksum, std::size_t checksum_len) const;
+
+    /// Adds to `matches` the indexed solvables containing the file `path`. The result is exact.
+    void add_matches(std::string_view path, libdnf::solv::SolvMap & matches) const;
+
+    /// Adds to `candidates` the indexed solvables containing a file which may match the glob `pattern`
+    /// (fnmatch() without flags). The result is a superset of the matching solvables.
+    /// @return `false` if the pattern has no usable literal prefix, `candidates` are untouched then.
+    bool add_glob_candidates(std::string_view pattern, libdnf::solv::SolvMap & candidates) const;
+
+    /// Returns `true` if the index covers exactly the solvables in range [start, end).
+    bool covers(Id start, Id end) const noexcept { return indexed_start == start && indexed_end == end; }
+
+    /// Returns `true` if solvable `id` is in the indexed range.
+    bool is_indexed(Id id) const noexcept { return id >= indexed_start && id < indexed_end; }
+
+private:
+    /// Sorted table of distinct strings.
+    struct StringTable {
+        std::vector<char> chars;
+        std::vector<uint32_t> offsets;  // offsets of the strings in `chars`, size() + 1 items
+
+        std::size_t size() const noexcept { return offsets.empty() ? 0 : offsets.size() - 1; }
+        std::string_view get(std::size_t idx) const noexcept {
+            return std::string_view(chars.data() + offsets[idx], offsets[idx + 1] - offsets[idx]);
+        }
+
+        /// Returns the index of the first string not less than `value`.
+        std::size_t lower_bound(std::string_view value) const;
+
+        /// Returns the range of indexes of the strings starting with `prefix`.
+        std::pair<std::size_t, std::size_t> prefix_range(std::string_view prefix) const;
+    };
+
+    /// Adds solvables of entries in range [first, last) to `result`.
+    void add_entries(std::size_t first, std::size_t last, libdnf::solv::SolvMap & result) const;
+
+    /// Returns the range of entries of directory `dir_idx` with basenames in range [first_basename, last_basename).
+    std::pair<std::size_t, std::size_t> find_entries(
+        std::size_t dir_idx, std::size_t first_basename, std::size_t last_basename) const;
+
+    StringTable dirs;
+    StringTable basenames;
+    std::vector<uint32_t> dir_first_entry;  // the first entry of each directory, dirs.size() + 1 items
+    std::vector<uint32_t> entry_basenames;  // basename of each entry
+    std::vector<uint32_t> entry_solvables;  // solvable - indexed_start of each entry
+    Id indexed_start{0};
+    Id indexed_end{0};
+};
+
+}  // namespace libdnf::repo
+
+#endif  // LIBDNF_REPO_FILE_INDEX_HPP
@@ -0,0 +1,209 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "mirror_stats.hpp"
+
+#include "utils/fs/file.hpp"
+#include "utils/fs/temp.hpp"
+
+#include "libdnf/base/base.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+
+namespace libdnf::repo {
+
+namespace fs = libdnf::utils::fs;
+
+namespace {
+
+constexpr const char * MIRROR_STATS_HEADER = "# dnf mirror statistics 1";
+
+// Weight of a new throughput sample of a download of at least MIRROR_FULL_WEIGHT_BYTES.
+constexpr double MIRROR_THROUGHPUT_ALPHA = 0.3;
+constexpr double MIRROR_FULL_WEIGHT_BYTES = 1024.0 * 1024.0;
+
+// Shortest duration of a measured transfer, shorter ones are rounded up to it.
+constexpr double MIRROR_MIN_TRANSFER_SECONDS = 0.001;
+
+// The success and failure counts are halved when their sum reaches the limit.
+constexpr uint64_t MIRROR_MAX_RESULTS = 100;
+
+// Mirrors unused for this time are not saved.
+constexpr int64_t MIRROR_MAX_AGE_SECONDS = 90 * 24 * 60 * 60;
+
+
+int64_t now_seconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+}  // namespace
+
+
+MirrorStats::MirrorStats(const BaseWeakPtr & base) : base(base) {}
+
+
+void MirrorStats::load() {
+    mirrors.clear();
+
+    const auto path = get_path();
+    if (!std::filesystem::exists(path)) {
+        return;
+    }
+
+    try {
+        fs::File file(path, "r");
+        std::string line;
+        if (!file.read_line(line) || line != MIRROR_STATS_HEADER) {
+            base->get_logger()->debug("Ignoring mirror statistics file \"{}\" of unknown format", path.native());
+            return;
+        }
+
+        // <throughput> <successes> <failures> <last_used> <url>
+        while (file.read_line(line)) {
+            std::istringstream fields(line);
+            Mirror mirror;
+            std::string url;
+            if (fields >> mirror.throughput >> mirror.successes >> mirror.failures >> mirror.last_used >> url) {
+                mirrors.insert_or_assign(std::move(url), mirror);
+            }
+        }
+    } catch (const std::exception & ex) {
+        base->get_logger()->debug("Cannot read mirror statistics file \"{}\": {}", path.native(), ex.what());
+        mirrors.clear();
+    }
+}
+
+
+void MirrorStats::save() const {
+    const auto path = get_path();
+    try {
+        const auto dir = path.parent_path();
+        std::filesystem::create_directories(dir);
+
+        auto tmp_file = fs::TempFile(dir, path.filename());
+        auto & file = tmp_file.open_as_file("w+");
+
+        file.write(MIRROR_STATS_HEADER);
+        file.putc('\n');
+        const auto oldest = now_seconds() - MIRROR_MAX_AGE_SECONDS;
+        for (const auto & [url, mirror] : mirrors) {
+            if (mirror.last_used < oldest) {
+                continue;
+            }
+            file.write(fmt::format(
+                "{:.0f} {} {} {} {}\n", mirror.throughput, mirror.successes, mirror.failures, mirror.last_used, url));
+        }
+
+        tmp_file.close();
+        std::filesystem::rename(tmp_file.get_path(), path);
+        tmp_file.release();
+    } catch (const std::exception & ex) {
+        base->get_logger()->warning("Cannot write mirror statistics file \"{}\": {}", path.native(), ex.what());
+    }
+}
+
+
+void MirrorStats::add_transfer(const std::string & mirror, uint64_t bytes, double seconds) {
+    if (bytes == 0) {
+        return;
+    }
+    auto & stats = get_or_create(mirror);
+    const double throughput = static_cast<double>(bytes) / std::max(seconds, MIRROR_MIN_TRANSFER_SECONDS);
+    if (stats.throughput <= 0) {
+        stats.throughput = throughput;
+    } else {
+        const double weight = std::min(static_cast<double>(bytes) / MIRROR_FULL_WEIGHT_BYTES, 1.0);
+        stats.throughput += MIRROR_THROUGHPUT_ALPHA * weight * (throughput - stats.throughput);
+    }
+}
+
+
+void MirrorStats::add_result(const std::string & mirror, bool success) {
+    auto & stats = get_or_create(mirror);
+    if (success) {
+        ++stats.successes;
+    } else {
+        ++stats.failures;
+    }
+    if (stats.successes + stats.failures >= MIRROR_MAX_RESULTS) {
+        stats.successes /= 2;
+        stats.failures /= 2;
+    }
+}
+
+
+double MirrorStats::get_throughput(const std::string & mirror) const {
+    auto * stats = get(mirror);
+    return stats && stats->throughput > 0 ? stats->throughput : MIRROR_UNKNOWN_THROUGHPUT;
+}
+
+
+double MirrorStats::get_score(const std::string & mirror) const {
+    double success_rate = 1.0;
+    if (auto * stats = get(mirror)) {
+        success_rate = static_cast<double>(stats->successes + 1) /
+                       static_cast<double>(stats->successes + stats->failures + 1);
+    }
+    return get_throughput(mirror) * success_rate;
+}
+
+
+std::vector<std::string> MirrorStats::rank(const std::vector<std::string> & mirrors) const {
+    std::vector<std::pair<double, std::string>> scored;
+    scored.reserve(mirrors.size());
+    for (const auto & mirror : mirrors) {
+        scored.emplace_back(get_score(mirror), mirror);
+    }
+    std::stable_sort(scored.begin(), scored.end(), [](const auto & lhs, const auto & rhs) {
+        return lhs.first > rhs.first;
+    });
+
+    std::vector<std::string> ranked;
+    ranked.reserve(scored.size());
+    for (auto & item : scored) {
+        ranked.push_back(std::move(item.second));
+    }
+    return ranked;
+}
+
+
+const MirrorStats::Mirror * MirrorStats::get(const std::string & mirror) const {
+    auto it = mirrors.find(mirror);
+    return it == mirrors.end() ? nullptr : &it->second;
+}
+
+
+MirrorStats::Mirror & MirrorStats::get_or_create(const std::string & mirror) {
+    auto & stats = mirrors[mirror];
+    stats.last_used = now_seconds();
+    return stats;
+}
+
+
+std::filesystem::path MirrorStats::get_path() const {
+    return std::filesystem::path(base->get_config().cachedir().get_value()) / MIRROR_STATS_FILENAME;
+}
+
+}  // namespace libdnf::repo
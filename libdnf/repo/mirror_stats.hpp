@@ -0,0 +1,95 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF_REPO_MIRROR_STATS_HPP
+#define LIBDNF_REPO_MIRROR_STATS_HPP
+
+#include "libdnf/base/base_weak.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace libdnf::repo {
+
+constexpr const char * MIRROR_STATS_FILENAME = "mirror-stats";
+
+/// Expected throughput of a mirror without measured downloads in bytes per second. It is optimistic,
+/// so that new mirrors are used and measured.
+constexpr double MIRROR_UNKNOWN_THROUGHPUT = 1024.0 * 1024.0;
+
+
+/// Persistent statistics of the package downloads from mirrors, stored in the cachedir.
+///
+/// The throughput of a mirror is an exponentially weighted moving average of the throughputs
+/// of the downloads from it, so it follows the changes of the mirror speed. Small downloads are
+/// dominated by the latency and affect the average less. The success and failure counts are halved
+/// when they grow large, so recent results weigh more.
+class MirrorStats {
+public:
+    struct Mirror {
+        /// Bytes per second, 0 if not measured yet.
+        double throughput{0};
+        uint64_t successes{0};
+        uint64_t failures{0};
+        /// Last update, seconds since the epoch.
+        int64_t last_used{0};
+    };
+
+    explicit MirrorStats(const BaseWeakPtr & base);
+
+    /// Loads the statistics from the cache file. A missing or damaged file gives empty statistics.
+    void load();
+
+    /// Writes the statistics to the cache file. Mirrors unused for a long time are dropped.
+    /// The statistics are best effort, errors are only logged.
+    void save() const;
+
+    /// Adds a transfer of `bytes` from `mirror` which took `seconds` to the throughput of the mirror.
+    void add_transfer(const std::string & mirror, uint64_t bytes, double seconds);
+
+    /// Counts a successful or failed download from `mirror`.
+    void add_result(const std::string & mirror, bool success);
+
+    /// @return The expected throughput of `mirror` in bytes per second.
+    double get_throughput(const std::string & mirror) const;
+
+    /// @return The expected throughput of `mirror` weighted by its success rate. Higher is better.
+    double get_score(const std::string & mirror) const;
+
+    /// @return `mirrors` ordered by the score, the best first. Mirrors with the same score keep their order.
+    std::vector<std::string> rank(const std::vector<std::string> & mirrors) const;
+
+    /// @return The statistics of `mirror` or nullptr if there are none.
+    const Mirror * get(const std::string & mirror) const;
+
+private:
+    std::filesystem::path get_path() const;
+    Mirror & get_or_create(const std::string & mirror);
+
+    BaseWeakPtr base;
+    std::map<std::string, Mirror> mirrors;
+};
+
+}  // namespace libdnf::repo
+
+#endif  // LIBDNF_REPO_MIRROR_STATS_HPP
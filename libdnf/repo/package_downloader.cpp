@@ -19,6 +19,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libdnf/repo/package_downloader.hpp"
 
+#include "mirror_stats.hpp"
 #include "repo_downloader.hpp"
 #include "utils/bgettext/bgettext-mark-domain.h"
 
@@ -29,7 +30,12 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <librepo/librepo.h>
 
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
 
 
 namespace std {
@@ -44,6 +50,22 @@ struct default_delete<LrPackageTarget> {
 
 namespace libdnf::repo {
 
+// A transfer running for at least SLOW_TRANSFER_MIN_SECONDS is aborted and the package is downloaded
+// from another mirror when its rate is below SLOW_TRANSFER_RATIO of the expected throughput of that mirror.
+constexpr double SLOW_TRANSFER_MIN_SECONDS = 2.0;
+constexpr double SLOW_TRANSFER_RATIO = 0.1;
+
+
+// State of a single download() shared by the callbacks of all its targets.
+struct DownloadState {
+    explicit DownloadState(const BaseWeakPtr & base, bool fail_fast) : stats(base), fail_fast(fail_fast) {}
+
+    MirrorStats stats;
+    bool fail_fast;
+    bool failed{false};  // a package failed to download from all of its mirrors
+};
+
+
 class PackageTarget {
 public:
     PackageTarget(const libdnf::rpm::Package & package, const std::string & destination, void * user_data)
@@ -51,27 +73,155 @@ public:
           destination(destination),
           user_data(user_data) {}
 
+    /// Returns the best mirror the package was not tried from, or nullptr if there is none.
+    const std::string * get_untried_mirror() const {
+        for (const auto & candidate : mirrors) {
+            if (std::find(tried_mirrors.begin(), tried_mirrors.end(), candidate) == tried_mirrors.end()) {
+                return &candidate;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Starts a new download attempt from `new_mirror`.
+    void start_attempt(const std::string & new_mirror) {
+        mirror = new_mirror;
+        tried_mirrors.push_back(new_mirror);
+        started = false;
+        slow = false;
+        retry = false;
+    }
+
     libdnf::rpm::Package package;
     std::string destination;
     void * user_data;
     void * user_cb_data{nullptr};
+
+    DownloadState * state{nullptr};
+
+    // Mirrors of the package repository ordered by their score, empty if librepo selects the mirrors
+    std::vector<std::string> mirrors;
+    std::vector<std::string> tried_mirrors;
+
+    // The current download attempt
+    std::string mirror;  // empty if librepo selects the mirror
+    std::chrono::steady_clock::time_point start_time;
+    bool started{false};
+    bool slow{false};   // aborted as too slow
+    bool retry{false};  // download again from an untried mirror
 };
 
+
+// Returns `true` if the transfer of `package_target` is so slow that the package should be downloaded
+// from another mirror.
+static bool is_transfer_slow(PackageTarget & package_target, double total_to_download, double downloaded) {
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - package_target.start_time;
+    if (elapsed.count() < SLOW_TRANSFER_MIN_SECONDS) {
+        return false;
+    }
+    const auto * next_mirror = package_target.get_untried_mirror();
+    if (!next_mirror) {
+        return false;
+    }
+
+    const double rate = downloaded / elapsed.count();
+    const double total = total_to_download > 0 ? total_to_download
+                                               : static_cast<double>(package_target.package.get_package_size());
+    if (rate > 0 && (total - downloaded) / rate < SLOW_TRANSFER_MIN_SECONDS) {
+        // almost done
+        return false;
+    }
+    // Only a measured throughput shows that the other mirror would be faster, the throughput
+    // of an unknown mirror is just a guess.
+    const auto * next_mirror_stats = package_target.state->stats.get(*next_mirror);
+    if (!next_mirror_stats || next_mirror_stats->throughput <= 0) {
+        return false;
+    }
+    return rate < SLOW_TRANSFER_RATIO * next_mirror_stats->throughput;
+}
+
+
 static int end_callback(void * data, LrTransferStatus status, const char * msg) {
     libdnf_assert(data != nullptr, "data in callback must be set");
 
     auto * package_target = static_cast<PackageTarget *>(data);
     auto cb_status = static_cast<DownloadCallbacks::TransferStatus>(status);
-    if (auto * download_callbacks = package_target->package.get_base()->get_download_callbacks()) {
-        return download_callbacks->end(package_target->user_cb_data, cb_status, msg);
+    auto & metrics = *package_target->package.get_base()->get_metrics();
+    auto * download_callbacks = package_target->package.get_base()->get_download_callbacks();
+
+    if (!package_target->mirror.empty()) {
+        auto & stats = package_target->state->stats;
+        if (status == LR_TRANSFER_SUCCESSFUL) {
+            if (package_target->started) {
+                const std::chrono::duration<double> elapsed =
+                    std::chrono::steady_clock::now() - package_target->start_time;
+                stats.add_transfer(package_target->mirror, package_target->package.get_package_size(), elapsed.count());
+            }
+            stats.add_result(package_target->mirror, true);
+        } else if (status == LR_TRANSFER_ERROR) {
+            if (!package_target->slow) {
+                stats.add_result(package_target->mirror, false);
+            }
+            if (package_target->get_untried_mirror()) {
+                // not the final result, report it as a mirror failure and download from another mirror
+                package_target->retry = true;
+                metrics.add_counter("download.mirror_retries", 1);
+                if (download_callbacks) {
+                    download_callbacks->mirror_failure(
+                        package_target->user_cb_data, msg, package_target->mirror.c_str());
+                }
+                return LR_CB_OK;
+            }
+        }
     }
-    return 0;
+
+    switch (status) {
+        case LR_TRANSFER_SUCCESSFUL:
+            metrics.add_counter("download.packages", 1);
+            metrics.add_counter("download.bytes", static_cast<int64_t>(package_target->package.get_package_size()));
+            break;
+        case LR_TRANSFER_ALREADYEXISTS:
+            metrics.add_counter("download.packages_cached", 1);
+            break;
+        case LR_TRANSFER_ERROR:
+            metrics.add_counter("download.errors", 1);
+            break;
+    }
+
+    int ret = 0;
+    if (download_callbacks) {
+        ret = download_callbacks->end(package_target->user_cb_data, cb_status, msg);
+    }
+
+    // Downloads from selected mirrors are not run with LR_PACKAGEDOWNLOAD_FAILFAST, a failure
+    // of a single mirror must not stop them. Fail fast when the package failed on all the mirrors.
+    if (status == LR_TRANSFER_ERROR && !package_target->mirror.empty() && package_target->state->fail_fast) {
+        package_target->state->failed = true;
+        return LR_CB_ERROR;
+    }
+    return ret;
 }
 
 static int progress_callback(void * data, double total_to_download, double downloaded) {
     libdnf_assert(data != nullptr, "data in callback must be set");
 
     auto * package_target = static_cast<PackageTarget *>(data);
+
+    if (!package_target->mirror.empty()) {
+        if (!package_target->started) {
+            package_target->started = true;
+            package_target->start_time = std::chrono::steady_clock::now();
+        } else if (is_transfer_slow(*package_target, total_to_download, downloaded)) {
+            const std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - package_target->start_time;
+            package_target->state->stats.add_transfer(
+                package_target->mirror, static_cast<uint64_t>(downloaded), elapsed.count());
+            package_target->slow = true;
+            package_target->package.get_base()->get_metrics()->add_counter("download.slow_transfers", 1);
+            return LR_CB_ABORT;
+        }
+    }
+
     if (auto * download_callbacks = package_target->package.get_base()->get_download_callbacks()) {
         return download_callbacks->progress(package_target->user_cb_data, total_to_download, downloaded);
     }
@@ -91,6 +241,66 @@ static int mirror_failure_callback(void * data, const char * msg, const char * u
 
 class PackageDownloader::Impl {
     friend PackageDownloader;
+
+    // Spreads the targets across the best `max_mirrors` mirrors of their repositories. A target is assigned
+    // to the mirror which would finish all the bytes assigned to it first, and it is retried only from
+    // the other selected mirrors. Targets of repositories with a single mirror and packages with their own
+    // base URL are left to librepo. The statistics are loaded only when there are mirrors to rank.
+    // Returns `true` if some targets were assigned to a mirror.
+    bool select_mirrors(MirrorStats & stats, std::size_t max_mirrors) {
+        if (max_mirrors < 2) {
+            return false;
+        }
+
+        bool stats_loaded = false;
+        bool selected = false;
+        std::map<std::string, std::vector<std::string>> repo_mirrors;
+        std::map<std::string, double> assigned_bytes;
+        for (auto & target : targets) {
+            if (!target.package.get_baseurl().empty()) {
+                continue;
+            }
+
+            auto repo = target.package.get_repo();
+            auto [it, inserted] = repo_mirrors.try_emplace(repo->get_id());
+            if (inserted && repo->downloader) {
+                auto all_mirrors = repo->downloader->get_mirrors();
+                if (all_mirrors.size() >= 2) {
+                    if (!stats_loaded) {
+                        stats.load();
+                        stats_loaded = true;
+                    }
+                    it->second = stats.rank(all_mirrors);
+                    if (it->second.size() > max_mirrors) {
+                        it->second.resize(max_mirrors);
+                    }
+                }
+            }
+            const auto & mirrors = it->second;
+            if (mirrors.size() < 2) {
+                continue;
+            }
+
+            const auto size = static_cast<double>(target.package.get_package_size());
+            const std::string * best = nullptr;
+            double best_finish = 0;
+            for (const auto & mirror : mirrors) {
+                const double finish = (assigned_bytes[mirror] + size) / stats.get_throughput(mirror);
+                if (!best || finish < best_finish) {
+                    best = &mirror;
+                    best_finish = finish;
+                }
+            }
+            assigned_bytes[*best] += size;
+
+            target.mirrors = mirrors;
+            target.start_attempt(*best);
+            selected = true;
+        }
+
+        return selected;
+    }
+
     std::vector<PackageTarget> targets;
 };
 
@@ -112,8 +322,15 @@ void PackageDownloader::add(const libdnf::rpm::Package & package, const std::str
 void PackageDownloader::download(bool fail_fast, bool resume) try {
     GError * err{nullptr};
 
-    std::vector<std::unique_ptr<LrPackageTarget>> lr_targets;
-    lr_targets.reserve(p_impl->targets.size());
+    if (p_impl->targets.empty()) {
+        return;
+    }
+
+    auto base = p_impl->targets.front().package.get_base();
+    libdnf::base::Metrics::Span download_span(*base->get_metrics(), "download.packages");
+
+    DownloadState state(base, fail_fast);
+
     for (auto & pkg_target : p_impl->targets) {
         std::filesystem::create_directory(pkg_target.destination);
 
@@ -124,44 +341,99 @@ void PackageDownloader::download(bool fail_fast, bool resume) try {
                 static_cast<double>(pkg_target.package.get_package_size()));
         }
 
-        auto * lr_target = lr_packagetarget_new_v3(
-            pkg_target.package.get_repo()->downloader->get_cached_handle().get(),
-            pkg_target.package.get_location().c_str(),
-            pkg_target.destination.c_str(),
-            static_cast<LrChecksumType>(pkg_target.package.get_checksum().get_type()),
-            pkg_target.package.get_checksum().get_checksum().c_str(),
-            static_cast<int64_t>(pkg_target.package.get_package_size()),
-            pkg_target.package.get_baseurl().empty() ? nullptr : pkg_target.package.get_baseurl().c_str(),
-            resume,
-            progress_callback,
-            &pkg_target,
-            end_callback,
-            mirror_failure_callback,
-            0,
-            0,
-            &err);
-
-        if (!lr_target) {
-            throw LibrepoError(std::unique_ptr<GError>(err));
-        }
-
-        lr_targets.emplace_back(lr_target);
+        pkg_target.state = &state;
     }
 
-    // Adding items to the end of GSList is slow. We go from the back and add items to the beginning.
-    GSList * list{nullptr};
-    for (auto it = lr_targets.rbegin(); it != lr_targets.rend(); ++it) {
-        list = g_slist_prepend(list, it->get());
+    // the statistics are used and updated only by the downloads from the pinned mirrors
+    const bool mirrors_pinned = p_impl->select_mirrors(state.stats, base->get_config().download_mirrors().get_value());
+
+    // The packages which failed on their mirror are downloaded again from another one in the next round.
+    std::vector<PackageTarget *> round_targets;
+    round_targets.reserve(p_impl->targets.size());
+    for (auto & pkg_target : p_impl->targets) {
+        round_targets.push_back(&pkg_target);
     }
-    std::unique_ptr<GSList, decltype(&g_slist_free)> list_holder(list, &g_slist_free);
 
-    LrPackageDownloadFlag flags = static_cast<LrPackageDownloadFlag>(0);
-    if (fail_fast) {
-        flags = static_cast<LrPackageDownloadFlag>(flags | LR_PACKAGEDOWNLOAD_FAILFAST);
+    try {
+        while (!round_targets.empty()) {
+            bool mirrors_selected = false;
+            std::vector<std::unique_ptr<LrPackageTarget>> lr_targets;
+            lr_targets.reserve(round_targets.size());
+            for (auto * pkg_target : round_targets) {
+                const char * base_url = nullptr;
+                if (!pkg_target->mirror.empty()) {
+                    base_url = pkg_target->mirror.c_str();
+                    mirrors_selected = true;
+                } else if (!pkg_target->package.get_baseurl().empty()) {
+                    base_url = pkg_target->package.get_baseurl().c_str();
+                }
+
+                auto * lr_target = lr_packagetarget_new_v3(
+                    pkg_target->package.get_repo()->downloader->get_cached_handle().get(),
+                    pkg_target->package.get_location().c_str(),
+                    pkg_target->destination.c_str(),
+                    static_cast<LrChecksumType>(pkg_target->package.get_checksum().get_type()),
+                    pkg_target->package.get_checksum().get_checksum().c_str(),
+                    static_cast<int64_t>(pkg_target->package.get_package_size()),
+                    base_url,
+                    resume,
+                    progress_callback,
+                    pkg_target,
+                    end_callback,
+                    mirror_failure_callback,
+                    0,
+                    0,
+                    &err);
+
+                if (!lr_target) {
+                    throw LibrepoError(std::unique_ptr<GError>(err));
+                }
+
+                lr_targets.emplace_back(lr_target);
+            }
+
+            // Adding items to the end of GSList is slow. We go from the back and add items to the beginning.
+            GSList * list{nullptr};
+            for (auto it = lr_targets.rbegin(); it != lr_targets.rend(); ++it) {
+                list = g_slist_prepend(list, it->get());
+            }
+            std::unique_ptr<GSList, decltype(&g_slist_free)> list_holder(list, &g_slist_free);
+
+            LrPackageDownloadFlag flags = static_cast<LrPackageDownloadFlag>(0);
+            if (fail_fast && !mirrors_selected) {
+                flags = static_cast<LrPackageDownloadFlag>(flags | LR_PACKAGEDOWNLOAD_FAILFAST);
+            }
+
+            const bool success = lr_download_packages(list, flags, &err);
+
+            std::vector<PackageTarget *> next_round_targets;
+            for (auto * pkg_target : round_targets) {
+                if (pkg_target->retry) {
+                    pkg_target->start_attempt(*pkg_target->get_untried_mirror());
+                    next_round_targets.push_back(pkg_target);
+                }
+            }
+
+            if (!success) {
+                std::unique_ptr<GError> error(err);
+                err = nullptr;
+                // the errors of the packages downloaded again are not final
+                if (state.failed || next_round_targets.empty()) {
+                    throw LibrepoError(std::move(error));
+                }
+            }
+
+            round_targets = std::move(next_round_targets);
+        }
+    } catch (...) {
+        if (mirrors_pinned) {
+            state.stats.save();
+        }
+        throw;
     }
 
-    if (!lr_download_packages(list, flags, &err)) {
-        throw LibrepoError(std::unique_ptr<GError>(err));
+    if (mirrors_pinned) {
+        state.stats.save();
     }
 } catch (const std::runtime_error & e) {
     throw_with_nested(PackageDownloadError(M_("Failed to download packages")));
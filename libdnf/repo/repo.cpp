@@ -62,6 +62,7 @@ extern "C" {
 #include <iostream>
 #include <list>
 #include <map>
+#include <optional>
 #include <set>
 #include <sstream>
 #include <system_error>
@@ -88,6 +89,21 @@ static int64_t mtime(const char * filename) {
 }
 
 
+// Returns the last write time of the primary metadata file, nullopt if the metadata are not loaded.
+static std::optional<std::filesystem::file_time_type> get_primary_write_time(const RepoDownloader & downloader) {
+    const auto & primary_fn = downloader.get_metadata_path(RepoDownloader::MD_FILENAME_PRIMARY);
+    if (primary_fn.empty()) {
+        return std::nullopt;
+    }
+    std::error_code ec;
+    auto write_time = std::filesystem::last_write_time(primary_fn, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    return write_time;
+}
+
+
 Repo::Repo(const BaseWeakPtr & base, const std::string & id, Repo::Type type)
     : base(base),
       config(base->get_config(), id),
@@ -185,23 +201,43 @@ bool Repo::fetch_metadata() {
             logger.debug("Using cache for repo \"{}\"", config.get_id());
             return false;
         }
+    }
+    if (sync_strategy == SyncStrategy::ONLY_CACHE) {
+        throw RepoError(M_("Cache-only enabled but no cache for repository \"{}\""), config.get_id());
+    }
 
-        if (is_in_sync()) {
-            // the expired metadata still reflect the origin:
-            utimes(downloader->get_metadata_path(RepoDownloader::MD_FILENAME_PRIMARY).c_str(), nullptr);
-            RepoCache(base, config.get_cachedir()).remove_attribute(RepoCache::ATTRIBUTE_EXPIRED);
+    // Only one process refreshes the metadata of the repository, the others wait for the lock and reuse the result.
+    auto cache_dir = config.get_cachedir();
+    auto primary_write_time = get_primary_write_time(*downloader);
+    bool waited;
+    auto lock = lock_repo_cache(logger, std::filesystem::path(cache_dir) / CACHE_METADATA_LOCK, true, waited);
+    if (waited) {
+        try {
+            read_metadata_cache();
+        } catch (const std::runtime_error &) {
+            // no usable cache, the metadata are downloaded below
+        }
+        auto refreshed_write_time = get_primary_write_time(*downloader);
+        if (refreshed_write_time && (!primary_write_time || *refreshed_write_time > *primary_write_time) &&
+            !RepoCache(base, cache_dir).is_attribute(RepoCache::ATTRIBUTE_EXPIRED)) {
+            logger.debug("Using metadata of repo \"{}\" refreshed by another process", config.get_id());
+            timestamp = mtime(downloader->get_metadata_path(RepoDownloader::MD_FILENAME_PRIMARY).c_str());
             expired = false;
             return true;
         }
     }
-    if (sync_strategy == SyncStrategy::ONLY_CACHE) {
-        throw RepoError(M_("Cache-only enabled but no cache for repository \"{}\""), config.get_id());
+
+    if (!downloader->get_metadata_path(RepoDownloader::MD_FILENAME_PRIMARY).empty() && is_in_sync()) {
+        // the expired metadata still reflect the origin:
+        utimes(downloader->get_metadata_path(RepoDownloader::MD_FILENAME_PRIMARY).c_str(), nullptr);
+        RepoCache(base, cache_dir).remove_attribute(RepoCache::ATTRIBUTE_EXPIRED);
+        expired = false;
+        return true;
     }
 
     logger.debug("Downloading metadata for repo \"{}\"", config.get_id());
-    auto cache_dir = config.get_cachedir();
     downloader->download_metadata(cache_dir);
-    RepoCache(base, config.get_cachedir()).remove_attribute(RepoCache::ATTRIBUTE_EXPIRED);
+    RepoCache(base, cache_dir).remove_attribute(RepoCache::ATTRIBUTE_EXPIRED);
     timestamp = -1;
     read_metadata_cache();
 
@@ -232,10 +268,18 @@ void Repo::download_metadata(const std::string & destdir) {
 }
 
 void Repo::load() {
+    load(nullptr);
+}
+
+void Repo::load(const std::shared_ptr<const std::string> & primary_solv) {
     make_solv_repo();
 
     if (type == Type::AVAILABLE) {
-        load_available_repo();
+        // keep the metadata from being refreshed by another process while they are read
+        bool waited;
+        auto lock = lock_repo_cache(
+            *base->get_logger(), std::filesystem::path(config.get_cachedir()) / CACHE_METADATA_LOCK, false, waited);
+        load_available_repo(primary_solv);
     } else if (type == Type::SYSTEM) {
         load_system_repo();
     }
@@ -338,6 +382,10 @@ int Repo::get_max_timestamp() {
     return downloader->max_timestamp;
 }
 
+void Repo::set_download_only_metadata_types(const std::set<std::string> & metadata_types) {
+    downloader->download_only_metadata = metadata_types;
+}
+
 void Repo::set_preserve_remote_time(bool preserve_remote_time) {
     downloader->preserve_remote_time = preserve_remote_time;
 }
@@ -422,32 +470,49 @@ void Repo::make_solv_repo() {
 }
 
 
-void Repo::load_available_repo() {
+std::shared_ptr<const std::string> Repo::parse_primary() const {
+    auto primary_fn = downloader->get_metadata_path(RepoDownloader::MD_FILENAME_PRIMARY);
+    if (type != Type::AVAILABLE || primary_fn.empty()) {
+        return nullptr;
+    }
+
+    // keep the metadata from being refreshed by another process while they are read
+    bool waited;
+    auto lock = lock_repo_cache(
+        *base->get_logger(), std::filesystem::path(config.get_cachedir()) / CACHE_METADATA_LOCK, false, waited);
+    return SolvRepo::parse_repo_main(base, config, downloader->repomd_filename, primary_fn);
+}
+
+void Repo::load_available_repo(const std::shared_ptr<const std::string> & primary_solv) {
     auto primary_fn = downloader->get_metadata_path(RepoDownloader::MD_FILENAME_PRIMARY);
     if (primary_fn.empty()) {
         throw RepoError(M_("Failed to load repository: \"primary\" data not present or in unsupported format"));
     }
 
-    solv_repo->load_repo_main(downloader->repomd_filename, primary_fn);
+    auto written_main_solv = solv_repo->load_repo_main(downloader->repomd_filename, primary_fn, primary_solv);
 
     auto optional_metadata = config.get_main_config().optional_metadata_types().get_value();
 
+    // The extensions of the rpm pool are parsed in parallel, they are loaded in this order
+    std::vector<RepodataType> ext_types;
     if (optional_metadata.contains(libdnf::METADATA_TYPE_FILELISTS)) {
-        solv_repo->load_repo_ext(RepodataType::FILELISTS, *downloader.get());
+        ext_types.push_back(RepodataType::FILELISTS);
     }
 
     if (optional_metadata.contains(libdnf::METADATA_TYPE_OTHER)) {
-        solv_repo->load_repo_ext(RepodataType::OTHER, *downloader.get());
+        ext_types.push_back(RepodataType::OTHER);
     }
 
     if (optional_metadata.contains(libdnf::METADATA_TYPE_PRESTO)) {
-        solv_repo->load_repo_ext(RepodataType::PRESTO, *downloader.get());
+        ext_types.push_back(RepodataType::PRESTO);
     }
 
     if (optional_metadata.contains(libdnf::METADATA_TYPE_UPDATEINFO)) {
-        solv_repo->load_repo_ext(RepodataType::UPDATEINFO, *downloader.get());
+        ext_types.push_back(RepodataType::UPDATEINFO);
     }
 
+    solv_repo->load_repo_exts(ext_types, *downloader.get(), std::move(written_main_solv));
+
     if (optional_metadata.contains(libdnf::METADATA_TYPE_COMPS)) {
         solv_repo->load_repo_ext(RepodataType::COMPS, *downloader.get());
     }
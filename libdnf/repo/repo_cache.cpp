@@ -25,6 +25,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf/base/base.hpp"
 #include "libdnf/logger/logger.hpp"
 
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
 
 namespace libdnf::repo {
 
@@ -159,6 +163,8 @@ RepoCache::RemoveStatistics RepoCache::remove_all() {
     status += remove_packages();
     status += remove_solv_files();
     status += cache_remove_attributes(cache_dir, log);
+    status.files_removed += remove(cache_dir / CACHE_METADATA_LOCK, status.errors, log);
+    status.files_removed += remove(cache_dir / CACHE_SOLV_FILES_LOCK, status.errors, log);
     std::error_code ec;
     if (std::filesystem::remove(cache_dir, ec)) {
         ++status.dirs_removed;
@@ -210,4 +216,100 @@ std::string RepoCache::get_repoid() {
 }
 
 
+namespace {
+
+// State of a lock file of the repository cache in this process. fcntl() locks do not exclude threads of one
+// process, and closing any descriptor of the file releases all the locks the process holds on it. So the holders
+// in this process exclude each other here, and the file is locked by a single Locker shared by all of them.
+struct ProcessLock {
+    std::size_t readers{0};
+    bool writer{false};
+    bool acquiring{false};  // the file lock is being acquired, the other threads wait for it
+    std::size_t users{0};   // holders and waiting threads, the state is removed without them
+    std::unique_ptr<libdnf::utils::Locker> locker;  // nullptr if the file is not locked
+};
+
+std::mutex process_locks_mutex;
+std::condition_variable process_lock_changed;
+std::map<std::string, ProcessLock> process_locks;  // by the path of the lock file
+
+}  // namespace
+
+
+RepoCacheLock::~RepoCacheLock() {
+    {
+        std::lock_guard<std::mutex> guard(process_locks_mutex);
+        auto it = process_locks.find(path);
+        auto & process_lock = it->second;
+        if (exclusive) {
+            process_lock.writer = false;
+        } else {
+            --process_lock.readers;
+        }
+        if (!process_lock.writer && process_lock.readers == 0) {
+            // under the mutex, a new holder must not lock the file before its descriptor is closed
+            process_lock.locker.reset();
+        }
+        if (--process_lock.users == 0) {
+            process_locks.erase(it);
+        }
+    }
+    process_lock_changed.notify_all();
+}
+
+
+std::unique_ptr<RepoCacheLock> lock_repo_cache(
+    Logger & logger, const std::filesystem::path & path, bool exclusive, bool & waited) {
+    waited = false;
+
+    std::unique_lock<std::mutex> guard(process_locks_mutex);
+    auto & process_lock = process_locks[path.native()];  // references to std::map elements stay valid
+    ++process_lock.users;
+    auto is_available = [&process_lock, exclusive] {
+        return !process_lock.acquiring && !process_lock.writer && (!exclusive || process_lock.readers == 0);
+    };
+    if (!is_available()) {
+        logger.debug("Waiting for lock \"{}\" held by another thread", path.native());
+        waited = true;
+        process_lock_changed.wait(guard, is_available);
+    }
+    if (exclusive) {
+        process_lock.writer = true;
+    } else {
+        ++process_lock.readers;
+    }
+    std::unique_ptr<RepoCacheLock> lock(new RepoCacheLock(path.native(), exclusive));
+    if (process_lock.locker) {
+        // a shared lock of the file is already held by another thread
+        return lock;
+    }
+
+    // The other threads wait until the file is locked, without holding the mutex
+    process_lock.acquiring = true;
+    guard.unlock();
+    std::unique_ptr<libdnf::utils::Locker> locker;
+    try {
+        std::filesystem::create_directories(path.parent_path());
+        // the lock file is kept, other processes can be waiting for it
+        locker = std::make_unique<libdnf::utils::Locker>(path, false);
+        if (!(exclusive ? locker->write_lock() : locker->read_lock())) {
+            logger.debug("Waiting for lock \"{}\" held by another process", path.native());
+            waited = true;
+            if (!(exclusive ? locker->write_lock(true) : locker->read_lock(true))) {
+                locker.reset();
+            }
+        }
+    } catch (const std::exception & ex) {
+        logger.debug("Cannot lock \"{}\", continuing without the lock: {}", path.native(), ex.what());
+        locker.reset();
+    }
+    guard.lock();
+    process_lock.locker = std::move(locker);
+    process_lock.acquiring = false;
+    guard.unlock();
+    process_lock_changed.notify_all();
+
+    return lock;
+}
+
 }  // namespace libdnf::repo
@@ -20,8 +20,16 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef LIBDNF_REPO_REPO_CACHE_PRIVATE_HPP
 #define LIBDNF_REPO_REPO_CACHE_PRIVATE_HPP
 
+#include "utils/locker.hpp"
+
+#include "libdnf/logger/logger.hpp"
 #include "libdnf/repo/repo_cache.hpp"
 
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+
 
 namespace libdnf::repo {
 
@@ -32,9 +40,46 @@ constexpr const char * CACHE_METADATA_DIR = "repodata";
 constexpr const char * CACHE_PACKAGES_DIR = "packages";
 constexpr const char * CACHE_SOLV_FILES_DIR = "solv";
 
+// Lock files in the repository cache directory. The metadata lock is held shared while the metadata are read
+// and exclusively while they are refreshed. The solv files lock serializes building of the solv files.
+constexpr const char * CACHE_METADATA_LOCK = "metadata.lock";
+constexpr const char * CACHE_SOLV_FILES_LOCK = "solv.lock";
+
 }  // namespace
 
 
+/// Lock of a repository cache file held by this process, released by the destructor.
+/// The lock can be released by another thread than the one which acquired it.
+class RepoCacheLock {
+public:
+    ~RepoCacheLock();
+
+    RepoCacheLock(const RepoCacheLock &) = delete;
+    RepoCacheLock & operator=(const RepoCacheLock &) = delete;
+
+private:
+    friend std::unique_ptr<RepoCacheLock> lock_repo_cache(
+        Logger & logger, const std::filesystem::path & path, bool exclusive, bool & waited);
+
+    RepoCacheLock(std::string path, bool exclusive) : path(std::move(path)), exclusive(exclusive) {}
+
+    std::string path;
+    bool exclusive;
+};
+
+
+/// Acquires a lock of the repository cache shared with other processes and other threads of this process
+/// (e.g. several Bases of a daemon), waits while another process or thread holds it.
+/// The cache is usable without the lock file, a problem with it (e.g. a read-only cache) is only logged,
+/// the lock then excludes only the threads of this process.
+/// @param path  path to the lock file
+/// @param exclusive  whether to acquire an exclusive lock, a shared lock otherwise
+/// @param waited  set to `true` if the lock was held by another process or thread and had to be waited for
+/// @return The acquired lock
+std::unique_ptr<RepoCacheLock> lock_repo_cache(
+    Logger & logger, const std::filesystem::path & path, bool exclusive, bool & waited);
+
+
 }  // namespace libdnf::repo
 
 #endif
@@ -0,0 +1,186 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "repo_config_index.hpp"
+
+#include "utils/fs/binary_io.hpp"
+#include "utils/fs/file.hpp"
+#include "utils/fs/temp.hpp"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+
+
+namespace libdnf::repo {
+
+namespace fs = libdnf::utils::fs;
+
+
+void RepoConfigIndex::load(const std::filesystem::path & path, const std::string & vars_fingerprint) {
+    this->vars_fingerprint = vars_fingerprint;
+    files.clear();
+    modified = false;
+
+    std::error_code ec;
+    const auto file_size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return;
+    }
+    fs::File file(path, "r");
+
+    std::array<char, REPO_CONFIG_INDEX_MAGIC.size()> magic;
+    std::array<char, REPO_CONFIG_INDEX_VERSION.size()> version;
+    if (file.read(magic.data(), magic.size()) != magic.size() || magic != REPO_CONFIG_INDEX_MAGIC ||
+        file.read(version.data(), version.size()) != version.size() || version != REPO_CONFIG_INDEX_VERSION) {
+        return;
+    }
+
+    std::string stored_fingerprint;
+    if (!fs::read_string(file, stored_fingerprint, file_size) || stored_fingerprint != vars_fingerprint) {
+        return;
+    }
+
+    std::map<std::string, File> loaded_files;
+    uint64_t nfiles;
+    if (!fs::read_u64(file, nfiles)) {
+        return;
+    }
+    for (uint64_t file_idx = 0; file_idx < nfiles; ++file_idx) {
+        std::string file_path;
+        File entry;
+        uint64_t nsections;
+        if (!fs::read_string(file, file_path, file_size) || !fs::read_u64(file, entry.key.mtime_ns) ||
+            !fs::read_u64(file, entry.key.size) || !fs::read_u64(file, entry.key.inode) ||
+            !fs::read_u64(file, nsections) || nsections > file_size) {
+            return;
+        }
+        entry.sections.resize(nsections);
+        for (auto & section : entry.sections) {
+            uint64_t noptions;
+            if (!fs::read_string(file, section.name, file_size) || !fs::read_string(file, section.repo_id, file_size) ||
+                !fs::read_u64(file, noptions) || noptions > file_size) {
+                return;
+            }
+            section.options.resize(noptions);
+            for (auto & [key, value] : section.options) {
+                if (!fs::read_string(file, key, file_size) || !fs::read_string(file, value, file_size)) {
+                    return;
+                }
+            }
+        }
+        loaded_files.emplace(std::move(file_path), std::move(entry));
+    }
+
+    files = std::move(loaded_files);
+}
+
+
+void RepoConfigIndex::write(const std::filesystem::path & path) const {
+    const auto parent_dir = path.parent_path();
+    std::filesystem::create_directories(parent_dir);
+
+    auto tmp_file = fs::TempFile(parent_dir, path.filename());
+    auto & file = tmp_file.open_as_file("w+");
+
+    // The index is a local cache, integers are stored in native byte order.
+    file.write(REPO_CONFIG_INDEX_MAGIC.data(), REPO_CONFIG_INDEX_MAGIC.size());
+    file.write(REPO_CONFIG_INDEX_VERSION.data(), REPO_CONFIG_INDEX_VERSION.size());
+    fs::write_string(file, vars_fingerprint);
+    fs::write_u64(file, files.size());
+    for (const auto & [file_path, entry] : files) {
+        fs::write_string(file, file_path);
+        fs::write_u64(file, entry.key.mtime_ns);
+        fs::write_u64(file, entry.key.size);
+        fs::write_u64(file, entry.key.inode);
+        fs::write_u64(file, entry.sections.size());
+        for (const auto & section : entry.sections) {
+            fs::write_string(file, section.name);
+            fs::write_string(file, section.repo_id);
+            fs::write_u64(file, section.options.size());
+            for (const auto & [key, value] : section.options) {
+                fs::write_string(file, key);
+                fs::write_string(file, value);
+            }
+        }
+    }
+
+    tmp_file.close();
+    std::filesystem::rename(tmp_file.get_path(), path);
+    tmp_file.release();
+}
+
+
+const RepoConfigIndex::File * RepoConfigIndex::find(const std::string & file_path, const FileKey & key) const {
+    auto it = files.find(file_path);
+    if (it == files.end() || !(it->second.key == key)) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+
+void RepoConfigIndex::set(const std::string & file_path, File && file) {
+    files.insert_or_assign(file_path, std::move(file));
+    modified = true;
+}
+
+
+void RepoConfigIndex::remove_missing(
+    const std::filesystem::path & dir_path, const std::vector<std::filesystem::path> & present_paths) {
+    // compare with a trailing separator, the configured directory may or may not end with one
+    const auto dir = (dir_path / "").lexically_normal();
+    for (auto it = files.begin(); it != files.end();) {
+        std::filesystem::path file_path(it->first);
+        if ((file_path.parent_path() / "").lexically_normal() == dir &&
+            std::find(present_paths.begin(), present_paths.end(), file_path) == present_paths.end()) {
+            it = files.erase(it);
+            modified = true;
+        } else {
+            ++it;
+        }
+    }
+}
+
+
+RepoConfigIndex::FileKey RepoConfigIndex::get_file_key(const std::filesystem::path & path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        throw std::filesystem::filesystem_error(
+            "cannot stat repository configuration file", path, std::error_code(errno, std::system_category()));
+    }
+    FileKey key;
+    key.mtime_ns = static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000000000 + static_cast<uint64_t>(st.st_mtim.tv_nsec);
+    key.size = static_cast<uint64_t>(st.st_size);
+    key.inode = static_cast<uint64_t>(st.st_ino);
+    return key;
+}
+
+
+std::string RepoConfigIndex::get_vars_fingerprint(const Vars & vars) {
+    std::string fingerprint;
+    for (const auto & [name, variable] : vars.get_variables()) {
+        fingerprint.append(name).append(1, '=').append(variable.value).append(1, '\n');
+    }
+    return fingerprint;
+}
+
+}  // namespace libdnf::repo
@@ -0,0 +1,104 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF_REPO_REPO_CONFIG_INDEX_HPP
+#define LIBDNF_REPO_REPO_CONFIG_INDEX_HPP
+
+#include "libdnf/conf/vars.hpp"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace libdnf::repo {
+
+static const constexpr std::array<char, 4> REPO_CONFIG_INDEX_MAGIC{'\0', 'd', 'r', 'i'};
+static const constexpr std::array<char, 4> REPO_CONFIG_INDEX_VERSION{'\0', '1', '.', '0'};
+
+
+/// Cache of parsed repository configuration files.
+///
+/// For every ".repo" file the index keeps its repository sections with the repo id and the option
+/// values already substituted by the variables. A file entry is valid while the modification time,
+/// size and inode of the file are unchanged. The whole index is valid only for the variables
+/// it was built with, see `get_vars_fingerprint()`.
+class RepoConfigIndex {
+public:
+    struct Section {
+        std::string name;
+        std::string repo_id;
+        std::vector<std::pair<std::string, std::string>> options;
+    };
+
+    struct FileKey {
+        uint64_t mtime_ns{0};
+        uint64_t size{0};
+        uint64_t inode{0};
+
+        bool operator==(const FileKey & other) const noexcept {
+            return mtime_ns == other.mtime_ns && size == other.size && inode == other.inode;
+        }
+    };
+
+    struct File {
+        FileKey key;
+        std::vector<Section> sections;
+    };
+
+    /// Loads the index from a cache file written by `write()`.
+    /// The index stays empty if the file is missing, damaged or was built with different variables.
+    void load(const std::filesystem::path & path, const std::string & vars_fingerprint);
+
+    /// Writes the index to `path`.
+    void write(const std::filesystem::path & path) const;
+
+    /// @return The cached sections of `file_path`, or nullptr if the file is not indexed or `key` differs.
+    const File * find(const std::string & file_path, const FileKey & key) const;
+
+    /// Stores the parsed sections of `file_path`.
+    void set(const std::string & file_path, File && file);
+
+    /// Removes the indexed files located directly in `dir_path` that are not in `present_paths`.
+    void remove_missing(
+        const std::filesystem::path & dir_path, const std::vector<std::filesystem::path> & present_paths);
+
+    /// @return `true` if the index was changed since it was loaded.
+    bool is_modified() const noexcept { return modified; }
+
+    /// @return The key of the file at `path`.
+    /// @throw std::filesystem::filesystem_error if the file cannot be stat'ed
+    static FileKey get_file_key(const std::filesystem::path & path);
+
+    /// @return String identifying the values of all `vars`.
+    static std::string get_vars_fingerprint(const Vars & vars);
+
+private:
+    std::string vars_fingerprint;
+    std::map<std::string, File> files;
+    bool modified{false};
+};
+
+}  // namespace libdnf::repo
+
+#endif  // LIBDNF_REPO_REPO_CONFIG_INDEX_HPP
@@ -28,10 +28,12 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf/conf/const.hpp"
 #include "libdnf/repo/repo_errors.hpp"
 
+#include <fcntl.h>
 #include <librepo/librepo.h>
 #include <solv/chksum.h>
 #include <solv/util.h>
 
+#include <cstdio>
 #include <filesystem>
 #include <fstream>
 #include <random>
@@ -54,6 +56,20 @@ static void str_vector_to_char_array(const std::vector<std::string> & vec, const
     arr[vec.size()] = nullptr;
 }
 
+// Moves `src` to `dest`, replaces an existing `dest`. The items are exchanged atomically when possible,
+// processes reading `dest` meanwhile see the complete old or new content, never a half-moved directory.
+static void replace_item(const std::filesystem::path & src, const std::filesystem::path & dest) {
+    if (renameat2(AT_FDCWD, src.c_str(), AT_FDCWD, dest.c_str(), RENAME_EXCHANGE) == 0) {
+        // `src` holds the replaced item now
+        std::filesystem::remove_all(src);
+        return;
+    }
+
+    // `dest` does not exist or the file system does not support the exchange
+    std::filesystem::remove_all(dest);
+    utils::fs::move_recursive(src, dest);
+}
+
 static LrYumRepo * get_yum_repo(LibrepoResult & result) {
     LrYumRepo * yum_repo;
     result.get_info(LRR_YUM_REPO, &yum_repo);
@@ -137,9 +153,7 @@ void RepoDownloader::download_metadata(const std::string & destdir) try {
         auto tmp_item = dir.path();
 
         auto target_item = destdir / tmp_item.filename();
-        std::filesystem::remove_all(target_item);
-
-        utils::fs::move_recursive(tmp_item, target_item);
+        replace_item(tmp_item, target_item);
     }
 } catch (const std::runtime_error & e) {
     auto src = get_source_info();
@@ -313,6 +327,14 @@ void RepoDownloader::load_local() try {
 }
 
 
+std::vector<std::string> RepoDownloader::get_mirrors() const {
+    if (!mirrors.empty()) {
+        return mirrors;
+    }
+    return config.baseurl().get_value();
+}
+
+
 /// Returns a librepo handle, set as per the repo options.
 /// Note that destdir is None, and the handle is cached.
 // TODO(jrohel) The librepo handle callbacks are not set. If librepo itself downloads an extra file
@@ -735,7 +757,9 @@ std::set<std::string> RepoDownloader::get_optional_metadata() const {
     if (repo_type == Repo::Type::SYSTEM) {
         return libdnf::OPTIONAL_METADATA_TYPES;
     } else {
-        return config.get_main_config().optional_metadata_types().get_value();
+        auto optional_metadata = config.get_main_config().optional_metadata_types().get_value();
+        optional_metadata.insert(download_only_metadata.begin(), download_only_metadata.end());
+        return optional_metadata;
     }
 }
 
@@ -72,6 +72,10 @@ public:
 
     const std::string & get_metadata_path(const std::string & metadata_type) const;
 
+    /// Returns the mirrors of the repository resolved from the mirrorlist or metalink, or the baseurls
+    /// if there are none. Every mirror is a base URL of the repository.
+    std::vector<std::string> get_mirrors() const;
+
 private:
     friend class Repo;
 
@@ -106,6 +110,7 @@ private:
     int max_mirror_tries = 0;  // try all mirrors
     std::map<std::string, std::string> substitutions;
     std::vector<std::string> http_headers;
+    std::set<std::string> download_only_metadata;  // optional metadata downloaded but not loaded
 
     // download output
     std::string repomd_filename;
@@ -21,14 +21,19 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "../module/module_sack_impl.hpp"
 #include "repo_cache_private.hpp"
+#include "repo_config_index.hpp"
 #include "rpm/package_sack_impl.hpp"
+#include "solv_repo.hpp"
 #include "utils/bgettext/bgettext-mark-domain.h"
 #include "utils/string.hpp"
 #include "utils/url.hpp"
 
 #include "libdnf/base/base.hpp"
+#include "libdnf/base/transaction.hpp"
+#include "libdnf/base/transaction_package.hpp"
 #include "libdnf/common/exception.hpp"
 #include "libdnf/conf/config_parser.hpp"
+#include "libdnf/conf/const.hpp"
 #include "libdnf/conf/option_bool.hpp"
 #include "libdnf/repo/file_downloader.hpp"
 
@@ -36,11 +41,14 @@ extern "C" {
 #include <solv/testcase.h>
 }
 
+#include <algorithm>
 #include <atomic>
 #include <cerrno>
 #include <condition_variable>
 #include <filesystem>
+#include <future>
 #include <mutex>
+#include <set>
 #include <sstream>
 #include <thread>
 
@@ -55,6 +63,12 @@ constexpr const char * CMDLINE_REPO_NAME = "@commandline";
 // TODO lukash: unused, remove?
 //constexpr const char * MODULE_FAIL_SAFE_REPO_NAME = "@modulefailsafe";
 
+// Name of the file in cachedir with the index of parsed repository configuration files
+constexpr const char * REPO_CONFIG_INDEX_FILENAME = "repo-config.index";
+
+// Maximum estimated size of the primaries parsed in advance and not yet loaded, in bytes
+constexpr std::size_t MAX_PRIMARIES_PARSED_SIZE = 256 * 1024 * 1024;
+
 }  // namespace
 
 namespace libdnf::repo {
@@ -176,6 +190,33 @@ std::map<std::string, libdnf::rpm::Package> RepoSack::add_cmdline_packages(
 }
 
 
+void RepoSack::update_system_repo(const libdnf::base::Transaction & transaction) {
+    if (!system_repo || !system_repo->solv_repo) {
+        return;
+    }
+
+    std::set<std::string> names;
+    for (const auto & tspkg : transaction.get_transaction_packages()) {
+        const auto action = tspkg.get_action();
+        if (transaction::transaction_item_action_is_inbound(action) ||
+            transaction::transaction_item_action_is_outbound(action)) {
+            names.insert(tspkg.get_package().get_name());
+        }
+    }
+    if (names.empty()) {
+        return;
+    }
+
+    system_repo->solv_repo->update_system_repo(names);
+
+    auto package_sack = base->get_rpm_package_sack();
+    package_sack->p_impl->invalidate_solvables();
+    package_sack->p_impl->invalidate_provides();
+    // new solvables need to be matched against the configured excludes and the considered map recomputed
+    package_sack->load_config_excludes_includes();
+}
+
+
 RepoWeakPtr RepoSack::get_system_repo() {
     if (!system_repo) {
         std::unique_ptr<Repo> repo(new Repo(base, SYSTEM_REPO_NAME, Repo::Type::SYSTEM));
@@ -190,14 +231,28 @@ RepoWeakPtr RepoSack::get_system_repo() {
 
 
 void RepoSack::update_and_load_repos(libdnf::repo::RepoQuery & repos) {
+    auto & metrics = *base->get_metrics();
+    libdnf::base::Metrics::Span update_and_load_span(metrics, "repo.update_and_load");
+
     std::atomic<bool> except_in_main_thread{false};  // set to true if an exception occurred in the main thread
     std::exception_ptr except_ptr;                   // for pass exception from thread_sack_loader to main thread,
                                                      // a default-constructed std::exception_ptr is a null pointer
 
-    std::vector<libdnf::repo::Repo *> prepared_repos;  // array of repositories prepared to load into solv sack
-    std::mutex prepared_repos_mutex;                   // mutex for the array
-    std::condition_variable signal_prepared_repo;      // signals that next item is added into array
-    std::size_t num_repos_loaded{0};                   // number of repositories already loaded into solv sack
+    struct PreparedRepo {
+        libdnf::repo::Repo * repo;
+        std::future<std::shared_ptr<const std::string>> primary_solv;  // primary parsed in advance, may be invalid
+    };
+
+    std::vector<PreparedRepo> prepared_repos;           // array of repositories prepared to load into solv sack
+    std::mutex prepared_repos_mutex;                    // mutex for the array
+    std::condition_variable signal_prepared_repo;       // signals that next item is added into array
+    std::size_t num_repos_loaded{0};                    // number of repositories already loaded into solv sack
+    std::atomic<std::size_t> primaries_parsed_size{0};  // estimated size of the primaries parsed in advance
+                                                        // and not yet loaded
+
+    // The primaries of the fetched repositories are parsed in parallel, each in a private pool, while the sack
+    // loader loads the previous ones. The parsed data are kept until they are loaded, their size is limited.
+    // A primary being parsed is accounted by the size of its metadata file, a parsed one by the size of its data.
 
     prepared_repos.reserve(repos.size() + 1);  // optimization: preallocate memory to avoid realocations, +1 stop tag
 
@@ -209,14 +264,26 @@ void RepoSack::update_and_load_repos(libdnf::repo::RepoQuery & repos) {
                 while (prepared_repos.size() <= num_repos_loaded) {
                     signal_prepared_repo.wait(lock);
                 }
-                auto repo = prepared_repos[num_repos_loaded];
+                auto repo = prepared_repos[num_repos_loaded].repo;
+                auto primary_future = std::move(prepared_repos[num_repos_loaded].primary_solv);
                 lock.unlock();
 
                 if (!repo || except_in_main_thread) {
                     break;  // nullptr mark - work is done, or exception in main thread
                 }
 
-                repo->load();
+                std::shared_ptr<const std::string> primary_solv;
+                if (primary_future.valid()) {
+                    primary_solv = primary_future.get();
+                    if (primary_solv) {
+                        primaries_parsed_size -= primary_solv->size();
+                    }
+                }
+
+                {
+                    libdnf::base::Metrics::Span load_span(metrics, "repo.load", repo->get_id());
+                    repo->load(primary_solv);
+                }
                 ++num_repos_loaded;
             }
         } catch (std::runtime_error & ex) {
@@ -229,7 +296,7 @@ void RepoSack::update_and_load_repos(libdnf::repo::RepoQuery & repos) {
     auto finish_sack_loader = [&]() {
         {
             std::lock_guard<std::mutex> lock(prepared_repos_mutex);
-            prepared_repos.push_back(nullptr);
+            prepared_repos.push_back({nullptr, {}});
         }
         signal_prepared_repo.notify_one();
 
@@ -251,7 +318,7 @@ void RepoSack::update_and_load_repos(libdnf::repo::RepoQuery & repos) {
         if (repo->get_type() == libdnf::repo::Repo::Type::SYSTEM) {
             {
                 std::lock_guard<std::mutex> lock(prepared_repos_mutex);
-                prepared_repos.push_back(repo.get());
+                prepared_repos.push_back({repo.get(), {}});
             }
 
             signal_prepared_repo.notify_one();
@@ -266,11 +333,36 @@ void RepoSack::update_and_load_repos(libdnf::repo::RepoQuery & repos) {
         }
         catch_thread_sack_loader_exceptions();
         try {
-            repo->fetch_metadata();
+            {
+                libdnf::base::Metrics::Span fetch_span(metrics, "repo.fetch_metadata", repo->get_id());
+                repo->fetch_metadata();
+            }
+
+            // over the size limit the sack loader parses the primary itself
+            std::future<std::shared_ptr<const std::string>> primary_solv;
+            if (primaries_parsed_size < MAX_PRIMARIES_PARSED_SIZE) {
+                std::error_code ec;
+                const auto primary_fn = repo->downloader->get_metadata_path(RepoDownloader::MD_FILENAME_PRIMARY);
+                const auto file_size = std::filesystem::file_size(primary_fn, ec);
+                const std::size_t estimated_size = ec ? 0 : static_cast<std::size_t>(file_size);
+                primaries_parsed_size += estimated_size;
+                try {
+                    primary_solv = std::async(
+                        std::launch::async, [repo_ptr = repo.get(), estimated_size, &primaries_parsed_size] {
+                            auto data = repo_ptr->parse_primary();
+                            primaries_parsed_size += data ? data->size() : 0;
+                            primaries_parsed_size -= estimated_size;
+                            return data;
+                        });
+                } catch (const std::system_error &) {
+                    // out of threads
+                    primaries_parsed_size -= estimated_size;
+                }
+            }
 
             {
                 std::lock_guard<std::mutex> lock(prepared_repos_mutex);
-                prepared_repos.push_back(repo.get());
+                prepared_repos.push_back({repo.get(), std::move(primary_solv)});
             }
 
             signal_prepared_repo.notify_one();
@@ -295,6 +387,14 @@ void RepoSack::update_and_load_repos(libdnf::repo::RepoQuery & repos) {
     finish_sack_loader();
     catch_thread_sack_loader_exceptions();
 
+    // The parsed extensions are replaced by lazy loads of their solv cache files written meanwhile,
+    // the others stay loaded for the rest of the session.
+    for (auto & repo : repos) {
+        if (repo->get_type() == libdnf::repo::Repo::Type::AVAILABLE && repo->solv_repo) {
+            repo->solv_repo->reload_written_exts();
+        }
+    }
+
     base->get_rpm_package_sack()->load_config_excludes_includes();
 }
 
@@ -315,6 +415,7 @@ void RepoSack::update_and_load_enabled_repos(bool load_system) {
     update_and_load_repos(repos);
 
     // TODO(jmracek) Replace by call that will resolve active modules and apply modular filterring
+    libdnf::base::Metrics::Span module_filtering_span(*base->get_metrics(), "module.filtering");
     base->get_module_sack()->p_impl->module_filtering();
 }
 
@@ -337,23 +438,52 @@ void RepoSack::dump_debugdata(const std::string & dir) {
 }
 
 
-void RepoSack::create_repos_from_file(const std::string & path) {
-    auto & logger = *base->get_logger();
+namespace {
+
+// Parses the repository sections of the configuration file at `path`, substitutes the variables in the section
+// names and option values.
+std::vector<RepoConfigIndex::Section> parse_repo_file(const std::string & path, const Vars & vars) {
     ConfigParser parser;
     parser.read(path);
-    const auto & cfg_parser_data = parser.get_data();
-    for (const auto & cfg_parser_data_iter : cfg_parser_data) {
-        const auto & section = cfg_parser_data_iter.first;
+    std::vector<RepoConfigIndex::Section> sections;
+    for (const auto & [section, options] : parser.get_data()) {
         if (section == "main") {
             continue;
         }
-        auto repo_id = base->get_vars()->substitute(section);
+        auto & repo_section = sections.emplace_back();
+        repo_section.name = section;
+        repo_section.repo_id = vars.substitute(section);
+        repo_section.options.reserve(options.size());
+        for (const auto & [key, value] : options) {
+            repo_section.options.emplace_back(key, vars.substitute(value));
+        }
+    }
+    return sections;
+}
 
-        logger.debug("Creating repo \"{}\" from config file \"{}\" section \"{}\"", repo_id, path, section);
 
-        auto repo = create_repo(repo_id);
+void create_repos_from_sections(
+    RepoSack & sack, const std::string & path, const std::vector<RepoConfigIndex::Section> & sections) {
+    auto & logger = *sack.get_base()->get_logger();
+    for (const auto & section : sections) {
+        const auto & repo_id = section.repo_id;
+
+        logger.debug("Creating repo \"{}\" from config file \"{}\" section \"{}\"", repo_id, path, section.name);
+
+        auto repo = sack.create_repo(repo_id);
         auto & repo_cfg = repo->get_config();
-        repo_cfg.load_from_parser(parser, section, *base->get_vars(), *base->get_logger());
+        auto & binds = repo_cfg.opt_binds();
+        // the same as ConfigRepo::load_from_parser(), the values are substituted already
+        for (const auto & [key, value] : section.options) {
+            auto opt_binds_iter = binds.find(key);
+            if (opt_binds_iter != binds.end()) {
+                try {
+                    opt_binds_iter->second.new_string(Option::Priority::REPOCONFIG, value);
+                } catch (const OptionError & ex) {
+                    logger.warning("Config error in section \"{}\" key \"{}\": {}", section.name, key, ex.what());
+                }
+            }
+        }
 
         if (repo_cfg.name().get_priority() == Option::Priority::DEFAULT) {
             logger.debug("Repo \"{}\" is missing name in configuration file \"{}\", using id.", repo_id, path);
@@ -362,6 +492,13 @@ void RepoSack::create_repos_from_file(const std::string & path) {
     }
 }
 
+}  // namespace
+
+
+void RepoSack::create_repos_from_file(const std::string & path) {
+    create_repos_from_sections(*this, path, parse_repo_file(path, *base->get_vars()));
+}
+
 void RepoSack::create_repos_from_config_file() {
     create_repos_from_file(std::filesystem::path(base->get_config().config_file_path().get_value()));
 }
@@ -376,8 +513,47 @@ void RepoSack::create_repos_from_dir(const std::string & dir_path) {
         }
     }
     std::sort(paths.begin(), paths.end());
+
+    // Parsed files are cached in an index, only new and changed files are parsed again.
+    // The cache is optional, any problem with it falls back to parsing.
+    auto & logger = *base->get_logger();
+    const auto & vars = *base->get_vars();
+    const std::filesystem::path index_path =
+        std::filesystem::path(base->get_config().cachedir().get_value()) / REPO_CONFIG_INDEX_FILENAME;
+    RepoConfigIndex index;
+    try {
+        index.load(index_path, RepoConfigIndex::get_vars_fingerprint(vars));
+    } catch (const std::exception & ex) {
+        logger.debug("Cannot load repository configuration index \"{}\": {}", index_path.native(), ex.what());
+    }
+
     for (auto & path : paths) {
-        create_repos_from_file(path);
+        RepoConfigIndex::FileKey key;
+        try {
+            key = RepoConfigIndex::get_file_key(path);
+        } catch (const std::filesystem::filesystem_error &) {
+            // the file vanished, let parsing report the problem
+            create_repos_from_file(path);
+            continue;
+        }
+        if (const auto * indexed_file = index.find(path, key)) {
+            create_repos_from_sections(*this, path, indexed_file->sections);
+        } else {
+            RepoConfigIndex::File file;
+            file.key = key;
+            file.sections = parse_repo_file(path, vars);
+            create_repos_from_sections(*this, path, file.sections);
+            index.set(path, std::move(file));
+        }
+    }
+
+    index.remove_missing(dir_path, paths);
+    if (index.is_modified()) {
+        try {
+            index.write(index_path);
+        } catch (const std::exception & ex) {
+            logger.debug("Cannot write repository configuration index \"{}\": {}", index_path.native(), ex.what());
+        }
     }
 }
 
@@ -420,7 +596,48 @@ void RepoSack::enable_source_repos() {
     }
 }
 
+void RepoSack::release_metadata(const std::set<std::string> & metadata_types) {
+    auto & logger = *base->get_logger();
+    libdnf::base::Metrics::Span release_span(*base->get_metrics(), "repo.release_metadata");
+
+    std::set<RepodataType> types;
+    for (const auto & metadata_type : metadata_types) {
+        if (metadata_type == METADATA_TYPE_FILELISTS) {
+            types.insert(RepodataType::FILELISTS);
+        } else if (metadata_type == METADATA_TYPE_OTHER) {
+            types.insert(RepodataType::OTHER);
+        } else if (metadata_type == METADATA_TYPE_PRESTO) {
+            types.insert(RepodataType::PRESTO);
+        } else {
+            logger.debug("Metadata of type \"{}\" cannot be released", metadata_type);
+        }
+    }
+
+    if (types.contains(RepodataType::FILELISTS)) {
+        // The file provides are computed from the filelists, compute them now so they are not reloaded right away
+        base->get_rpm_package_sack()->p_impl->make_provides_ready();
+    }
+
+    std::size_t released_size = 0;
+    auto rq = RepoQuery(base);
+    rq.filter_type(Repo::Type::AVAILABLE);
+    for (auto & repo : rq.get_data()) {
+        if (!repo->solv_repo) {
+            continue;
+        }
+        if (!types.empty()) {
+            released_size += repo->solv_repo->release_repo_exts(types);
+        }
+        repo->solv_repo->log_memory_use();
+    }
+
+    base->get_metrics()->add_counter("repo.released_metadata_bytes", static_cast<int64_t>(released_size));
+    logger.debug("Released {} bytes of repository metadata", released_size);
+}
+
+
 void RepoSack::internalize_repos() {
+    libdnf::base::Metrics::Span internalize_span(*base->get_metrics(), "repo.internalize");
     auto rq = RepoQuery(base);
     for (auto & repo : rq.get_data()) {
         repo->internalize();
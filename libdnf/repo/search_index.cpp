@@ -0,0 +1,315 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "search_index.hpp"
+
+#include "utils/fs/binary_io.hpp"
+#include "utils/fs/file.hpp"
+#include "utils/fs/temp.hpp"
+
+extern "C" {
+#include <solv/knownid.h>
+}
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+
+namespace libdnf::repo {
+
+namespace fs = libdnf::utils::fs;
+
+
+namespace {
+
+constexpr std::array<Id, SearchIndex::KEY_COUNT> INDEXED_KEYNAMES{
+    SOLVABLE_NAME, SOLVABLE_SUMMARY, SOLVABLE_DESCRIPTION, SOLVABLE_URL};
+
+
+// Locale independent lowercase, the index must not depend on the environment it was built in.
+inline uint32_t ascii_tolower(unsigned char c) noexcept {
+    return c >= 'A' && c <= 'Z' ? static_cast<uint32_t>(c - 'A' + 'a') : c;
+}
+
+
+inline uint32_t make_gram(const unsigned char * ptr) noexcept {
+    return ascii_tolower(ptr[0]) << 16 | ascii_tolower(ptr[1]) << 8 | ascii_tolower(ptr[2]);
+}
+
+
+void put_varint(std::vector<unsigned char> & out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+
+struct PostingBuilder {
+    std::vector<unsigned char> bytes;
+    uint32_t last{0};
+    uint32_t count{0};
+};
+
+}  // namespace
+
+
+std::optional<SearchIndex::Key> SearchIndex::keyname_to_key(Id keyname) noexcept {
+    switch (keyname) {
+        case SOLVABLE_NAME:
+            return Key::NAME;
+        case SOLVABLE_SUMMARY:
+            return Key::SUMMARY;
+        case SOLVABLE_DESCRIPTION:
+            return Key::DESCRIPTION;
+        case SOLVABLE_URL:
+            return Key::URL;
+        default:
+            return std::nullopt;
+    }
+}
+
+
+void SearchIndex::build(solv::Pool & pool, ::Repo * repo, Id start, Id end) {
+    indexed_start = start;
+    indexed_end = end;
+
+    std::unordered_map<uint32_t, PostingBuilder> builders;
+    for (std::size_t key_idx = 0; key_idx < KEY_COUNT; ++key_idx) {
+        builders.clear();
+        for (Id id = start; id < end; ++id) {
+            if (pool.id2solvable(id)->repo != repo || !pool.is_package(id)) {
+                continue;
+            }
+            const Id keyname = INDEXED_KEYNAMES[key_idx];
+            const char * value = keyname == SOLVABLE_NAME ? pool.get_name(id) : pool.lookup_str(id, keyname);
+            if (!value) {
+                continue;
+            }
+            const auto len = strlen(value);
+            const auto * ptr = reinterpret_cast<const unsigned char *>(value);
+            const auto posting = static_cast<uint32_t>(id - start + 1);
+            for (std::size_t i = 0; i + GRAM_SIZE <= len; ++i) {
+                auto & builder = builders[make_gram(ptr + i)];
+                if (builder.last == posting) {
+                    continue;
+                }
+                put_varint(builder.bytes, posting - builder.last);
+                builder.last = posting;
+                ++builder.count;
+            }
+        }
+
+        auto & field = fields[key_idx];
+        field = Field();
+        field.grams.reserve(builders.size());
+        for (const auto & [gram, builder] : builders) {
+            field.grams.push_back(gram);
+        }
+        std::sort(field.grams.begin(), field.grams.end());
+        field.counts.reserve(field.grams.size());
+        field.offsets.reserve(field.grams.size() + 1);
+        for (auto gram : field.grams) {
+            const auto & builder = builders[gram];
+            field.offsets.push_back(static_cast<uint32_t>(field.postings.size()));
+            field.counts.push_back(builder.count);
+            field.postings.insert(field.postings.end(), builder.bytes.begin(), builder.bytes.end());
+        }
+        field.offsets.push_back(static_cast<uint32_t>(field.postings.size()));
+    }
+}
+
+
+void SearchIndex::decode(const Field & field, std::size_t gram_idx, std::vector<uint32_t> & out) {
+    out.clear();
+    out.reserve(field.counts[gram_idx]);
+    const unsigned char * ptr = field.postings.data() + field.offsets[gram_idx];
+    const unsigned char * end = field.postings.data() + field.offsets[gram_idx + 1];
+    uint32_t value = 0;
+    while (ptr < end) {
+        uint32_t delta = 0;
+        unsigned shift = 0;
+        while (ptr < end && (*ptr & 0x80) && shift < 28) {
+            delta |= static_cast<uint32_t>(*ptr++ & 0x7f) << shift;
+            shift += 7;
+        }
+        if (ptr == end) {
+            break;
+        }
+        delta |= static_cast<uint32_t>(*ptr++) << shift;
+        value += delta;
+        out.push_back(value);
+    }
+}
+
+
+bool SearchIndex::add_candidates(Key key, std::string_view pattern, libdnf::solv::SolvMap & candidates) const {
+    if (pattern.size() < GRAM_SIZE) {
+        return false;
+    }
+    // Case insensitive matching of non-ASCII characters depends on the locale, leave it to the caller.
+    for (unsigned char c : pattern) {
+        if (c >= 0x80) {
+            return false;
+        }
+    }
+
+    const auto & field = fields[static_cast<std::size_t>(key)];
+    const auto * ptr = reinterpret_cast<const unsigned char *>(pattern.data());
+    std::vector<std::size_t> gram_indexes;
+    for (std::size_t i = 0; i + GRAM_SIZE <= pattern.size(); ++i) {
+        const auto gram = make_gram(ptr + i);
+        auto it = std::lower_bound(field.grams.begin(), field.grams.end(), gram);
+        if (it == field.grams.end() || *it != gram) {
+            // no indexed value contains the gram
+            return true;
+        }
+        gram_indexes.push_back(static_cast<std::size_t>(it - field.grams.begin()));
+    }
+
+    // Start with the most selective gram to keep the intersections small
+    std::sort(gram_indexes.begin(), gram_indexes.end());
+    gram_indexes.erase(std::unique(gram_indexes.begin(), gram_indexes.end()), gram_indexes.end());
+    std::sort(gram_indexes.begin(), gram_indexes.end(), [&field](std::size_t lhs, std::size_t rhs) {
+        return field.counts[lhs] < field.counts[rhs];
+    });
+
+    std::vector<uint32_t> result;
+    std::vector<uint32_t> postings;
+    std::vector<uint32_t> intersection;
+    decode(field, gram_indexes[0], result);
+    for (std::size_t i = 1; i < gram_indexes.size() && !result.empty(); ++i) {
+        decode(field, gram_indexes[i], postings);
+        intersection.clear();
+        std::set_intersection(
+            result.begin(), result.end(), postings.begin(), postings.end(), std::back_inserter(intersection));
+        result.swap(intersection);
+    }
+
+    const auto max_posting = static_cast<uint32_t>(indexed_end - indexed_start);
+    for (auto posting : result) {
+        if (posting >= 1 && posting <= max_posting) {
+            candidates.add_unsafe(indexed_start + static_cast<Id>(posting) - 1);
+        }
+    }
+    return true;
+}
+
+
+void SearchIndex::add_all(libdnf::solv::SolvMap & candidates) const {
+    for (Id id = indexed_start; id < indexed_end; ++id) {
+        candidates.add_unsafe(id);
+    }
+}
+
+
+void SearchIndex::write(
+    const std::filesystem::path & path, const unsigned char * checksum, std::size_t checksum_len) const {
+    const auto parent_dir = path.parent_path();
+    std::filesystem::create_directory(parent_dir);
+
+    auto tmp_file = fs::TempFile(parent_dir, path.filename());
+    auto & file = tmp_file.open_as_file("w+");
+
+    // The index is a local cache, integers are stored in native byte order.
+    file.write(SEARCH_INDEX_MAGIC.data(), SEARCH_INDEX_MAGIC.size());
+    file.write(SEARCH_INDEX_VERSION.data(), SEARCH_INDEX_VERSION.size());
+    fs::write_u32(file, static_cast<uint32_t>(checksum_len));
+    file.write(checksum, checksum_len);
+    fs::write_u32(file, static_cast<uint32_t>(indexed_end - indexed_start));
+    for (const auto & field : fields) {
+        fs::write_u32(file, static_cast<uint32_t>(field.grams.size()));
+        fs::write_u32(file, static_cast<uint32_t>(field.postings.size()));
+        fs::write_vector(file, field.grams);
+        fs::write_vector(file, field.counts);
+        fs::write_vector(file, field.offsets);
+        fs::write_vector(file, field.postings);
+    }
+
+    tmp_file.close();
+    std::filesystem::rename(tmp_file.get_path(), path);
+    tmp_file.release();
+}
+
+
+bool SearchIndex::load(
+    const std::filesystem::path & path,
+    const unsigned char * checksum,
+    std::size_t checksum_len,
+    Id start,
+    Id end) {
+    if (!std::filesystem::exists(path)) {
+        return false;
+    }
+    const auto file_size = std::filesystem::file_size(path);
+    fs::File file(path, "r");
+
+    std::array<char, SEARCH_INDEX_MAGIC.size()> magic;
+    std::array<char, SEARCH_INDEX_VERSION.size()> version;
+    if (!fs::read_exact(file, magic.data(), magic.size()) || magic != SEARCH_INDEX_MAGIC ||
+        !fs::read_exact(file, version.data(), version.size()) || version != SEARCH_INDEX_VERSION) {
+        return false;
+    }
+
+    uint32_t stored_checksum_len;
+    if (!fs::read_u32(file, stored_checksum_len) || stored_checksum_len != checksum_len) {
+        return false;
+    }
+    std::vector<unsigned char> stored_checksum;
+    if (!fs::read_vector(file, stored_checksum, checksum_len) ||
+        memcmp(stored_checksum.data(), checksum, checksum_len) != 0) {
+        return false;
+    }
+
+    uint32_t nsolvables;
+    if (!fs::read_u32(file, nsolvables) || nsolvables != static_cast<uint32_t>(end - start)) {
+        return false;
+    }
+
+    std::array<Field, KEY_COUNT> loaded_fields;
+    for (auto & field : loaded_fields) {
+        uint32_t ngrams;
+        uint32_t npostings;
+        if (!fs::read_u32(file, ngrams) || !fs::read_u32(file, npostings)) {
+            return false;
+        }
+        // guard against allocating nonsense sizes from a damaged file
+        if (static_cast<uintmax_t>(ngrams) * 3 * sizeof(uint32_t) + npostings > file_size) {
+            return false;
+        }
+        if (!fs::read_vector(file, field.grams, ngrams) || !fs::read_vector(file, field.counts, ngrams) ||
+            !fs::read_vector(file, field.offsets, ngrams + 1) || !fs::read_vector(file, field.postings, npostings)) {
+            return false;
+        }
+        if (field.offsets.front() != 0 || field.offsets.back() != npostings ||
+            !std::is_sorted(field.offsets.begin(), field.offsets.end()) ||
+            !std::is_sorted(field.grams.begin(), field.grams.end())) {
+            return false;
+        }
+    }
+
+    fields = std::move(loaded_fields);
+    indexed_start = start;
+    indexed_end = end;
+    return true;
+}
+
+}  // namespace libdnf::repo
@@ -0,0 +1,102 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF_REPO_SEARCH_INDEX_HPP
+#define LIBDNF_REPO_SEARCH_INDEX_HPP
+
+#include "solv/pool.hpp"
+#include "solv/solv_map.hpp"
+
+#include <solv/repo.h>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+
+namespace libdnf::repo {
+
+static const constexpr std::array<char, 4> SEARCH_INDEX_MAGIC{'\0', 'd', 's', 'i'};
+static const constexpr std::array<char, 4> SEARCH_INDEX_VERSION{'\0', '1', '.', '0'};
+
+
+/// Trigram index of the package attributes used by full-text search (name, summary,
+/// description and url) of a single repository.
+///
+/// Attribute values are lowercased (ASCII only) and split into overlapping three byte grams.
+/// For every gram the index keeps a delta-encoded list of solvables (relative to the first
+/// indexed solvable) whose value contains the gram. A substring lookup intersects the lists
+/// of all grams of the pattern. The result is a superset of the matching solvables, callers
+/// are expected to verify the candidates against the real values.
+class SearchIndex {
+public:
+    enum class Key { NAME, SUMMARY, DESCRIPTION, URL };
+    static constexpr std::size_t KEY_COUNT = 4;
+    static constexpr std::size_t GRAM_SIZE = 3;
+
+    /// Indexes package solvables of `repo` in range [start, end).
+    void build(solv::Pool & pool, ::Repo * repo, Id start, Id end);
+
+    /// Loads the index from a cache file written by `write()`.
+    /// @return `false` if the file is missing or was written for different metadata.
+    bool load(
+        const std::filesystem::path & path,
+        const unsigned char * checksum,
+        std::size_t checksum_len,
+        Id start,
+        Id end);
+
+    /// Writes the index to `path`. The `checksum` identifies the repository metadata the index was built from.
+    void write(const std::filesystem::path & path, const unsigned char * checksum, std::size_t checksum_len) const;
+
+    /// Adds to `candidates` indexed solvables whose `key` attribute may contain `pattern` (case insensitive).
+    /// @return `false` if the pattern is too short to be looked up in the index, `candidates` are untouched then.
+    bool add_candidates(Key key, std::string_view pattern, libdnf::solv::SolvMap & candidates) const;
+
+    /// Adds all indexed solvables to `candidates`.
+    void add_all(libdnf::solv::SolvMap & candidates) const;
+
+    /// Returns `true` if the index covers exactly the solvables in range [start, end).
+    bool covers(Id start, Id end) const noexcept { return indexed_start == start && indexed_end == end; }
+
+    /// Returns the index key for libsolv `keyname` or an empty optional if the attribute is not indexed.
+    static std::optional<Key> keyname_to_key(Id keyname) noexcept;
+
+private:
+    struct Field {
+        std::vector<uint32_t> grams;          // sorted trigrams
+        std::vector<uint32_t> counts;         // number of solvables for each gram
+        std::vector<uint32_t> offsets;        // offsets of gram postings in `postings`, grams.size() + 1 items
+        std::vector<unsigned char> postings;  // varint encoded deltas of (solvable - indexed_start + 1)
+    };
+
+    /// Decodes postings of `gram_idx` of `field` into `out`.
+    static void decode(const Field & field, std::size_t gram_idx, std::vector<uint32_t> & out);
+
+    std::array<Field, KEY_COUNT> fields;
+    Id indexed_start{0};
+    Id indexed_end{0};
+};
+
+}  // namespace libdnf::repo
+
+#endif  // LIBDNF_REPO_SEARCH_INDEX_HPP
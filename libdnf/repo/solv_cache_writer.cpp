@@ -0,0 +1,134 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "solv_cache_writer.hpp"
+
+#include "utils/fs/temp.hpp"
+
+#include "libdnf/base/base.hpp"
+
+#include <algorithm>
+#include <system_error>
+
+
+namespace libdnf::repo {
+
+SolvCacheWriter::~SolvCacheWriter() {
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        stop = true;
+    }
+    job_queued.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+
+void SolvCacheWriter::write(
+    std::filesystem::path path, std::shared_ptr<const std::string> data, std::shared_ptr<RepoCacheLock> lock) {
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        jobs.push_back(Job{std::move(path), std::move(data), std::move(lock)});
+        if (!worker.joinable()) {
+            try {
+                worker = std::thread(&SolvCacheWriter::run, this);
+            } catch (const std::system_error &) {
+                // Out of threads, write the file in the calling thread
+                auto job = std::move(jobs.back());
+                jobs.pop_back();
+                write_file(job);
+                return;
+            }
+        }
+    }
+    job_queued.notify_one();
+}
+
+
+void SolvCacheWriter::wait_for(const std::filesystem::path & path) {
+    std::unique_lock<std::mutex> lock(mutex);
+    job_finished.wait(lock, [&] {
+        return std::none_of(jobs.begin(), jobs.end(), [&](const Job & job) { return job.path == path; });
+    });
+}
+
+
+bool SolvCacheWriter::is_pending(const std::filesystem::path & path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::any_of(jobs.begin(), jobs.end(), [&](const Job & job) { return job.path == path; });
+}
+
+
+void SolvCacheWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    job_finished.wait(lock, [&] { return jobs.empty(); });
+}
+
+
+void SolvCacheWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        job_queued.wait(lock, [&] { return stop || !jobs.empty(); });
+        if (jobs.empty()) {
+            // stopped and all the files are written
+            return;
+        }
+
+        // The job stays in the queue while it is written, so that `wait_for()` waits for it.
+        auto & job = jobs.front();
+        lock.unlock();
+        write_file(job);
+        auto finished_lock = std::move(job.lock);
+        lock.lock();
+        jobs.pop_front();
+        job_finished.notify_all();
+
+        // release the lock of the solv files outside of the mutex
+        lock.unlock();
+        finished_lock.reset();
+        lock.lock();
+    }
+}
+
+
+void SolvCacheWriter::write_file(const Job & job) {
+    auto & logger = *base->get_logger();
+    try {
+        libdnf::base::Metrics::Span write_span(
+            *base->get_metrics(), "repo.write_solv_file", job.path.filename().native());
+
+        const auto parent_dir = job.path.parent_path();
+        std::filesystem::create_directory(parent_dir);
+
+        auto tmp_file = utils::fs::TempFile(parent_dir, job.path.filename());
+        auto & file = tmp_file.open_as_file("w+");
+        logger.trace("Writing solv cache file \"{}\"", tmp_file.get_path().native());
+        file.write(*job.data);
+        tmp_file.close();
+
+        std::filesystem::rename(tmp_file.get_path(), job.path);
+        tmp_file.release();
+    } catch (const std::exception & e) {
+        // the cache is an optimization, the metadata are parsed again next time
+        logger.warning("Failed to write solv cache file \"{}\": {}", job.path.native(), e.what());
+    }
+}
+
+}  // namespace libdnf::repo
@@ -0,0 +1,89 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF_REPO_SOLV_CACHE_WRITER_HPP
+#define LIBDNF_REPO_SOLV_CACHE_WRITER_HPP
+
+#include "libdnf/base/base_weak.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+namespace libdnf::repo {
+
+class RepoCacheLock;
+
+/// Writes solv cache files in a background thread.
+///
+/// The files are serialized by the caller, the writer never accesses the libsolv pool. Every file is written
+/// to a temporary file in the target directory and renamed to the target path, so readers never see a partially
+/// written file. The queued files are written in the order they were queued.
+class SolvCacheWriter {
+public:
+    explicit SolvCacheWriter(const BaseWeakPtr & base) : base(base) {}
+
+    /// Writes all the queued files.
+    ~SolvCacheWriter();
+
+    SolvCacheWriter(const SolvCacheWriter &) = delete;
+    SolvCacheWriter & operator=(const SolvCacheWriter &) = delete;
+
+    /// Queues writing of `data` to `path`.
+    /// @param lock  a lock released after the file is written, may be `nullptr`
+    void write(
+        std::filesystem::path path, std::shared_ptr<const std::string> data, std::shared_ptr<RepoCacheLock> lock);
+
+    /// Waits until the queued writes of `path` are finished.
+    void wait_for(const std::filesystem::path & path);
+
+    /// Returns `true` if a write of `path` is queued or being written. Does not wait.
+    bool is_pending(const std::filesystem::path & path);
+
+    /// Waits until all the queued writes are finished.
+    void flush();
+
+private:
+    struct Job {
+        std::filesystem::path path;
+        std::shared_ptr<const std::string> data;
+        std::shared_ptr<RepoCacheLock> lock;
+    };
+
+    void run();
+    void write_file(const Job & job);
+
+    BaseWeakPtr base;
+
+    std::mutex mutex;
+    std::condition_variable job_queued;
+    std::condition_variable job_finished;
+    std::deque<Job> jobs;  // the front job is being written, it is removed when finished
+    bool stop{false};
+    std::thread worker;
+};
+
+}  // namespace libdnf::repo
+
+#endif  // LIBDNF_REPO_SOLV_CACHE_WRITER_HPP
@@ -23,7 +23,6 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "repo_cache_private.hpp"
 #include "solv/pool.hpp"
 #include "utils/bgettext/bgettext-mark-domain.h"
-#include "utils/fs/temp.hpp"
 
 #include "libdnf/base/base.hpp"
 #include "libdnf/utils/to_underlying.hpp"
@@ -38,9 +37,20 @@ extern "C" {
 #include <solv/repo_solv.h>
 #include <solv/repo_updateinfoxml.h>
 #include <solv/repo_write.h>
+#include <solv/repodata.h>
 #include <solv/solv_xfopen.h>
 }
 
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
 
 namespace libdnf::repo {
 
@@ -59,7 +69,8 @@ static std::array<char, SOLV_USERDATA_SOLV_TOOLVERSION_SIZE> get_padded_solv_too
     return padded_solv_toolversion;
 }
 
-void SolvRepo::userdata_fill(SolvUserdata * userdata) {
+// Fills the userdata of a solv cache file of the repository with the repomd `checksum`.
+static void fill_solv_userdata(SolvUserdata * userdata, const unsigned char * checksum) {
     if (strlen(solv_toolversion) > SOLV_USERDATA_SOLV_TOOLVERSION_SIZE) {
         libdnf_throw_assertion(
             "Libsolv's solv_toolvesion is: {} long but we expect max of: {}",
@@ -73,6 +84,10 @@ void SolvRepo::userdata_fill(SolvUserdata * userdata) {
     memcpy(userdata->checksum, checksum, CHKSUM_BYTES);
 }
 
+void SolvRepo::userdata_fill(SolvUserdata * userdata) {
+    fill_solv_userdata(userdata, checksum);
+}
+
 bool SolvRepo::can_use_solvfile_cache(solv::Pool & pool, fs::File & solvfile_cache) {
     auto & logger = *base->get_logger();
 
@@ -218,6 +233,137 @@ bool is_one_piece(::Repo * repo) {
 }
 
 
+// Serializes the data selected by `writer` into memory.
+// Returns nullptr on failure, the error is described by pool_errstr().
+static std::shared_ptr<const std::string> write_to_memory(Repowriter * writer) {
+    char * buffer = nullptr;
+    size_t size = 0;
+    FILE * stream = open_memstream(&buffer, &size);
+    if (!stream) {
+        throw std::bad_alloc();
+    }
+    int res = repowriter_write(writer, stream);
+    fclose(stream);
+    std::unique_ptr<char, decltype(&free)> buffer_guard(buffer, &free);
+    if (res != 0) {
+        return nullptr;
+    }
+    return std::make_shared<const std::string>(buffer, size);
+}
+
+
+// Loads repodata serialized by write_to_memory() into `repo`. libsolv cannot page the data from memory,
+// they are loaded completely.
+static int add_solv_from_memory(::Repo * repo, const std::string & data, int flags) {
+    FILE * stream = fmemopen(const_cast<char *>(data.data()), data.size(), "r");
+    if (!stream) {
+        throw std::bad_alloc();
+    }
+    int res = repo_add_solv(repo, stream, flags);
+    fclose(stream);
+    return res;
+}
+
+
+// Parses extension metadata of the `type` from `ext_file` into `repo`.
+static int add_ext_metadata(::Repo * repo, fs::File & ext_file, RepodataType type) {
+    switch (type) {
+        case RepodataType::FILELISTS:
+            return repo_add_rpmmd(repo, ext_file.get(), "FL", REPO_EXTEND_SOLVABLES);
+        case RepodataType::PRESTO:
+            return repo_add_deltainfoxml(repo, ext_file.get(), 0);
+        case RepodataType::UPDATEINFO:
+            return repo_add_updateinfoxml(repo, ext_file.get(), 0);
+        case RepodataType::COMPS:
+            return repo_add_comps(repo, ext_file.get(), 0);
+        case RepodataType::OTHER:
+            return repo_add_rpmmd(repo, ext_file.get(), 0, REPO_EXTEND_SOLVABLES);
+    }
+
+    libdnf_throw_assertion("Unknown RepodataType: {}", utils::to_underlying(type));
+}
+
+
+// Serializes repodata `repodata_id` of `repo` in the format of the .solvx cache file of the `type`.
+// The solvables in range [solvables_start, solvables_end) are stored for the types adding new solvables.
+static std::shared_ptr<const std::string> write_ext_to_memory(
+    ::Repo * repo,
+    Id repodata_id,
+    RepodataType type,
+    const SolvUserdata & userdata,
+    Id solvables_start,
+    Id solvables_end) {
+    std::unique_ptr<Repowriter, decltype(&repowriter_free)> writer(repowriter_create(repo), &repowriter_free);
+    repowriter_set_userdata(writer.get(), &userdata, SOLV_USERDATA_SIZE);
+    repowriter_set_repodatarange(writer.get(), repodata_id, repodata_id + 1);
+
+    if (type == RepodataType::UPDATEINFO || type == RepodataType::COMPS) {
+        repowriter_set_solvablerange(writer.get(), solvables_start, solvables_end);
+    } else {
+        repowriter_set_flags(writer.get(), REPOWRITER_NO_STORAGE_SOLVABLE);
+    }
+
+    return write_to_memory(writer.get());
+}
+
+
+// Returns `true` if the solv cache file at `path` exists and was written with the `userdata`.
+static bool is_solv_file_current(const std::filesystem::path & path, const SolvUserdata & userdata) {
+    fs::File file;
+    try {
+        file = fs::File(path, "r");
+    } catch (const std::filesystem::filesystem_error &) {
+        return false;
+    }
+
+    unsigned char * read_userdata;
+    int read_userdata_len;
+    if (solv_read_userdata(file.get(), &read_userdata, &read_userdata_len) != 0) {
+        return false;
+    }
+    std::unique_ptr<unsigned char, decltype(&solv_free)> read_userdata_guard(read_userdata, &solv_free);
+    return read_userdata_len == SOLV_USERDATA_SIZE && memcmp(read_userdata, &userdata, SOLV_USERDATA_SIZE) == 0;
+}
+
+
+// Parses extension metadata of the `type` in a private pool seeded with the main solvables of the repo
+// serialized in `main_solv`. The private pool contains the same solvables of the repo in the same order,
+// so the serialized extension is the same as if it was parsed in the shared pool.
+static std::shared_ptr<const std::string> parse_ext_in_private_pool(
+    const std::string & repo_id,
+    const std::string & main_solv,
+    RepodataType type,
+    const std::string & ext_fn,
+    const SolvUserdata & userdata) {
+    solv::Pool pool;
+    pool_setdisttype(*pool, DISTTYPE_RPM);
+    ::Repo * repo = repo_create(*pool, repo_id.c_str());
+
+    if (add_solv_from_memory(repo, main_solv, 0) != 0) {
+        throw SolvError(M_("Failed to load primary cache for repo \"{}\": {}"), repo_id, pool_errstr(*pool));
+    }
+
+    int solvables_start = pool->nsolvables;
+    auto type_name = repodata_type_to_name(type);
+    fs::File ext_file(ext_fn, "r", true);
+    if (add_ext_metadata(repo, ext_file, type) != 0) {
+        throw SolvError(
+            M_("Failed to load {} extension for repo \"{}\" from \"{}\": {}"),
+            type_name,
+            repo_id,
+            ext_fn,
+            pool_errstr(*pool));
+    }
+
+    auto data = write_ext_to_memory(repo, repo->nrepodata - 1, type, userdata, solvables_start, pool->nsolvables);
+    if (!data) {
+        throw SolvError(
+            M_("Failed to write {} cache for repo \"{}\": {}"), type_name, repo_id, pool_errstr(*pool));
+    }
+    return data;
+}
+
+
 SolvRepo::SolvRepo(const libdnf::BaseWeakPtr & base, const ConfigRepo & config, void * appdata)
     : base(base),
       config(config),
@@ -234,7 +380,10 @@ SolvRepo::~SolvRepo() {
 }
 
 
-void SolvRepo::load_repo_main(const std::string & repomd_fn, const std::string & primary_fn) {
+std::shared_ptr<const std::string> SolvRepo::load_repo_main(
+    const std::string & repomd_fn,
+    const std::string & primary_fn,
+    const std::shared_ptr<const std::string> & primary_solv) {
     auto & logger = *base->get_logger();
     auto & pool = get_rpm_pool(base);
 
@@ -243,17 +392,47 @@ void SolvRepo::load_repo_main(const std::string & repomd_fn, const std::string &
     checksum_calc(checksum, repomd_file);
 
     int solvables_start = pool->nsolvables;
+    Id repodata_start = repo->nrepodata;
 
     if (load_solv_cache(pool, nullptr, 0)) {
         main_solvables_start = solvables_start;
         main_solvables_end = pool->nsolvables;
 
-        return;
+        return nullptr;
+    }
+
+    // another process may be building the same solv file, wait for it and use the result
+    bool waited;
+    auto solv_lock = lock_solv_files(waited);
+    if (waited && load_solv_cache(pool, nullptr, 0)) {
+        main_solvables_start = solvables_start;
+        main_solvables_end = pool->nsolvables;
+
+        return nullptr;
+    }
+
+    if (primary_solv) {
+        logger.debug("Loading primary for repo \"{}\" parsed in advance", config.get_id());
+        if (add_solv_from_memory(repo, *primary_solv, 0) != 0) {
+            throw SolvError(
+                M_("Failed to load primary for repo \"{}\" from \"{}\": {}."),
+                config.get_id(),
+                primary_fn,
+                pool_errstr(*pool));
+        }
+        main_solvables_start = solvables_start;
+        main_solvables_end = pool->nsolvables;
+        add_resident_repodata(repodata_start);
+
+        // the parsed data are the content of the .solv cache file
+        base->p_impl->get_solv_cache_writer().write(solv_file_path(), primary_solv, solv_files_lock.lock());
+        return primary_solv;
     }
 
     fs::File primary_file(primary_fn, "r", true);
 
     logger.debug("Loading repomd and primary for repo \"{}\"", config.get_id());
+    libdnf::base::Metrics::Span parse_span(*base->get_metrics(), "repo.parse_primary", config.get_id());
     if (repo_add_repomdxml(repo, repomd_file.get(), 0) != 0) {
         throw SolvError(
             M_("Failed to load repomd for repo \"{}\" from \"{}\": {}."),
@@ -272,10 +451,71 @@ void SolvRepo::load_repo_main(const std::string & repomd_fn, const std::string &
 
     main_solvables_start = solvables_start;
     main_solvables_end = pool->nsolvables;
+    add_resident_repodata(repodata_start);
+    parse_span.finish();
 
-    if (config.build_cache().get_value()) {
-        write_main(true);
+    if (!config.build_cache().get_value()) {
+        return nullptr;
+    }
+    return write_main();
+}
+
+
+std::shared_ptr<const std::string> SolvRepo::parse_repo_main(
+    const libdnf::BaseWeakPtr & base,
+    const ConfigRepo & config,
+    const std::string & repomd_fn,
+    const std::string & primary_fn) {
+    if (!config.build_cache().get_value()) {
+        return nullptr;
+    }
+
+    SolvUserdata solv_userdata{};
+    fs::File repomd_file(repomd_fn, "r");
+    unsigned char repomd_checksum[CHKSUM_BYTES];
+    checksum_calc(repomd_checksum, repomd_file);
+    fill_solv_userdata(&solv_userdata, repomd_checksum);
+
+    const auto solv_path = std::filesystem::path(config.get_cachedir()) / CACHE_SOLV_FILES_DIR /
+                           (config.get_id() + ".solv");
+    if (is_solv_file_current(solv_path, solv_userdata)) {
+        return nullptr;
+    }
+
+    base->get_logger()->debug("Parsing repomd and primary for repo \"{}\" in advance", config.get_id());
+    libdnf::base::Metrics::Span parse_span(*base->get_metrics(), "repo.parse_primary", config.get_id());
+    solv::Pool pool;
+    pool_setdisttype(*pool, DISTTYPE_RPM);
+    ::Repo * repo = repo_create(*pool, config.get_id().c_str());
+
+    fs::File primary_file(primary_fn, "r", true);
+    if (repo_add_repomdxml(repo, repomd_file.get(), 0) != 0) {
+        throw SolvError(
+            M_("Failed to load repomd for repo \"{}\" from \"{}\": {}."),
+            config.get_id(),
+            repomd_fn,
+            pool_errstr(*pool));
+    }
+    if (repo_add_rpmmd(repo, primary_file.get(), 0, 0) != 0) {
+        throw SolvError(
+            M_("Failed to load primary for repo \"{}\" from \"{}\": {}."),
+            config.get_id(),
+            primary_fn,
+            pool_errstr(*pool));
+    }
+
+    std::unique_ptr<Repowriter, decltype(&repowriter_free)> writer(repowriter_create(repo), &repowriter_free);
+    repowriter_set_userdata(writer.get(), &solv_userdata, SOLV_USERDATA_SIZE);
+    repowriter_set_solvablerange(writer.get(), repo->start, repo->end);
+    auto data = write_to_memory(writer.get());
+    if (!data) {
+        throw SolvError(
+            M_("Failed to write primary cache for repo \"{}\" to \"{}\": {}"),
+            config.get_id(),
+            solv_path.native(),
+            pool_errstr(*pool));
     }
+    return data;
 }
 
 
@@ -348,14 +588,28 @@ void SolvRepo::load_repo_ext(RepodataType type, const RepoDownloader & downloade
 
     int solvables_start = pool->nsolvables;
 
-    if (load_solv_cache(pool, type_name, repodata_type_to_flags(type))) {
-        if (type == RepodataType::UPDATEINFO) {
+    std::shared_ptr<RepoCacheLock> solv_lock;
+    bool cache_loaded = load_solv_cache(pool, type_name, repodata_type_to_flags(type));
+    if (!cache_loaded) {
+        // another process may be building the same solv file, wait for it and use the result
+        bool waited;
+        solv_lock = lock_solv_files(waited);
+        cache_loaded = waited && load_solv_cache(pool, type_name, repodata_type_to_flags(type));
+    }
+
+    if (cache_loaded) {
+        if (type == RepodataType::FILELISTS) {
+            filelists_loaded = true;
+        } else if (type == RepodataType::UPDATEINFO) {
             updateinfo_solvables_start = solvables_start;
             updateinfo_solvables_end = pool->nsolvables;
         } else if (type == RepodataType::COMPS) {
             comps_solvables_start = solvables_start;
             comps_solvables_end = pool->nsolvables;
         }
+        if (type != RepodataType::COMPS) {
+            ext_repodata_types[repo->nrepodata - 1] = type;
+        }
 
         return;
     }
@@ -363,32 +617,7 @@ void SolvRepo::load_repo_ext(RepodataType type, const RepoDownloader & downloade
     fs::File ext_file(ext_fn, "r", true);
     logger.debug("Loading {} extension for repo \"{}\" from \"{}\"", type_name, config.get_id(), ext_fn);
 
-    int res = 0;
-    switch (type) {
-        case RepodataType::FILELISTS:
-            res = repo_add_rpmmd(repo, ext_file.get(), "FL", REPO_EXTEND_SOLVABLES);
-            break;
-        case RepodataType::PRESTO:
-            res = repo_add_deltainfoxml(repo, ext_file.get(), 0);
-            break;
-        case RepodataType::UPDATEINFO:
-            if ((res = repo_add_updateinfoxml(repo, ext_file.get(), 0)) == 0) {
-                updateinfo_solvables_start = solvables_start;
-                updateinfo_solvables_end = pool->nsolvables;
-            }
-            break;
-        case RepodataType::COMPS:
-            if ((res = repo_add_comps(comps_repo, ext_file.get(), 0)) == 0) {
-                comps_solvables_start = solvables_start;
-                comps_solvables_end = pool->nsolvables;
-            }
-            break;
-        case RepodataType::OTHER:
-            res = repo_add_rpmmd(repo, ext_file.get(), 0, REPO_EXTEND_SOLVABLES);
-            break;
-    }
-
-    if (res != 0) {
+    if (add_ext_metadata(type == RepodataType::COMPS ? comps_repo : repo, ext_file, type) != 0) {
         throw SolvError(
             M_("Failed to load {} extension for repo \"{}\" from \"{}\": {}"),
             type_name,
@@ -397,8 +626,194 @@ void SolvRepo::load_repo_ext(RepodataType type, const RepoDownloader & downloade
             pool_errstr(*get_rpm_pool(base)));
     }
 
+    if (type == RepodataType::FILELISTS) {
+        filelists_loaded = true;
+    } else if (type == RepodataType::UPDATEINFO) {
+        updateinfo_solvables_start = solvables_start;
+        updateinfo_solvables_end = pool->nsolvables;
+    } else if (type == RepodataType::COMPS) {
+        comps_solvables_start = solvables_start;
+        comps_solvables_end = pool->nsolvables;
+    }
+    if (type != RepodataType::COMPS) {
+        ext_repodata_types[repo->nrepodata - 1] = type;
+        resident_repodata.insert(repo->nrepodata - 1);
+    }
+
     if (config.build_cache().get_value()) {
         write_ext(repo->nrepodata - 1, type);
+        if (type == RepodataType::FILELISTS) {
+            write_file_index();
+        }
+        if (type != RepodataType::UPDATEINFO && type != RepodataType::COMPS && repo->end == main_solvables_end &&
+            is_one_piece(repo)) {
+            written_exts.emplace_back(repo->nrepodata - 1, type);
+        }
+    }
+}
+
+
+void SolvRepo::load_repo_exts(
+    const std::vector<RepodataType> & types,
+    const RepoDownloader & downloader,
+    std::shared_ptr<const std::string> written_main_solv) {
+    // The private pools are seeded with the main solvables, the extensions must not be loaded yet
+    if (!config.build_cache().get_value() || main_solvables_start == 0 || repo->start != main_solvables_start ||
+        repo->end != main_solvables_end || !is_one_piece(repo)) {
+        written_main_solv.reset();
+        reload_written_main();
+        for (auto type : types) {
+            load_repo_ext(type, downloader);
+        }
+        return;
+    }
+
+    auto & logger = *base->get_logger();
+    auto & pool = get_rpm_pool(base);
+
+    struct Extension {
+        RepodataType type;
+        const char * type_name;
+        std::string path;
+        bool parse;
+        std::shared_ptr<const std::string> data;
+        std::exception_ptr error;
+    };
+
+    std::vector<Extension> extensions;
+    for (auto type : types) {
+        libdnf_assert(type != RepodataType::COMPS, "Comps are loaded into the comps pool by load_repo_ext()");
+        auto type_name = repodata_type_to_name(type);
+        const auto & ext_fn = downloader.get_metadata_path(type_name);
+        if (ext_fn.empty()) {
+            logger.debug("No {} metadata available for repo \"{}\"", type_name, config.get_id());
+            continue;
+        }
+        auto & extension = extensions.emplace_back();
+        extension.type = type;
+        extension.type_name = type_name;
+        extension.path = ext_fn;
+        extension.parse = !is_solv_cache_usable(pool, type_name);
+    }
+
+    auto needs_parsing = [&] {
+        return std::any_of(extensions.begin(), extensions.end(), [](auto & extension) { return extension.parse; });
+    };
+
+    std::shared_ptr<RepoCacheLock> solv_lock;
+    std::shared_ptr<const std::string> seed_solv;
+    if (needs_parsing()) {
+        // another process may be building the same solv files, wait for it and use the result
+        bool waited;
+        solv_lock = lock_solv_files(waited);
+        if (waited) {
+            for (auto & extension : extensions) {
+                extension.parse = extension.parse && !is_solv_cache_usable(pool, extension.type_name);
+            }
+        }
+
+        // The main repodata written by this process may still be queued for writing, they are not waited for
+        if (needs_parsing() && written_main_solv) {
+            seed_solv = written_main_solv;
+        } else if (needs_parsing() && is_solv_cache_usable(pool, nullptr)) {
+            seed_solv = std::make_shared<const std::string>(fs::File(solv_file_path(), "r").read());
+        }
+    }
+
+    if (needs_parsing() && seed_solv) {
+        libdnf::base::Metrics::Span parse_span(*base->get_metrics(), "repo.parse_ext", config.get_id());
+        SolvUserdata solv_userdata{};
+        userdata_fill(&solv_userdata);
+
+        auto parse_extension = [&](Extension & extension) {
+            try {
+                libdnf::base::Metrics::Span span(*base->get_metrics(), "repo.parse_ext_type", extension.type_name);
+                extension.data = parse_ext_in_private_pool(
+                    config.get_id(), *seed_solv, extension.type, extension.path, solv_userdata);
+            } catch (...) {
+                // The thread must not throw exceptions. Pass them to the caller.
+                extension.error = std::current_exception();
+            }
+        };
+
+        std::vector<Extension *> to_parse;
+        for (auto & extension : extensions) {
+            if (extension.parse) {
+                logger.debug(
+                    "Loading {} extension for repo \"{}\" from \"{}\"",
+                    extension.type_name,
+                    config.get_id(),
+                    extension.path);
+                to_parse.push_back(&extension);
+            }
+        }
+
+        std::vector<std::thread> threads;
+        std::size_t next = 1;
+        try {
+            for (; next < to_parse.size(); ++next) {
+                threads.emplace_back(parse_extension, std::ref(*to_parse[next]));
+            }
+        } catch (const std::system_error &) {
+            // Out of threads, the remaining extensions are parsed by the calling thread
+        }
+        parse_extension(*to_parse[0]);
+        for (; next < to_parse.size(); ++next) {
+            parse_extension(*to_parse[next]);
+        }
+        for (auto & thread : threads) {
+            thread.join();
+        }
+    }
+
+    // the main repodata serialized by this process are needed only to seed the private pools
+    seed_solv.reset();
+    written_main_solv.reset();
+    reload_written_main();
+
+    // Load the extensions in the requested order, UPDATEINFO adds new solvables after the extended ones.
+    // The written extensions are reloaded lazily from their files by `reload_written_exts()` once they are written.
+    for (auto & extension : extensions) {
+        if (extension.parse && !extension.data) {
+            if (extension.error) {
+                std::rethrow_exception(extension.error);
+            }
+            // there is no seed of the private pool
+            load_repo_ext(extension.type, downloader);
+            continue;
+        }
+
+        int solvables_start = pool->nsolvables;
+        if (extension.parse) {
+            if (add_solv_from_memory(repo, *extension.data, repodata_type_to_flags(extension.type)) != 0) {
+                throw SolvError(
+                    M_("Failed to load {} extension for repo \"{}\" from \"{}\": {}"),
+                    extension.type_name,
+                    config.get_id(),
+                    extension.path,
+                    pool_errstr(*pool));
+            }
+            base->p_impl->get_solv_cache_writer().write(
+                solv_file_path(extension.type_name), std::move(extension.data), solv_lock);
+            resident_repodata.insert(repo->nrepodata - 1);
+            if (extension.type != RepodataType::UPDATEINFO) {
+                written_exts.emplace_back(repo->nrepodata - 1, extension.type);
+            }
+        } else if (!load_solv_cache(pool, extension.type_name, repodata_type_to_flags(extension.type))) {
+            load_repo_ext(extension.type, downloader);
+            continue;
+        }
+
+        ext_repodata_types[repo->nrepodata - 1] = extension.type;
+        if (extension.type == RepodataType::FILELISTS) {
+            filelists_loaded = true;
+            if (extension.parse) {
+                write_file_index();
+            }
+        } else if (extension.type == RepodataType::UPDATEINFO) {
+            updateinfo_solvables_start = solvables_start;
+            updateinfo_solvables_end = pool->nsolvables;
+        }
     }
 }
 
@@ -417,6 +832,7 @@ void SolvRepo::load_system_repo(const std::string & rootdir) {
 
     int solvables_start = pool->nsolvables;
 
+    libdnf::base::Metrics::Span rpmdb_span(*base->get_metrics(), "repo.load_rpmdb");
     int flagsrpm = REPO_REUSE_REPODATA | RPM_ADD_WITH_HDRID | REPO_USE_ROOTDIR;
     if (repo_add_rpmdb(repo, nullptr, flagsrpm) != 0) {
         throw SolvError(
@@ -437,6 +853,77 @@ void SolvRepo::load_system_repo(const std::string & rootdir) {
 }
 
 
+std::pair<std::size_t, std::size_t> SolvRepo::update_system_repo(const std::set<std::string> & names) {
+    libdnf_assert(repo->pool->installed == repo, "Only the system repo can be updated from the rpmdb");
+
+    auto & logger = *base->get_logger();
+    auto & pool = get_rpm_pool(base);
+    libdnf::base::Metrics::Span span(*base->get_metrics(), "repo.update_system_repo");
+
+    // The loaded solvables of the given names by their rpmdb id. Solvables not loaded
+    // from the rpmdb (e.g. from a testcase) have no rpmdb id and are left alone.
+    std::unordered_set<Id> name_ids;
+    for (const auto & name : names) {
+        if (Id name_id = pool_str2id(*pool, name.c_str(), 0)) {
+            name_ids.insert(name_id);
+        }
+    }
+    std::unordered_map<Id, Id> loaded;
+    Id solvable_id;
+    Solvable * solvable;
+    FOR_REPO_SOLVABLES(repo, solvable_id, solvable) {
+        if (name_ids.find(solvable->name) == name_ids.end()) {
+            continue;
+        }
+        if (auto rpmdbid = static_cast<Id>(repo_lookup_num(repo, solvable_id, RPM_RPMDBID, 0))) {
+            loaded.emplace(rpmdbid, solvable_id);
+        }
+    }
+
+    std::unique_ptr<void, void * (*)(void *)> rpm_state(
+        rpm_state_create(*pool, pool_get_rootdir(*pool)), rpm_state_free);
+
+    // After the loop `loaded` contains only the packages erased from the rpmdb.
+    std::vector<Id> added;
+    libdnf::solv::IdQueue rpmdbids;
+    for (const auto & name : names) {
+        rpmdbids.clear();
+        rpm_installedrpmdbids(rpm_state.get(), "Name", name.c_str(), &rpmdbids.get_queue());
+        for (int i = 0; i < rpmdbids.size(); ++i) {
+            auto it = loaded.find(rpmdbids[i]);
+            if (it == loaded.end()) {
+                added.push_back(rpmdbids[i]);
+            } else {
+                loaded.erase(it);
+            }
+        }
+    }
+
+    // Ids are not reused, PackageSets and excludes referring to the freed solvables must not match new packages.
+    for (const auto & [rpmdbid, id] : loaded) {
+        repo_free_solvable(repo, id, 0);
+    }
+
+    for (auto rpmdbid : added) {
+        auto * handle = rpm_byrpmdbid(rpm_state.get(), rpmdbid);
+        const int flags = REPO_REUSE_REPODATA | REPO_NO_INTERNALIZE | RPM_ADD_WITH_HDRID;
+        Id new_id = handle ? repo_add_rpm_handle(repo, handle, flags) : 0;
+        if (new_id == 0) {
+            throw SolvError(
+                M_("Failed to read package with rpmdb id {} into the system repo: {}"), rpmdbid, pool_errstr(*pool));
+        }
+        repo_set_num(repo, new_id, RPM_RPMDBID, static_cast<unsigned long long>(rpmdbid));
+    }
+
+    main_solvables_end = pool->nsolvables;
+    search_index.reset();
+    set_needs_internalizing();
+
+    logger.debug("Updated system repo: {} packages removed, {} packages added", loaded.size(), added.size());
+    return {loaded.size(), added.size()};
+}
+
+
 // return true if q1 is a superset of q2
 // only works if there are no duplicates both in q1 and q2
 // the map parameter must point to an empty map that can hold all ids
@@ -481,7 +968,7 @@ void SolvRepo::rewrite_repo(libdnf::solv::IdQueue & fileprovides) {
     repodata_set_idarray(data, SOLVID_META, REPOSITORY_ADDEDFILEPROVIDES, &fileprovides.get_queue());
     repodata_internalize(data);
 
-    write_main(false);
+    write_main();
 }
 
 
@@ -504,16 +991,36 @@ void SolvRepo::set_subpriority(int subpriority) {
 }
 
 
+std::shared_ptr<RepoCacheLock> SolvRepo::lock_solv_files(bool & waited) {
+    waited = false;
+    if (!config.build_cache().get_value()) {
+        return nullptr;
+    }
+
+    // The lock is per process, a second lock of the same file would release the first one when unlocked
+    if (auto lock = solv_files_lock.lock()) {
+        return lock;
+    }
+
+    std::shared_ptr<RepoCacheLock> lock = lock_repo_cache(
+        *base->get_logger(), std::filesystem::path(config.get_cachedir()) / CACHE_SOLV_FILES_LOCK, true, waited);
+    solv_files_lock = lock;
+    return lock;
+}
+
+
 bool SolvRepo::load_solv_cache(solv::Pool & pool, const char * type, int flags) {
     auto & logger = *base->get_logger();
 
     auto path = solv_file_path(type);
+    base->p_impl->get_solv_cache_writer().wait_for(path);
 
     try {
         fs::File cache_file(path, "r");
 
         if (can_use_solvfile_cache(pool, cache_file)) {
             logger.debug("Loading solv cache file: \"{}\"", path.native());
+            libdnf::base::Metrics::Span load_span(*base->get_metrics(), "repo.load_solv", path.filename().native());
             if (repo_add_solv(type == RepoDownloader::MD_FILENAME_GROUP ? comps_repo : repo, cache_file.get(), flags) !=
                 0) {
                 throw SolvError(
@@ -537,63 +1044,56 @@ bool SolvRepo::load_solv_cache(solv::Pool & pool, const char * type, int flags)
 }
 
 
-void SolvRepo::write_main(bool load_after_write) {
+bool SolvRepo::is_solv_cache_usable(solv::Pool & pool, const char * type) {
+    auto path = solv_file_path(type);
+    base->p_impl->get_solv_cache_writer().wait_for(path);
+
+    try {
+        fs::File cache_file(path, "r");
+        return can_use_solvfile_cache(pool, cache_file);
+    } catch (const std::filesystem::filesystem_error & e) {
+        if (e.code().default_error_condition() != std::errc::no_such_file_or_directory) {
+            base->get_logger()->warning("Error opening cache file, ignoring: {}", e.what());
+        }
+    }
+
+    return false;
+}
+
+
+std::shared_ptr<const std::string> SolvRepo::write_main() {
     auto & logger = *base->get_logger();
+    libdnf::base::Metrics::Span write_span(*base->get_metrics(), "repo.write_solv", config.get_id());
     auto & pool = get_rpm_pool(base);
 
     const char * chksum = pool_bin2hex(*pool, checksum, solv_chksum_len(CHKSUM_TYPE));
 
     const auto solvfile_path = solv_file_path();
-    const auto solvfile_parent_dir = solvfile_path.parent_path();
-
-    std::filesystem::create_directory(solvfile_parent_dir);
-
-    auto cache_tmp_file = fs::TempFile(solvfile_parent_dir, solvfile_path.filename());
-    auto & cache_file = cache_tmp_file.open_as_file("w+");
 
     logger.trace(
         "Writing primary cache for repo \"{}\" to \"{}\" (checksum: 0x{})",
         config.get_id(),
-        cache_tmp_file.get_path().native(),
+        solvfile_path.native(),
         chksum);
 
     SolvUserdata solv_userdata{};
     userdata_fill(&solv_userdata);
 
-    Repowriter * writer = repowriter_create(repo);
-    repowriter_set_userdata(writer, &solv_userdata, SOLV_USERDATA_SIZE);
-    repowriter_set_solvablerange(writer, main_solvables_start, main_solvables_end);
-    int res = repowriter_write(writer, cache_file.get());
-    repowriter_free(writer);
+    std::unique_ptr<Repowriter, decltype(&repowriter_free)> writer(repowriter_create(repo), &repowriter_free);
+    repowriter_set_userdata(writer.get(), &solv_userdata, SOLV_USERDATA_SIZE);
+    repowriter_set_solvablerange(writer.get(), main_solvables_start, main_solvables_end);
+    auto data = write_to_memory(writer.get());
 
-    if (res != 0) {
+    if (!data) {
         throw SolvError(
             M_("Failed to write primary cache for repo \"{}\" to \"{}\": {}"),
             config.get_id(),
-            cache_tmp_file.get_path().native(),
+            solvfile_path.native(),
             pool_errstr(*pool));
     }
 
-    cache_tmp_file.close();
-
-    if (load_after_write && is_one_piece(repo)) {
-        // this saves memory, libsolv doesn't load all the data from a solv file, it dup()s the fd,
-        // keeps the file open and lazily loads some data on-demand.
-        fs::File file(cache_tmp_file.get_path(), "r");
-
-        repo_empty(repo, 1);
-        int ret = repo_add_solv(repo, file.get(), 0);
-        if (ret) {
-            throw SolvError(
-                M_("Failed to re-load primary cache for repo \"{}\" from \"{}\": {}"),
-                config.get_id(),
-                cache_tmp_file.get_path().native(),
-                pool_errstr(*pool));
-        }
-    }
-
-    std::filesystem::rename(cache_tmp_file.get_path(), solvfile_path);
-    cache_tmp_file.release();
+    base->p_impl->get_solv_cache_writer().write(solvfile_path, data, solv_files_lock.lock());
+    return data;
 }
 
 
@@ -601,82 +1101,254 @@ void SolvRepo::write_ext(Id repodata_id, RepodataType type) {
     libdnf_assert(repodata_id != 0, "0 is not a valid repodata id");
 
     auto & logger = *base->get_logger();
+    libdnf::base::Metrics::Span write_span(*base->get_metrics(), "repo.write_solv", config.get_id());
     solv::Pool & pool = type == RepodataType::COMPS ? static_cast<solv::Pool &>(get_comps_pool(base))
                                                     : static_cast<solv::Pool &>(get_rpm_pool(base));
 
     const auto type_name = repodata_type_to_name(type);
     const auto solvfile_path = solv_file_path(type_name);
-    const auto solvfile_parent_dir = solvfile_path.parent_path();
-
-    std::filesystem::create_directory(solvfile_parent_dir);
-
-    auto cache_tmp_file = fs::TempFile(solvfile_parent_dir, solvfile_path.filename());
-    auto & cache_file = cache_tmp_file.open_as_file("w+");
 
     logger.trace(
-        "Writing {} extension cache for repo \"{}\" to \"{}\"",
-        type_name,
-        config.get_id(),
-        cache_tmp_file.get_path().native());
-
+        "Writing {} extension cache for repo \"{}\" to \"{}\"", type_name, config.get_id(), solvfile_path.native());
 
     SolvUserdata solv_userdata{};
     userdata_fill(&solv_userdata);
 
-    Repowriter * writer;
-    if (type == RepodataType::COMPS) {
-        writer = repowriter_create(comps_repo);
-    } else {
-        writer = repowriter_create(repo);
-    }
-    repowriter_set_userdata(writer, &solv_userdata, SOLV_USERDATA_SIZE);
-    repowriter_set_repodatarange(writer, repodata_id, repodata_id + 1);
-
+    std::shared_ptr<const std::string> data;
     if (type == RepodataType::UPDATEINFO) {
-        repowriter_set_solvablerange(writer, updateinfo_solvables_start, updateinfo_solvables_end);
+        data = write_ext_to_memory(
+            repo, repodata_id, type, solv_userdata, updateinfo_solvables_start, updateinfo_solvables_end);
     } else if (type == RepodataType::COMPS) {
-        repowriter_set_solvablerange(writer, comps_solvables_start, comps_solvables_end);
+        data = write_ext_to_memory(
+            comps_repo, repodata_id, type, solv_userdata, comps_solvables_start, comps_solvables_end);
     } else {
-        repowriter_set_flags(writer, REPOWRITER_NO_STORAGE_SOLVABLE);
+        data = write_ext_to_memory(repo, repodata_id, type, solv_userdata, 0, 0);
     }
 
-    int res = repowriter_write(writer, cache_file.get());
-    repowriter_free(writer);
-
-    if (res != 0) {
+    if (!data) {
         throw SolvError(
             M_("Failed to write {} cache for repo \"{}\" to \"{}\": {}"),
             type_name,
             config.get_id(),
-            cache_tmp_file.get_path().native(),
+            solvfile_path.native(),
             pool_errstr(*pool));
     }
 
-    cache_tmp_file.close();
+    base->p_impl->get_solv_cache_writer().write(solvfile_path, std::move(data), solv_files_lock.lock());
+}
 
-    if (is_one_piece(repo) && type != RepodataType::UPDATEINFO && type != RepodataType::COMPS) {
-        // this saves memory, libsolv doesn't load all the data from a solv file, it dup()s the fd,
-        // keeps the file open and lazily loads some data on-demand.
-        fs::File file(cache_tmp_file.get_path(), "r");
 
-        Repodata * data = repo_id2repodata(repo, repodata_id);
+bool SolvRepo::reload_written_main() {
+    auto & logger = *base->get_logger();
+    auto & pool = get_rpm_pool(base);
 
-        repodata_extend_block(data, repo->start, repo->end - repo->start);
-        data->state = REPODATA_LOADING;
-        res = repo_add_solv(repo, file.get(), repodata_type_to_flags(type) | REPO_USE_LOADING);
-        if (res) {
-            throw SolvError(
-                M_("Failed to re-load {} cache for repo \"{}\" from \"{}\": {}"),
-                type_name,
-                config.get_id(),
-                cache_tmp_file.get_path().native(),
-                pool_errstr(*pool));
+    // The solvables are loaded again with the same ids, the repo must be the last one in the pool.
+    // Only the main repodata written by this process are held in memory.
+    if (main_solvables_start == 0 || !ext_repodata_types.empty() || !resident_repodata.contains(1) ||
+        repo->start != main_solvables_start || repo->end != main_solvables_end || repo->end != pool->nsolvables ||
+        !is_one_piece(repo)) {
+        return false;
+    }
+
+    const auto path = solv_file_path();
+    if (base->p_impl->get_solv_cache_writer().is_pending(path)) {
+        logger.debug("Keeping primary of repo \"{}\" loaded, its solv cache file is being written", config.get_id());
+        return false;
+    }
+
+    fs::File file;
+    try {
+        file = fs::File(path, "r");
+    } catch (const std::filesystem::filesystem_error & e) {
+        logger.debug("Keeping primary of repo \"{}\" loaded: {}", config.get_id(), e.what());
+        return false;
+    }
+    if (!can_use_solvfile_cache(pool, file)) {
+        logger.debug("Keeping primary of repo \"{}\" loaded, its solv cache file is outdated", config.get_id());
+        return false;
+    }
+
+    // this saves memory, libsolv doesn't load all the data from a solv file, it dup()s the fd,
+    // keeps the file open and lazily loads some data on-demand.
+    repo_empty(repo, 1);
+    resident_repodata.clear();
+    if (repo_add_solv(repo, file.get(), 0) != 0) {
+        throw SolvError(
+            M_("Failed to re-load primary cache for repo \"{}\" from \"{}\": {}"),
+            config.get_id(),
+            path.native(),
+            pool_errstr(*pool));
+    }
+    libdnf_assert(
+        repo->start == main_solvables_start && repo->end == main_solvables_end,
+        "Solvables of repo \"{}\" were re-loaded with different ids",
+        config.get_id());
+    return true;
+}
+
+
+bool SolvRepo::reload_ext(Id repodata_id, RepodataType type) {
+    auto & logger = *base->get_logger();
+    auto & pool = get_rpm_pool(base);
+
+    const auto type_name = repodata_type_to_name(type);
+    const auto path = solv_file_path(type_name);
+    base->p_impl->get_solv_cache_writer().wait_for(path);
+
+    fs::File file;
+    try {
+        file = fs::File(path, "r");
+    } catch (const std::filesystem::filesystem_error & e) {
+        logger.debug("Keeping {} extension of repo \"{}\" loaded: {}", type_name, config.get_id(), e.what());
+        return false;
+    }
+    if (!can_use_solvfile_cache(pool, file)) {
+        logger.debug(
+            "Keeping {} extension of repo \"{}\" loaded, its solv cache file is outdated", type_name, config.get_id());
+        return false;
+    }
+
+    // this saves memory, libsolv doesn't load all the data from a solv file, it dup()s the fd,
+    // keeps the file open and lazily loads some data on-demand.
+    // The file was written for the main solvables, UPDATEINFO may have added more solvables since then.
+    Repodata * data = repo_id2repodata(repo, repodata_id);
+    repodata_extend_block(data, main_solvables_start, main_solvables_end - main_solvables_start);
+    data->state = REPODATA_LOADING;
+    if (repo_add_solv(repo, file.get(), repodata_type_to_flags(type) | REPO_USE_LOADING) != 0) {
+        throw SolvError(
+            M_("Failed to re-load {} cache for repo \"{}\" from \"{}\": {}"),
+            type_name,
+            config.get_id(),
+            path.native(),
+            pool_errstr(*pool));
+    }
+    data->state = REPODATA_AVAILABLE;
+    resident_repodata.erase(repodata_id);
+    return true;
+}
+
+
+void SolvRepo::add_resident_repodata(Id repodata_start) {
+    for (Id repodata_id = repodata_start; repodata_id < repo->nrepodata; ++repodata_id) {
+        resident_repodata.insert(repodata_id);
+    }
+}
+
+
+const SearchIndex & SolvRepo::get_search_index() {
+    // Index of an available repo covers the solvables loaded from primary metadata and is cached
+    // next to the .solv file. Other repos (system, command line) are indexed in memory only and
+    // are reindexed when new solvables are added to them.
+    const bool cacheable = is_search_index_cacheable();
+    const Id start = cacheable ? main_solvables_start : repo->start;
+    const Id end = cacheable ? main_solvables_end : repo->end;
+
+    if (search_index && search_index->covers(start, end)) {
+        return *search_index;
+    }
+
+    if (cacheable) {
+        auto & logger = *base->get_logger();
+        const auto path = search_index_file_path();
+        auto index = std::make_unique<SearchIndex>();
+        try {
+            if (index->load(path, checksum, CHKSUM_BYTES, start, end)) {
+                logger.debug("Loaded search index for repo \"{}\" from \"{}\"", config.get_id(), path.native());
+                search_index = std::move(index);
+                return *search_index;
+            }
+        } catch (const std::filesystem::filesystem_error & e) {
+            logger.warning("Error reading search index cache file, ignoring: {}", e.what());
+        }
+        write_search_index();
+    } else {
+        search_index = std::make_unique<SearchIndex>();
+        search_index->build(get_rpm_pool(base), repo, start, end);
+    }
+
+    return *search_index;
+}
+
+
+bool SolvRepo::is_search_index_cacheable() const {
+    return config.build_cache().get_value() && main_solvables_start != 0 && repo->pool->installed != repo;
+}
+
+
+void SolvRepo::write_search_index() {
+    auto & logger = *base->get_logger();
+
+    search_index = std::make_unique<SearchIndex>();
+    search_index->build(get_rpm_pool(base), repo, main_solvables_start, main_solvables_end);
+
+    const auto path = search_index_file_path();
+    logger.trace("Writing search index for repo \"{}\" to \"{}\"", config.get_id(), path.native());
+    try {
+        search_index->write(path, checksum, CHKSUM_BYTES);
+    } catch (const std::filesystem::filesystem_error & e) {
+        logger.warning("Failed to write search index for repo \"{}\": {}", config.get_id(), e.what());
+    }
+}
+
+
+std::filesystem::path SolvRepo::search_index_file_path() {
+    return std::filesystem::path(config.get_cachedir()) / CACHE_SOLV_FILES_DIR / (config.get_id() + "-search.idx");
+}
+
+
+const FileIndex * SolvRepo::get_file_index() {
+    // Only the filelists of an available repo are indexed. Without loaded filelists the file filters
+    // see only the files listed in primary metadata and the index must not find more.
+    if (!filelists_loaded || main_solvables_start == 0) {
+        return nullptr;
+    }
+    if (file_index && file_index->covers(main_solvables_start, main_solvables_end)) {
+        return file_index.get();
+    }
+
+    if (config.build_cache().get_value()) {
+        auto & logger = *base->get_logger();
+        const auto path = file_index_file_path();
+        auto index = std::make_unique<FileIndex>();
+        try {
+            if (index->load(path, checksum, CHKSUM_BYTES, main_solvables_start, main_solvables_end)) {
+                logger.debug("Loaded file index for repo \"{}\" from \"{}\"", config.get_id(), path.native());
+                file_index = std::move(index);
+                return file_index.get();
+            }
+        } catch (const std::filesystem::filesystem_error & e) {
+            logger.warning("Error reading file index cache file, ignoring: {}", e.what());
         }
-        data->state = REPODATA_AVAILABLE;
+        write_file_index();
+    } else {
+        internalize();
+        file_index = std::make_unique<FileIndex>();
+        file_index->build(get_rpm_pool(base), repo, main_solvables_start, main_solvables_end);
     }
 
-    std::filesystem::rename(cache_tmp_file.get_path(), solvfile_path);
-    cache_tmp_file.release();
+    return file_index.get();
+}
+
+
+void SolvRepo::write_file_index() {
+    auto & logger = *base->get_logger();
+
+    internalize();
+    file_index = std::make_unique<FileIndex>();
+    file_index->build(get_rpm_pool(base), repo, main_solvables_start, main_solvables_end);
+
+    const auto path = file_index_file_path();
+    logger.trace("Writing file index for repo \"{}\" to \"{}\"", config.get_id(), path.native());
+    try {
+        file_index->write(path, checksum, CHKSUM_BYTES);
+    } catch (const std::filesystem::filesystem_error & e) {
+        logger.warning("Failed to write file index for repo \"{}\": {}", config.get_id(), e.what());
+    }
+}
+
+
+std::filesystem::path SolvRepo::file_index_file_path() {
+    return std::filesystem::path(config.get_cachedir()) / CACHE_SOLV_FILES_DIR / (config.get_id() + "-filenames.idx");
 }
 
 
@@ -693,4 +1365,126 @@ std::filesystem::path SolvRepo::solv_file_path(const char * type) {
     return std::filesystem::path(config.get_cachedir()) / CACHE_SOLV_FILES_DIR / solv_file_name(type);
 }
 
+// Returns estimated memory use of the keys of `data` in bytes by the key name. libsolv knows the sizes only
+// for the repodata loaded from solv data, the keys of repodata parsed from the metadata have size 0.
+// The vertical keys of repodata loaded from a solv file are read from the file on demand, they are counted
+// only for `resident` repodata.
+static std::map<Id, std::size_t> get_repodata_key_sizes(const Repodata & data, bool resident) {
+    std::map<Id, std::size_t> sizes;
+    for (int idx = 1; idx < data.nkeys; ++idx) {
+        const auto & key = data.keys[idx];
+        // the size of the constant keys is their value
+        if (key.type == REPOKEY_TYPE_CONSTANT || key.type == REPOKEY_TYPE_CONSTANTID || key.type == REPOKEY_TYPE_VOID) {
+            continue;
+        }
+        if (resident || key.storage != KEY_STORAGE_VERTICAL_OFFSET) {
+            sizes[key.name] += key.size;
+        }
+    }
+    return sizes;
+}
+
+
+// Returns estimated memory use of `data` in bytes: its keys, local string pool and directories.
+static std::size_t get_repodata_size(const Repodata & data, bool resident) {
+    std::size_t size = data.spool.sstrings + static_cast<std::size_t>(data.dirpool.ndirs) * sizeof(Id);
+    for (const auto & [name, key_size] : get_repodata_key_sizes(data, resident)) {
+        size += key_size;
+    }
+    return size;
+}
+
+
+// Returns the size of the vertical keys of `data` in bytes, the data libsolv reads from the solv file on demand.
+static std::size_t get_repodata_paged_size(const Repodata & data) {
+    std::size_t size = 0;
+    for (int idx = 1; idx < data.nkeys; ++idx) {
+        if (data.keys[idx].storage == KEY_STORAGE_VERTICAL_OFFSET) {
+            size += data.keys[idx].size;
+        }
+    }
+    return size;
+}
+
+
+std::size_t SolvRepo::release_repo_exts(const std::set<RepodataType> & types) {
+    auto & logger = *base->get_logger();
+
+    std::size_t released_size = 0;
+    for (const auto & [repodata_id, type] : ext_repodata_types) {
+        // UPDATEINFO adds solvables, loading it again would add them again
+        if (!types.contains(type) || type == RepodataType::UPDATEINFO) {
+            continue;
+        }
+        // the extensions loaded from their solv files are already read on demand, reloading them saves nothing
+        if (!resident_repodata.contains(repodata_id) ||
+            repo_id2repodata(repo, repodata_id)->state != REPODATA_AVAILABLE) {
+            continue;
+        }
+
+        if (!reload_ext(repodata_id, type)) {
+            continue;
+        }
+        std::erase(written_exts, std::make_pair(repodata_id, type));
+
+        // only the vertical data of the reloaded extension stop being held in memory
+        const auto size = get_repodata_paged_size(*repo_id2repodata(repo, repodata_id));
+        released_size += size;
+        logger.debug(
+            "Released {} extension of repo \"{}\" ({} bytes)", repodata_type_to_name(type), config.get_id(), size);
+    }
+
+    return released_size;
+}
+
+
+void SolvRepo::reload_written_exts() {
+    auto & writer = base->p_impl->get_solv_cache_writer();
+    std::erase_if(written_exts, [&](const auto & written_ext) {
+        const auto [repodata_id, type] = written_ext;
+        if (writer.is_pending(solv_file_path(repodata_type_to_name(type)))) {
+            return false;
+        }
+        reload_ext(repodata_id, type);
+        return true;
+    });
+}
+
+
+std::size_t SolvRepo::get_memory_use() const {
+    std::size_t total_size = 0;
+    for (Id repodata_id = 1; repodata_id < repo->nrepodata; ++repodata_id) {
+        total_size +=
+            get_repodata_size(*repo_id2repodata(repo, repodata_id), resident_repodata.contains(repodata_id));
+    }
+    return total_size;
+}
+
+
+void SolvRepo::log_memory_use() {
+    auto & logger = *base->get_logger();
+    auto & pool = get_rpm_pool(base);
+
+    logger.debug("Estimated memory use of repo \"{}\": {} bytes", config.get_id(), get_memory_use());
+
+    for (Id repodata_id = 1; repodata_id < repo->nrepodata; ++repodata_id) {
+        const auto & data = *repo_id2repodata(repo, repodata_id);
+        auto type_it = ext_repodata_types.find(repodata_id);
+        const char * name = type_it != ext_repodata_types.end() ? repodata_type_to_name(type_it->second) : "main";
+        const bool resident = resident_repodata.contains(repodata_id);
+        logger.debug("  {} repodata: {} bytes", name, get_repodata_size(data, resident));
+
+        auto key_sizes = get_repodata_key_sizes(data, resident);
+        std::vector<std::pair<Id, std::size_t>> keys(key_sizes.begin(), key_sizes.end());
+        std::stable_sort(keys.begin(), keys.end(), [](const auto & lhs, const auto & rhs) {
+            return lhs.second > rhs.second;
+        });
+        for (const auto & [key_name, key_size] : keys) {
+            if (key_size > 0) {
+                logger.debug("    {}: {} bytes", pool.id2str(key_name), key_size);
+            }
+        }
+    }
+}
+
 }  //namespace libdnf::repo
@@ -20,7 +20,10 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef LIBDNF_REPO_SOLV_REPO_HPP
 #define LIBDNF_REPO_SOLV_REPO_HPP
 
+#include "file_index.hpp"
+#include "repo_cache_private.hpp"
 #include "repo_downloader.hpp"
+#include "search_index.hpp"
 #include "solv/id_queue.hpp"
 #include "solv/pool.hpp"
 #include "utils/fs/file.hpp"
@@ -32,6 +35,12 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include <solv/repo.h>
 
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
 
 
 static const constexpr size_t CHKSUM_BYTES = 32;
@@ -69,11 +78,39 @@ public:
     ~SolvRepo();
 
     /// Loads main metadata (solvables) from available repo.
-    void load_repo_main(const std::string & repomd_fn, const std::string & primary_fn);
+    /// @param primary_solv  the metadata parsed in advance by `parse_repo_main()`, or nullptr to parse them here
+    /// @return The main repodata serialized by this process for the .solv cache file, or nullptr if they were
+    ///         loaded from the file or the cache files are not built. They are to be passed to `load_repo_exts()`.
+    std::shared_ptr<const std::string> load_repo_main(
+        const std::string & repomd_fn,
+        const std::string & primary_fn,
+        const std::shared_ptr<const std::string> & primary_solv = nullptr);
+
+    /// Parses the main metadata of an available repo in a private pool and serializes them into the content
+    /// of its .solv cache file. Does not access the shared pool, the metadata of several repos can be parsed
+    /// in parallel with each other and with the loading of other repos.
+    /// @return The serialized main repodata, or nullptr if the cache files are not built or the .solv cache file
+    ///         is valid.
+    static std::shared_ptr<const std::string> parse_repo_main(
+        const libdnf::BaseWeakPtr & base,
+        const ConfigRepo & config,
+        const std::string & repomd_fn,
+        const std::string & primary_fn);
 
     /// Loads additional metadata (filelist, others, ...) from available repo.
     void load_repo_ext(RepodataType type, const RepoDownloader & downloader);
 
+    /// Loads additional metadata of the `types` from available repo, same as calling `load_repo_ext()` for
+    /// each of them. When the solv cache files are built, the metadata of the types without a valid cache file
+    /// are parsed in parallel, each in a private pool seeded with the main solvables of the repo.
+    /// Must be called right after `load_repo_main()`, the comps are not supported. Before the extensions are
+    /// added, the main repodata are replaced by a lazy load of the .solv cache file if the file is already written.
+    /// @param written_main_solv  the main repodata returned by `load_repo_main()`, they seed the private pools
+    void load_repo_exts(
+        const std::vector<RepodataType> & types,
+        const RepoDownloader & downloader,
+        std::shared_ptr<const std::string> written_main_solv);
+
     /// Loads system repository into the pool.
     ///
     /// @param rootdir If empty, loads the installroot rpmdb, if not loads rpmdb from this root path
@@ -83,6 +120,12 @@ public:
     /// Loads additional system repo metadata (comps, modules)
     void load_system_repo_ext(RepodataType type);
 
+    /// Synchronizes the packages named `names` in the loaded system repository with the rpmdb.
+    /// Solvables of packages no longer in the rpmdb are freed (their ids are not reused), headers
+    /// installed since the repository was loaded are added. Other packages are not touched.
+    /// @return Number of removed and added solvables.
+    std::pair<std::size_t, std::size_t> update_system_repo(const std::set<std::string> & names);
+
     void rewrite_repo(libdnf::solv::IdQueue & fileprovides);
 
     // Internalize repository if needed.
@@ -92,27 +135,110 @@ public:
     void set_subpriority(int subpriority);
 
     // Checksum of data in .solv file. Used for validity check of .solvx files.
-    unsigned char checksum[CHKSUM_BYTES];
+    // All zeros if the repository was not loaded from repository metadata.
+    unsigned char checksum[CHKSUM_BYTES]{};
 
     void set_needs_internalizing() { needs_internalizing = true; };
 
+    /// Returns the full-text search index of the repository packages. The index is loaded
+    /// from the cache file or built when it is missing or does not match the loaded solvables.
+    const SearchIndex & get_search_index();
+
+    /// Returns the file path index of the repository packages, or nullptr if the filelists of the repository
+    /// are not loaded. The index is loaded from the cache file or built when it is missing or outdated.
+    const FileIndex * get_file_index();
+
+    /// Releases the memory of the loaded extensions of the `types`. A released extension is replaced by a lazy
+    /// load of its solv cache file, libsolv reads the data from the file again when they are accessed. The reading
+    /// is not safe for concurrent readers of the pool. Only the extensions which do not add solvables (FILELISTS,
+    /// OTHER, PRESTO), are held in memory and have a valid solv cache file are released. The extensions loaded
+    /// from their solv cache files are read on demand already.
+    /// @return Estimated number of released bytes, the size of the data which are read on demand now.
+    std::size_t release_repo_exts(const std::set<RepodataType> & types);
+
+    /// Replaces the extensions parsed during loading by lazy loads of their solv cache files, as
+    /// `release_repo_exts()` does. Only the files the writer has already finished are used, the extensions
+    /// whose files are still being written stay loaded and are tried again by the next call. Never waits
+    /// for the writer.
+    void reload_written_exts();
+
+    /// @return Estimated memory use of the repodata of the repository in bytes.
+    std::size_t get_memory_use() const;
+
+    /// Logs estimated memory use of the repodata of the repository and of their keys at the debug level.
+    void log_memory_use();
+
 private:
     bool load_solv_cache(solv::Pool & pool, const char * type, int flags);
 
-    /// Writes libsolv's .solv cache file with main libsolv repodata.
-    void write_main(bool load_after_write);
+    /// Returns `true` if the solv cache file of the `type` exists and was written for the loaded metadata.
+    bool is_solv_cache_usable(solv::Pool & pool, const char * type);
 
-    /// Writes libsolv's .solvx cache file with extended libsolv repodata.
+    /// Acquires the lock serializing building of the solv files of the repository between processes.
+    /// The lock is held until the solv files queued for writing meanwhile are written, a lock still held
+    /// by the queued files is returned again.
+    /// Returns nullptr if the solv files are not built (`build_cache` is disabled) or the lock cannot be acquired.
+    /// @param waited  set to `true` if another process held the lock, it may have built the solv files meanwhile
+    std::shared_ptr<RepoCacheLock> lock_solv_files(bool & waited);
+
+    /// Serializes main libsolv repodata and queues writing of libsolv's .solv cache file.
+    /// @return The serialized repodata.
+    std::shared_ptr<const std::string> write_main();
+
+    /// Serializes extended libsolv repodata and queues writing of libsolv's .solvx cache file.
     void write_ext(Id repodata_id, RepodataType type);
 
+    /// Replaces the main repodata held in memory by a lazy load of the .solv cache file if the writer has
+    /// already finished it, as the extensions are reloaded. Never waits for the writer. The repo must be
+    /// the last one in the pool and must not have any extensions loaded.
+    /// @return `false` if the main repodata stay loaded.
+    bool reload_written_main();
+
+    /// Waits until the .solvx cache file of the `type` is written and replaces the extension repodata
+    /// `repodata_id` by a lazy load of the file. The file must extend the main solvables.
+    /// @return `false` if the file is missing or outdated, the extension stays loaded then.
+    bool reload_ext(Id repodata_id, RepodataType type);
+
+    /// Marks the repodata from `repodata_start` to the last one as held in memory.
+    void add_resident_repodata(Id repodata_start);
+
     std::string solv_file_name(const char * type = nullptr);
     std::filesystem::path solv_file_path(const char * type = nullptr);
 
+    /// Builds the search index of the main solvables and writes it next to the .solv cache file.
+    void write_search_index();
+    std::filesystem::path search_index_file_path();
+
+    /// Returns `true` if the search index covers the main solvables and can be stored in the cache.
+    bool is_search_index_cacheable() const;
+
+    /// Builds the file path index of the main solvables and writes it next to the .solvx cache files.
+    void write_file_index();
+    std::filesystem::path file_index_file_path();
+
     libdnf::BaseWeakPtr base;
     const ConfigRepo & config;
 
     bool needs_internalizing{false};
 
+    std::unique_ptr<SearchIndex> search_index;
+
+    bool filelists_loaded{false};
+    std::unique_ptr<FileIndex> file_index;
+
+    /// Lock of the solv files held by this repo or by its solv files queued for writing.
+    std::weak_ptr<RepoCacheLock> solv_files_lock;
+
+    /// Extensions parsed during loading whose solv cache files are queued for writing.
+    std::vector<std::pair<Id, RepodataType>> written_exts;
+
+    /// Types of the loaded extensions of the rpm pool by their repodata id.
+    std::map<Id, RepodataType> ext_repodata_types;
+
+    /// Ids of the repodata held in memory, parsed from the metadata or loaded from serialized data in memory.
+    /// The vertical data of the other repodata are read from their solv cache files on demand.
+    std::set<Id> resident_repodata;
+
     /// Ranges of solvables for different types of data, used for writing libsolv cache files
     int main_solvables_start{0};
     int main_solvables_end{0};
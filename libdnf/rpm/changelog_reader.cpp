@@ -0,0 +1,403 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libdnf/rpm/changelog_reader.hpp"
+
+#include "utils/fs/file.hpp"
+
+#include "libdnf/base/base.hpp"
+#include "libdnf/conf/const.hpp"
+#include "libdnf/repo/repo.hpp"
+
+#include <cctype>
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+namespace libdnf::rpm {
+
+namespace {
+
+constexpr std::size_t READ_CHUNK_SIZE = 64 * 1024;
+
+constexpr std::string_view PACKAGE_START = "<package ";
+constexpr std::string_view PACKAGE_END = "</package>";
+constexpr std::string_view CHANGELOG_START = "<changelog";
+constexpr std::string_view CHANGELOG_END = "</changelog>";
+constexpr std::string_view MARKUP_START = "<!";
+constexpr std::string_view COMMENT_START = "<!--";
+constexpr std::string_view COMMENT_END = "-->";
+constexpr std::string_view CDATA_START = "<![CDATA[";
+constexpr std::string_view CDATA_END = "]]>";
+
+
+/// Buffered forward-only search in a (possibly compressed) metadata file.
+class MetadataStream {
+public:
+    explicit MetadataStream(const std::string & path) : file(path, "r", true) {}
+
+    /// @return Offset of the first `needle` at or after `from`, reads more data if needed.
+    ///         `std::string::npos` if the end of the file is reached.
+    std::size_t find(std::string_view needle, std::size_t from) {
+        while (true) {
+            auto found = std::string_view(buffer).find(needle, from);
+            if (found != std::string::npos || eof) {
+                return found;
+            }
+            // continue the search in the newly read data, the needle can start in the current data
+            if (buffer.size() >= from + needle.size()) {
+                from = buffer.size() - needle.size() + 1;
+            }
+            read_chunk();
+        }
+    }
+
+    /// Like `find()`, but `needle` in comments and CDATA sections is skipped.
+    std::size_t find_outside_markup(std::string_view needle, std::size_t from) {
+        while (true) {
+            auto found = find(needle, from);
+            if (found == std::string::npos) {
+                return found;
+            }
+            auto markup = view(from, found).find(MARKUP_START);
+            if (markup == std::string_view::npos) {
+                return found;
+            }
+            markup += from;
+            // the data up to the end of the found `needle` are read, enough to recognize the markup
+            auto markup_view = view(markup, found + needle.size());
+            if (markup_view.starts_with(COMMENT_START)) {
+                from = find(COMMENT_END, markup + COMMENT_START.size());
+                if (from == std::string::npos) {
+                    return from;
+                }
+                from += COMMENT_END.size();
+            } else if (markup_view.starts_with(CDATA_START)) {
+                from = find(CDATA_END, markup + CDATA_START.size());
+                if (from == std::string::npos) {
+                    return from;
+                }
+                from += CDATA_END.size();
+            } else {
+                // e.g. a doctype declaration
+                from = markup + MARKUP_START.size();
+            }
+        }
+    }
+
+    /// Drops the data before `pos` if it is worth it.
+    /// @return The new offset of the data at `pos`.
+    std::size_t discard(std::size_t pos) {
+        if (pos < READ_CHUNK_SIZE) {
+            return pos;
+        }
+        buffer.erase(0, pos);
+        return 0;
+    }
+
+    std::string_view view(std::size_t begin, std::size_t end) const {
+        return std::string_view(buffer).substr(begin, end - begin);
+    }
+
+private:
+    void read_chunk() {
+        const auto old_size = buffer.size();
+        buffer.resize(old_size + READ_CHUNK_SIZE);
+        const auto bytes_read = file.read(buffer.data() + old_size, READ_CHUNK_SIZE);
+        buffer.resize(old_size + bytes_read);
+        eof = bytes_read < READ_CHUNK_SIZE;
+    }
+
+    libdnf::utils::fs::File file;
+    std::string buffer;
+    bool eof{false};
+};
+
+
+void append_utf8(std::string & output, unsigned long code_point) {
+    if (code_point < 0x80) {
+        output.push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        output.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if (code_point < 0x10000) {
+        output.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        output.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        output.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        output.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        output.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+
+/// Appends `text` to `output` with the predefined XML entities and the character references replaced.
+void append_unescaped(std::string & output, std::string_view text) {
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        auto amp = text.find('&', pos);
+        auto semicolon = amp == std::string_view::npos ? amp : text.find(';', amp);
+        if (semicolon == std::string_view::npos) {
+            output.append(text.substr(pos));
+            break;
+        }
+        output.append(text.substr(pos, amp - pos));
+        auto entity = text.substr(amp + 1, semicolon - amp - 1);
+        if (entity == "amp") {
+            output.push_back('&');
+        } else if (entity == "lt") {
+            output.push_back('<');
+        } else if (entity == "gt") {
+            output.push_back('>');
+        } else if (entity == "quot") {
+            output.push_back('"');
+        } else if (entity == "apos") {
+            output.push_back('\'');
+        } else if (entity.size() > 1 && entity[0] == '#') {
+            unsigned long code_point = 0;
+            const bool hex = entity[1] == 'x' || entity[1] == 'X';
+            const char * digits = entity.data() + (hex ? 2 : 1);
+            auto res = std::from_chars(digits, entity.data() + entity.size(), code_point, hex ? 16 : 10);
+            if (res.ec == std::errc() && res.ptr == entity.data() + entity.size() && code_point <= 0x10FFFF) {
+                append_utf8(output, code_point);
+            } else {
+                output.append(text.substr(amp, semicolon - amp + 1));
+            }
+        } else {
+            output.append(text.substr(amp, semicolon - amp + 1));
+        }
+        pos = semicolon + 1;
+    }
+}
+
+
+/// Replaces the predefined XML entities and the character references in `text`.
+std::string xml_unescape(std::string_view text) {
+    std::string output;
+    output.reserve(text.size());
+    append_unescaped(output, text);
+    return output;
+}
+
+
+/// @return The offset after the comment or CDATA section at `pos` in `text`, npos if it is not terminated.
+///         Other markup starting with "<!" is skipped by its first two characters.
+std::size_t skip_markup(std::string_view text, std::size_t pos) {
+    auto markup = text.substr(pos);
+    if (markup.starts_with(COMMENT_START)) {
+        auto end = text.find(COMMENT_END, pos + COMMENT_START.size());
+        return end == std::string_view::npos ? end : end + COMMENT_END.size();
+    }
+    if (markup.starts_with(CDATA_START)) {
+        auto end = text.find(CDATA_END, pos + CDATA_START.size());
+        return end == std::string_view::npos ? end : end + CDATA_END.size();
+    }
+    return pos + MARKUP_START.size();
+}
+
+
+/// @return Offset of the first `needle` at or after `from` which is not in a comment or a CDATA section,
+///         npos if there is none.
+std::size_t find_outside_markup(std::string_view text, std::string_view needle, std::size_t from) {
+    while (true) {
+        auto found = text.find(needle, from);
+        auto markup = text.substr(0, found).find(MARKUP_START, from);
+        if (markup == std::string_view::npos) {
+            return found;
+        }
+        from = skip_markup(text, markup);
+        if (from == std::string_view::npos) {
+            return from;
+        }
+    }
+}
+
+
+/// @return The character data of the element content `text`. The entities are replaced, the content
+///         of CDATA sections is taken as it is and comments are dropped.
+std::string get_text(std::string_view text) {
+    std::string output;
+    output.reserve(text.size());
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        auto markup = text.find(MARKUP_START, pos);
+        append_unescaped(output, text.substr(pos, markup == std::string_view::npos ? markup : markup - pos));
+        if (markup == std::string_view::npos) {
+            break;
+        }
+        if (text.substr(markup).starts_with(CDATA_START)) {
+            const auto data_pos = markup + CDATA_START.size();
+            auto end = text.find(CDATA_END, data_pos);
+            output.append(text.substr(data_pos, end == std::string_view::npos ? end : end - data_pos));
+        }
+        pos = skip_markup(text, markup);
+    }
+    return output;
+}
+
+
+/// @return The value of the attribute `name` of the start tag `tag`, empty if the tag does not have it.
+std::string_view get_attribute(std::string_view tag, std::string_view name) {
+    for (auto pos = tag.find(name); pos != std::string_view::npos; pos = tag.find(name, pos + 1)) {
+        const auto value_pos = pos + name.size() + 2;
+        if (pos == 0 || value_pos > tag.size() || !std::isspace(static_cast<unsigned char>(tag[pos - 1])) ||
+            tag[pos + name.size()] != '=') {
+            continue;
+        }
+        const char quote = tag[value_pos - 1];
+        if (quote != '"' && quote != '\'') {
+            continue;
+        }
+        auto value_end = tag.find(quote, value_pos);
+        if (value_end == std::string_view::npos) {
+            break;
+        }
+        return tag.substr(value_pos, value_end - value_pos);
+    }
+    return {};
+}
+
+
+/// Parses the `<changelog>` elements from the content of a `<package>` element.
+std::vector<Changelog> parse_changelogs(std::string_view content) {
+    std::vector<Changelog> changelogs;
+    std::size_t pos = 0;
+    while ((pos = find_outside_markup(content, CHANGELOG_START, pos)) != std::string_view::npos) {
+        auto tag_end = content.find('>', pos);
+        if (tag_end == std::string_view::npos) {
+            break;
+        }
+        auto tag = content.substr(pos, tag_end - pos);
+        std::string_view text;
+        if (tag.back() == '/') {
+            pos = tag_end + 1;
+        } else {
+            // the text can contain comments and CDATA sections, e.g. with "</changelog>" in them
+            auto text_end = find_outside_markup(content, CHANGELOG_END, tag_end);
+            if (text_end == std::string_view::npos) {
+                break;
+            }
+            text = content.substr(tag_end + 1, text_end - tag_end - 1);
+            pos = text_end + CHANGELOG_END.size();
+        }
+
+        long long timestamp = 0;
+        auto date = get_attribute(tag, "date");
+        std::from_chars(date.data(), date.data() + date.size(), timestamp);
+        changelogs.emplace_back(
+            static_cast<time_t>(timestamp), xml_unescape(get_attribute(tag, "author")), get_text(text));
+    }
+    return changelogs;
+}
+
+
+/// Reads changelogs of the `packages` (indexed by pkgid) from the "other" metadata file `path`.
+/// The found packages are moved from `packages` to `changelogs`. All the packages with the same pkgid
+/// get the changelogs of the first entry with the pkgid, the later entries are skipped.
+void read_other_metadata(
+    const std::string & path,
+    std::unordered_map<std::string, std::vector<Package>> & packages,
+    std::map<Package, std::vector<Changelog>> & changelogs) {
+    MetadataStream stream(path);
+    std::size_t pos = 0;
+    while (!packages.empty()) {
+        auto start = stream.find_outside_markup(PACKAGE_START, pos);
+        if (start == std::string::npos) {
+            break;
+        }
+        auto tag_end = stream.find(">", start);
+        if (tag_end == std::string::npos) {
+            break;
+        }
+        std::size_t end;
+        if (stream.view(tag_end - 1, tag_end)[0] == '/') {
+            end = tag_end + 1;
+            pos = end;
+        } else {
+            end = stream.find_outside_markup(PACKAGE_END, tag_end);
+            if (end == std::string::npos) {
+                break;
+            }
+            pos = end + PACKAGE_END.size();
+        }
+
+        // only the packages with the requested pkgid are parsed, the others are just skipped
+        auto pkgid = get_attribute(stream.view(start, tag_end), "pkgid");
+        auto it = packages.find(std::string(pkgid));
+        if (it != packages.end()) {
+            auto package_changelogs = parse_changelogs(stream.view(tag_end + 1, end));
+            for (const auto & package : it->second) {
+                changelogs.insert_or_assign(package, package_changelogs);
+            }
+            packages.erase(it);
+        }
+
+        pos = stream.discard(pos);
+    }
+}
+
+}  // namespace
+
+
+std::map<Package, std::vector<Changelog>> read_changelogs(const PackageSet & packages) {
+    std::map<Package, std::vector<Changelog>> changelogs;
+    if (packages.empty()) {
+        return changelogs;
+    }
+
+    const auto other_loaded =
+        packages.get_base()->get_config().optional_metadata_types().get_value().contains(METADATA_TYPE_OTHER);
+
+    // packages to read from the "other" metadata files, by the path of the file and pkgid
+    // a repository can contain the same package (the same pkgid) more times
+    std::map<std::string, std::unordered_map<std::string, std::vector<Package>>> from_metadata;
+    for (const auto & package : packages) {
+        if (!other_loaded) {
+            auto repo = package.get_repo();
+            if (repo->get_type() == repo::Repo::Type::AVAILABLE) {
+                auto path = repo->get_metadata_path(METADATA_TYPE_OTHER);
+                auto pkgid = package.get_checksum().get_checksum();
+                if (!path.empty() && !pkgid.empty()) {
+                    from_metadata[std::move(path)][std::move(pkgid)].push_back(package);
+                    continue;
+                }
+            }
+        }
+        changelogs.emplace(package, package.get_changelogs());
+    }
+
+    for (auto & [path, path_packages] : from_metadata) {
+        read_other_metadata(path, path_packages, changelogs);
+        // packages missing in the metadata file have no changelogs
+        for (const auto & item : path_packages) {
+            for (const auto & package : item.second) {
+                changelogs.emplace(package, std::vector<Changelog>());
+            }
+        }
+    }
+
+    return changelogs;
+}
+
+}  // namespace libdnf::rpm
@@ -0,0 +1,265 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libdnf/rpm/dependency_closure.hpp"
+
+#include "base/base_private.hpp"
+#include "package_sack_impl.hpp"
+#include "package_set_impl.hpp"
+#include "solv/id_queue.hpp"
+#include "solv/pool.hpp"
+#include "solv/solv_map.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+
+namespace libdnf::rpm {
+
+class DependencyClosure::Impl {
+public:
+    Impl(const PackageSet & universe, const DependencyClosureSettings & settings);
+
+    void compute(const PackageSet & roots, libdnf::solv::SolvMap & closure);
+
+private:
+    friend DependencyClosure;
+
+    static constexpr std::size_t NO_NODE = std::numeric_limits<std::size_t>::max();
+
+    struct Node {
+        Id id;
+        // range of the children in `nodes`, the children of a node are always stored next to each other
+        std::size_t children_begin;
+        std::size_t children_end;
+    };
+
+    void build_dependants_index();
+
+    BaseWeakPtr base;
+    libdnf::solv::SolvMap universe;
+    unsigned max_depth;
+    bool reverse;
+    std::vector<Id> keys;
+
+    // Reverse index in the CSR form, the packages depending on package `id` are
+    // `dependants[dependants_offsets[id]]` .. `dependants[dependants_offsets[id + 1] - 1]`.
+    // It covers the solvables of the pool at the time it was built, it is rebuilt when the pool grows.
+    std::size_t indexed_nsolvables{0};
+    std::vector<std::size_t> dependants_offsets;
+    std::vector<Id> dependants;
+
+    // The last computed closure in the breadth-first order, the roots first
+    std::vector<Node> nodes;
+    std::size_t nroots{0};
+    std::vector<std::size_t> node_index;  // index of the node of a package in `nodes`, NO_NODE if not in the closure
+};
+
+
+DependencyClosure::Impl::Impl(const PackageSet & universe, const DependencyClosureSettings & settings)
+    : base(universe.get_base()),
+      universe(*universe.p_impl),
+      max_depth(settings.max_depth),
+      reverse(settings.reverse) {
+    if (settings.with_requires) {
+        keys.push_back(SOLVABLE_REQUIRES);
+    }
+    if (settings.with_recommends) {
+        keys.push_back(SOLVABLE_RECOMMENDS);
+    }
+    if (settings.with_suggests) {
+        keys.push_back(SOLVABLE_SUGGESTS);
+    }
+    if (settings.with_supplements) {
+        keys.push_back(SOLVABLE_SUPPLEMENTS);
+    }
+    if (settings.with_enhances) {
+        keys.push_back(SOLVABLE_ENHANCES);
+    }
+}
+
+
+void DependencyClosure::Impl::build_dependants_index() {
+    auto & pool = get_rpm_pool(base);
+    const auto nsolvables = static_cast<std::size_t>(pool.get_nsolvables());
+
+    // pairs <provider, dependant>
+    std::vector<std::pair<Id, Id>> edges;
+    libdnf::solv::IdQueue deps;
+    for (Id id : universe) {
+        Solvable * solvable = pool.id2solvable(id);
+        for (Id key : keys) {
+            deps.clear();
+            solvable_lookup_idarray(solvable, key, &deps.get_queue());
+            for (Id dep : deps) {
+                if (dep == SOLVABLE_PREREQMARKER) {
+                    continue;
+                }
+                for (Id * provider = pool_whatprovides_ptr(*pool, dep); *provider != 0; ++provider) {
+                    if (*provider != id) {
+                        edges.emplace_back(*provider, id);
+                    }
+                }
+            }
+        }
+    }
+
+    // counting sort of the edges by the provider
+    dependants_offsets.assign(nsolvables + 1, 0);
+    for (const auto & edge : edges) {
+        ++dependants_offsets[static_cast<std::size_t>(edge.first) + 1];
+    }
+    for (std::size_t idx = 1; idx <= nsolvables; ++idx) {
+        dependants_offsets[idx] += dependants_offsets[idx - 1];
+    }
+    std::vector<std::size_t> next(dependants_offsets.begin(), dependants_offsets.end() - 1);
+    dependants.resize(edges.size());
+    for (const auto & [provider, dependant] : edges) {
+        dependants[next[static_cast<std::size_t>(provider)]++] = dependant;
+    }
+
+    indexed_nsolvables = nsolvables;
+}
+
+
+void DependencyClosure::Impl::compute(const PackageSet & roots, libdnf::solv::SolvMap & closure) {
+    auto & pool = get_rpm_pool(base);
+    base->get_rpm_package_sack()->p_impl->make_provides_ready();
+    const auto nsolvables = static_cast<std::size_t>(pool.get_nsolvables());
+    // Packages added to the pool after the construction are not in the universe, but they can be
+    // the roots or the providers, the universe map and the reverse index must cover them.
+    if (universe.allocated_size() < static_cast<int>(nsolvables)) {
+        universe.grow(static_cast<int>(nsolvables));
+    }
+    if (reverse && indexed_nsolvables != nsolvables) {
+        build_dependants_index();
+    }
+
+    for (const auto & node : nodes) {
+        node_index[static_cast<std::size_t>(node.id)] = NO_NODE;
+    }
+    node_index.resize(nsolvables, NO_NODE);
+    nodes.clear();
+
+    auto visit = [&](Id id) {
+        if (!closure.contains_unsafe(id) && universe.contains_unsafe(id)) {
+            closure.add_unsafe(id);
+            node_index[static_cast<std::size_t>(id)] = nodes.size();
+            nodes.push_back({id, 0, 0});
+        }
+    };
+
+    for (Id id : *roots.p_impl) {
+        closure.add_unsafe(id);
+        node_index[static_cast<std::size_t>(id)] = nodes.size();
+        nodes.push_back({id, 0, 0});
+    }
+    nroots = nodes.size();
+
+    unsigned depth = 0;
+    std::size_t level_end = nroots;
+    libdnf::solv::IdQueue deps;
+    for (std::size_t idx = 0; idx < nodes.size(); ++idx) {
+        if (idx == level_end) {
+            ++depth;
+            level_end = nodes.size();
+        }
+        const Id id = nodes[idx].id;
+        const auto children_begin = nodes.size();
+
+        if (max_depth == 0 || depth < max_depth) {
+            if (reverse) {
+                const auto uid = static_cast<std::size_t>(id);
+                for (auto dep_idx = dependants_offsets[uid]; dep_idx < dependants_offsets[uid + 1]; ++dep_idx) {
+                    visit(dependants[dep_idx]);
+                }
+            } else {
+                Solvable * solvable = pool.id2solvable(id);
+                for (Id key : keys) {
+                    deps.clear();
+                    solvable_lookup_idarray(solvable, key, &deps.get_queue());
+                    for (Id dep : deps) {
+                        if (dep == SOLVABLE_PREREQMARKER) {
+                            continue;
+                        }
+                        for (Id * provider = pool_whatprovides_ptr(*pool, dep); *provider != 0; ++provider) {
+                            visit(*provider);
+                        }
+                    }
+                }
+            }
+        }
+
+        // The children are not expanded yet, sorting them keeps the ranges of the other nodes valid.
+        auto children_first = nodes.begin() + static_cast<std::ptrdiff_t>(children_begin);
+        std::sort(children_first, nodes.end(), [](const Node & a, const Node & b) { return a.id < b.id; });
+        for (auto child_idx = children_begin; child_idx < nodes.size(); ++child_idx) {
+            node_index[static_cast<std::size_t>(nodes[child_idx].id)] = child_idx;
+        }
+        nodes[idx].children_begin = children_begin;
+        nodes[idx].children_end = nodes.size();
+    }
+}
+
+
+DependencyClosure::DependencyClosure(const PackageSet & universe, const DependencyClosureSettings & settings)
+    : p_impl(new Impl(universe, settings)) {}
+
+DependencyClosure::~DependencyClosure() = default;
+
+DependencyClosure::DependencyClosure(DependencyClosure && src) noexcept = default;
+
+DependencyClosure & DependencyClosure::operator=(DependencyClosure && src) noexcept = default;
+
+
+PackageSet DependencyClosure::compute(const PackageSet & roots) {
+    libdnf_assert_same_base(p_impl->base, roots.get_base());
+
+    libdnf::solv::SolvMap closure(get_rpm_pool(p_impl->base).get_nsolvables());
+    p_impl->compute(roots, closure);
+    return PackageSet(p_impl->base, closure);
+}
+
+
+std::vector<Package> DependencyClosure::get_roots() const {
+    std::vector<Package> roots;
+    roots.reserve(p_impl->nroots);
+    for (std::size_t idx = 0; idx < p_impl->nroots; ++idx) {
+        roots.emplace_back(Package(p_impl->base, PackageId(p_impl->nodes[idx].id)));
+    }
+    return roots;
+}
+
+
+std::vector<Package> DependencyClosure::get_children(const Package & package) const {
+    std::vector<Package> children;
+    const auto id = static_cast<std::size_t>(package.get_id().id);
+    if (id >= p_impl->node_index.size() || p_impl->node_index[id] == Impl::NO_NODE) {
+        return children;
+    }
+    const auto & node = p_impl->nodes[p_impl->node_index[id]];
+    children.reserve(node.children_end - node.children_begin);
+    for (auto idx = node.children_begin; idx < node.children_end; ++idx) {
+        children.emplace_back(Package(p_impl->base, PackageId(p_impl->nodes[idx].id)));
+    }
+    return children;
+}
+
+}  // namespace libdnf::rpm
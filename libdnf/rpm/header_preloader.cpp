@@ -0,0 +1,196 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "header_preloader.hpp"
+
+#include "transaction.hpp"
+#include "utils/bgettext/bgettext-mark-domain.h"
+
+#include "libdnf/base/base.hpp"
+
+#include <rpm/rpmio.h>
+#include <rpm/rpmkeyring.h>
+#include <rpm/rpmlib.h>
+
+#include <algorithm>
+#include <system_error>
+
+
+namespace libdnf::rpm {
+
+Header read_package_header(rpmts ts, const std::string & path) {
+    FD_t fd = Fopen(path.c_str(), "r.ufdio");
+
+    if (!fd) {
+        throw TransactionError(
+            M_("Failed to read package header, cannot open file \"{}\": {}"), path, std::string(Fstrerror(fd)));
+    }
+
+    const char * descr = path.c_str();
+    Header h{};  // Initialization of h is not needed. It is output argument of rpmReadPackageFile().
+    rpmRC rpmrc = rpmReadPackageFile(ts, fd, descr, &h);
+    Fclose(fd);
+
+    switch (rpmrc) {
+        case RPMRC_NOTTRUSTED:
+        case RPMRC_NOKEY:
+        case RPMRC_OK:
+            break;
+        case RPMRC_NOTFOUND:
+        case RPMRC_FAIL:
+        default:
+            h = headerFree(h);
+            throw TransactionError(M_("Failed to read package header from file \"{}\""), path);
+            break;
+    }
+
+    return h;
+}
+
+
+HeaderPreloader::HeaderPreloader(const BaseWeakPtr & base, rpmts ts) : base(base), ts(ts) {}
+
+
+HeaderPreloader::~HeaderPreloader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    work_available.notify_all();
+    for (auto & thread : threads) {
+        thread.join();
+    }
+    for (auto worker_ts : worker_transactions) {
+        rpmtsFree(worker_ts);
+    }
+    for (auto & [path, entry] : entries) {
+        headerFree(entry.header);
+    }
+}
+
+
+void HeaderPreloader::start(const std::vector<std::string> & paths) {
+    std::size_t scheduled;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto & path : paths) {
+            if (entries.try_emplace(path).second) {
+                queue.push_back(path);
+            }
+        }
+        scheduled = queue.size() - next;
+    }
+    work_available.notify_all();
+
+    const auto max_threads = std::min(MAX_THREADS, std::max(std::thread::hardware_concurrency(), 1U));
+    if (threads.size() >= max_threads || threads.size() >= scheduled) {
+        return;
+    }
+
+    // The rpm transaction set is not thread safe, every worker gets its own with the same configuration.
+    // The keyring is loaded only once and shared, it is reference counted and locked by librpm.
+    auto * keyring = rpmtsGetKeyring(ts, 1);
+    while (threads.size() < max_threads && threads.size() < scheduled) {
+        auto worker_ts = rpmtsCreate();
+        rpmtsSetRootDir(worker_ts, rpmtsRootDir(ts));
+        rpmtsSetVSFlags(worker_ts, rpmtsVSFlags(ts));
+        rpmtsSetVfyFlags(worker_ts, rpmtsVfyFlags(ts));
+        rpmtsSetVfyLevel(worker_ts, rpmtsVfyLevel(ts));
+        if (keyring) {
+            rpmtsSetKeyring(worker_ts, keyring);
+        }
+        try {
+            threads.emplace_back(&HeaderPreloader::worker, this, worker_ts);
+        } catch (const std::system_error &) {
+            // Out of threads, the running workers read the headers. Without any worker `take()` reads them.
+            rpmtsFree(worker_ts);
+            break;
+        }
+        worker_transactions.push_back(worker_ts);
+    }
+    rpmKeyringFree(keyring);
+}
+
+
+Header HeaderPreloader::take(const std::string & path) {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = entries.find(path);
+    if (it == entries.end() || (threads.empty() && !it->second.done)) {
+        // not scheduled, or no worker could be started
+        if (it != entries.end()) {
+            entries.erase(it);
+        }
+        lock.unlock();
+        return read_package_header(ts, path);
+    }
+
+    // references to the elements stay valid when the map is rehashed, iterators do not
+    auto & entry = it->second;
+    entry_done.wait(lock, [&entry] { return entry.done; });
+    auto header = entry.header;
+    auto error = entry.error;
+    auto log = std::move(entry.log);
+    entries.erase(path);
+    lock.unlock();
+
+    RpmLogCapture::log_records(*base->get_logger(), log);
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return header;
+}
+
+
+void HeaderPreloader::worker(rpmts worker_ts) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        work_available.wait(lock, [this] { return stop || next < queue.size(); });
+        if (stop) {
+            break;
+        }
+        auto path = queue[next++];  // copy, `queue` can be reallocated by `start()`
+        lock.unlock();
+
+        Header header{nullptr};
+        std::exception_ptr error;
+        std::vector<RpmLogCapture::Record> log;
+        {
+            // rpm logs from all the workers would interleave, the consumer logs them with the header
+            RpmLogCapture rpm_log_capture;
+            try {
+                header = read_package_header(worker_ts, path);
+            } catch (...) {
+                // The thread must not throw exceptions. Pass them to the consumer of the header.
+                error = std::current_exception();
+            }
+            log = rpm_log_capture.release_records();
+        }
+
+        lock.lock();
+        auto & entry = entries[path];
+        entry.header = header;
+        entry.error = error;
+        entry.log = std::move(log);
+        entry.done = true;
+        entry_done.notify_all();
+    }
+}
+
+}  // namespace libdnf::rpm
@@ -0,0 +1,103 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF_RPM_HEADER_PRELOADER_HPP
+#define LIBDNF_RPM_HEADER_PRELOADER_HPP
+
+#include "rpm_log_guard.hpp"
+
+#include "libdnf/base/base_weak.hpp"
+
+#include <rpm/header.h>
+#include <rpm/rpmts.h>
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+namespace libdnf::rpm {
+
+/// Reads and verifies headers of package files by a bounded pool of threads.
+///
+/// Reading a header includes the digest and signature checks of `rpmReadPackageFile()`, for large
+/// transactions the serial reading is dominated by waiting for I/O. The preloader reads the headers
+/// concurrently in the background, consumers take them in their own (deterministic) order.
+/// Every worker uses its own rpm transaction set configured like the one passed to the constructor.
+/// The rpm log records of the workers are captured and logged by the consumer together with the header.
+/// Capturing relies on the rpm log callback of an `RpmLogGuard` held by the owner (the `rpm::Transaction`)
+/// for the whole lifetime of the preloader.
+class HeaderPreloader {
+public:
+    /// Maximal number of threads reading the headers.
+    static constexpr unsigned MAX_THREADS = 8;
+
+    /// @param ts  rpm transaction set whose root directory, verification flags and keyring are used for reading
+    HeaderPreloader(const BaseWeakPtr & base, rpmts ts);
+    ~HeaderPreloader();
+
+    HeaderPreloader(const HeaderPreloader &) = delete;
+    HeaderPreloader & operator=(const HeaderPreloader &) = delete;
+
+    /// Starts reading headers of the package files in `paths` in the background.
+    /// Paths already scheduled by a previous call are skipped.
+    void start(const std::vector<std::string> & paths);
+
+    /// Returns the header of the package file `path`, waits for it if it is still being read.
+    /// Files not scheduled by `start()` are read synchronously.
+    /// The caller owns the returned header and has to free it by `headerFree()`.
+    /// @throw TransactionError if the header cannot be read
+    Header take(const std::string & path);
+
+private:
+    struct Entry {
+        bool done{false};
+        Header header{nullptr};
+        std::exception_ptr error;
+        std::vector<RpmLogCapture::Record> log;
+    };
+
+    void worker(rpmts worker_ts);
+
+    BaseWeakPtr base;
+    rpmts ts;
+    std::vector<std::string> queue;  // scheduled paths in the order they are read
+    std::size_t next{0};             // index of the next path in `queue` to read
+    std::unordered_map<std::string, Entry> entries;
+    std::mutex mutex;
+    std::condition_variable work_available;  // signals that a path was added to `queue` or `stop` was set
+    std::condition_variable entry_done;      // signals that a header was read
+    bool stop{false};
+    std::vector<std::thread> threads;
+    std::vector<rpmts> worker_transactions;
+};
+
+
+/// Reads the header of the package file `path` using rpm transaction set `ts`.
+/// @throw TransactionError if the file cannot be opened or the header cannot be read
+Header read_package_header(rpmts ts, const std::string & path);
+
+}  // namespace libdnf::rpm
+
+#endif  // LIBDNF_RPM_HEADER_PRELOADER_HPP
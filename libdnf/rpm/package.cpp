@@ -137,11 +137,69 @@ std::string Package::get_url() const {
 }
 
 std::string Package::get_summary() const {
-    return libdnf::utils::string::c_to_str(get_rpm_pool(base).lookup_str(id.id, SOLVABLE_SUMMARY));
+    return libdnf::utils::string::c_to_str(get_rpm_pool(base).lookup_translated_str(id.id, SOLVABLE_SUMMARY));
 }
 
 std::string Package::get_description() const {
-    return libdnf::utils::string::c_to_str(get_rpm_pool(base).lookup_str(id.id, SOLVABLE_DESCRIPTION));
+    return libdnf::utils::string::c_to_str(get_rpm_pool(base).lookup_translated_str(id.id, SOLVABLE_DESCRIPTION));
+}
+
+namespace {
+
+inline std::string_view to_view(const char * str) noexcept {
+    return str ? std::string_view(str) : std::string_view();
+}
+
+}  // namespace
+
+std::string_view Package::get_name_view() const {
+    return to_view(get_rpm_pool(base).get_name(id.id));
+}
+
+std::string_view Package::get_epoch_view() const {
+    auto epoch = libdnf::solv::EvrView(get_evr_view()).e;
+    return epoch.empty() ? libdnf::solv::ZERO_EPOCH : epoch;
+}
+
+std::string_view Package::get_version_view() const {
+    return libdnf::solv::EvrView(get_evr_view()).v;
+}
+
+std::string_view Package::get_release_view() const {
+    return libdnf::solv::EvrView(get_evr_view()).r;
+}
+
+std::string_view Package::get_arch_view() const {
+    return to_view(get_rpm_pool(base).get_arch(id.id));
+}
+
+std::string_view Package::get_evr_view() const {
+    return to_view(get_rpm_pool(base).get_evr(id.id));
+}
+
+std::string_view Package::get_repo_id_view() const {
+    // libsolv repositories are named by the repo id, see SolvRepo
+    return to_view(get_rpm_pool(base).id2solvable(id.id)->repo->name);
+}
+
+std::string_view Package::get_summary_view() const {
+    return to_view(get_rpm_pool(base).lookup_translated_str(id.id, SOLVABLE_SUMMARY));
+}
+
+std::string_view Package::get_url_view() const {
+    return to_view(get_rpm_pool(base).lookup_str(id.id, SOLVABLE_URL));
+}
+
+std::string_view Package::get_license_view() const {
+    return to_view(get_rpm_pool(base).lookup_str(id.id, SOLVABLE_LICENSE));
+}
+
+void Package::append_nevra(std::string & buffer) const {
+    get_rpm_pool(base).append_nevra(id.id, buffer);
+}
+
+void Package::append_full_nevra(std::string & buffer) const {
+    get_rpm_pool(base).append_full_nevra(id.id, buffer);
 }
 
 std::vector<std::string> Package::get_files() const {
@@ -376,6 +434,10 @@ Package::Package(const BaseWeakPtr & base, unsigned long long rpmdbid) : base(ba
     libdnf_assert(installed_repo, "Installed repo not loaded");
 
     for (auto candidate_id = installed_repo->start; candidate_id < installed_repo->end; ++candidate_id) {
+        // the range contains solvables freed by RepoSack::update_system_repo() and of repos loaded meanwhile
+        if (pool->solvables[candidate_id].repo != installed_repo) {
+            continue;
+        }
         if (rpmdbid == repo_lookup_num(installed_repo, candidate_id, RPM_RPMDBID, 0)) {
             id.id = candidate_id;
             return;
@@ -389,4 +451,37 @@ BaseWeakPtr Package::get_base() const {
     return base;
 }
 
+
+template <>
+bool cmp_nevra<Package>(const Package & lhs, const Package & rhs) {
+    int r = lhs.get_name_view().compare(rhs.get_name_view());
+    if (r != 0) {
+        return r < 0;
+    }
+
+    // the evr views are null-terminated
+    r = rpmvercmp(lhs.get_evr_view().data(), rhs.get_evr_view().data());
+    if (r != 0) {
+        return r < 0;
+    }
+
+    return lhs.get_arch_view() < rhs.get_arch_view();
+}
+
+template <>
+bool cmp_naevr<Package>(const Package & lhs, const Package & rhs) {
+    int r = lhs.get_name_view().compare(rhs.get_name_view());
+    if (r != 0) {
+        return r < 0;
+    }
+
+    r = lhs.get_arch_view().compare(rhs.get_arch_view());
+    if (r != 0) {
+        return r < 0;
+    }
+
+    // the evr views are null-terminated
+    return rpmvercmp(lhs.get_evr_view().data(), rhs.get_evr_view().data()) < 0;
+}
+
 }  // namespace libdnf::rpm
@@ -0,0 +1,147 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "package_attributes.hpp"
+
+#include "libdnf/common/exception.hpp"
+#include "libdnf/repo/repo.hpp"
+
+
+namespace libdnf::rpm {
+
+namespace {
+
+std::string_view to_view(const char * str) {
+    return str ? std::string_view(str) : std::string_view();
+}
+
+}  // namespace
+
+
+const PackageAttributeInfo * find_package_attribute(std::string_view name) noexcept {
+    for (const auto & info : PACKAGE_ATTRIBUTES) {
+        if (name == info.name) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
+
+std::string_view PackageAttributeReader::get_string(Id id, PackageAttribute attribute) {
+    switch (attribute) {
+        case PackageAttribute::NAME:
+            return pool.get_name(id);
+        case PackageAttribute::EPOCH: {
+            auto epoch = solv::EvrView(pool.get_evr(id)).e;
+            return epoch.empty() ? solv::ZERO_EPOCH : epoch;
+        }
+        case PackageAttribute::VERSION:
+            return solv::EvrView(pool.get_evr(id)).v;
+        case PackageAttribute::RELEASE:
+            return solv::EvrView(pool.get_evr(id)).r;
+        case PackageAttribute::ARCH:
+            return pool.get_arch(id);
+        case PackageAttribute::EVR:
+            return pool.get_evr(id);
+        case PackageAttribute::NEVRA:
+            buffer.clear();
+            pool.append_nevra(id, buffer);
+            return buffer;
+        case PackageAttribute::FULL_NEVRA:
+            buffer.clear();
+            pool.append_full_nevra(id, buffer);
+            return buffer;
+        case PackageAttribute::REPOID:
+            // libsolv repositories are named by the repo id, see SolvRepo
+            return to_view(pool.id2solvable(id)->repo->name);
+        case PackageAttribute::REPONAME: {
+            auto & solvable_repo = solv::get_repo(pool.id2solvable(id));
+            if (repo != &solvable_repo) {
+                repo = &solvable_repo;
+                repo_name = solvable_repo.get_name();
+            }
+            return repo_name;
+        }
+        case PackageAttribute::SOURCERPM:
+            return to_view(pool.get_sourcerpm(id));
+        case PackageAttribute::SUMMARY:
+            return to_view(pool.lookup_translated_str(id, SOLVABLE_SUMMARY));
+        case PackageAttribute::DESCRIPTION:
+            return to_view(pool.lookup_translated_str(id, SOLVABLE_DESCRIPTION));
+        case PackageAttribute::URL:
+            return to_view(pool.lookup_str(id, SOLVABLE_URL));
+        case PackageAttribute::LICENSE:
+            return to_view(pool.lookup_str(id, SOLVABLE_LICENSE));
+        case PackageAttribute::PACKAGER:
+            return to_view(pool.lookup_str(id, SOLVABLE_PACKAGER));
+        case PackageAttribute::VENDOR:
+            return to_view(pool.lookup_str(id, SOLVABLE_VENDOR));
+        case PackageAttribute::GROUP:
+            return to_view(pool.lookup_str(id, SOLVABLE_GROUP));
+        case PackageAttribute::LOCATION: {
+            Solvable * solvable = pool.id2solvable(id);
+            solv::get_repo(solvable).internalize();
+            return to_view(solvable_lookup_location(solvable, nullptr));
+        }
+        case PackageAttribute::DOWNLOADSIZE:
+        case PackageAttribute::INSTALLSIZE:
+        case PackageAttribute::BUILDTIME:
+        case PackageAttribute::INSTALLTIME:
+            break;
+    }
+    libdnf_throw_assertion("Package attribute {} is not a string attribute", static_cast<int>(attribute));
+}
+
+
+uint64_t PackageAttributeReader::get_number(Id id, PackageAttribute attribute) const {
+    switch (attribute) {
+        case PackageAttribute::DOWNLOADSIZE:
+            return pool.lookup_num(id, SOLVABLE_DOWNLOADSIZE);
+        case PackageAttribute::INSTALLSIZE:
+            return pool.lookup_num(id, SOLVABLE_INSTALLSIZE);
+        case PackageAttribute::BUILDTIME:
+            return pool.lookup_num(id, SOLVABLE_BUILDTIME);
+        case PackageAttribute::INSTALLTIME:
+            return pool.lookup_num(id, SOLVABLE_INSTALLTIME);
+        default:
+            break;
+    }
+    libdnf_throw_assertion("Package attribute {} is not a number attribute", static_cast<int>(attribute));
+}
+
+
+std::optional<Id> PackageAttributeReader::get_value_id(Id id, PackageAttribute attribute) const {
+    Solvable * solvable = pool.id2solvable(id);
+    switch (attribute) {
+        case PackageAttribute::NAME:
+            return solvable->name;
+        case PackageAttribute::ARCH:
+            return solvable->arch;
+        case PackageAttribute::EVR:
+            return solvable->evr;
+        case PackageAttribute::REPOID:
+        case PackageAttribute::REPONAME:
+            return solvable->repo->repoid;
+        default:
+            return std::nullopt;
+    }
+}
+
+}  // namespace libdnf::rpm
@@ -0,0 +1,129 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF_RPM_PACKAGE_ATTRIBUTES_HPP
+#define LIBDNF_RPM_PACKAGE_ATTRIBUTES_HPP
+
+#include "solv/pool.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+
+namespace libdnf::repo {
+class Repo;
+}  // namespace libdnf::repo
+
+
+namespace libdnf::rpm {
+
+/// Package attributes which are read directly from the package pool, the tags of PackageFormatter
+/// and the columns of PackageColumns.
+enum class PackageAttribute {
+    NAME,
+    EPOCH,
+    VERSION,
+    RELEASE,
+    ARCH,
+    EVR,
+    NEVRA,
+    FULL_NEVRA,
+    REPOID,
+    REPONAME,
+    DOWNLOADSIZE,
+    INSTALLSIZE,
+    BUILDTIME,
+    INSTALLTIME,
+    SOURCERPM,
+    SUMMARY,
+    DESCRIPTION,
+    URL,
+    LICENSE,
+    PACKAGER,
+    VENDOR,
+    GROUP,
+    LOCATION
+};
+
+struct PackageAttributeInfo {
+    const char * name;
+    PackageAttribute attribute;
+    bool is_number;
+};
+
+inline constexpr PackageAttributeInfo PACKAGE_ATTRIBUTES[] = {
+    {"name", PackageAttribute::NAME, false},
+    {"epoch", PackageAttribute::EPOCH, false},
+    {"version", PackageAttribute::VERSION, false},
+    {"release", PackageAttribute::RELEASE, false},
+    {"arch", PackageAttribute::ARCH, false},
+    {"evr", PackageAttribute::EVR, false},
+    {"nevra", PackageAttribute::NEVRA, false},
+    {"full_nevra", PackageAttribute::FULL_NEVRA, false},
+    {"repoid", PackageAttribute::REPOID, false},
+    {"reponame", PackageAttribute::REPONAME, false},
+    {"downloadsize", PackageAttribute::DOWNLOADSIZE, true},
+    {"installsize", PackageAttribute::INSTALLSIZE, true},
+    {"buildtime", PackageAttribute::BUILDTIME, true},
+    {"installtime", PackageAttribute::INSTALLTIME, true},
+    {"sourcerpm", PackageAttribute::SOURCERPM, false},
+    {"summary", PackageAttribute::SUMMARY, false},
+    {"description", PackageAttribute::DESCRIPTION, false},
+    {"url", PackageAttribute::URL, false},
+    {"license", PackageAttribute::LICENSE, false},
+    {"packager", PackageAttribute::PACKAGER, false},
+    {"vendor", PackageAttribute::VENDOR, false},
+    {"group", PackageAttribute::GROUP, false},
+    {"location", PackageAttribute::LOCATION, false}};
+
+/// @return The attribute called `name`, nullptr if there is none.
+const PackageAttributeInfo * find_package_attribute(std::string_view name) noexcept;
+
+
+/// Reads the attributes of packages from the package pool.
+///
+/// Values which are not stored in the pool as they are (nevras, repository names) are composed
+/// in a buffer of the reader. A returned string is valid until the next call of the reader or
+/// a change of the pool. Consecutive packages mostly share the repository, its name is cached.
+class PackageAttributeReader {
+public:
+    explicit PackageAttributeReader(solv::RpmPool & pool) : pool(pool) {}
+
+    /// @return The value of the string `attribute` of the package `id`.
+    std::string_view get_string(Id id, PackageAttribute attribute);
+
+    /// @return The value of the number `attribute` of the package `id`.
+    uint64_t get_number(Id id, PackageAttribute attribute) const;
+
+    /// @return The pool id which identifies the value of the string `attribute` of the package `id`,
+    /// packages with the same pool id have the same value. std::nullopt if the value has no such id.
+    std::optional<Id> get_value_id(Id id, PackageAttribute attribute) const;
+
+private:
+    solv::RpmPool & pool;
+    std::string buffer;
+    const repo::Repo * repo{nullptr};
+    std::string repo_name;
+};
+
+}  // namespace libdnf::rpm
+
+#endif  // LIBDNF_RPM_PACKAGE_ATTRIBUTES_HPP
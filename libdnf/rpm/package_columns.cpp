@@ -0,0 +1,242 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libdnf/rpm/package_columns.hpp"
+
+#include "base/base_impl.hpp"
+#include "package_attributes.hpp"
+#include "package_set_impl.hpp"
+#include "utils/bgettext/bgettext-mark-domain.h"
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+
+namespace libdnf::rpm {
+
+namespace {
+
+// Builds the table of distinct values of a string column.
+// Values identified by a pool id (names, arches, evrs, repositories) are looked up by the id,
+// the other ones by the string.
+class StringInterner {
+public:
+    uint32_t add(std::string_view value) {
+        auto it = string_indexes.find(value);
+        if (it != string_indexes.end()) {
+            return it->second;
+        }
+        auto index = static_cast<uint32_t>(values.size());
+        // the keys point to the elements of `values`, the deque does not move them when growing
+        string_indexes.emplace(values.emplace_back(value), index);
+        return index;
+    }
+
+    template <typename GetValue>
+    uint32_t add(Id id, GetValue get_value) {
+        auto it = id_indexes.find(id);
+        if (it != id_indexes.end()) {
+            return it->second;
+        }
+        auto index = add(get_value());
+        id_indexes.emplace(id, index);
+        return index;
+    }
+
+    /// Moves the distinct values to `strings`. The interner must not be used anymore.
+    void release_values(std::vector<std::string> & strings) {
+        string_indexes.clear();
+        strings.reserve(values.size());
+        std::move(values.begin(), values.end(), std::back_inserter(strings));
+        values.clear();
+    }
+
+private:
+    std::deque<std::string> values;
+    std::unordered_map<std::string_view, uint32_t> string_indexes;
+    std::unordered_map<Id, uint32_t> id_indexes;
+};
+
+}  // namespace
+
+
+class PackageColumns::Impl {
+public:
+    struct Column {
+        std::string name;
+        bool is_number;
+        std::vector<std::string> strings;
+        std::vector<uint32_t> string_indexes;
+        std::vector<uint64_t> numbers;
+    };
+
+    const Column & get_column(const std::string & attribute) const;
+    void read_strings(PackageAttributeReader & reader, PackageAttribute attribute, Column & column);
+
+    std::vector<std::string> attributes;
+    std::vector<int> ids;
+    std::vector<Column> columns;
+};
+
+
+const PackageColumns::Impl::Column & PackageColumns::Impl::get_column(const std::string & attribute) const {
+    for (const auto & column : columns) {
+        if (column.name == attribute) {
+            return column;
+        }
+    }
+    throw PackageColumnsError(M_("Attribute \"{}\" was not exported"), attribute);
+}
+
+
+void PackageColumns::Impl::read_strings(PackageAttributeReader & reader, PackageAttribute attribute, Column & column) {
+    StringInterner interner;
+    column.string_indexes.reserve(ids.size());
+    for (Id id : ids) {
+        auto get_value = [&] { return reader.get_string(id, attribute); };
+        if (auto value_id = reader.get_value_id(id, attribute)) {
+            column.string_indexes.push_back(interner.add(*value_id, get_value));
+        } else {
+            column.string_indexes.push_back(interner.add(get_value()));
+        }
+    }
+    interner.release_values(column.strings);
+}
+
+
+PackageColumns::PackageColumns(const PackageSet & packages, const std::vector<std::string> & attributes)
+    : p_impl(new Impl) {
+    PackageAttributeReader reader(get_rpm_pool(packages.p_impl->base));
+
+    p_impl->ids.reserve(packages.size());
+    for (Id id : *packages.p_impl) {
+        p_impl->ids.push_back(id);
+    }
+
+    for (const auto & attribute : attributes) {
+        if (std::find(p_impl->attributes.begin(), p_impl->attributes.end(), attribute) != p_impl->attributes.end()) {
+            continue;
+        }
+
+        const auto * info = find_package_attribute(attribute);
+        if (!info) {
+            throw PackageColumnsError(M_("Unknown package attribute \"{}\""), attribute);
+        }
+        auto & column = p_impl->columns.emplace_back(Impl::Column{attribute, info->is_number, {}, {}, {}});
+        if (info->is_number) {
+            column.numbers.reserve(p_impl->ids.size());
+            for (Id id : p_impl->ids) {
+                column.numbers.push_back(reader.get_number(id, info->attribute));
+            }
+        } else {
+            p_impl->read_strings(reader, info->attribute, column);
+        }
+        p_impl->attributes.push_back(attribute);
+    }
+}
+
+PackageColumns::~PackageColumns() = default;
+
+PackageColumns::PackageColumns(const PackageColumns & src) : p_impl(new Impl(*src.p_impl)) {}
+
+PackageColumns::PackageColumns(PackageColumns && src) noexcept = default;
+
+PackageColumns & PackageColumns::operator=(const PackageColumns & src) {
+    if (this != &src) {
+        *p_impl = *src.p_impl;
+    }
+    return *this;
+}
+
+PackageColumns & PackageColumns::operator=(PackageColumns && src) noexcept = default;
+
+
+std::size_t PackageColumns::size() const noexcept {
+    return p_impl->ids.size();
+}
+
+
+const std::vector<std::string> & PackageColumns::get_attributes() const noexcept {
+    return p_impl->attributes;
+}
+
+
+const std::vector<int> & PackageColumns::get_ids() const noexcept {
+    return p_impl->ids;
+}
+
+
+bool PackageColumns::is_number(const std::string & attribute) const {
+    return p_impl->get_column(attribute).is_number;
+}
+
+
+const std::vector<std::string> & PackageColumns::get_strings(const std::string & attribute) const {
+    const auto & column = p_impl->get_column(attribute);
+    if (column.is_number) {
+        throw PackageColumnsError(M_("Attribute \"{}\" is not a string attribute"), attribute);
+    }
+    return column.strings;
+}
+
+
+const std::vector<uint32_t> & PackageColumns::get_string_indexes(const std::string & attribute) const {
+    const auto & column = p_impl->get_column(attribute);
+    if (column.is_number) {
+        throw PackageColumnsError(M_("Attribute \"{}\" is not a string attribute"), attribute);
+    }
+    return column.string_indexes;
+}
+
+
+const std::vector<uint64_t> & PackageColumns::get_numbers(const std::string & attribute) const {
+    const auto & column = p_impl->get_column(attribute);
+    if (!column.is_number) {
+        throw PackageColumnsError(M_("Attribute \"{}\" is not a number attribute"), attribute);
+    }
+    return column.numbers;
+}
+
+
+std::vector<std::string> PackageColumns::get_string_attributes() {
+    std::vector<std::string> names;
+    for (const auto & info : PACKAGE_ATTRIBUTES) {
+        if (!info.is_number) {
+            names.emplace_back(info.name);
+        }
+    }
+    return names;
+}
+
+
+std::vector<std::string> PackageColumns::get_number_attributes() {
+    std::vector<std::string> names;
+    for (const auto & info : PACKAGE_ATTRIBUTES) {
+        if (info.is_number) {
+            names.emplace_back(info.name);
+        }
+    }
+    return names;
+}
+
+}  // namespace libdnf::rpm
@@ -0,0 +1,228 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "libdnf/rpm/package_formatter.hpp"
+
+#include "base/base_impl.hpp"
+#include "package_attributes.hpp"
+#include "package_set_impl.hpp"
+#include "utils/bgettext/bgettext-mark-domain.h"
+
+#include <charconv>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+
+namespace libdnf::rpm {
+
+namespace {
+
+// Size of the buffer for formatting a package set, it is written to the output stream when full
+constexpr std::size_t OUTPUT_BUFFER_SIZE = 256 * 1024;
+
+// Maximal field width of a tag, wider fields would only pad the output with whitespace
+constexpr std::size_t MAX_FIELD_WIDTH = 4096;
+
+struct Op {
+    const PackageAttributeInfo * attribute;  // nullptr for a literal op
+    std::string literal;                     // text of a literal op
+    std::size_t width;                       // minimal width of the field
+    bool left_align;
+};
+
+
+void append_field(std::string & output, std::string_view value, const Op & op) {
+    if (value.size() >= op.width) {
+        output.append(value);
+    } else if (op.left_align) {
+        output.append(value);
+        output.append(op.width - value.size(), ' ');
+    } else {
+        output.append(op.width - value.size(), ' ');
+        output.append(value);
+    }
+}
+
+}  // namespace
+
+
+class PackageFormatter::Impl {
+public:
+    explicit Impl(const std::string & format);
+
+    void format(PackageAttributeReader & reader, Id id, std::string & output) const;
+
+private:
+    void add_literal(char c);
+
+    std::vector<Op> ops;
+};
+
+
+PackageFormatter::Impl::Impl(const std::string & format) {
+    for (std::size_t pos = 0; pos < format.size(); ++pos) {
+        char c = format[pos];
+        if (c == '\\' && pos + 1 < format.size()) {
+            switch (format[pos + 1]) {
+                case 'n':
+                    add_literal('\n');
+                    ++pos;
+                    continue;
+                case 't':
+                    add_literal('\t');
+                    ++pos;
+                    continue;
+                case '\\':
+                    add_literal('\\');
+                    ++pos;
+                    continue;
+                default:
+                    break;
+            }
+        }
+        if (c != '%') {
+            add_literal(c);
+            continue;
+        }
+
+        if (pos + 1 < format.size() && format[pos + 1] == '%') {
+            add_literal('%');
+            ++pos;
+            continue;
+        }
+
+        // %[-][width]{tag}
+        auto tag_start = pos++;
+        Op op{nullptr, {}, 0, false};
+        if (pos < format.size() && format[pos] == '-') {
+            op.left_align = true;
+            ++pos;
+        }
+        auto width_end = format.find_first_not_of("0123456789", pos);
+        if (width_end == std::string::npos || format[width_end] != '{') {
+            throw PackageFormatterError(
+                M_("Invalid query format \"{}\": expected \"{{\" after \"%\" at position {}"), format, tag_start);
+        }
+        if (width_end > pos) {
+            auto res = std::from_chars(format.data() + pos, format.data() + width_end, op.width);
+            if (res.ec != std::errc() || op.width > MAX_FIELD_WIDTH) {
+                throw PackageFormatterError(
+                    M_("Invalid query format \"{}\": field width at position {} exceeds the maximum of {}"),
+                    format,
+                    tag_start,
+                    MAX_FIELD_WIDTH);
+            }
+        }
+        auto tag_end = format.find('}', width_end);
+        if (tag_end == std::string::npos) {
+            throw PackageFormatterError(
+                M_("Invalid query format \"{}\": missing \"}}\" of the tag at position {}"), format, tag_start);
+        }
+        auto tag_name = std::string_view(format).substr(width_end + 1, tag_end - width_end - 1);
+        op.attribute = find_package_attribute(tag_name);
+        if (!op.attribute) {
+            throw PackageFormatterError(M_("Unknown tag \"{}\" in query format"), std::string(tag_name));
+        }
+        ops.push_back(std::move(op));
+        pos = tag_end;
+    }
+}
+
+
+void PackageFormatter::Impl::add_literal(char c) {
+    if (ops.empty() || ops.back().attribute) {
+        ops.push_back({nullptr, {}, 0, false});
+    }
+    ops.back().literal.push_back(c);
+}
+
+
+void PackageFormatter::Impl::format(PackageAttributeReader & reader, Id id, std::string & output) const {
+    for (const auto & op : ops) {
+        if (!op.attribute) {
+            output.append(op.literal);
+            continue;
+        }
+        if (op.attribute->is_number) {
+            char number[24];
+            auto res = std::to_chars(number, number + sizeof(number), reader.get_number(id, op.attribute->attribute));
+            append_field(output, std::string_view(number, static_cast<std::size_t>(res.ptr - number)), op);
+        } else {
+            append_field(output, reader.get_string(id, op.attribute->attribute), op);
+        }
+    }
+}
+
+
+PackageFormatter::PackageFormatter(const std::string & format) : p_impl(new Impl(format)) {}
+
+PackageFormatter::~PackageFormatter() = default;
+
+PackageFormatter::PackageFormatter(const PackageFormatter & src) : p_impl(new Impl(*src.p_impl)) {}
+
+PackageFormatter::PackageFormatter(PackageFormatter && src) noexcept = default;
+
+PackageFormatter & PackageFormatter::operator=(const PackageFormatter & src) {
+    if (this != &src) {
+        *p_impl = *src.p_impl;
+    }
+    return *this;
+}
+
+PackageFormatter & PackageFormatter::operator=(PackageFormatter && src) noexcept = default;
+
+
+void PackageFormatter::format(const Package & package, std::string & output) const {
+    PackageAttributeReader reader(get_rpm_pool(package.base));
+    p_impl->format(reader, package.get_id().id, output);
+}
+
+
+std::string PackageFormatter::format(const Package & package) const {
+    std::string output;
+    format(package, output);
+    return output;
+}
+
+
+void PackageFormatter::format(const PackageSet & packages, std::ostream & output) const {
+    PackageAttributeReader reader(get_rpm_pool(packages.p_impl->base));
+    std::string buffer;
+    buffer.reserve(OUTPUT_BUFFER_SIZE + OUTPUT_BUFFER_SIZE / 4);
+    for (Id id : *packages.p_impl) {
+        p_impl->format(reader, id, buffer);
+        if (buffer.size() >= OUTPUT_BUFFER_SIZE) {
+            output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+    output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+
+std::vector<std::string> PackageFormatter::get_tags() {
+    std::vector<std::string> tags;
+    for (const auto & info : PACKAGE_ATTRIBUTES) {
+        tags.emplace_back(info.name);
+    }
+    return tags;
+}
+
+}  // namespace libdnf::rpm
@@ -21,7 +21,9 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "base/base_private.hpp"
 #include "common/sack/query_cmp_private.hpp"
 #include "package_query_impl.hpp"
+#include "package_sack_impl.hpp"
 #include "package_set_impl.hpp"
+#include "solv/parallel_filter.hpp"
 #include "utils/convert.hpp"
 
 #include "libdnf/advisory/advisory_query.hpp"
@@ -282,19 +284,25 @@ PackageQuery & PackageQuery::operator=(PackageQuery && src) noexcept = default;
 
 PackageQuery::~PackageQuery() = default;
 
-template <const char * (libdnf::solv::Pool::*getter)(Id) const>
+/// @return The number of threads for the filters that can be evaluated in parallel, see the `query_threads` option.
+static unsigned int get_query_threads(const BaseWeakPtr & base) {
+    return libdnf::solv::get_filter_threads(base->get_config().query_threads().get_value());
+}
+
+/// Adds to `filter_result` the `candidates` whose string returned by `get_value(candidate_id)` matches
+/// the glob `c_pattern`. With `threads` > 1 every thread calls its own copy of `get_value`.
+template <typename GetValue>
 inline static void filter_glob_internal(
-    libdnf::solv::Pool & pool,
     const char * c_pattern,
     const libdnf::solv::SolvMap & candidates,
     libdnf::solv::SolvMap & filter_result,
-    int fnm_flags) {
-    for (Id candidate_id : candidates) {
-        const char * candidate_str = (pool.*getter)(candidate_id);
-        if (fnmatch(c_pattern, candidate_str, fnm_flags) == 0) {
-            filter_result.add_unsafe(candidate_id);
-        }
-    }
+    int fnm_flags,
+    unsigned int threads,
+    const GetValue & get_value) {
+    libdnf::solv::filter_parallel(
+        candidates, filter_result, threads, [c_pattern, fnm_flags, get_value](Id candidate_id) mutable {
+            return fnmatch(c_pattern, get_value(candidate_id), fnm_flags) == 0;
+        });
 }
 
 void PackageQuery::filter_name(const std::vector<std::string> & patterns, libdnf::sack::QueryCmp cmp_type) {
@@ -310,6 +318,8 @@ void PackageQuery::filter_name(const std::vector<std::string> & patterns, libdnf
     }
 
     bool cmp_glob = (cmp_type & libdnf::sack::QueryCmp::GLOB) == libdnf::sack::QueryCmp::GLOB;
+    const auto threads = get_query_threads(p_impl->base);
+    auto get_name = [&pool](Id candidate_id) { return pool.get_name(candidate_id); };
 
     for (auto & pattern : patterns) {
         libdnf::sack::QueryCmp tmp_cmp_type = cmp_type;
@@ -349,27 +359,40 @@ void PackageQuery::filter_name(const std::vector<std::string> & patterns, libdnf
                 }
             } break;
             case libdnf::sack::QueryCmp::ICONTAINS: {
-                for (Id candidate_id : *p_impl) {
-                    const char * name = pool.get_name(candidate_id);
-                    if (strcasestr(name, c_pattern) != nullptr) {
-                        filter_result.add_unsafe(candidate_id);
-                    }
+                libdnf::solv::SolvMap index_candidates(pool.get_nsolvables());
+                const bool use_index =
+                    PQImpl::add_search_index_candidates(p_impl->base, SOLVABLE_NAME, c_pattern, index_candidates);
+                if (use_index) {
+                    index_candidates &= *p_impl;
                 }
+                libdnf::solv::filter_parallel(
+                    use_index ? index_candidates : *p_impl,
+                    filter_result,
+                    threads,
+                    [&pool, c_pattern](Id candidate_id) {
+                        return strcasestr(pool.get_name(candidate_id), c_pattern) != nullptr;
+                    });
             } break;
             case libdnf::sack::QueryCmp::IGLOB:
-                filter_glob_internal<&libdnf::solv::RpmPool::get_name>(
-                    pool, c_pattern, *p_impl, filter_result, FNM_CASEFOLD);
+                filter_glob_internal(c_pattern, *p_impl, filter_result, FNM_CASEFOLD, threads, get_name);
                 break;
             case libdnf::sack::QueryCmp::CONTAINS: {
-                for (Id candidate_id : *p_impl) {
-                    const char * name = pool.get_name(candidate_id);
-                    if (strstr(name, c_pattern) != nullptr) {
-                        filter_result.add_unsafe(candidate_id);
-                    }
+                libdnf::solv::SolvMap index_candidates(pool.get_nsolvables());
+                const bool use_index =
+                    PQImpl::add_search_index_candidates(p_impl->base, SOLVABLE_NAME, c_pattern, index_candidates);
+                if (use_index) {
+                    index_candidates &= *p_impl;
                 }
+                libdnf::solv::filter_parallel(
+                    use_index ? index_candidates : *p_impl,
+                    filter_result,
+                    threads,
+                    [&pool, c_pattern](Id candidate_id) {
+                        return strstr(pool.get_name(candidate_id), c_pattern) != nullptr;
+                    });
             } break;
             case libdnf::sack::QueryCmp::GLOB:
-                filter_glob_internal<&libdnf::solv::RpmPool::get_name>(pool, c_pattern, *p_impl, filter_result, 0);
+                filter_glob_internal(c_pattern, *p_impl, filter_result, 0, threads, get_name);
                 break;
             default:
                 libdnf_throw_assert_unsupported_query_cmp_type(cmp_type);
@@ -467,17 +490,17 @@ inline static bool cmp_lte(int cmp) {
 
 template <bool (*cmp_fnc)(int value_to_cmp)>
 inline static void filter_evr_internal(
-    libdnf::solv::RpmPool & pool, const std::vector<std::string> & patterns, libdnf::solv::SolvMap & query_result) {
+    libdnf::solv::RpmPool & pool,
+    const std::vector<std::string> & patterns,
+    libdnf::solv::SolvMap & query_result,
+    unsigned int threads) {
     libdnf::solv::SolvMap filter_result(static_cast<int>(pool->nsolvables));
     for (auto & pattern : patterns) {
         const char * pattern_c_str = pattern.c_str();
-        for (Id candidate_id : query_result) {
+        libdnf::solv::filter_parallel(query_result, filter_result, threads, [&pool, pattern_c_str](Id candidate_id) {
             Solvable * solvable = pool.id2solvable(candidate_id);
-            int cmp = pool.evrcmp_str(pool.id2str(solvable->evr), pattern_c_str, EVRCMP_COMPARE);
-            if (cmp_fnc(cmp)) {
-                filter_result.add_unsafe(candidate_id);
-            }
-        }
+            return cmp_fnc(pool.evrcmp_str(pool.id2str(solvable->evr), pattern_c_str, EVRCMP_COMPARE));
+        });
     }
     // Apply filter results to query
     query_result &= filter_result;
@@ -485,21 +508,22 @@ inline static void filter_evr_internal(
 
 void PackageQuery::filter_evr(const std::vector<std::string> & patterns, libdnf::sack::QueryCmp cmp_type) {
     auto & pool = get_rpm_pool(p_impl->base);
+    const auto threads = get_query_threads(p_impl->base);
     switch (cmp_type) {
         case libdnf::sack::QueryCmp::GT:
-            filter_evr_internal<cmp_gt>(pool, patterns, *p_impl);
+            filter_evr_internal<cmp_gt>(pool, patterns, *p_impl, threads);
             break;
         case libdnf::sack::QueryCmp::LT:
-            filter_evr_internal<cmp_lt>(pool, patterns, *p_impl);
+            filter_evr_internal<cmp_lt>(pool, patterns, *p_impl, threads);
             break;
         case libdnf::sack::QueryCmp::GTE:
-            filter_evr_internal<cmp_gte>(pool, patterns, *p_impl);
+            filter_evr_internal<cmp_gte>(pool, patterns, *p_impl, threads);
             break;
         case libdnf::sack::QueryCmp::LTE:
-            filter_evr_internal<cmp_lte>(pool, patterns, *p_impl);
+            filter_evr_internal<cmp_lte>(pool, patterns, *p_impl, threads);
             break;
         case libdnf::sack::QueryCmp::EQ:
-            filter_evr_internal<cmp_eq>(pool, patterns, *p_impl);
+            filter_evr_internal<cmp_eq>(pool, patterns, *p_impl, threads);
             break;
         default:
             libdnf_throw_assert_unsupported_query_cmp_type(cmp_type);
@@ -539,7 +563,10 @@ void PackageQuery::filter_arch(const std::vector<std::string> & patterns, libdnf
                 }
             } break;
             case libdnf::sack::QueryCmp::GLOB:
-                filter_glob_internal<&libdnf::solv::RpmPool::get_arch>(pool, c_pattern, *p_impl, filter_result, 0);
+                filter_glob_internal(
+                    c_pattern, *p_impl, filter_result, 0, get_query_threads(p_impl->base), [&pool](Id candidate_id) {
+                        return pool.get_arch(candidate_id);
+                    });
                 break;
             default:
                 libdnf_throw_assert_unsupported_query_cmp_type(cmp_type);
@@ -757,16 +784,20 @@ inline static void filter_version_internal(
     libdnf::solv::RpmPool & pool,
     const char * c_pattern,
     libdnf::solv::SolvMap & candidates,
-    libdnf::solv::SolvMap & filter_result) {
+    libdnf::solv::SolvMap & filter_result,
+    unsigned int threads) {
     char * formatted_c_pattern = solv_dupjoin(c_pattern, "-0", nullptr);
-    for (Id candidate_id : candidates) {
-        std::string vr(pool.split_evr(pool.get_evr(candidate_id)).v);
-        vr.append("-0");
-        int cmp = pool.evrcmp_str(vr.c_str(), formatted_c_pattern, EVRCMP_COMPARE);
-        if (cmp_eq(cmp)) {
-            filter_result.add_unsafe(candidate_id);
-        }
-    }
+    libdnf::solv::filter_parallel(
+        candidates,
+        filter_result,
+        threads,
+        [&pool, formatted_c_pattern, vr = std::string()](Id candidate_id) mutable {
+            // EvrView instead of split_evr(), the pool's temporary space must not be used by more threads
+            vr.assign(libdnf::solv::EvrView(pool.get_evr(candidate_id)).v);
+            vr.append("-0");
+            int cmp = pool.evrcmp_str(vr.c_str(), formatted_c_pattern, EVRCMP_COMPARE);
+            return cmp_eq(cmp);
+        });
     solv_free(formatted_c_pattern);
 }
 
@@ -778,6 +809,7 @@ void PackageQuery::filter_version(const std::vector<std::string> & patterns, lib
     }
 
     auto & pool = get_rpm_pool(p_impl->base);
+    const auto threads = get_query_threads(p_impl->base);
     libdnf::solv::SolvMap filter_result(pool.get_nsolvables());
     bool cmp_glob = (cmp_type & libdnf::sack::QueryCmp::GLOB) == libdnf::sack::QueryCmp::GLOB;
 
@@ -790,22 +822,31 @@ void PackageQuery::filter_version(const std::vector<std::string> & patterns, lib
         }
         switch (tmp_cmp_type) {
             case libdnf::sack::QueryCmp::EQ:
-                filter_version_internal<cmp_eq>(pool, c_pattern, *p_impl, filter_result);
+                filter_version_internal<cmp_eq>(pool, c_pattern, *p_impl, filter_result, threads);
                 break;
             case libdnf::sack::QueryCmp::GLOB:
-                filter_glob_internal<&libdnf::solv::RpmPool::get_version>(pool, c_pattern, *p_impl, filter_result, 0);
+                filter_glob_internal(
+                    c_pattern,
+                    *p_impl,
+                    filter_result,
+                    0,
+                    threads,
+                    [&pool, version = std::string()](Id candidate_id) mutable {
+                        version.assign(libdnf::solv::EvrView(pool.get_evr(candidate_id)).v);
+                        return version.c_str();
+                    });
                 break;
             case libdnf::sack::QueryCmp::GT:
-                filter_version_internal<cmp_gt>(pool, c_pattern, *p_impl, filter_result);
+                filter_version_internal<cmp_gt>(pool, c_pattern, *p_impl, filter_result, threads);
                 break;
             case libdnf::sack::QueryCmp::LT:
-                filter_version_internal<cmp_lt>(pool, c_pattern, *p_impl, filter_result);
+                filter_version_internal<cmp_lt>(pool, c_pattern, *p_impl, filter_result, threads);
                 break;
             case libdnf::sack::QueryCmp::GTE:
-                filter_version_internal<cmp_gte>(pool, c_pattern, *p_impl, filter_result);
+                filter_version_internal<cmp_gte>(pool, c_pattern, *p_impl, filter_result, threads);
                 break;
             case libdnf::sack::QueryCmp::LTE:
-                filter_version_internal<cmp_lte>(pool, c_pattern, *p_impl, filter_result);
+                filter_version_internal<cmp_lte>(pool, c_pattern, *p_impl, filter_result, threads);
                 break;
             default:
                 libdnf_throw_assert_unsupported_query_cmp_type(cmp_type);
@@ -825,16 +866,19 @@ inline static void filter_release_internal(
     libdnf::solv::RpmPool & pool,
     const char * c_pattern,
     libdnf::solv::SolvMap & candidates,
-    libdnf::solv::SolvMap & filter_result) {
+    libdnf::solv::SolvMap & filter_result,
+    unsigned int threads) {
     char * formatted_c_pattern = solv_dupjoin("0-", c_pattern, nullptr);
-    for (Id candidate_id : candidates) {
-        std::string vr("0-");
-        vr.append(pool.split_evr(pool.get_evr(candidate_id)).r);
-        int cmp = pool.evrcmp_str(vr.c_str(), formatted_c_pattern, EVRCMP_COMPARE);
-        if (cmp_eq(cmp)) {
-            filter_result.add_unsafe(candidate_id);
-        }
-    }
+    libdnf::solv::filter_parallel(
+        candidates,
+        filter_result,
+        threads,
+        [&pool, formatted_c_pattern, vr = std::string()](Id candidate_id) mutable {
+            vr.assign("0-");
+            vr.append(libdnf::solv::EvrView(pool.get_evr(candidate_id)).r);
+            int cmp = pool.evrcmp_str(vr.c_str(), formatted_c_pattern, EVRCMP_COMPARE);
+            return cmp_eq(cmp);
+        });
     solv_free(formatted_c_pattern);
 }
 
@@ -846,6 +890,7 @@ void PackageQuery::filter_release(const std::vector<std::string> & patterns, lib
     }
 
     auto & pool = get_rpm_pool(p_impl->base);
+    const auto threads = get_query_threads(p_impl->base);
     libdnf::solv::SolvMap filter_result(pool.get_nsolvables());
     bool cmp_glob = (cmp_type & libdnf::sack::QueryCmp::GLOB) == libdnf::sack::QueryCmp::GLOB;
 
@@ -858,22 +903,31 @@ void PackageQuery::filter_release(const std::vector<std::string> & patterns, lib
         }
         switch (tmp_cmp_type) {
             case libdnf::sack::QueryCmp::EQ:
-                filter_release_internal<cmp_eq>(pool, c_pattern, *p_impl, filter_result);
+                filter_release_internal<cmp_eq>(pool, c_pattern, *p_impl, filter_result, threads);
                 break;
             case libdnf::sack::QueryCmp::GLOB:
-                filter_glob_internal<&libdnf::solv::RpmPool::get_release>(pool, c_pattern, *p_impl, filter_result, 0);
+                filter_glob_internal(
+                    c_pattern,
+                    *p_impl,
+                    filter_result,
+                    0,
+                    threads,
+                    [&pool, release = std::string()](Id candidate_id) mutable {
+                        release.assign(libdnf::solv::EvrView(pool.get_evr(candidate_id)).r);
+                        return release.c_str();
+                    });
                 break;
             case libdnf::sack::QueryCmp::GT:
-                filter_release_internal<cmp_gt>(pool, c_pattern, *p_impl, filter_result);
+                filter_release_internal<cmp_gt>(pool, c_pattern, *p_impl, filter_result, threads);
                 break;
             case libdnf::sack::QueryCmp::LT:
-                filter_release_internal<cmp_lt>(pool, c_pattern, *p_impl, filter_result);
+                filter_release_internal<cmp_lt>(pool, c_pattern, *p_impl, filter_result, threads);
                 break;
             case libdnf::sack::QueryCmp::GTE:
-                filter_release_internal<cmp_gte>(pool, c_pattern, *p_impl, filter_result);
+                filter_release_internal<cmp_gte>(pool, c_pattern, *p_impl, filter_result, threads);
                 break;
             case libdnf::sack::QueryCmp::LTE:
-                filter_release_internal<cmp_lte>(pool, c_pattern, *p_impl, filter_result);
+                filter_release_internal<cmp_lte>(pool, c_pattern, *p_impl, filter_result, threads);
                 break;
             default:
                 libdnf_throw_assert_unsupported_query_cmp_type(cmp_type);
@@ -1133,7 +1187,7 @@ static void filter_dataiterator(
     Pool * pool,
     Id keyname,
     int flags,
-    libdnf::solv::SolvMap & candidates,
+    const libdnf::solv::SolvMap & candidates,
     libdnf::solv::SolvMap & filter_result,
     const char * c_pattern) {
     Dataiterator di;
@@ -1148,12 +1202,46 @@ static void filter_dataiterator(
     }
 }
 
-static void filter_dataiterator_internal(
-    Pool * pool,
+bool PackageQuery::PQImpl::add_search_index_candidates(
+    const BaseWeakPtr & base, Id keyname, const char * pattern, libdnf::solv::SolvMap & index_candidates) {
+    auto key = repo::SearchIndex::keyname_to_key(keyname);
+    if (!key) {
+        return false;
+    }
+    return base->get_rpm_package_sack()->p_impl->add_search_index_candidates(*key, pattern, index_candidates);
+}
+
+void PackageQuery::PQImpl::filter_files(
+    const BaseWeakPtr & base,
+    const libdnf::solv::SolvMap & candidates,
+    const char * pattern,
+    bool glob,
+    libdnf::solv::SolvMap & filter_result) {
+    Pool * pool = *get_rpm_pool(base);
+    const int flags = SEARCH_FILES | SEARCH_COMPLETE_FILELIST | (glob ? SEARCH_GLOB : SEARCH_STRING);
+
+    libdnf::solv::SolvMap index_matches(pool->nsolvables);
+    libdnf::solv::SolvMap index_candidates(pool->nsolvables);
+    if (!base->get_rpm_package_sack()->p_impl->add_file_index_candidates(
+            pattern, glob, index_matches, index_candidates)) {
+        filter_dataiterator(pool, SOLVABLE_FILELIST, flags, candidates, filter_result, pattern);
+        return;
+    }
+
+    // Exact paths found in an index are final, only the other candidates are verified on the filelists
+    index_matches &= candidates;
+    filter_result |= index_matches;
+    index_candidates &= candidates;
+    filter_dataiterator(pool, SOLVABLE_FILELIST, flags, index_candidates, filter_result, pattern);
+}
+
+void PackageQuery::PQImpl::filter_dataiterator_internal(
+    const BaseWeakPtr & base,
     Id keyname,
     libdnf::solv::SolvMap & candidates,
     libdnf::sack::QueryCmp cmp_type,
     const std::vector<std::string> & patterns) {
+    Pool * pool = *get_rpm_pool(base);
     libdnf::solv::SolvMap filter_result(pool->nsolvables);
 
     bool cmp_not = (cmp_type & libdnf::sack::QueryCmp::NOT) == libdnf::sack::QueryCmp::NOT;
@@ -1195,6 +1283,22 @@ static void filter_dataiterator_internal(
             default:
                 libdnf_throw_assert_unsupported_query_cmp_type(cmp_type);
         }
+
+        if (keyname == SOLVABLE_FILELIST &&
+            (tmp_cmp_type == libdnf::sack::QueryCmp::EQ || tmp_cmp_type == libdnf::sack::QueryCmp::GLOB)) {
+            filter_files(base, candidates, c_pattern, tmp_cmp_type == libdnf::sack::QueryCmp::GLOB, filter_result);
+            continue;
+        }
+
+        if (tmp_cmp_type == libdnf::sack::QueryCmp::CONTAINS || tmp_cmp_type == libdnf::sack::QueryCmp::ICONTAINS) {
+            // Iterating over the attribute data is expensive, verify only packages found in the search index
+            libdnf::solv::SolvMap index_candidates(pool->nsolvables);
+            if (add_search_index_candidates(base, keyname, c_pattern, index_candidates)) {
+                index_candidates &= candidates;
+                filter_dataiterator(pool, keyname, flags, index_candidates, filter_result, c_pattern);
+                continue;
+            }
+        }
         filter_dataiterator(pool, keyname, flags, candidates, filter_result, c_pattern);
     }
 
@@ -1207,19 +1311,19 @@ static void filter_dataiterator_internal(
 }
 
 void PackageQuery::filter_file(const std::vector<std::string> & patterns, libdnf::sack::QueryCmp cmp_type) {
-    filter_dataiterator_internal(*get_rpm_pool(p_impl->base), SOLVABLE_FILELIST, *p_impl, cmp_type, patterns);
+    PQImpl::filter_dataiterator_internal(p_impl->base, SOLVABLE_FILELIST, *p_impl, cmp_type, patterns);
 }
 
 void PackageQuery::filter_description(const std::vector<std::string> & patterns, libdnf::sack::QueryCmp cmp_type) {
-    filter_dataiterator_internal(*get_rpm_pool(p_impl->base), SOLVABLE_DESCRIPTION, *p_impl, cmp_type, patterns);
+    PQImpl::filter_dataiterator_internal(p_impl->base, SOLVABLE_DESCRIPTION, *p_impl, cmp_type, patterns);
 }
 
 void PackageQuery::filter_summary(const std::vector<std::string> & patterns, libdnf::sack::QueryCmp cmp_type) {
-    filter_dataiterator_internal(*get_rpm_pool(p_impl->base), SOLVABLE_SUMMARY, *p_impl, cmp_type, patterns);
+    PQImpl::filter_dataiterator_internal(p_impl->base, SOLVABLE_SUMMARY, *p_impl, cmp_type, patterns);
 }
 
 void PackageQuery::filter_url(const std::vector<std::string> & patterns, libdnf::sack::QueryCmp cmp_type) {
-    filter_dataiterator_internal(*get_rpm_pool(p_impl->base), SOLVABLE_URL, *p_impl, cmp_type, patterns);
+    PQImpl::filter_dataiterator_internal(p_impl->base, SOLVABLE_URL, *p_impl, cmp_type, patterns);
 }
 
 void PackageQuery::filter_location(const std::vector<std::string> & patterns, libdnf::sack::QueryCmp cmp_type) {
@@ -1389,27 +1493,27 @@ void PackageQuery::PQImpl::filter_reldep(
 
     libdnf::solv::SolvMap filter_result(pool.get_nsolvables());
 
-    libdnf::solv::IdQueue rco;
-
-    for (Id candidate_id : *pkg_set.p_impl) {
-        Solvable * solvable = pool.id2solvable(candidate_id);
-        auto reldep_list_size = reldep_list.size();
-        for (int index = 0; index < reldep_list_size; ++index) {
-            Id reldep_filter_id = reldep_list.get_id(index).id;
-
+    // The dependencies are read from the solvables themselves, the lookup does not touch the repodata
+    libdnf::solv::filter_parallel(
+        *pkg_set.p_impl,
+        filter_result,
+        get_query_threads(base),
+        [&pool, &reldep_list, libsolv_key, rco = libdnf::solv::IdQueue()](Id candidate_id) mutable {
+            Solvable * solvable = pool.id2solvable(candidate_id);
             rco.clear();
             solvable_lookup_idarray(solvable, libsolv_key, &rco.get_queue());
             auto rco_size = rco.size();
-            for (int index_j = 0; index_j < rco_size; ++index_j) {
-                Id reldep_id_from_solvable = rco[index_j];
-
-                if (pool_match_dep(*pool, reldep_filter_id, reldep_id_from_solvable) != 0) {
-                    filter_result.add_unsafe(candidate_id);
-                    break;
+            auto reldep_list_size = reldep_list.size();
+            for (int index = 0; index < reldep_list_size; ++index) {
+                Id reldep_filter_id = reldep_list.get_id(index).id;
+                for (int index_j = 0; index_j < rco_size; ++index_j) {
+                    if (pool_match_dep(*pool, reldep_filter_id, rco[index_j]) != 0) {
+                        return true;
+                    }
                 }
             }
-        }
-    }
+            return false;
+        });
 
     // Apply filter results to query
     if (cmp_not) {
@@ -1688,6 +1792,13 @@ void PackageQuery::PQImpl::filter_nevra(
     }
 
     libdnf::solv::RpmPool & pool = get_rpm_pool(pkg_set.get_base());
+    const auto threads = get_query_threads(pkg_set.get_base());
+    // append_nevra() instead of get_nevra(), which uses the pool's temporary space
+    auto get_nevra = [&pool, nevra = std::string()](Id candidate_id) mutable {
+        nevra.clear();
+        pool.append_nevra(candidate_id, nevra);
+        return nevra.c_str();
+    };
 
     switch (tmp_cmp_type) {
         case libdnf::sack::QueryCmp::EQ: {
@@ -1716,11 +1827,10 @@ void PackageQuery::PQImpl::filter_nevra(
             filter_nevra_internal<cmp_lte>(pool, c_pattern, sorted_solvables, filter_result);
             break;
         case libdnf::sack::QueryCmp::GLOB:
-            filter_glob_internal<&libdnf::solv::RpmPool::get_nevra>(pool, c_pattern, *pkg_set.p_impl, filter_result, 0);
+            filter_glob_internal(c_pattern, *pkg_set.p_impl, filter_result, 0, threads, get_nevra);
             break;
         case libdnf::sack::QueryCmp::IGLOB:
-            filter_glob_internal<&libdnf::solv::RpmPool::get_nevra>(
-                pool, c_pattern, *pkg_set.p_impl, filter_result, FNM_CASEFOLD);
+            filter_glob_internal(c_pattern, *pkg_set.p_impl, filter_result, FNM_CASEFOLD, threads, get_nevra);
             break;
         case libdnf::sack::QueryCmp::IEXACT: {
             for (Id candidate_id : *pkg_set.p_impl) {
@@ -2336,13 +2446,7 @@ std::pair<bool, libdnf::rpm::Nevra> PackageQuery::resolve_pkg_spec(
         }
     }
     if (settings.with_filenames && libdnf::utils::is_file_pattern(pkg_spec)) {
-        filter_dataiterator(
-            *pool,
-            SOLVABLE_FILELIST,
-            SEARCH_FILES | SEARCH_COMPLETE_FILELIST | (glob ? SEARCH_GLOB : SEARCH_STRING),
-            *p_impl,
-            filter_result,
-            pkg_spec.c_str());
+        PQImpl::filter_files(p_impl->base, *p_impl, pkg_spec.c_str(), glob, filter_result);
         if (!filter_result.empty()) {
             *p_impl &= filter_result;
             return {true, libdnf::rpm::Nevra()};
@@ -78,6 +78,29 @@ public:
         const std::vector<libdnf::advisory::AdvisoryPackage> & adv_pkgs,
         libdnf::sack::QueryCmp cmp_type);
 
+    /// Filter `candidates` by values of the `keyname` attribute using libsolv's Dataiterator
+    static void filter_dataiterator_internal(
+        const BaseWeakPtr & base,
+        Id keyname,
+        libdnf::solv::SolvMap & candidates,
+        libdnf::sack::QueryCmp cmp_type,
+        const std::vector<std::string> & patterns);
+
+    /// Adds to `index_candidates` solvables whose `keyname` attribute may contain `pattern` according to
+    /// the repositories' search indexes. Substring matches are always a subset of the added solvables.
+    /// @return `false` if the attribute is not indexed or the pattern is too short for the index lookup.
+    static bool add_search_index_candidates(
+        const BaseWeakPtr & base, Id keyname, const char * pattern, libdnf::solv::SolvMap & index_candidates);
+
+    /// Adds to `filter_result` the `candidates` containing the file `pattern` (a glob if `glob` is `true`).
+    /// The file indexes of the repositories are used to limit the filelists that are scanned.
+    static void filter_files(
+        const BaseWeakPtr & base,
+        const libdnf::solv::SolvMap & candidates,
+        const char * pattern,
+        bool glob,
+        libdnf::solv::SolvMap & filter_result);
+
 private:
     friend PackageQuery;
     ExcludeFlags flags;
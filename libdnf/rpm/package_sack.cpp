@@ -49,6 +49,12 @@ using LibsolvRepo = Repo;
 
 namespace libdnf::rpm {
 
+PackageSack::Impl::~Impl() {
+    for (auto & [solver, stamp] : idle_solvers) {
+        solver_free(solver);
+    }
+}
+
 void PackageSack::Impl::make_provides_ready() {
     if (provides_ready) {
         return;
@@ -380,10 +386,123 @@ void PackageSack::Impl::recompute_considered_in_pool() {
         libdnf::solv::SolvMap empty_map(0);
         get_rpm_pool(base).swap_considered_map(empty_map);
     }
+    invalidate_solvers();
 
     considered_uptodate = true;
 }
 
+PackageSack::Impl::SolverStamp PackageSack::Impl::get_solver_stamp() const {
+    auto & pool = get_rpm_pool(base);
+    return {solvers_generation, pool->nsolvables, pool->installed};
+}
+
+::Solver * PackageSack::Impl::acquire_solver() {
+    const auto stamp = get_solver_stamp();
+    ::Solver * solver = nullptr;
+    while (!solver && !idle_solvers.empty()) {
+        auto [idle_solver, idle_stamp] = idle_solvers.back();
+        idle_solvers.pop_back();
+        if (idle_stamp == stamp) {
+            solver = idle_solver;
+        } else {
+            solver_free(idle_solver);
+        }
+    }
+
+    if (solver) {
+        base->get_metrics()->add_counter("goal.solver_reused", 1);
+    } else {
+        solver = solver_create(*get_rpm_pool(base));
+        base->get_metrics()->add_counter("goal.solver_created", 1);
+    }
+    acquired_solvers.emplace_back(solver, stamp);
+    return solver;
+}
+
+void PackageSack::Impl::release_solver(::Solver * solver) {
+    auto it = std::find_if(acquired_solvers.begin(), acquired_solvers.end(), [solver](const auto & item) {
+        return item.first == solver;
+    });
+    libdnf_assert(it != acquired_solvers.end(), "Released solver was not acquired from the PackageSack");
+    const auto stamp = it->second;
+    acquired_solvers.erase(it);
+
+    if (stamp == get_solver_stamp() && idle_solvers.size() < MAX_IDLE_SOLVERS) {
+        idle_solvers.emplace_back(solver, stamp);
+    } else {
+        solver_free(solver);
+    }
+}
+
+void PackageSack::Impl::invalidate_solvers() {
+    ++solvers_generation;
+    for (auto & [solver, stamp] : idle_solvers) {
+        solver_free(solver);
+    }
+    idle_solvers.clear();
+}
+
+bool PackageSack::Impl::add_search_index_candidates(
+    repo::SearchIndex::Key key, std::string_view pattern, libdnf::solv::SolvMap & candidates) {
+    if (pattern.size() < repo::SearchIndex::GRAM_SIZE) {
+        return false;
+    }
+
+    auto & pool = get_rpm_pool(base);
+    libdnf::solv::SolvMap repo_candidates(pool.get_nsolvables());
+    Id repo_id;
+    ::Repo * r;
+    FOR_REPOS(repo_id, r) {
+        auto * libdnf_repo = static_cast<repo::Repo *>(r->appdata);
+        if (!libdnf_repo || !libdnf_repo->solv_repo) {
+            for (Id id = r->start; id < r->end; ++id) {
+                if (pool.id2solvable(id)->repo == r) {
+                    repo_candidates.add_unsafe(id);
+                }
+            }
+            continue;
+        }
+        if (!libdnf_repo->solv_repo->get_search_index().add_candidates(key, pattern, repo_candidates)) {
+            return false;
+        }
+    }
+
+    candidates |= repo_candidates;
+    return true;
+}
+
+bool PackageSack::Impl::add_file_index_candidates(
+    std::string_view pattern, bool glob, libdnf::solv::SolvMap & matches, libdnf::solv::SolvMap & candidates) {
+    auto & pool = get_rpm_pool(base);
+    libdnf::solv::SolvMap repo_matches(pool.get_nsolvables());
+    libdnf::solv::SolvMap repo_candidates(pool.get_nsolvables());
+    Id repo_id;
+    ::Repo * r;
+    FOR_REPOS(repo_id, r) {
+        auto * libdnf_repo = static_cast<repo::Repo *>(r->appdata);
+        const repo::FileIndex * index =
+            libdnf_repo && libdnf_repo->solv_repo ? libdnf_repo->solv_repo->get_file_index() : nullptr;
+        // Solvables not covered by the index (e.g. system repo, command line packages) are verified by the caller
+        for (Id id = r->start; id < r->end; ++id) {
+            if (pool.id2solvable(id)->repo == r && (!index || !index->is_indexed(id))) {
+                repo_candidates.add_unsafe(id);
+            }
+        }
+        if (!index) {
+            continue;
+        }
+        if (!glob) {
+            index->add_matches(pattern, repo_matches);
+        } else if (!index->add_glob_candidates(pattern, repo_candidates)) {
+            return false;
+        }
+    }
+
+    matches |= repo_matches;
+    candidates |= repo_candidates;
+    return true;
+}
+
 PackageSackWeakPtr PackageSack::get_weak_ptr() {
     return PackageSackWeakPtr(this, &p_impl->sack_guard);
 }
@@ -20,6 +20,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef LIBDNF_RPM_PACKAGE_SACK_IMPL_HPP
 #define LIBDNF_RPM_PACKAGE_SACK_IMPL_HPP
 
+#include "repo/search_index.hpp"
 #include "solv/id_queue.hpp"
 #include "solv/pool.hpp"
 #include "solv/solv_map.hpp"
@@ -30,9 +31,12 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 extern "C" {
 #include <solv/pool.h>
+#include <solv/solver.h>
 }
 
+#include <cstdint>
 #include <optional>
+#include <utility>
 #include <vector>
 
 
@@ -63,6 +67,7 @@ namespace libdnf::rpm {
 class PackageSack::Impl {
 public:
     explicit Impl(const BaseWeakPtr & base) : base(base) {}
+    ~Impl();
 
     /// Return number of solvables in pool
     int get_nsolvables() const noexcept { return get_rpm_pool(base)->nsolvables; };
@@ -78,7 +83,18 @@ public:
 
     void make_provides_ready();
 
-    void invalidate_provides() { provides_ready = false; }
+    void invalidate_provides() {
+        provides_ready = false;
+        invalidate_solvers();
+    }
+
+    /// Drops the cached maps and lists of the package solvables. They are recomputed only when the number
+    /// of solvables changes, freeing of solvables must invalidate them explicitly.
+    void invalidate_solvables() {
+        cached_solvables_size = 0;
+        cached_sorted_solvables_size = 0;
+        cached_sorted_icase_solvables_size = 0;
+    }
 
     PackageId get_running_kernel_id();
 
@@ -117,7 +133,49 @@ public:
     /// And sets `considered_uptodate` to` true`.
     void recompute_considered_in_pool();
 
+    /// Adds to `candidates` the solvables whose `key` attribute may contain `pattern` according to
+    /// the search indexes of the repositories. The result is a superset of the real matches.
+    /// @return `false` if the pattern cannot be looked up in the indexes, `candidates` are untouched then.
+    bool add_search_index_candidates(
+        repo::SearchIndex::Key key, std::string_view pattern, libdnf::solv::SolvMap & candidates);
+
+    /// Looks up the file `pattern` in the file indexes of the repositories. The solvables found in an index
+    /// are added to `matches` for an exact path and to `candidates` for a glob. The solvables of repositories
+    /// without an index are added to `candidates`. The `candidates` must be verified by the caller.
+    /// @return `false` if the glob cannot be looked up in an index, `matches` and `candidates` are untouched then.
+    bool add_file_index_candidates(
+        std::string_view pattern, bool glob, libdnf::solv::SolvMap & matches, libdnf::solv::SolvMap & candidates);
+
+    /// Returns a libsolv solver for the current state of the pool. An idle solver released after a previous
+    /// resolve is reused if the solvables, the provides and the considered map of the pool did not change
+    /// since the solver was created. The caller sets all the solver flags it depends on.
+    ::Solver * acquire_solver();
+
+    /// Takes back a solver returned by `acquire_solver()`. The solver is kept idle for the next resolve
+    /// if it is still valid for the pool, otherwise it is freed.
+    void release_solver(::Solver * solver);
+
+    /// Frees the idle solvers, the solvers in use are freed when they are released.
+    /// Called when the solvables, the provides or the considered map of the pool change.
+    void invalidate_solvers();
+
 private:
+    /// State of the pool a solver was created for.
+    struct SolverStamp {
+        uint64_t generation;
+        int nsolvables;
+        ::Repo * installed;
+
+        bool operator==(const SolverStamp & other) const noexcept {
+            return generation == other.generation && nsolvables == other.nsolvables && installed == other.installed;
+        }
+    };
+
+    SolverStamp get_solver_stamp() const;
+
+    // Resolving a Goal uses two solvers, the second one checks the result in the strict mode
+    static constexpr std::size_t MAX_IDLE_SOLVERS = 2;
+
     bool provides_ready{false};
 
     BaseWeakPtr base;
@@ -139,6 +197,10 @@ private:
 
     bool considered_uptodate = true;
 
+    uint64_t solvers_generation{0};  // incremented by invalidate_solvers()
+    std::vector<std::pair<::Solver *, SolverStamp>> idle_solvers;
+    std::vector<std::pair<::Solver *, SolverStamp>> acquired_solvers;
+
     std::vector<Solvable *> cached_sorted_solvables;
     int cached_sorted_solvables_size{0};
     /// pair<id_of_lowercase_name, Solvable *>
@@ -182,6 +244,7 @@ inline std::vector<std::pair<Id, Solvable *>> & PackageSack::Impl::get_sorted_ic
     }
     Id name = 0;
     Id icase_name = 0;
+    cached_sorted_icase_solvables.clear();
     for (auto * solvable : get_sorted_solvables()) {
         if (solvable->name != name) {
             icase_name = pool.id_to_lowercase_id(solvable->name, 1);
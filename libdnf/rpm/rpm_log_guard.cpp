@@ -26,7 +26,9 @@ namespace libdnf::rpm {
 
 std::mutex RpmLogGuardBase::rpm_log_mutex;
 
-static int rpmlog_callback(rpmlogRec rec, rpmlogCallbackData data) {
+static thread_local RpmLogCapture * current_capture = nullptr;
+
+static Logger::Level rpmlog_level(rpmlogRec rec) {
     Logger::Level level = Logger::Level::DEBUG;  // default for the case of an unknown value below
     switch (rpmlogRecPriority(rec)) {
         case RPMLOG_EMERG:
@@ -51,13 +53,34 @@ static int rpmlog_callback(rpmlogRec rec, rpmlogCallbackData data) {
             level = Logger::Level::TRACE;
             break;
     }
+    return level;
+}
+
+// Passes the record to the capture of the current thread, returns `false` if the thread does not capture.
+static bool capture_record(rpmlogRec rec) {
+    auto * capture = RpmLogCapture::get_current();
+    if (!capture) {
+        return false;
+    }
+    std::string msg(rpmlogRecMessage(rec));
+    if (!msg.empty() && msg[msg.length() - 1] == '\n') {
+        msg.pop_back();
+    }
+    capture->add_record(rpmlog_level(rec), std::move(msg));
+    return true;
+}
+
+static int rpmlog_callback(rpmlogRec rec, rpmlogCallbackData data) {
+    if (capture_record(rec)) {
+        return 0;
+    }
 
     std::string_view msg(rpmlogRecMessage(rec));
     if (msg[msg.length() - 1] == '\n') {
         msg.remove_suffix(1);
     }
 
-    static_cast<libdnf::Logger *>(data)->log(level, "[rpm] {}", msg);
+    static_cast<libdnf::Logger *>(data)->log(rpmlog_level(rec), "[rpm] {}", msg);
     return 0;
 }
 
@@ -76,6 +99,10 @@ RpmLogGuard::~RpmLogGuard() {
 
 
 static int rpmlog_callback_strings(rpmlogRec rec, rpmlogCallbackData data) {
+    if (capture_record(rec)) {
+        return 0;
+    }
+
     std::string msg(rpmlogRecMessage(rec));
     if (!msg.empty() && msg[msg.length() - 1] == '\n') {
         msg.pop_back();
@@ -89,4 +116,26 @@ RpmLogGuardStrings::RpmLogGuardStrings() : RpmLogGuardBase() {
     rpmlogSetCallback(&rpmlog_callback_strings, this);
 }
 
+
+RpmLogCapture::RpmLogCapture() : previous(current_capture) {
+    current_capture = this;
+}
+
+
+RpmLogCapture::~RpmLogCapture() {
+    current_capture = previous;
+}
+
+
+RpmLogCapture * RpmLogCapture::get_current() noexcept {
+    return current_capture;
+}
+
+
+void RpmLogCapture::log_records(Logger & logger, const std::vector<Record> & records) {
+    for (const auto & record : records) {
+        logger.log(record.level, "[rpm] {}", record.message);
+    }
+}
+
 }  // namespace libdnf::rpm
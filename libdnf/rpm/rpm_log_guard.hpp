@@ -24,6 +24,9 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf/logger/logger.hpp"
 
 #include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 
 namespace libdnf::rpm {
@@ -59,6 +62,38 @@ private:
     std::vector<std::string> rpm_logs{};
 };
 
+/// Captures the rpm log records of the current thread while it exists. The captured records are not passed
+/// to the callback of the guards. Threads calling rpm concurrently with others capture their records and
+/// a single thread logs them later by `log_records()`, in a deterministic order.
+class RpmLogCapture {
+public:
+    struct Record {
+        Logger::Level level;
+        std::string message;
+    };
+
+    RpmLogCapture();
+    ~RpmLogCapture();
+
+    RpmLogCapture(const RpmLogCapture &) = delete;
+    RpmLogCapture & operator=(const RpmLogCapture &) = delete;
+
+    /// Returns the capture of the current thread, or nullptr if its records are not captured.
+    static RpmLogCapture * get_current() noexcept;
+
+    void add_record(Logger::Level level, std::string message) { records.push_back({level, std::move(message)}); }
+
+    /// Returns the captured records and clears them.
+    std::vector<Record> release_records() { return std::exchange(records, {}); }
+
+    /// Logs the `records` to the `logger` in their order.
+    static void log_records(Logger & logger, const std::vector<Record> & records);
+
+private:
+    std::vector<Record> records;
+    RpmLogCapture * previous;
+};
+
 }  // namespace libdnf::rpm
 
 #endif
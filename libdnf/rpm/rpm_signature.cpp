@@ -121,7 +121,11 @@ RpmSignature::CheckResult RpmSignature::check_package_signature(rpm::Package pkg
     rpmtsSetVfyLevel(ts_ptr.get(), RPMSIG_SIGNATURE_TYPE);
     std::string path = pkg.get_package_path();
     char * const path_array[2] = {&path[0], NULL};
+    auto & metrics = *base->get_metrics();
+    libdnf::base::Metrics::Span verify_span(metrics, "rpm.verify_signature", pkg.get_full_nevra());
     auto rc = rpmcliVerifySignatures(ts_ptr.get(), path_array);
+    verify_span.finish();
+    metrics.add_counter("rpm.verified_signatures", 1);
 
     rpmlogSetMask(oldmask);
 
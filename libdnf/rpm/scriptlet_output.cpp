@@ -0,0 +1,295 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "scriptlet_output.hpp"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+
+namespace libdnf::rpm {
+
+namespace {
+
+const std::string DEFAULT_PREFIX = "[scriptlet] ";
+char newline = '\n';
+
+// How often the reading thread checks whether it was asked to stop, in milliseconds.
+constexpr int STOP_CHECK_INTERVAL = 100;
+
+}  // namespace
+
+
+ScriptletOutput::ScriptletOutput(Logger & logger, const std::filesystem::path & log_path)
+    : logger(logger), buffer(new char[BUFFER_SIZE]), prefix(DEFAULT_PREFIX) {
+    if (log_path.empty()) {
+        return;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(log_path.parent_path(), ec);
+    log_fd = open(log_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (log_fd == -1) {
+        logger.warning("Cannot open scriptlet log \"{}\": {}", log_path.native(), std::strerror(errno));
+    }
+}
+
+
+ScriptletOutput::~ScriptletOutput() {
+    if (thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        thread.join();
+    }
+    if (read_fd != -1) {
+        close(read_fd);
+    }
+    if (log_fd != -1) {
+        close(log_fd);
+    }
+}
+
+
+int ScriptletOutput::start() {
+    int pipe_fds[2];
+    if (pipe(pipe_fds) == -1) {
+        logger.error("Transaction::Run: Cannot create pipe: {}", std::strerror(errno));
+        return -1;
+    }
+    // The pipe is also drained by the thread running rpm, see `script_start()`. It must never block there.
+    fcntl(pipe_fds[0], F_SETFL, fcntl(pipe_fds[0], F_GETFL) | O_NONBLOCK);
+    read_fd = pipe_fds[0];
+    thread = std::thread(&ScriptletOutput::reader, this);
+    return pipe_fds[1];
+}
+
+
+void ScriptletOutput::script_start(const std::string & source, OutputHandler handler) {
+    std::lock_guard<std::mutex> handler_lock(handler_mutex);
+    OutputHandler previous_handler;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // the output still waiting in the pipe was written before the scriptlet started
+        read_available();
+        process_lines(true);
+        handler_output.clear();
+        handler_output.swap(pending_output);
+        prefix = "[" + source + "] ";
+        previous_handler = std::exchange(output_handler, std::move(handler));
+    }
+    call_handler(previous_handler);
+}
+
+
+void ScriptletOutput::script_stop() {
+    std::lock_guard<std::mutex> handler_lock(handler_mutex);
+    OutputHandler handler;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        read_available();
+        process_lines(true);
+        handler_output.clear();
+        handler_output.swap(pending_output);
+        prefix = DEFAULT_PREFIX;
+        handler = std::exchange(output_handler, nullptr);
+    }
+    call_handler(handler);
+}
+
+
+void ScriptletOutput::finish() {
+    if (thread.joinable()) {
+        thread.join();
+    }
+    if (read_fd != -1) {
+        close(read_fd);
+        read_fd = -1;
+    }
+}
+
+
+bool ScriptletOutput::read_available() {
+    while (read_fd != -1 && !eof) {
+        auto len = read(read_fd, buffer.get() + buffer_used, BUFFER_SIZE - buffer_used);
+        if (len > 0) {
+            buffer_used += static_cast<std::size_t>(len);
+            process_lines(false);
+        } else if (len == 0) {
+            eof = true;
+            process_lines(true);
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return true;
+        } else if (errno != EINTR) {
+            logger.error("Transaction::Run: Cannot read scriptlet output from pipe: {}", std::strerror(errno));
+            process_lines(true);
+            return false;
+        }
+    }
+    return false;
+}
+
+
+void ScriptletOutput::process_lines(bool flush_partial) {
+    const char * data = buffer.get();
+    std::size_t pos = 0;
+    bool terminated = true;
+    while (pos < buffer_used) {
+        const auto * line_end = static_cast<const char *>(std::memchr(data + pos, '\n', buffer_used - pos));
+        std::size_t end;
+        if (line_end) {
+            end = static_cast<std::size_t>(line_end - data) + 1;
+        } else if (flush_partial || buffer_used == BUFFER_SIZE) {
+            end = buffer_used;
+        } else {
+            break;
+        }
+        std::string_view line(data + pos, end - pos);
+        terminated = line_end != nullptr;
+        if (log_fd == -1) {
+            logger.info("{}{}", prefix, line_end ? line.substr(0, line.size() - 1) : line);
+        } else {
+            iovecs.push_back({prefix.data(), prefix.size()});
+            iovecs.push_back({const_cast<char *>(line.data()), line.size()});
+            if (!line_end) {
+                iovecs.push_back({&newline, 1});
+            }
+        }
+        pos = end;
+    }
+
+    write_log();
+
+    // the processed lines are passed to the handler in one batch, only the last one can be unterminated
+    if (output_handler && pos > 0) {
+        pending_output.append(data, pos);
+        if (!terminated) {
+            pending_output.push_back(newline);
+        }
+    }
+
+    // keep the unterminated tail for the next read
+    buffer_used -= pos;
+    if (buffer_used > 0 && pos > 0) {
+        std::memmove(buffer.get(), data + pos, buffer_used);
+    }
+}
+
+
+void ScriptletOutput::deliver_output() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        handler_output.clear();
+        handler_output.swap(pending_output);
+    }
+    // `output_handler` cannot change meanwhile, it is changed only with `handler_mutex` locked
+    if (!call_handler(output_handler)) {
+        // the pipe must be kept drained, the rest of the output goes only to the log
+        std::lock_guard<std::mutex> lock(mutex);
+        output_handler = nullptr;
+        pending_output.clear();
+    }
+}
+
+
+bool ScriptletOutput::call_handler(const OutputHandler & handler) {
+    if (!handler || handler_output.empty()) {
+        return true;
+    }
+    try {
+        handler(handler_output);
+    } catch (const std::exception & ex) {
+        logger.error("Transaction::Run: Exception in scriptlet output handler: {}", ex.what());
+        return false;
+    }
+    return true;
+}
+
+
+void ScriptletOutput::write_log() {
+    std::size_t first = 0;
+    while (first < iovecs.size()) {
+        auto count = std::min(iovecs.size() - first, static_cast<std::size_t>(IOV_MAX));
+        auto written = writev(log_fd, &iovecs[first], static_cast<int>(count));
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            logger.error("Cannot write scriptlet log, logging scriptlet output: {}", std::strerror(errno));
+            close(log_fd);
+            log_fd = -1;
+            break;
+        }
+        // skip the written fragments, a partially written one is adjusted
+        auto remaining = static_cast<std::size_t>(written);
+        while (remaining > 0) {
+            auto & iov = iovecs[first];
+            if (remaining < iov.iov_len) {
+                iov.iov_base = static_cast<char *>(iov.iov_base) + remaining;
+                iov.iov_len -= remaining;
+                break;
+            }
+            remaining -= iov.iov_len;
+            ++first;
+        }
+    }
+    iovecs.clear();
+}
+
+
+void ScriptletOutput::reader() {
+    try {
+        struct pollfd pfd = {read_fd, POLLIN, 0};
+        while (true) {
+            auto ret = poll(&pfd, 1, STOP_CHECK_INTERVAL);
+            if (ret == -1 && errno != EINTR) {
+                logger.error("Transaction::Run: Cannot poll scriptlet output pipe: {}", std::strerror(errno));
+                break;
+            }
+            bool done;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (stop) {
+                    break;
+                }
+                done = ret > 0 && !read_available();
+            }
+            std::lock_guard<std::mutex> handler_lock(handler_mutex);
+            deliver_output();
+            if (done) {
+                break;
+            }
+        }
+    } catch (const std::exception & ex) {
+        // The thread must not throw exceptions.
+        logger.error("Transaction::Run: Exception while processing scriptlet output: {}", ex.what());
+    }
+}
+
+}  // namespace libdnf::rpm
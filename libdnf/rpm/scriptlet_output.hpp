@@ -0,0 +1,129 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF_RPM_SCRIPTLET_OUTPUT_HPP
+#define LIBDNF_RPM_SCRIPTLET_OUTPUT_HPP
+
+#include "libdnf/logger/logger.hpp"
+
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+
+namespace libdnf::rpm {
+
+/// Captures the output of rpm scriptlets written to a pipe.
+///
+/// A dedicated thread keeps the pipe drained, so chatty scriptlets (and rpm waiting for them) never block
+/// on a full pipe. The data are read into a large buffer and split into lines with `memchr()`. The lines
+/// of one read are appended to the scriptlet log by a single `writev()`. Every line is attributed to
+/// the scriptlet running at the time, see `script_start()`, and the lines of each read are passed to
+/// the output handler of the scriptlet while it runs.
+class ScriptletOutput {
+public:
+    /// Receives a batch of lines written by the running scriptlet. The view is valid only during the call.
+    /// The handler is called from the reading thread or from the thread calling `script_start()` and
+    /// `script_stop()`, the calls are serialized. The pipe is drained and logged meanwhile.
+    using OutputHandler = std::function<void(std::string_view output)>;
+
+    /// Size of the read buffer, also the maximal length of a line. Longer lines are split.
+    static constexpr std::size_t BUFFER_SIZE = 256 * 1024;
+
+    /// @param logger  logger for errors, the output is logged to it if the scriptlet log cannot be used
+    /// @param log_path  path of the scriptlet log the output is appended to, empty to log the output to `logger`
+    ScriptletOutput(Logger & logger, const std::filesystem::path & log_path);
+    ~ScriptletOutput();
+
+    ScriptletOutput(const ScriptletOutput &) = delete;
+    ScriptletOutput & operator=(const ScriptletOutput &) = delete;
+
+    /// Creates the pipe and starts the thread reading it.
+    /// The caller passes the returned write end to rpm and closes it.
+    /// @return The write end of the pipe, -1 if the pipe cannot be created.
+    int start();
+
+    /// Attributes the following output to the scriptlet `source`, e.g. "%post(foo-1.0-1.noarch)".
+    /// Output already written to the pipe still belongs to the previous source.
+    /// @param handler  receives the output of the scriptlet in batches, may be empty
+    void script_start(const std::string & source, OutputHandler handler = {});
+
+    /// Ends the attribution to the scriptlet passed to `script_start()`, the rest of its output is passed
+    /// to the handler before the call returns. Must be called after the scriptlet process finished,
+    /// its whole output is in the pipe then. An unterminated last line is terminated by a newline.
+    void script_stop();
+
+    /// Waits until the reading thread processes the rest of the output and ends.
+    /// All write ends of the pipe have to be closed before, otherwise the call blocks.
+    /// The destructor only stops the thread, the output still in the pipe is lost then.
+    void finish();
+
+private:
+    /// Reads all data available in the pipe. Must be called with `mutex` locked.
+    /// @return `false` if the end of the pipe was reached or the reading failed.
+    bool read_available();
+
+    /// Processes the complete lines in `buffer`, with `flush_partial` the unterminated tail too.
+    /// The lines are logged and collected in `pending_output` for the output handler.
+    void process_lines(bool flush_partial);
+
+    /// Passes `pending_output` to the output handler. Must be called with `handler_mutex` locked
+    /// and `mutex` unlocked, the handler must not hold up the reading of the pipe.
+    void deliver_output();
+
+    /// Passes `handler_output` to `handler`. Must be called with `handler_mutex` locked.
+    /// @return `false` if the handler threw an exception.
+    bool call_handler(const OutputHandler & handler);
+
+    /// Writes the collected `iovecs` to the scriptlet log.
+    void write_log();
+
+    void reader();
+
+    Logger & logger;
+    int log_fd{-1};
+    int read_fd{-1};
+    bool eof{false};
+    bool stop{false};  // set by the destructor to end the reading thread without waiting for the end of the pipe
+    std::unique_ptr<char[]> buffer;
+    std::size_t buffer_used{0};
+    std::string prefix;                // "[<source>] " prepended to every line in the scriptlet log
+    OutputHandler output_handler;      // handler of the output of the currently running scriptlet
+    std::string pending_output;        // output waiting for `output_handler`
+    std::string handler_output;        // output being passed to the handler, guarded by `handler_mutex`
+    std::vector<struct iovec> iovecs;  // batch of line fragments for `writev()`
+    // `mutex` guards the buffer and the state of the reading, `handler_mutex` serializes the calls of the handler.
+    // `handler_mutex` is always locked first. `output_handler` is changed only with both of them locked.
+    std::mutex mutex;
+    std::mutex handler_mutex;
+    std::thread thread;
+};
+
+}  // namespace libdnf::rpm
+
+#endif  // LIBDNF_RPM_SCRIPTLET_OUTPUT_HPP
@@ -19,6 +19,7 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "goal_private.hpp"
 
+#include "rpm/package_sack_impl.hpp"
 #include "solv/pool.hpp"
 #include "utils/bgettext/bgettext-mark-domain.h"
 
@@ -85,19 +86,13 @@ void construct_job(
     //         job->pushBack(SOLVER_VERIFY|SOLVER_SOLVABLE_ALL, 0);
 }
 
-void init_solver(Pool * pool, Solver ** solver) {
-    if (*solver) {
-        solver_free(*solver);
-    }
-
-    *solver = solver_create(pool);
-
+void init_solver(Solver * solver) {
     /* don't erase packages that are no longer in repo during distupgrade */
-    solver_set_flag(*solver, SOLVER_FLAG_KEEP_ORPHANS, 1);
+    solver_set_flag(solver, SOLVER_FLAG_KEEP_ORPHANS, 1);
     /* no arch change for forcebest */
-    solver_set_flag(*solver, SOLVER_FLAG_BEST_OBEY_POLICY, 1);
+    solver_set_flag(solver, SOLVER_FLAG_BEST_OBEY_POLICY, 1);
     /* support package splits via obsoletes */
-    solver_set_flag(*solver, SOLVER_FLAG_YUM_OBSOLETES, 1);
+    solver_set_flag(solver, SOLVER_FLAG_YUM_OBSOLETES, 1);
 
 // TODO Ask Neal whether it is needed. See https://bugs.mageia.org/show_bug.cgi?id=18315
 #if defined(LIBSOLV_FLAG_URPMREORDER)
@@ -350,7 +345,11 @@ libdnf::GoalProblem GoalPrivate::resolve() {
         libsolv_transaction = NULL;
     }
 
-    init_solver(*pool, &libsolv_solver);
+    // The solver of the previous resolve and idle solvers left by other goals are reused while the pool
+    // is unchanged, all flags the result depends on are set below
+    release_solver();
+    libsolv_solver = base->get_rpm_package_sack()->p_impl->acquire_solver();
+    init_solver(libsolv_solver);
 
     // Remove SOLVER_WEAK and add SOLVER_BEST to all transactions to allow report skipped packages and best candidates
     // with broken dependenies
@@ -390,6 +389,18 @@ libdnf::GoalProblem GoalPrivate::resolve() {
     return protected_in_removals();
 }
 
+void GoalPrivate::release_solver() {
+    if (!libsolv_solver) {
+        return;
+    }
+    if (base.is_valid()) {
+        base->get_rpm_package_sack()->p_impl->release_solver(libsolv_solver);
+    } else {
+        solver_free(libsolv_solver);
+    }
+    libsolv_solver = nullptr;
+}
+
 libdnf::solv::IdQueue GoalPrivate::list_installs() {
     return list_results(SOLVER_TRANSACTION_INSTALL, SOLVER_TRANSACTION_OBSOLETES);
 }
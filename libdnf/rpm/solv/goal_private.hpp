@@ -156,6 +156,9 @@ public:
 private:
     bool limit_installonly_packages(libdnf::solv::IdQueue & job, Id running_kernel);
 
+    /// Returns the solver to the PackageSack for reuse by the next resolve.
+    void release_solver();
+
     libdnf::solv::IdQueue list_results(Id type_filter1, Id type_filter2);
 
     BaseWeakPtr base;
@@ -214,9 +217,7 @@ inline GoalPrivate::GoalPrivate(const GoalPrivate & src)
 }
 
 inline GoalPrivate::~GoalPrivate() {
-    if (libsolv_solver) {
-        solver_free(libsolv_solver);
-    }
+    release_solver();
     if (libsolv_transaction) {
         transaction_free(libsolv_transaction);
     }
@@ -224,14 +225,11 @@ inline GoalPrivate::~GoalPrivate() {
 
 inline GoalPrivate & GoalPrivate::operator=(const GoalPrivate & src) {
     if (this != &src) {
+        release_solver();
         base = src.base;
         staging = src.staging;
         installonly = src.installonly;
         installonly_limit = src.installonly_limit;
-        if (libsolv_solver != nullptr) {
-            solver_free(libsolv_solver);
-            libsolv_solver = nullptr;
-        }
         if (libsolv_transaction != nullptr) {
             transaction_free(libsolv_transaction);
             libsolv_transaction = nullptr;
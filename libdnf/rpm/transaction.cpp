@@ -40,6 +40,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <filesystem>
 #include <map>
+#include <string>
+#include <string_view>
 #include <type_traits>
 
 
@@ -101,6 +103,7 @@ Transaction::Transaction(const BaseWeakPtr & base) : base(base), rpm_log_guard(b
 Transaction::Transaction(Base & base) : Transaction(base.get_weak_ptr()) {}
 
 Transaction::~Transaction() {
+    header_preloader.reset();
     rpmtsFree(ts);
     if (script_fd) {
         Fclose(script_fd);
@@ -138,7 +141,32 @@ std::string Transaction::get_db_cookie() const {
     return rpmdb_cookie;
 }
 
+void Transaction::preload_headers(const base::Transaction & transaction) {
+    std::vector<std::string> paths;
+    for (const auto & tspkg : transaction.get_transaction_packages()) {
+        switch (tspkg.get_action()) {
+            case libdnf::transaction::TransactionItemAction::INSTALL:
+            case libdnf::transaction::TransactionItemAction::UPGRADE:
+            case libdnf::transaction::TransactionItemAction::DOWNGRADE:
+            case libdnf::transaction::TransactionItemAction::REINSTALL:
+                paths.push_back(tspkg.get_package().get_package_path());
+                break;
+            case libdnf::transaction::TransactionItemAction::REMOVE:
+            case libdnf::transaction::TransactionItemAction::REPLACED:
+            case libdnf::transaction::TransactionItemAction::REASON_CHANGE:
+                break;
+        }
+    }
+    if (!header_preloader) {
+        header_preloader = std::make_unique<HeaderPreloader>(base, ts);
+    }
+    header_preloader->start(paths);
+}
+
 void Transaction::fill(const base::Transaction & transaction) {
+    // no-op for the headers already scheduled by an earlier call
+    preload_headers(transaction);
+
     transaction_items = transaction.get_transaction_packages();
     for (auto & tspkg : transaction_items) {
         switch (tspkg.get_action()) {
@@ -226,32 +254,10 @@ BaseWeakPtr Transaction::get_base() const {
 }
 
 Header Transaction::read_pkg_header(const std::string & file_path) const {
-    FD_t fd = Fopen(file_path.c_str(), "r.ufdio");
-
-    if (!fd) {
-        throw TransactionError(
-            M_("Failed to read package header, cannot open file \"{}\": {}"), file_path, std::string(Fstrerror(fd)));
+    if (header_preloader) {
+        return header_preloader->take(file_path);
     }
-
-    const char * descr = file_path.c_str();
-    Header h{};  // Initialization of h is not needed. It is output argument of rpmReadPackageFile().
-    rpmRC rpmrc = rpmReadPackageFile(ts, fd, descr, &h);
-    Fclose(fd);
-
-    switch (rpmrc) {
-        case RPMRC_NOTTRUSTED:
-        case RPMRC_NOKEY:
-        case RPMRC_OK:
-            break;
-        case RPMRC_NOTFOUND:
-        case RPMRC_FAIL:
-        default:
-            h = headerFree(h);
-            throw TransactionError(M_("Failed to read package header from file \"{}\""), file_path);
-            break;
-    }
-
-    return h;
+    return read_package_header(ts, file_path);
 }
 
 Header Transaction::get_header(unsigned int rec_offset) {
@@ -597,9 +603,23 @@ void * Transaction::ts_callback(
                 "RPM callback start {} scriptlet \"{}\"",
                 TransactionCallbacks::script_type_to_string(script_type),
                 to_full_nevra_string(nevra));
+            auto script_name = fmt::format(
+                "{} {}", TransactionCallbacks::script_type_to_string(script_type), to_full_nevra_string(nevra));
+            transaction.script_span = std::make_unique<base::Metrics::Span>(
+                *transaction.base->get_metrics(), "transaction.scriptlet", script_name);
             if (callbacks) {
                 callbacks->script_start(item, nevra, script_type);
             }
+            if (transaction.scriptlet_output) {
+                ScriptletOutput::OutputHandler handler;
+                if (callbacks) {
+                    // the output is streamed while the scriptlet runs, rpm waits for the scriptlet meanwhile
+                    handler = [callbacks, item, nevra, script_type](std::string_view output) {
+                        callbacks->script_output(item, nevra, script_type, output);
+                    };
+                }
+                transaction.scriptlet_output->script_start(script_name, std::move(handler));
+            }
             break;
         }
         case RPMCALLBACK_SCRIPT_STOP: {
@@ -612,6 +632,10 @@ void * Transaction::ts_callback(
                 TransactionCallbacks::script_type_to_string(script_type),
                 to_full_nevra_string(nevra),
                 total);
+            transaction.script_span.reset();
+            if (transaction.scriptlet_output) {
+                transaction.scriptlet_output->script_stop();
+            }
             if (callbacks) {
                 callbacks->script_stop(item, nevra, script_type, total);
             }
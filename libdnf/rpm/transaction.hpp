@@ -21,9 +21,12 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef LIBDNF_RPM_TRANSACTION_HPP
 #define LIBDNF_RPM_TRANSACTION_HPP
 
+#include "header_preloader.hpp"
 #include "rpm_log_guard.hpp"
+#include "scriptlet_output.hpp"
 
 #include "libdnf/base/base_weak.hpp"
+#include "libdnf/base/metrics.hpp"
 #include "libdnf/base/transaction_package.hpp"
 #include "libdnf/common/exception.hpp"
 #include "libdnf/rpm/package.hpp"
@@ -275,7 +278,13 @@ public:
         callbacks_holder.callbacks = std::move(callbacks);
     }
 
+    /// Start reading headers of the package files to be installed by `transaction` in the background.
+    /// Calling it before `fill()` overlaps the reading with other work (e.g. waiting for a lock).
+    /// @param transcation The base::Transaction object.
+    void preload_headers(const base::Transaction & transaction);
+
     /// Fill the RPM transaction from base::Transaction.
+    /// Headers of the package files are read in parallel, the elements are added in the order of the packages.
     /// @param transcation The base::Transaction object.
     void fill(const base::Transaction & transaction);
 
@@ -313,6 +322,11 @@ public:
     /// @param file_path  new file path
     void set_script_out_file(const std::string & file_path);
 
+    /// Set the capture of the scriptlet output, the output is attributed to the running scriptlets
+    /// and passed to `TransactionCallbacks::script_output()`.
+    /// @param output  capture reading the pipe whose write end is set by `set_script_out_fd()`, or nullptr
+    void set_scriptlet_output(ScriptletOutput * output) { scriptlet_output = output; }
+
     /// @return A `Base` object to which the transaction belongs.
     /// @since 5.0
     BaseWeakPtr get_base() const;
@@ -328,6 +342,8 @@ private:
     FD_t script_fd{nullptr};
     CallbacksHolder callbacks_holder{nullptr, this};
     FD_t fd_in_cb{nullptr};  // file descriptor used by transaction in callback (install/reinstall package)
+    std::unique_ptr<base::Metrics::Span> script_span;  // measures the currently running scriptlet
+    ScriptletOutput * scriptlet_output{nullptr};
 
     TransactionItem * last_added_item{nullptr};  // item added by last install/reinstall/erase/...
     bool last_item_added_ts_element{false};      // Did the last item add the element ts?
@@ -335,6 +351,7 @@ private:
     std::map<unsigned int, rpmte> implicit_ts_elements;  // elements added to the librpm transaction by librpm itself
     bool downgrade_requested{false};
     std::vector<TransactionItem> transaction_items;
+    std::unique_ptr<HeaderPreloader> header_preloader;
 
     RpmLogGuard rpm_log_guard;
 
@@ -0,0 +1,144 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF_SOLV_PARALLEL_FILTER_HPP
+#define LIBDNF_SOLV_PARALLEL_FILTER_HPP
+
+#include "solv_map.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+
+namespace libdnf::solv {
+
+/// Minimal number of candidates checked by one thread of `filter_parallel()`.
+/// Smaller partitions do not pay for starting the thread.
+constexpr std::size_t PARALLEL_FILTER_MIN_CANDIDATES = 2048;
+
+/// Partition boundaries are aligned to whole 64-bit words of the map (64 ids).
+constexpr std::size_t PARALLEL_FILTER_ALIGNMENT_BYTES = 8;
+
+
+/// @return The number of threads for `threads_option`, 0 means the number of available CPUs.
+inline unsigned int get_filter_threads(unsigned int threads_option) noexcept {
+    if (threads_option == 0) {
+        return std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    return threads_option;
+}
+
+
+/// Adds to `filter_result` the ids from `candidates` for which `predicate(id)` returns `true`.
+///
+/// With `max_threads` > 1 and enough candidates, the candidate map is split into partitions with
+/// about the same number of candidates. Every partition is filtered by its own thread with its own
+/// copy of `predicate` into its own result map, the result maps are merged by bitwise OR. The result
+/// is the same as from the single-threaded run. The predicate must be safe to call concurrently,
+/// state needed by the predicate (e.g. buffers) can be kept in a `mutable` lambda capture.
+/// An exception thrown by the predicate is rethrown after all the threads finish.
+template <typename Predicate>
+void filter_parallel(
+    const SolvMap & candidates, SolvMap & filter_result, unsigned int max_threads, const Predicate & predicate) {
+    std::size_t nthreads = 1;
+    std::size_t ncandidates = 0;
+    if (max_threads > 1) {
+        ncandidates = candidates.size();
+        nthreads = std::min(static_cast<std::size_t>(max_threads), ncandidates / PARALLEL_FILTER_MIN_CANDIDATES);
+    }
+
+    if (nthreads <= 1) {
+        auto thread_predicate = predicate;
+        for (Id candidate_id : candidates) {
+            if (thread_predicate(candidate_id)) {
+                filter_result.add_unsafe(candidate_id);
+            }
+        }
+        return;
+    }
+
+    // Find partition boundaries (in bytes of the map) with about the same number of candidates
+    const Map & map = candidates.get_map();
+    const auto map_size = static_cast<std::size_t>(map.size);
+    std::vector<std::size_t> boundaries{0};
+    std::size_t counted = 0;
+    for (std::size_t byte = 0; byte < map_size && boundaries.size() < nthreads; ++byte) {
+        counted += BIT_COUNT_LOOKUP[map.map[byte]];
+        if ((byte + 1) % PARALLEL_FILTER_ALIGNMENT_BYTES == 0 &&
+            counted >= ncandidates * boundaries.size() / nthreads) {
+            boundaries.push_back(byte + 1);
+        }
+    }
+    boundaries.push_back(map_size);
+
+    const auto npartitions = boundaries.size() - 1;
+    std::vector<SolvMap> partition_results(npartitions, SolvMap(filter_result.allocated_size()));
+    std::vector<std::exception_ptr> errors(npartitions);
+
+    auto filter_partition = [&](std::size_t partition) {
+        try {
+            auto thread_predicate = predicate;
+            auto & result = partition_results[partition];
+            const auto end_id = static_cast<Id>(boundaries[partition + 1] << 3);
+            auto it = candidates.begin();
+            it.jump(static_cast<Id>(boundaries[partition] << 3));
+            for (const auto end = candidates.end(); it != end && *it < end_id; ++it) {
+                if (thread_predicate(*it)) {
+                    result.add_unsafe(*it);
+                }
+            }
+        } catch (...) {
+            // The thread must not throw exceptions. Pass them to the caller.
+            errors[partition] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(npartitions - 1);
+    std::size_t next_partition = 1;
+    try {
+        for (; next_partition < npartitions; ++next_partition) {
+            threads.emplace_back(filter_partition, next_partition);
+        }
+    } catch (const std::system_error &) {
+        // Out of threads, the remaining partitions are filtered by the calling thread
+    }
+    filter_partition(0);
+    for (; next_partition < npartitions; ++next_partition) {
+        filter_partition(next_partition);
+    }
+    for (auto & thread : threads) {
+        thread.join();
+    }
+
+    for (std::size_t partition = 0; partition < npartitions; ++partition) {
+        if (errors[partition]) {
+            std::rethrow_exception(errors[partition]);
+        }
+        filter_result |= partition_results[partition];
+    }
+}
+
+}  // namespace libdnf::solv
+
+#endif  // LIBDNF_SOLV_PARALLEL_FILTER_HPP
@@ -74,6 +74,28 @@ TempEvr::~TempEvr() {
 }
 
 
+EvrView::EvrView(std::string_view evr) {
+    // the first character is never a separator, see TempEvr
+    const auto sep = evr.empty() ? std::string_view::npos : evr.find_first_of(":-", 1);
+    if (sep == std::string_view::npos) {
+        v = evr;
+    } else if (evr[sep] == '-') {
+        v = evr.substr(0, sep);
+        r = evr.substr(sep + 1);
+    } else {  // evr[sep] == ':'
+        e = evr.substr(0, sep);
+        const auto vr = evr.substr(sep + 1);
+        const auto dash = vr.empty() ? std::string_view::npos : vr.find('-', 1);
+        if (dash == std::string_view::npos) {
+            v = vr;
+        } else {
+            v = vr.substr(0, dash);
+            r = vr.substr(dash + 1);
+        }
+    }
+}
+
+
 Pool::~Pool() {
     pool_free(pool);
 }
@@ -116,6 +138,33 @@ unsigned long Pool::get_epoch_num(Id id) const {
 
 
 std::string Pool::get_full_nevra(Id id) const {
+    std::string res;
+    append_full_nevra(id, res);
+    return res;
+}
+
+
+void Pool::append_nevra(Id id, std::string & buffer) const {
+    Solvable * solvable = id2solvable(id);
+    const std::string_view name = id2str(solvable->name);
+    // the same as pool_solvable2str()
+    const std::string_view evr = solvable->evr ? id2str(solvable->evr) : "";
+    const std::string_view arch = solvable->arch ? id2str(solvable->arch) : "";
+
+    buffer.reserve(buffer.size() + name.size() + evr.size() + arch.size() + 2);
+    buffer.append(name);
+    if (!evr.empty()) {
+        buffer.append(1, '-');
+        buffer.append(evr);
+    }
+    if (!arch.empty()) {
+        buffer.append(1, '.');
+        buffer.append(arch);
+    }
+}
+
+
+void Pool::append_full_nevra(Id id, std::string & buffer) const {
     Solvable * solvable = id2solvable(id);
     const char * name = id2str(solvable->name);
     const char * evr = id2str(solvable->evr);
@@ -131,28 +180,25 @@ std::string Pool::get_full_nevra(Id id) const {
         }
     }
 
-    std::string res;
     // potentially wasting up to 4 bytes (2 for the zero epoch and 2 for a '-' and a '.')
-    res.reserve(strlen(name) + strlen(evr) + strlen(arch) + 4);
+    buffer.reserve(buffer.size() + strlen(name) + strlen(evr) + strlen(arch) + 4);
 
-    res.append(name);
+    buffer.append(name);
 
     if (*evr != '\0') {
-        res.append("-");
+        buffer.append("-");
 
         if (add_zero_epoch) {
-            res.append("0:");
+            buffer.append("0:");
         }
 
-        res.append(evr);
+        buffer.append(evr);
     }
 
     if (*arch != '\0') {
-        res.append(".");
-        res.append(arch);
+        buffer.append(".");
+        buffer.append(arch);
     }
-
-    return res;
 }
 
 
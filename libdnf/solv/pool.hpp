@@ -27,6 +27,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <climits>
 #include <memory>
+#include <string>
+#include <string_view>
 
 extern "C" {
 #include <solv/dataiterator.h>
@@ -75,6 +77,17 @@ private:
 };
 
 
+/// Views of the epoch, version and release of an evr. The evr is split the same way as by TempEvr,
+/// but the parts are not copied. A missing epoch or release is an empty view.
+struct EvrView {
+    std::string_view e;
+    std::string_view v;
+    std::string_view r;
+
+    explicit EvrView(std::string_view evr);
+};
+
+
 class Pool {
 public:
     Pool() : considered(0) { pool = pool_create(); }
@@ -122,6 +135,13 @@ public:
         return pool_lookup_str(pool, id, keyname);
     }
 
+    /// Looks up the translation of `keyname` in the pool languages, the untranslated string if there is none.
+    const char * lookup_translated_str(Id id, Id keyname) const {
+        Solvable * solvable = id2solvable(id);
+        libdnf::solv::get_repo(solvable).internalize();
+        return solvable_lookup_str_poollang(solvable, keyname);
+    }
+
     unsigned long long lookup_num(Id id, Id keyname) const {
         if (id > 0) {
             libdnf::solv::get_repo(id2solvable(id)).internalize();
@@ -173,6 +193,12 @@ public:
 
     std::string get_full_nevra(Id id) const;
 
+    /// Appends NEVRA of the solvable `id` (the same as `get_nevra()`) to `buffer`.
+    void append_nevra(Id id, std::string & buffer) const;
+
+    /// Appends NEVRA of the solvable `id` with the epoch always present (the same as `get_full_nevra()`) to `buffer`.
+    void append_full_nevra(Id id, std::string & buffer) const;
+
     bool is_installed(Solvable * solvable) const { return solvable->repo == pool->installed; }
 
     bool is_installed(Id id) const { return is_installed(id2solvable(id)); }
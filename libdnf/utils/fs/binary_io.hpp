@@ -0,0 +1,98 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIBDNF_UTILS_FS_BINARY_IO_HPP
+#define LIBDNF_UTILS_FS_BINARY_IO_HPP
+
+#include "file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+/// Reading and writing of the binary cache files (indexes, cached transactions). The values are stored
+/// in the native byte order, the files are not portable between architectures.
+/// The read functions return `false` if the file ends before the value is complete.
+namespace libdnf::utils::fs {
+
+inline void write_u32(File & file, uint32_t value) {
+    file.write(&value, sizeof(value));
+}
+
+
+inline void write_u64(File & file, uint64_t value) {
+    file.write(&value, sizeof(value));
+}
+
+
+/// Writes the size of the `value` followed by its characters.
+inline void write_string(File & file, const std::string & value) {
+    write_u64(file, value.size());
+    file.write(value);
+}
+
+
+/// Writes the items of the `vec` without its size.
+template <typename T>
+void write_vector(File & file, const std::vector<T> & vec) {
+    if (!vec.empty()) {
+        file.write(vec.data(), vec.size() * sizeof(T));
+    }
+}
+
+
+inline bool read_exact(File & file, void * buffer, std::size_t count) {
+    return count == 0 || file.read(buffer, count) == count;
+}
+
+
+inline bool read_u32(File & file, uint32_t & value) {
+    return read_exact(file, &value, sizeof(value));
+}
+
+
+inline bool read_u64(File & file, uint64_t & value) {
+    return read_exact(file, &value, sizeof(value));
+}
+
+
+/// Reads a string written by `write_string()`. Fails on a size over the `file_size` to guard against
+/// allocating nonsense sizes from a damaged file.
+inline bool read_string(File & file, std::string & value, uint64_t file_size) {
+    uint64_t size;
+    if (!read_u64(file, size) || size > file_size) {
+        return false;
+    }
+    value.resize(size);
+    return read_exact(file, value.data(), size);
+}
+
+
+/// Reads `count` items written by `write_vector()` into the `vec`.
+template <typename T>
+bool read_vector(File & file, std::vector<T> & vec, std::size_t count) {
+    vec.resize(count);
+    return read_exact(file, vec.data(), count * sizeof(T));
+}
+
+}  // namespace libdnf::utils::fs
+
+#endif  // LIBDNF_UTILS_FS_BINARY_IO_HPP
@@ -24,24 +24,27 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libdnf/common/exception.hpp"
 
+#include <errno.h>
 #include <fcntl.h>
 #include <string.h>
 #include <unistd.h>
 
 namespace libdnf::utils {
 
-bool Locker::read_lock() {
-    return lock(F_RDLCK);
+bool Locker::read_lock(bool wait) {
+    return lock(F_RDLCK, wait);
 }
 
-bool Locker::write_lock() {
-    return lock(F_WRLCK);
+bool Locker::write_lock(bool wait) {
+    return lock(F_WRLCK, wait);
 }
 
-bool Locker::lock(short int type) {
-    lock_fd = open(path.c_str(), O_CREAT | O_RDWR, 0660);
+bool Locker::lock(short int type, bool wait) {
     if (lock_fd == -1) {
-        throw SystemError(errno, M_("Failed to open lock file \"{}\""), path);
+        lock_fd = open(path.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0660);
+        if (lock_fd == -1) {
+            throw SystemError(errno, M_("Failed to open lock file \"{}\""), path);
+        }
     }
 
     struct flock fl;
@@ -51,7 +54,10 @@ bool Locker::lock(short int type) {
     fl.l_start = 0;
     fl.l_len = 0;
     fl.l_pid = 0;
-    auto rc = fcntl(lock_fd, F_SETLK, &fl);
+    int rc;
+    do {
+        rc = fcntl(lock_fd, wait ? F_SETLKW : F_SETLK, &fl);
+    } while (rc == -1 && wait && errno == EINTR);
     if (rc == -1) {
         if (errno == EACCES || errno == EAGAIN) {
             return false;
@@ -65,10 +71,12 @@ bool Locker::lock(short int type) {
 
 void Locker::unlock() {
     if (lock_fd != -1) {
-        if (close(lock_fd) == -1) {
+        auto fd = lock_fd;
+        lock_fd = -1;
+        if (close(fd) == -1) {
             throw SystemError(errno, M_("Failed to close lock file \"{}\""), path);
         }
-        if (unlink(path.c_str()) == -1) {
+        if (remove_on_unlock && unlink(path.c_str()) == -1) {
             throw SystemError(errno, M_("Failed to delete lock file \"{}\""), path);
         }
     }
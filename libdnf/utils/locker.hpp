@@ -24,18 +24,35 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 namespace libdnf::utils {
 
+/// Advisory lock of a file shared between processes (fcntl() record lock of the whole file).
+/// The lock does not exclude threads of one process.
 class Locker {
 public:
-    explicit Locker(const std::string & path) : path(path){};
+    /// @param path  path to the lock file, created if it does not exist
+    /// @param remove_on_unlock  whether the lock file is removed by `unlock()`, it has to be kept if other
+    ///                          processes can wait for the lock
+    explicit Locker(const std::string & path, bool remove_on_unlock = true)
+        : path(path),
+          remove_on_unlock(remove_on_unlock){};
     ~Locker();
-    bool read_lock();
-    bool write_lock();
+
+    /// Acquires a shared lock, converts an already held lock.
+    /// @param wait  whether to wait until the lock is available
+    /// @return `true` if the lock was acquired, `false` if it is held by another process and `wait` is false
+    bool read_lock(bool wait = false);
+
+    /// Acquires an exclusive lock, converts an already held lock.
+    /// @param wait  whether to wait until the lock is available
+    /// @return `true` if the lock was acquired, `false` if it is held by another process and `wait` is false
+    bool write_lock(bool wait = false);
+
     void unlock();
 
 private:
-    bool lock(short int type);
+    bool lock(short int type, bool wait);
 
     std::string path;
+    bool remove_on_unlock;
     int lock_fd{-1};
 };
 
@@ -0,0 +1,512 @@
+#!/usr/bin/python3
+
+"""
+Generates a synthetic rpm-md repository for performance testing.
+
+The repository contains primary, filelists, other, updateinfo, comps and modules
+metadata for the requested number of packages. The dependency graph resembles
+a distribution: a small core of widely used libraries, a larger set of libraries
+depending on the core and applications on top of them. All dependencies are
+satisfiable within the repository.
+
+The output is fully determined by the number of packages and the seed, so
+results measured on the generated data can be compared across runs and machines.
+No network access and no rpm tooling is needed.
+
+Optionally a snapshot of an installed system is written in the libsolv testcase
+format (system.repo), it can be loaded into the system repository instead of
+the rpmdb. A part of the installed packages are older versions of the
+available ones so that the upgrade of the system is not empty.
+
+A manifest.json with the parameters and names of packages suitable for
+benchmarked operations is written next to the repodata.
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import random
+import xml.sax.saxutils
+
+
+TIMESTAMP = 1597222003
+
+WORDS = [
+    "acl", "archive", "audio", "auth", "bind", "boost", "cairo", "cloud", "codec", "compress", "core", "crypt",
+    "curl", "data", "db", "dbus", "desktop", "devel", "doc", "editor", "event", "font", "fs", "gfx", "glib", "gtk",
+    "http", "i18n", "icon", "image", "input", "ipc", "json", "kernel", "lang", "ldap", "locale", "log", "lua",
+    "mail", "math", "media", "mesa", "net", "nss", "office", "perl", "plugin", "print", "proxy", "python3", "qt",
+    "rpc", "ruby", "sasl", "sched", "sdl", "security", "server", "shell", "sound", "sql", "ssh", "ssl", "storage",
+    "sys", "tcl", "term", "text", "theme", "tools", "udev", "unicode", "usb", "utils", "video", "vim", "web", "xml",
+    "yaml", "zlib",
+]
+
+LICENSES = ["MIT", "GPL-2.0-or-later", "LGPL-2.1-or-later", "BSD-3-Clause", "Apache-2.0"]
+
+CORE_FRACTION = 0.02
+LIB_FRACTION = 0.30
+ARCHES = ["x86_64"] * 4 + ["noarch"]
+
+
+def escape(text):
+    return xml.sax.saxutils.escape(text, {'"': "&quot;"})
+
+
+class Package:
+    def __init__(self, index, name, arch, version, release, kind):
+        self.index = index
+        self.name = name
+        self.arch = arch
+        self.version = version
+        self.release = release
+        self.kind = kind  # "core", "lib" or "app"
+        self.provides = []
+        self.requires = []
+        self.recommends = []
+        self.obsoletes = []
+        self.conflicts = []
+        self.files = []
+        self.dep_indexes = []
+        self.pkgid = None
+
+    @property
+    def soname(self):
+        return "{}.so.{}()(64bit)".format(self.name, self.version.split(".")[0])
+
+    def nevra(self, release=None):
+        return "{}-0:{}-{}.{}".format(self.name, self.version, release or self.release, self.arch)
+
+
+class Generator:
+    def __init__(self, count, seed):
+        self.count = count
+        self.rng = random.Random(seed)
+        self.seed = seed
+        self.packages = []
+        self.old_packages = []
+        self.modules = []
+
+    def pick_lower(self, upper, limit):
+        # Preferential attachment to the low indexes (core libraries are used the most).
+        return min(int(upper * self.rng.random() ** 3), limit - 1)
+
+    def generate_packages(self):
+        core_count = max(1, int(self.count * CORE_FRACTION))
+        lib_count = max(1, int(self.count * LIB_FRACTION))
+        for idx in range(self.count):
+            if idx < core_count:
+                kind = "core"
+            elif idx < core_count + lib_count:
+                kind = "lib"
+            else:
+                kind = "app"
+            words = self.rng.sample(WORDS, 2)
+            name = "{}-{}{}".format(words[0], words[1], idx)
+            if kind != "app":
+                name = "lib" + name
+            arch = "x86_64" if kind != "app" else self.rng.choice(ARCHES)
+            version = "{}.{}.{}".format(self.rng.randint(0, 9), self.rng.randint(0, 30), self.rng.randint(0, 99))
+            release = "{}.fc38".format(self.rng.randint(2, 9))
+            self.packages.append(Package(idx, name, arch, version, release, kind))
+
+        for pkg in self.packages:
+            self.generate_package_content(pkg, core_count, core_count + lib_count)
+
+        # Every 10th package has also its previous build in the repository
+        for pkg in self.packages[::10]:
+            old = Package(pkg.index, pkg.name, pkg.arch, pkg.version, self.previous_release(pkg.release), pkg.kind)
+            old.provides = pkg.provides
+            old.requires = pkg.requires
+            old.recommends = pkg.recommends
+            old.files = pkg.files
+            self.old_packages.append(old)
+
+        for pkg in self.packages + self.old_packages:
+            pkg.pkgid = hashlib.sha256("{}:{}".format(self.seed, pkg.nevra()).encode()).hexdigest()
+
+    @staticmethod
+    def previous_release(release):
+        number, dist = release.split(".", 1)
+        return "{}.{}".format(int(number) - 1, dist)
+
+    def generate_package_content(self, pkg, core_end, lib_end):
+        rng = self.rng
+        pkg.provides.append("{} = {}-{}".format(pkg.name, pkg.version, pkg.release))
+        if pkg.kind != "app":
+            pkg.provides.append(pkg.soname)
+            pkg.files.append("/usr/lib64/{}.so.{}".format(pkg.name, pkg.version))
+        else:
+            pkg.files.append("/usr/bin/{}".format(pkg.name))
+
+        if pkg.index > 0:
+            # libraries the package links to
+            limit = core_end if pkg.kind == "core" else lib_end
+            ndeps = {"core": rng.randint(0, 2), "lib": rng.randint(1, 4), "app": rng.randint(2, 8)}[pkg.kind]
+            for _ in range(ndeps):
+                dep = self.packages[self.pick_lower(min(pkg.index, limit), pkg.index)]
+                if dep.index in pkg.dep_indexes:
+                    continue
+                pkg.dep_indexes.append(dep.index)
+                if dep.kind != "app":
+                    pkg.requires.append(dep.soname)
+                else:
+                    pkg.requires.append("{} >= {}".format(dep.name, dep.version))
+
+            # file and versioned dependencies on the applications
+            if pkg.kind == "app" and pkg.index > lib_end and rng.random() < 0.2:
+                dep = self.packages[rng.randint(lib_end, pkg.index - 1)]
+                if dep.index not in pkg.dep_indexes:
+                    pkg.dep_indexes.append(dep.index)
+                    pkg.requires.append(dep.files[0])
+
+            if rng.random() < 0.3:
+                dep = self.packages[rng.randint(0, pkg.index - 1)]
+                pkg.recommends.append(dep.name)
+
+        if rng.random() < 0.01:
+            pkg.obsoletes.append("{}-compat < {}".format(pkg.name, pkg.version))
+        if rng.random() < 0.005:
+            pkg.conflicts.append("{}-legacy".format(pkg.name))
+
+        for _ in range(rng.randint(1, 20)):
+            pkg.files.append("/usr/share/{}/{}.dat".format(pkg.name, rng.choice(WORDS)))
+        pkg.files.append("/usr/share/doc/{}/README".format(pkg.name))
+        pkg.files.append("/usr/share/licenses/{}/LICENSE".format(pkg.name))
+        pkg.files = sorted(set(pkg.files))
+
+    def generate_modules(self):
+        count = max(1, self.count // 2000)
+        for idx in range(count):
+            name = "module{}".format(idx)
+            streams = []
+            for stream_idx, stream in enumerate(["1", "2"]):
+                artifacts = []
+                for pkg_idx in range(3):
+                    pkg = Package(
+                        -1,
+                        "{}-pkg{}".format(name, pkg_idx),
+                        "x86_64",
+                        "{}.{}".format(stream, pkg_idx),
+                        "1.module_f38+{}{}".format(idx, stream_idx),
+                        "app")
+                    pkg.provides.append("{} = {}-{}".format(pkg.name, pkg.version, pkg.release))
+                    pkg.requires.append(self.packages[self.rng.randint(0, len(self.packages) - 1)].name)
+                    pkg.files.append("/usr/bin/{}".format(pkg.name))
+                    pkg.pkgid = hashlib.sha256("{}:{}".format(self.seed, pkg.nevra()).encode()).hexdigest()
+                    artifacts.append(pkg)
+                streams.append((stream, artifacts))
+            self.modules.append((name, streams))
+
+    def all_packages(self):
+        yield from self.packages
+        yield from self.old_packages
+        for _, streams in self.modules:
+            for _, artifacts in streams:
+                yield from artifacts
+
+    def write_primary(self, path):
+        packages = list(self.all_packages())
+        with open(path, "w") as out:
+            out.write('<?xml version="1.0" encoding="UTF-8"?>\n')
+            out.write('<metadata xmlns="http://linux.duke.edu/metadata/common" '
+                      'xmlns:rpm="http://linux.duke.edu/metadata/rpm" packages="{}">\n'.format(len(packages)))
+            for pkg in packages:
+                size = 1000 + len(pkg.files) * 4096
+                out.write('<package type="rpm">\n')
+                out.write('  <name>{}</name>\n'.format(pkg.name))
+                out.write('  <arch>{}</arch>\n'.format(pkg.arch))
+                out.write('  <version epoch="0" ver="{}" rel="{}"/>\n'.format(pkg.version, pkg.release))
+                out.write('  <checksum type="sha256" pkgid="YES">{}</checksum>\n'.format(pkg.pkgid))
+                out.write('  <summary>{} {} component</summary>\n'.format(
+                    pkg.name.split("-")[0].capitalize(), pkg.kind))
+                out.write('  <description>The {} package provides the {} {}.</description>\n'.format(
+                    pkg.name, "library" if pkg.kind != "app" else "application", pkg.name))
+                out.write('  <packager>Synthetic Packager</packager>\n')
+                out.write('  <url>https://example.com/{}/</url>\n'.format(pkg.name))
+                out.write('  <time file="{0}" build="{0}"/>\n'.format(TIMESTAMP))
+                out.write('  <size package="{}" installed="{}" archive="{}"/>\n'.format(size, size * 3, size * 3))
+                out.write('  <location href="Packages/{}-{}-{}.{}.rpm"/>\n'.format(
+                    pkg.name, pkg.version, pkg.release, pkg.arch))
+                out.write('  <format>\n')
+                out.write('    <rpm:license>{}</rpm:license>\n'.format(LICENSES[len(pkg.name) % len(LICENSES)]))
+                out.write('    <rpm:vendor>Synthetic</rpm:vendor>\n')
+                out.write('    <rpm:group>Unspecified</rpm:group>\n')
+                out.write('    <rpm:buildhost>localhost</rpm:buildhost>\n')
+                out.write('    <rpm:sourcerpm>{}-{}-{}.src.rpm</rpm:sourcerpm>\n'.format(
+                    pkg.name, pkg.version, pkg.release))
+                out.write('    <rpm:header-range start="4504" end="{}"/>\n'.format(4504 + size // 10))
+                self.write_deps(out, "provides", pkg.provides)
+                self.write_deps(out, "requires", pkg.requires)
+                self.write_deps(out, "obsoletes", pkg.obsoletes)
+                self.write_deps(out, "conflicts", pkg.conflicts)
+                self.write_deps(out, "recommends", pkg.recommends)
+                # only the files commonly used in dependencies are in primary
+                for file in pkg.files:
+                    if file.startswith("/usr/bin/"):
+                        out.write('    <file>{}</file>\n'.format(escape(file)))
+                out.write('  </format>\n')
+                out.write('</package>\n')
+            out.write('</metadata>\n')
+
+    @staticmethod
+    def write_deps(out, tag, deps):
+        if not deps:
+            return
+        flags = {">=": "GE", "=": "EQ", "<": "LT"}
+        out.write('    <rpm:{}>\n'.format(tag))
+        for dep in deps:
+            parts = dep.split()
+            if len(parts) == 1:
+                out.write('      <rpm:entry name="{}"/>\n'.format(escape(parts[0])))
+                continue
+            name, op, evr = parts
+            ver, _, rel = evr.partition("-")
+            entry = '      <rpm:entry name="{}" flags="{}" epoch="0" ver="{}"'.format(escape(name), flags[op], ver)
+            if rel:
+                entry += ' rel="{}"'.format(rel)
+            out.write(entry + '/>\n')
+        out.write('    </rpm:{}>\n'.format(tag))
+
+    def write_filelists(self, path):
+        packages = list(self.all_packages())
+        with open(path, "w") as out:
+            out.write('<?xml version="1.0" encoding="UTF-8"?>\n')
+            out.write('<filelists xmlns="http://linux.duke.edu/metadata/filelists" packages="{}">\n'.format(
+                len(packages)))
+            for pkg in packages:
+                out.write('<package pkgid="{}" name="{}" arch="{}">\n'.format(pkg.pkgid, pkg.name, pkg.arch))
+                out.write('  <version epoch="0" ver="{}" rel="{}"/>\n'.format(pkg.version, pkg.release))
+                for file in pkg.files:
+                    out.write('  <file>{}</file>\n'.format(escape(file)))
+                out.write('</package>\n')
+            out.write('</filelists>\n')
+
+    def write_other(self, path):
+        packages = list(self.all_packages())
+        with open(path, "w") as out:
+            out.write('<?xml version="1.0" encoding="UTF-8"?>\n')
+            out.write('<otherdata xmlns="http://linux.duke.edu/metadata/other" packages="{}">\n'.format(
+                len(packages)))
+            for pkg in packages:
+                out.write('<package pkgid="{}" name="{}" arch="{}">\n'.format(pkg.pkgid, pkg.name, pkg.arch))
+                out.write('  <version epoch="0" ver="{}" rel="{}"/>\n'.format(pkg.version, pkg.release))
+                for idx in range(1 + len(pkg.name) % 5):
+                    out.write(
+                        '  <changelog author="Synthetic Packager &lt;packager@example.com&gt; - {}-{}" date="{}">'
+                        '- Change number {} of {}</changelog>\n'.format(
+                            pkg.version, pkg.release, TIMESTAMP - idx * 86400, idx, pkg.name))
+                out.write('</package>\n')
+            out.write('</otherdata>\n')
+
+    def write_updateinfo(self, path):
+        types = ["security", "bugfix", "enhancement"]
+        severities = ["low", "moderate", "important", "critical"]
+        with open(path, "w") as out:
+            out.write('<?xml version="1.0" encoding="UTF-8"?>\n<updates>\n')
+            for idx, start in enumerate(range(0, self.count, 50)):
+                pkgs = self.packages[start:start + self.rng.randint(1, 5)]
+                adv_type = types[idx % len(types)]
+                out.write('  <update from="synthetic@example.com" status="stable" type="{}" version="1">\n'.format(
+                    adv_type))
+                out.write('    <id>SYNTH-2023-{}</id>\n'.format(idx))
+                out.write('    <title>Update of {}</title>\n'.format(pkgs[0].name))
+                out.write('    <release>Fedora 38</release>\n')
+                out.write('    <issued date="2023-01-01 00:00:00"/>\n')
+                out.write('    <severity>{}</severity>\n'.format(severities[idx % len(severities)]))
+                if adv_type == "security":
+                    out.write('    <references>\n')
+                    out.write('      <reference href="https://example.com/CVE-2023-{0}" id="CVE-2023-{0}" '
+                              'type="cve" title="CVE-2023-{0}"/>\n'.format(idx))
+                    out.write('    </references>\n')
+                out.write('    <description>Synthetic advisory {}</description>\n'.format(idx))
+                out.write('    <pkglist>\n      <collection short="F38">\n        <name>Fedora 38</name>\n')
+                for pkg in pkgs:
+                    out.write('        <package name="{}" version="{}" release="{}" epoch="0" arch="{}">\n'.format(
+                        pkg.name, pkg.version, pkg.release, pkg.arch))
+                    out.write('          <filename>{}-{}-{}.{}.rpm</filename>\n'.format(
+                        pkg.name, pkg.version, pkg.release, pkg.arch))
+                    out.write('        </package>\n')
+                out.write('      </collection>\n    </pkglist>\n  </update>\n')
+            out.write('</updates>\n')
+
+    def write_comps(self, path):
+        groups = []
+        with open(path, "w") as out:
+            out.write('<?xml version="1.0" encoding="UTF-8"?>\n')
+            out.write("<!DOCTYPE comps PUBLIC '-//Red Hat, Inc.//DTD Comps info//EN' 'comps.dtd'>\n<comps>\n")
+            for idx, start in enumerate(range(0, self.count, 200)):
+                group_id = "group{}".format(idx)
+                groups.append(group_id)
+                out.write('  <group>\n')
+                out.write('    <id>{}</id>\n'.format(group_id))
+                out.write('    <name>Group {}</name>\n'.format(idx))
+                out.write('    <description>Synthetic group {}</description>\n'.format(idx))
+                out.write('    <default>false</default>\n    <uservisible>true</uservisible>\n')
+                out.write('    <packagelist>\n')
+                for pos, pkg in enumerate(self.packages[start:start + 50]):
+                    req_type = ["mandatory", "default", "optional"][pos % 3]
+                    out.write('      <packagereq type="{}">{}</packagereq>\n'.format(req_type, pkg.name))
+                out.write('    </packagelist>\n  </group>\n')
+            for idx in range(min(5, len(groups))):
+                out.write('  <environment>\n')
+                out.write('    <id>environment{}</id>\n'.format(idx))
+                out.write('    <name>Environment {}</name>\n'.format(idx))
+                out.write('    <description>Synthetic environment {}</description>\n'.format(idx))
+                out.write('    <grouplist>\n')
+                for group_id in groups[idx::5][:10]:
+                    out.write('      <groupid>{}</groupid>\n'.format(group_id))
+                out.write('    </grouplist>\n  </environment>\n')
+            out.write('</comps>\n')
+
+    def write_modules(self, path):
+        with open(path, "w") as out:
+            for name, streams in self.modules:
+                for stream, artifacts in streams:
+                    out.write('---\ndocument: modulemd\nversion: 2\ndata:\n')
+                    out.write('  name: {}\n  stream: "{}"\n  version: 20230101000000\n'.format(name, stream))
+                    out.write('  context: 6c81f848\n  arch: x86_64\n')
+                    out.write('  summary: Synthetic module {}\n  description: Synthetic module {}\n'.format(
+                        name, name))
+                    out.write('  license:\n    module:\n    - MIT\n')
+                    out.write('  profiles:\n    default:\n      rpms:\n')
+                    for pkg in artifacts:
+                        out.write('      - {}\n'.format(pkg.name))
+                    out.write('  artifacts:\n    rpms:\n')
+                    for pkg in artifacts:
+                        out.write('    - {}\n'.format(pkg.nevra()))
+                    out.write('...\n')
+                out.write('---\ndocument: modulemd-defaults\nversion: 1\ndata:\n')
+                out.write('  module: {}\n  stream: "{}"\n  profiles:\n    "{}": [default]\n...\n'.format(
+                    name, streams[0][0], streams[0][0]))
+
+    def choose_installed(self, fraction):
+        # Installs random roots together with their dependency closure.
+        installed = set()
+        target = int(self.count * fraction)
+        while len(installed) < target:
+            stack = [self.rng.randint(0, self.count - 1)]
+            while stack:
+                idx = stack.pop()
+                if idx in installed:
+                    continue
+                installed.add(idx)
+                stack.extend(self.packages[idx].dep_indexes)
+        return sorted(installed)
+
+    def write_system_repo(self, path, installed):
+        with open(path, "w") as out:
+            out.write("=Ver: 3.0\n")
+            for idx in installed:
+                pkg = self.packages[idx]
+                # Every other installed package is outdated
+                release = self.previous_release(pkg.release) if idx % 2 == 0 else pkg.release
+                out.write("=Pkg: {} {} {} {}\n".format(pkg.name, pkg.version, release, pkg.arch))
+                for prv in pkg.provides:
+                    if prv.startswith(pkg.name + " = "):
+                        prv = "{} = {}-{}".format(pkg.name, pkg.version, release)
+                    out.write("=Prv: {}\n".format(prv))
+                for file in pkg.files:
+                    if file.startswith("/usr/bin/"):
+                        out.write("=Prv: {}\n".format(file))
+                for req in pkg.requires:
+                    out.write("=Req: {}\n".format(req))
+                for rec in pkg.recommends:
+                    out.write("=Rec: {}\n".format(rec))
+
+    def write_repomd(self, repodata_dir, files):
+        with open(os.path.join(repodata_dir, "repomd.xml"), "w") as out:
+            out.write('<?xml version="1.0" encoding="UTF-8"?>\n')
+            out.write('<repomd xmlns="http://linux.duke.edu/metadata/repo" '
+                      'xmlns:rpm="http://linux.duke.edu/metadata/rpm">\n')
+            out.write('  <revision>{}</revision>\n'.format(TIMESTAMP))
+            for md_type, filename in files:
+                location = os.path.join(repodata_dir, filename)
+                with open(location, "rb") as f:
+                    checksum = hashlib.sha256(f.read()).hexdigest()
+                size = os.path.getsize(location)
+                out.write('  <data type="{}">\n'.format(md_type))
+                out.write('    <checksum type="sha256">{}</checksum>\n'.format(checksum))
+                out.write('    <open-checksum type="sha256">{}</open-checksum>\n'.format(checksum))
+                out.write('    <location href="repodata/{}"/>\n'.format(filename))
+                out.write('    <timestamp>{}</timestamp>\n'.format(TIMESTAMP))
+                out.write('    <size>{}</size>\n'.format(size))
+                out.write('    <open-size>{}</open-size>\n'.format(size))
+                out.write('  </data>\n')
+            out.write('</repomd>\n')
+
+    def manifest(self, installed):
+        apps = [pkg for pkg in self.packages if pkg.kind == "app"]
+        installed_set = set(installed)
+        not_installed_apps = [pkg for pkg in apps if pkg.index not in installed_set]
+        # leaf applications (nothing depends on them) are good candidates for removal
+        required = set()
+        for idx in installed:
+            required.update(self.packages[idx].dep_indexes)
+        installed_leaves = [self.packages[idx] for idx in installed if idx not in required]
+        libs = [pkg for pkg in self.packages if pkg.kind == "lib"]
+        return {
+            "packages": self.count,
+            "seed": self.seed,
+            "solvables": sum(1 for _ in self.all_packages()),
+            "installed": len(installed),
+            "install_targets": [pkg.name for pkg in not_installed_apps[-5:]],
+            "remove_targets": [pkg.name for pkg in installed_leaves[:5]],
+            "name_glob": "lib{}-*".format(WORDS[0]),
+            "provide": libs[len(libs) // 2].soname if libs else "",
+            "file": apps[len(apps) // 2].files[0] if apps else "",
+        }
+
+    def write(self, output, system_fraction):
+        repodata_dir = os.path.join(output, "repodata")
+        os.makedirs(repodata_dir, exist_ok=True)
+
+        files = [
+            ("primary", "primary.xml"),
+            ("filelists", "filelists.xml"),
+            ("other", "other.xml"),
+            ("updateinfo", "updateinfo.xml"),
+            ("group", "comps.xml"),
+            ("modules", "modules.yaml"),
+        ]
+        self.write_primary(os.path.join(repodata_dir, "primary.xml"))
+        self.write_filelists(os.path.join(repodata_dir, "filelists.xml"))
+        self.write_other(os.path.join(repodata_dir, "other.xml"))
+        self.write_updateinfo(os.path.join(repodata_dir, "updateinfo.xml"))
+        self.write_comps(os.path.join(repodata_dir, "comps.xml"))
+        self.write_modules(os.path.join(repodata_dir, "modules.yaml"))
+        self.write_repomd(repodata_dir, files)
+
+        installed = []
+        if system_fraction > 0:
+            installed = self.choose_installed(system_fraction)
+            self.write_system_repo(os.path.join(output, "system.repo"), installed)
+
+        with open(os.path.join(output, "manifest.json"), "w") as out:
+            json.dump(self.manifest(installed), out, indent=4, sort_keys=True)
+            out.write("\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate a synthetic rpm-md repository for performance tests.")
+    parser.add_argument("output", help="output directory, repodata/ is created inside")
+    parser.add_argument("-n", "--packages", type=int, default=10000, help="number of packages (default: 10000)")
+    parser.add_argument("--seed", type=int, default=1, help="seed of the generator (default: 1)")
+    parser.add_argument(
+        "--system", type=float, default=0.3, metavar="FRACTION",
+        help="fraction of packages installed in the system.repo snapshot, 0 disables it (default: 0.3)")
+    args = parser.parse_args()
+
+    if args.packages < 1:
+        parser.error("the number of packages must be positive")
+    if not 0 <= args.system <= 1:
+        parser.error("the system fraction must be between 0 and 1")
+
+    generator = Generator(args.packages, args.seed)
+    generator.generate_packages()
+    generator.generate_modules()
+    generator.write(args.output, args.system)
+
+
+if __name__ == "__main__":
+    main()
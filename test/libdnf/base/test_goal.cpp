@@ -75,6 +75,42 @@ void BaseGoalTest::test_install_not_available() {
     CPPUNIT_ASSERT_EQUAL(libdnf::GoalUsedSetting::USED_FALSE, fist_event.get_job_settings()->get_used_strict());
 }
 
+void BaseGoalTest::test_install_many_specs() {
+    add_repo_repomd("repomd-repo1");
+
+    // enough specs to resolve them using the shared index of package names
+    std::vector<std::string> missing_specs{"missing1", "missing2", "missing3-1.0", "missing4.x86_64", "pkg-0:9-9"};
+    libdnf::Goal goal(base);
+    goal.add_rpm_install("pkg");
+    goal.add_rpm_install("pkg-libs-1:1.3-4.x86_64");
+    goal.add_rpm_install("pkg.x86_64");
+    for (const auto & spec : missing_specs) {
+        goal.add_rpm_install(spec);
+    }
+    auto transaction = goal.resolve();
+
+    std::vector<libdnf::base::TransactionPackage> expected = {
+        libdnf::base::TransactionPackage(
+            get_pkg("pkg-0:1.2-3.x86_64"),
+            TransactionItemAction::INSTALL,
+            TransactionItemReason::USER,
+            TransactionItemState::STARTED),
+        libdnf::base::TransactionPackage(
+            get_pkg("pkg-libs-1:1.3-4.x86_64"),
+            TransactionItemAction::INSTALL,
+            TransactionItemReason::USER,
+            TransactionItemState::STARTED)};
+    CPPUNIT_ASSERT_EQUAL(expected, transaction.get_transaction_packages());
+
+    std::vector<std::string> not_found_specs;
+    for (const auto & log : transaction.get_resolve_logs()) {
+        if (log.get_problem() == libdnf::GoalProblem::NOT_FOUND) {
+            not_found_specs.push_back(*log.get_spec());
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL(missing_specs, not_found_specs);
+}
+
 void BaseGoalTest::test_install_from_cmdline() {
     // Tests installing a cmdline package when there is a package with the same NEVRA available in a repo
     add_repo_rpm("rpm-repo1");
@@ -551,3 +587,92 @@ void BaseGoalTest::test_install_or_reinstall() {
             TransactionItemState::STARTED)};
     CPPUNIT_ASSERT_EQUAL(expected, transaction.get_transaction_packages());
 }
+
+void BaseGoalTest::test_solver_cache() {
+    add_repo_rpm("rpm-repo1");
+    add_system_pkg("repos-rpm/rpm-repo1/one-1-1.noarch.rpm", TransactionItemReason::DEPENDENCY);
+    base.get_config().solver_cache().set(true);
+    auto & metrics = *base.get_metrics();
+
+    libdnf::Goal goal(base);
+    goal.add_rpm_upgrade("one");
+    auto transaction = goal.resolve();
+    CPPUNIT_ASSERT_EQUAL(int64_t(1), metrics.get_counter("goal.solver_cache_misses"));
+    CPPUNIT_ASSERT_EQUAL(int64_t(0), metrics.get_counter("goal.solver_cache_hits"));
+
+    // the same goal is served from the cache, including the replaced package
+    libdnf::Goal same_goal(base);
+    same_goal.add_rpm_upgrade("one");
+    auto cached_transaction = same_goal.resolve();
+    CPPUNIT_ASSERT_EQUAL(int64_t(1), metrics.get_counter("goal.solver_cache_hits"));
+    CPPUNIT_ASSERT_EQUAL(transaction.get_transaction_packages(), cached_transaction.get_transaction_packages());
+    CPPUNIT_ASSERT_EQUAL(
+        transaction.get_transaction_packages()[0].get_replaces(),
+        cached_transaction.get_transaction_packages()[0].get_replaces());
+
+    // a different configuration is a different key
+    base.get_config().best().set(true);
+    libdnf::Goal best_goal(base);
+    best_goal.add_rpm_upgrade("one");
+    best_goal.resolve();
+    CPPUNIT_ASSERT_EQUAL(int64_t(2), metrics.get_counter("goal.solver_cache_misses"));
+    CPPUNIT_ASSERT_EQUAL(int64_t(1), metrics.get_counter("goal.solver_cache_hits"));
+
+    // a different architecture is a different key
+    base.get_vars()->set("basearch", "aarch64");
+    libdnf::Goal arch_goal(base);
+    arch_goal.add_rpm_upgrade("one");
+    arch_goal.resolve();
+    CPPUNIT_ASSERT_EQUAL(int64_t(3), metrics.get_counter("goal.solver_cache_misses"));
+    CPPUNIT_ASSERT_EQUAL(int64_t(1), metrics.get_counter("goal.solver_cache_hits"));
+
+    // the solver debug data are written by the solver, the cache is bypassed
+    base.get_config().debug_solver().set(true);
+    base.get_config().debugdir().set(base.get_config().cachedir().get_value() + "/debugdata");
+    libdnf::Goal debug_goal(base);
+    debug_goal.add_rpm_upgrade("one");
+    debug_goal.resolve();
+    CPPUNIT_ASSERT_EQUAL(int64_t(3), metrics.get_counter("goal.solver_cache_misses"));
+    CPPUNIT_ASSERT_EQUAL(int64_t(1), metrics.get_counter("goal.solver_cache_hits"));
+}
+
+void BaseGoalTest::test_solver_reuse() {
+    add_repo_repomd("repomd-repo1");
+    auto & metrics = *base.get_metrics();
+
+    std::vector<libdnf::base::TransactionPackage> expected = {libdnf::base::TransactionPackage(
+        get_pkg("pkg-0:1.2-3.x86_64"),
+        TransactionItemAction::INSTALL,
+        TransactionItemReason::USER,
+        TransactionItemState::STARTED)};
+
+    {
+        libdnf::Goal goal(base);
+        goal.add_rpm_install("pkg");
+        auto transaction = goal.resolve();
+        CPPUNIT_ASSERT_EQUAL(expected, transaction.get_transaction_packages());
+    }
+    const auto created = metrics.get_counter("goal.solver_created");
+    CPPUNIT_ASSERT(created > 0);
+
+    // the pool did not change, the following resolves reuse the solvers of the previous ones
+    for (int i = 0; i < 3; ++i) {
+        libdnf::Goal goal(base);
+        goal.add_rpm_install("pkg");
+        auto transaction = goal.resolve();
+        CPPUNIT_ASSERT_EQUAL(expected, transaction.get_transaction_packages());
+    }
+    CPPUNIT_ASSERT_EQUAL(created, metrics.get_counter("goal.solver_created"));
+    CPPUNIT_ASSERT(metrics.get_counter("goal.solver_reused") > 0);
+
+    // a change of the considered map invalidates the idle solvers
+    libdnf::rpm::PackageQuery excludes(base);
+    excludes.filter_name({"pkg-libs"});
+    base.get_rpm_package_sack()->add_user_excludes(excludes);
+
+    libdnf::Goal goal(base);
+    goal.add_rpm_install("pkg");
+    auto transaction = goal.resolve();
+    CPPUNIT_ASSERT_EQUAL(expected, transaction.get_transaction_packages());
+    CPPUNIT_ASSERT(metrics.get_counter("goal.solver_created") > created);
+}
@@ -33,6 +33,7 @@ class BaseGoalTest : public BaseTestCase {
 #ifndef WITH_PERFORMANCE_TESTS
     CPPUNIT_TEST(test_install);
     CPPUNIT_TEST(test_install_not_available);
+    CPPUNIT_TEST(test_install_many_specs);
     CPPUNIT_TEST(test_install_multilib_all);
     CPPUNIT_TEST(test_install_installed_pkg);
     CPPUNIT_TEST(test_install_or_reinstall);
@@ -53,6 +54,8 @@ class BaseGoalTest : public BaseTestCase {
     CPPUNIT_TEST(test_downgrade_user);
     CPPUNIT_TEST(test_distrosync);
     CPPUNIT_TEST(test_distrosync_all);
+    CPPUNIT_TEST(test_solver_cache);
+    CPPUNIT_TEST(test_solver_reuse);
 #endif
 
 #ifdef WITH_PERFORMANCE_TESTS
@@ -65,6 +68,7 @@ public:
 
     void test_install();
     void test_install_not_available();
+    void test_install_many_specs();
     void test_install_multilib_all();
     void test_install_installed_pkg();
     void test_install_or_reinstall();
@@ -85,6 +89,8 @@ public:
     void test_downgrade_user();
     void test_distrosync();
     void test_distrosync_all();
+    void test_solver_cache();
+    void test_solver_reuse();
 };
 
 
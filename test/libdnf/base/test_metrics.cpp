@@ -0,0 +1,154 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_metrics.hpp"
+
+#include "libdnf/base/metrics.hpp"
+
+#include <json.h>
+
+#include <string>
+#include <thread>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MetricsTest);
+
+
+using Span = libdnf::base::Metrics::Span;
+
+
+void MetricsTest::test_spans() {
+    libdnf::base::Metrics metrics;
+    {
+        Span outer(metrics, "outer");
+        {
+            Span inner(metrics, "inner", "detail");
+        }
+        Span running(metrics, "running");
+        running.finish();
+        // finishing twice is a no-op
+        running.finish();
+
+        // spans measured in another thread do not nest into spans of this thread
+        std::thread([&metrics]() { Span other(metrics, "other"); }).join();
+
+        auto spans = metrics.get_spans();
+        CPPUNIT_ASSERT_EQUAL(std::size_t(4), spans.size());
+        CPPUNIT_ASSERT(!spans[0].finished);
+        CPPUNIT_ASSERT(spans[1].finished);
+    }
+
+    auto spans = metrics.get_spans();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4), spans.size());
+
+    CPPUNIT_ASSERT_EQUAL(std::string("outer"), spans[0].name);
+    CPPUNIT_ASSERT_EQUAL(-1, spans[0].parent);
+    CPPUNIT_ASSERT(spans[0].finished);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("inner"), spans[1].name);
+    CPPUNIT_ASSERT_EQUAL(std::string("detail"), spans[1].detail);
+    CPPUNIT_ASSERT_EQUAL(0, spans[1].parent);
+
+    // "inner" was finished before "running" started, both are children of "outer"
+    CPPUNIT_ASSERT_EQUAL(std::string("running"), spans[2].name);
+    CPPUNIT_ASSERT_EQUAL(0, spans[2].parent);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("other"), spans[3].name);
+    CPPUNIT_ASSERT_EQUAL(-1, spans[3].parent);
+    CPPUNIT_ASSERT(spans[3].thread != spans[0].thread);
+
+    for (const auto & span : spans) {
+        CPPUNIT_ASSERT(span.wall_us >= 0);
+        CPPUNIT_ASSERT(span.start_us >= spans[0].start_us);
+    }
+    CPPUNIT_ASSERT(spans[0].wall_us >= spans[1].wall_us);
+    CPPUNIT_ASSERT_EQUAL(spans[1].wall_us, metrics.get_total_wall_us("inner"));
+    CPPUNIT_ASSERT_EQUAL(int64_t(0), metrics.get_total_wall_us("unknown"));
+}
+
+
+void MetricsTest::test_counters() {
+    libdnf::base::Metrics metrics;
+    CPPUNIT_ASSERT_EQUAL(int64_t(0), metrics.get_counter("bytes"));
+
+    metrics.add_counter("bytes", 100);
+    metrics.add_counter("bytes", 20);
+    metrics.add_counter("packages", 1);
+
+    CPPUNIT_ASSERT_EQUAL(int64_t(120), metrics.get_counter("bytes"));
+    std::map<std::string, int64_t> expected{{"bytes", 120}, {"packages", 1}};
+    CPPUNIT_ASSERT(expected == metrics.get_counters());
+}
+
+
+void MetricsTest::test_clear() {
+    libdnf::base::Metrics metrics;
+    metrics.add_counter("bytes", 1);
+    {
+        Span span(metrics, "cleared");
+        metrics.clear();
+        Span new_span(metrics, "new");
+    }
+
+    // the span running during clear() is not recorded and does not become a parent
+    auto spans = metrics.get_spans();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), spans.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("new"), spans[0].name);
+    CPPUNIT_ASSERT_EQUAL(-1, spans[0].parent);
+    CPPUNIT_ASSERT(spans[0].finished);
+    CPPUNIT_ASSERT(metrics.get_counters().empty());
+}
+
+
+void MetricsTest::test_export() {
+    libdnf::base::Metrics metrics;
+    {
+        Span span(metrics, "phase", "repo1");
+    }
+    metrics.add_counter("bytes", 42);
+
+    auto * json = json_tokener_parse(metrics.to_json().c_str());
+    CPPUNIT_ASSERT(json != nullptr);
+    json_object * spans;
+    CPPUNIT_ASSERT(json_object_object_get_ex(json, "spans", &spans));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), static_cast<std::size_t>(json_object_array_length(spans)));
+    json_object * value;
+    CPPUNIT_ASSERT(json_object_object_get_ex(json_object_array_get_idx(spans, 0), "name", &value));
+    CPPUNIT_ASSERT_EQUAL(std::string("phase"), std::string(json_object_get_string(value)));
+    CPPUNIT_ASSERT(json_object_object_get_ex(json_object_array_get_idx(spans, 0), "detail", &value));
+    CPPUNIT_ASSERT_EQUAL(std::string("repo1"), std::string(json_object_get_string(value)));
+    json_object * counters;
+    CPPUNIT_ASSERT(json_object_object_get_ex(json, "counters", &counters));
+    CPPUNIT_ASSERT(json_object_object_get_ex(counters, "bytes", &value));
+    CPPUNIT_ASSERT_EQUAL(int64_t(42), json_object_get_int64(value));
+    json_object_put(json);
+
+    // one complete event for the span and one counter event
+    auto * trace = json_tokener_parse(metrics.to_chrome_trace().c_str());
+    CPPUNIT_ASSERT(trace != nullptr);
+    json_object * events;
+    CPPUNIT_ASSERT(json_object_object_get_ex(trace, "traceEvents", &events));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), static_cast<std::size_t>(json_object_array_length(events)));
+    CPPUNIT_ASSERT(json_object_object_get_ex(json_object_array_get_idx(events, 0), "ph", &value));
+    CPPUNIT_ASSERT_EQUAL(std::string("X"), std::string(json_object_get_string(value)));
+    CPPUNIT_ASSERT(json_object_object_get_ex(json_object_array_get_idx(events, 1), "ph", &value));
+    CPPUNIT_ASSERT_EQUAL(std::string("C"), std::string(json_object_get_string(value)));
+    json_object_put(trace);
+}
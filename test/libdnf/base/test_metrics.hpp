@@ -0,0 +1,44 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF_TEST_BASE_METRICS_HPP
+#define LIBDNF_TEST_BASE_METRICS_HPP
+
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class MetricsTest : public CppUnit::TestCase {
+    CPPUNIT_TEST_SUITE(MetricsTest);
+    CPPUNIT_TEST(test_spans);
+    CPPUNIT_TEST(test_counters);
+    CPPUNIT_TEST(test_clear);
+    CPPUNIT_TEST(test_export);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void test_spans();
+    void test_counters();
+    void test_clear();
+    void test_export();
+};
+
+#endif
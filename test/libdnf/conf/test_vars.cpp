@@ -20,6 +20,16 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "test_vars.hpp"
 
+#include "libdnf/base/metrics.hpp"
+
+#include <fmt/format.h>
+#include <json.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
 
 CPPUNIT_TEST_SUITE_REGISTRATION(VarsTest);
 
@@ -70,3 +80,120 @@ void VarsTest::test_vars_env() {
         std::string("foo0-foo1-foo9-testvar1-testvar2-456"),
         base->get_vars()->substitute("${DNF0}-${DNF1}-${DNF9}-${var1}-${var41}-${var2}"));
 }
+
+
+namespace {
+
+// The former substitution, every reference is replaced in place.
+std::string substitute_in_place(const libdnf::Vars & vars, const std::string & text) {
+    std::string res = text;
+    auto start = res.find_first_of('$');
+    while (start != std::string::npos) {
+        auto variable = start + 1;
+        if (variable >= res.length()) {
+            break;
+        }
+        bool bracket = res[variable] == '{';
+        if (bracket && ++variable >= res.length()) {
+            break;
+        }
+        auto it = std::find_if_not(res.begin() + static_cast<long>(variable), res.end(), [](char c) {
+            return std::isalnum(c) != 0 || c == '_';
+        });
+        if (bracket && it == res.end()) {
+            break;
+        }
+        auto past_variable = static_cast<std::size_t>(std::distance(res.begin(), it));
+        if (bracket && *it != '}') {
+            start = res.find_first_of('$', past_variable);
+            continue;
+        }
+        auto name = res.substr(variable, past_variable - variable);
+        if (vars.contains(name)) {
+            if (bracket) {
+                ++past_variable;
+            }
+            const auto & subst_str = vars.get_value(name);
+            res.replace(start, past_variable - start, subst_str);
+            start = res.find_first_of('$', start + subst_str.length());
+        } else {
+            start = res.find_first_of('$', past_variable);
+        }
+    }
+    return res;
+}
+
+}  // namespace
+
+
+void VarsTest::test_vars_substitute_in_one_pass() {
+    base->get_config().varsdir().set(std::vector<std::string>{PROJECT_SOURCE_DIR "/test/libdnf/conf/data/vars"});
+    base->setup();
+    const auto & vars = *base->get_vars();
+
+    // the single pass substitution gives the same results as the replacement in place
+    for (const std::string text :
+         {"foo$var1-bar", "$$$${var1}$var2-$nn-${nnn}", "${var1", "${var1-}$var2", "$", "${", "", "no vars"}) {
+        CPPUNIT_ASSERT_EQUAL(substitute_in_place(vars, text), vars.substitute(text));
+    }
+    CPPUNIT_ASSERT_EQUAL(
+        std::string("value123/456/value123/$unknown"), vars.substitute("$var1/${var2}/$var1/$unknown"));
+}
+
+
+void VarsTest::test_vars_substitute_performance() {
+    constexpr int REPOS = 500;
+    constexpr int ROUNDS = 20;
+
+    base->setup();
+    auto & vars = *base->get_vars();
+    vars.set("arch", "x86_64");
+    vars.set("basearch", "x86_64");
+    vars.set("releasever", "38");
+    vars.set("contentdir", "pub/fedora/linux");
+
+    // option values of synthetic repository configurations
+    std::vector<std::string> values;
+    for (int idx = 0; idx < REPOS; ++idx) {
+        values.push_back(fmt::format("repo-{}-$releasever-$basearch", idx));
+        values.push_back(fmt::format("Repository {} $releasever - $basearch", idx));
+        values.push_back(
+            fmt::format("https://example.com/$contentdir/repo{}/$releasever/Everything/$basearch/os/", idx));
+        values.push_back(
+            fmt::format("https://mirrors.example.com/mirrorlist?repo=repo{}-$releasever&arch=$basearch", idx));
+        values.push_back(
+            fmt::format("https://mirrors.example.com/metalink?repo=repo{}-$releasever&arch=$basearch", idx));
+        values.push_back(
+            fmt::format("file:///etc/pki/rpm-gpg/RPM-GPG-KEY-repo{}-$releasever-$basearch ${{arch}}/${{arch}}", idx));
+    }
+    for (const auto & value : values) {
+        CPPUNIT_ASSERT_EQUAL(substitute_in_place(vars, value), vars.substitute(value));
+    }
+
+    libdnf::base::Metrics metrics;
+    std::size_t total_length = 0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        {
+            libdnf::base::Metrics::Span span(metrics, "vars.in_place");
+            for (const auto & value : values) {
+                total_length += substitute_in_place(vars, value).length();
+            }
+        }
+        {
+            libdnf::base::Metrics::Span span(metrics, "vars.substitute");
+            for (const auto & value : values) {
+                total_length += vars.substitute(value).length();
+            }
+        }
+    }
+    CPPUNIT_ASSERT(total_length > 0);
+
+    auto * root = json_object_new_object();
+    for (const char * span : {"vars.in_place", "vars.substitute"}) {
+        json_object_object_add(root, span, json_object_new_int64(metrics.get_total_wall_us(span) / ROUNDS));
+    }
+    const auto results_path = PROJECT_BINARY_DIR "/test/libdnf/performance-test-vars.json";
+    std::ofstream results(results_path);
+    results << json_object_to_json_string_ext(root, JSON_C_TO_STRING_PRETTY) << std::endl;
+    json_object_put(root);
+}
@@ -33,6 +33,12 @@ class VarsTest : public TestCaseFixture {
     CPPUNIT_TEST(test_vars);
     CPPUNIT_TEST(test_vars_multiple_dirs);
     CPPUNIT_TEST(test_vars_env);
+    CPPUNIT_TEST(test_vars_substitute_in_one_pass);
+
+#ifdef WITH_PERFORMANCE_TESTS
+    CPPUNIT_TEST(test_vars_substitute_performance);
+#endif
+
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -41,6 +47,8 @@ public:
     void test_vars();
     void test_vars_multiple_dirs();
     void test_vars_env();
+    void test_vars_substitute_in_one_pass();
+    void test_vars_substitute_performance();
 
     std::unique_ptr<libdnf::Base> base;
 };
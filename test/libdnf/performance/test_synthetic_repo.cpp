@@ -0,0 +1,339 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_synthetic_repo.hpp"
+
+#include "private_accessor.hpp"
+#include "utils/string.hpp"
+
+#include "libdnf/base/goal.hpp"
+#include "libdnf/conf/const.hpp"
+#include "libdnf/repo/repo_sack.hpp"
+#include "libdnf/rpm/package_query.hpp"
+#include "libdnf/transaction/rpm_package.hpp"
+#include "libdnf/transaction/transaction.hpp"
+
+#include <fmt/format.h>
+#include <json.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SyntheticRepoPerformanceTest);
+
+using libdnf::base::Metrics;
+
+
+namespace {
+
+// Allows accessing private methods
+create_private_getter_template;
+create_getter(new_package, &libdnf::transaction::Transaction::new_package);
+create_getter(start, &libdnf::transaction::Transaction::start);
+create_getter(finish, &libdnf::transaction::Transaction::finish);
+create_getter(new_transaction, &libdnf::transaction::TransactionHistory::new_transaction);
+
+create_getter(set_name, &libdnf::transaction::Package::set_name);
+create_getter(set_epoch, &libdnf::transaction::Package::set_epoch);
+create_getter(set_version, &libdnf::transaction::Package::set_version);
+create_getter(set_release, &libdnf::transaction::Package::set_release);
+create_getter(set_arch, &libdnf::transaction::Package::set_arch);
+create_getter(set_repoid, &libdnf::transaction::Package::set_repoid);
+create_getter(set_action, &libdnf::transaction::Package::set_action);
+create_getter(set_reason, &libdnf::transaction::Package::set_reason);
+create_getter(set_state, &libdnf::transaction::Package::set_state);
+
+constexpr int REPEATED_RESOLVES = 50;
+constexpr int HISTORY_TRANSACTIONS = 20;
+constexpr int HISTORY_TRANSACTION_PACKAGES = 500;
+
+
+// Parameters of a generated repository, see manifest() in test/data/generate-synthetic-repo.py
+struct Manifest {
+    std::string packages;
+    std::vector<std::string> install_targets;
+    std::vector<std::string> remove_targets;
+    std::string name_glob;
+    std::string provide;
+    std::string file;
+};
+
+
+std::string get_string(json_object * root, const char * key) {
+    json_object * value;
+    if (!json_object_object_get_ex(root, key, &value)) {
+        return {};
+    }
+    return json_object_get_string(value);
+}
+
+
+std::vector<std::string> get_strings(json_object * root, const char * key) {
+    std::vector<std::string> ret;
+    json_object * value;
+    if (json_object_object_get_ex(root, key, &value)) {
+        for (std::size_t idx = 0; idx < json_object_array_length(value); ++idx) {
+            ret.emplace_back(json_object_get_string(json_object_array_get_idx(value, idx)));
+        }
+    }
+    return ret;
+}
+
+
+Manifest read_manifest(const std::filesystem::path & path) {
+    auto * root = json_object_from_file(path.c_str());
+    CPPUNIT_ASSERT_MESSAGE("Cannot parse " + path.native(), root);
+
+    Manifest manifest;
+    manifest.packages = get_string(root, "packages");
+    manifest.install_targets = get_strings(root, "install_targets");
+    manifest.remove_targets = get_strings(root, "remove_targets");
+    manifest.name_glob = get_string(root, "name_glob");
+    manifest.provide = get_string(root, "provide");
+    manifest.file = get_string(root, "file");
+    json_object_put(root);
+    return manifest;
+}
+
+
+// Returns generated repositories (PROJECT_BINARY_DIR/test/data/synthetic/<size>) ordered by size.
+std::vector<std::filesystem::path> find_synthetic_repos() {
+    std::vector<std::filesystem::path> ret;
+    const std::filesystem::path root = PROJECT_BINARY_DIR "/test/data/synthetic";
+    if (!std::filesystem::is_directory(root)) {
+        return ret;
+    }
+    for (const auto & entry : std::filesystem::directory_iterator(root)) {
+        if (std::filesystem::exists(entry.path() / "manifest.json")) {
+            ret.push_back(entry.path());
+        }
+    }
+    std::sort(ret.begin(), ret.end(), [](const auto & lhs, const auto & rhs) {
+        return std::stoul(lhs.filename().native()) < std::stoul(rhs.filename().native());
+    });
+    return ret;
+}
+
+
+void load_repo(libdnf::Base & base, const std::filesystem::path & repo_path) {
+    auto repo = base.get_repo_sack()->create_repo("synthetic");
+    repo->get_config().baseurl().set("file://" + repo_path.native());
+    repo->fetch_metadata();
+    repo->load();
+}
+
+
+void check_resolved(libdnf::base::Transaction & transaction, const std::string & what) {
+    CPPUNIT_ASSERT_MESSAGE(
+        fmt::format("{} failed: {}", what, libdnf::utils::string::join(transaction.get_resolve_logs_as_strings(), "; ")),
+        transaction.get_problems() == libdnf::GoalProblem::NO_PROBLEM);
+    CPPUNIT_ASSERT_MESSAGE(what + " resulted in an empty transaction", !transaction.get_transaction_packages().empty());
+}
+
+
+json_object * parse_json(const std::string & json) {
+    auto * ret = json_tokener_parse(json.c_str());
+    return ret ? ret : json_object_new_object();
+}
+
+}  // namespace
+
+
+std::unique_ptr<libdnf::Base> SyntheticRepoPerformanceTest::new_base(const std::filesystem::path & cachedir) {
+    auto base = std::make_unique<libdnf::Base>();
+    base->get_config().installroot().set(temp->get_path() / "installroot");
+    base->get_config().cachedir().set(cachedir);
+    base->get_config().optional_metadata_types().set(libdnf::OPTIONAL_METADATA_TYPES);
+    base->get_vars()->set("arch", "x86_64");
+    base->setup();
+    return base;
+}
+
+
+void SyntheticRepoPerformanceTest::test_synthetic_repos() {
+    const auto repos = find_synthetic_repos();
+    CPPUNIT_ASSERT_MESSAGE("No synthetic repositories found, build the 'synthetic_repos' target first", !repos.empty());
+
+    for (const auto & repo_path : repos) {
+        temp = std::make_unique<libdnf::utils::fs::TempDir>("libdnf5_perftest");
+        std::filesystem::create_directory(temp->get_path() / "installroot");
+        run_benchmarks(repo_path);
+    }
+}
+
+
+void SyntheticRepoPerformanceTest::run_benchmarks(const std::filesystem::path & repo_path) {
+    const auto manifest = read_manifest(repo_path / "manifest.json");
+    const auto cachedir = temp->get_path() / "cache";
+    Metrics metrics;
+
+    // Cold load parses the XML metadata and writes the solv cache files, warm load reads them.
+    {
+        auto cold_base = new_base(cachedir);
+        Metrics::Span span(metrics, "load.cold");
+        load_repo(*cold_base, repo_path);
+    }
+
+    auto base = new_base(cachedir);
+    {
+        Metrics::Span span(metrics, "load.warm");
+        load_repo(*base, repo_path);
+    }
+
+    const auto system_repo_path = repo_path / "system.repo";
+    if (std::filesystem::exists(system_repo_path)) {
+        Metrics::Span span(metrics, "load.system");
+        base->get_repo_sack()->get_system_repo()->add_libsolv_testcase(system_repo_path);
+    }
+
+    metrics.add_counter("packages", static_cast<int64_t>(libdnf::rpm::PackageQuery(*base).size()));
+
+    {
+        Metrics::Span span(metrics, "query.name_glob");
+        libdnf::rpm::PackageQuery query(*base);
+        query.filter_name({manifest.name_glob}, libdnf::sack::QueryCmp::GLOB);
+        metrics.add_counter("query.name_glob.results", static_cast<int64_t>(query.size()));
+    }
+    {
+        Metrics::Span span(metrics, "query.provides");
+        libdnf::rpm::PackageQuery query(*base);
+        query.filter_provides({manifest.provide});
+        CPPUNIT_ASSERT(!query.empty());
+    }
+    {
+        Metrics::Span span(metrics, "query.file");
+        libdnf::rpm::PackageQuery query(*base);
+        query.filter_file({manifest.file});
+        CPPUNIT_ASSERT(!query.empty());
+    }
+    {
+        Metrics::Span span(metrics, "query.latest");
+        libdnf::rpm::PackageQuery query(*base);
+        query.filter_available();
+        query.filter_latest_evr();
+        metrics.add_counter("query.latest.results", static_cast<int64_t>(query.size()));
+    }
+    {
+        Metrics::Span span(metrics, "query.upgrades");
+        libdnf::rpm::PackageQuery query(*base);
+        query.filter_upgrades();
+        metrics.add_counter("query.upgrades.results", static_cast<int64_t>(query.size()));
+    }
+
+    {
+        Metrics::Span span(metrics, "goal.install");
+        libdnf::Goal goal(*base);
+        for (const auto & spec : manifest.install_targets) {
+            goal.add_rpm_install(spec);
+        }
+        auto transaction = goal.resolve();
+        check_resolved(transaction, "install");
+        metrics.add_counter(
+            "goal.install.packages", static_cast<int64_t>(transaction.get_transaction_packages().size()));
+    }
+    {
+        Metrics::Span span(metrics, "goal.upgrade_all");
+        libdnf::Goal goal(*base);
+        goal.add_rpm_upgrade();
+        auto transaction = goal.resolve();
+        check_resolved(transaction, "upgrade all");
+        metrics.add_counter(
+            "goal.upgrade_all.packages", static_cast<int64_t>(transaction.get_transaction_packages().size()));
+    }
+    {
+        Metrics::Span span(metrics, "goal.remove_clean_deps");
+        libdnf::GoalJobSettings settings;
+        settings.clean_requirements_on_remove = libdnf::GoalSetting::SET_TRUE;
+        libdnf::Goal goal(*base);
+        for (const auto & spec : manifest.remove_targets) {
+            goal.add_rpm_remove(spec, settings);
+        }
+        auto transaction = goal.resolve();
+        check_resolved(transaction, "remove");
+        metrics.add_counter(
+            "goal.remove_clean_deps.packages", static_cast<int64_t>(transaction.get_transaction_packages().size()));
+    }
+
+    {
+        // Goals of an interactive session resolved one after another against the unchanged pool
+        Metrics::Span span(metrics, "goal.repeated_resolves");
+        for (int resolve_idx = 0; resolve_idx < REPEATED_RESOLVES; ++resolve_idx) {
+            libdnf::Goal goal(*base);
+            if (resolve_idx % 2 == 0) {
+                for (const auto & spec : manifest.install_targets) {
+                    goal.add_rpm_install(spec);
+                }
+            } else {
+                for (const auto & spec : manifest.remove_targets) {
+                    goal.add_rpm_remove(spec);
+                }
+            }
+            auto transaction = goal.resolve();
+            check_resolved(transaction, "repeated resolve");
+        }
+        metrics.add_counter("goal.repeated_resolves.count", REPEATED_RESOLVES);
+    }
+
+    {
+        Metrics::Span span(metrics, "history.write");
+        auto history = base->get_transaction_history();
+        for (int trans_idx = 0; trans_idx < HISTORY_TRANSACTIONS; ++trans_idx) {
+            auto trans = ((*history).*get(new_transaction{}))();
+            for (int pkg_idx = 0; pkg_idx < HISTORY_TRANSACTION_PACKAGES; ++pkg_idx) {
+                auto & pkg = (trans.*get(new_package{}))();
+                (pkg.*get(set_name{}))(fmt::format("name_{}_{}", trans_idx, pkg_idx));
+                (pkg.*get(set_epoch{}))("0");
+                (pkg.*get(set_version{}))("1.0");
+                (pkg.*get(set_release{}))("1");
+                (pkg.*get(set_arch{}))("x86_64");
+                (pkg.*get(set_repoid{}))("synthetic");
+                (pkg.*get(set_action{}))(libdnf::transaction::TransactionItemAction::INSTALL);
+                (pkg.*get(set_reason{}))(libdnf::transaction::TransactionItemReason::USER);
+                (pkg.*get(set_state{}))(libdnf::transaction::TransactionItemState::OK);
+            }
+            (trans.*get(start{}))();
+            (trans.*get(finish{}))(libdnf::transaction::TransactionState::OK);
+        }
+    }
+    {
+        // a new Base forces reading the transactions from the database
+        auto history_base = new_base(cachedir);
+        Metrics::Span span(metrics, "history.read");
+        std::size_t packages = 0;
+        for (auto & trans : history_base->get_transaction_history()->list_all_transactions()) {
+            packages += trans.get_packages().size();
+        }
+        CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(HISTORY_TRANSACTIONS * HISTORY_TRANSACTION_PACKAGES), packages);
+    }
+
+    // Results of the benchmarks together with the detailed metrics collected by libdnf during the run.
+    auto * root = json_object_new_object();
+    json_object_object_add(root, "repository", json_object_new_string(repo_path.c_str()));
+    json_object_object_add(root, "benchmarks", parse_json(metrics.to_json()));
+    json_object_object_add(root, "libdnf", parse_json(base->get_metrics()->to_json()));
+
+    const auto results_path = fmt::format(PROJECT_BINARY_DIR "/test/libdnf/performance-{}.json", manifest.packages);
+    std::ofstream results(results_path);
+    results << json_object_to_json_string_ext(root, JSON_C_TO_STRING_PRETTY) << std::endl;
+    json_object_put(root);
+}
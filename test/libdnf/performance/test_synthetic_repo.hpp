@@ -0,0 +1,55 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef TEST_LIBDNF_PERFORMANCE_SYNTHETIC_REPO_HPP
+#define TEST_LIBDNF_PERFORMANCE_SYNTHETIC_REPO_HPP
+
+
+#include "test_case_fixture.hpp"
+
+#include "libdnf/base/metrics.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <filesystem>
+
+
+// End-to-end benchmarks on repositories generated by test/data/generate-synthetic-repo.py.
+// The results of every repository size are written to PROJECT_BINARY_DIR/test/libdnf/performance-<size>.json.
+class SyntheticRepoPerformanceTest : public TestCaseFixture {
+    CPPUNIT_TEST_SUITE(SyntheticRepoPerformanceTest);
+
+#ifdef WITH_PERFORMANCE_TESTS
+    CPPUNIT_TEST(test_synthetic_repos);
+#endif
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void test_synthetic_repos();
+
+private:
+    void run_benchmarks(const std::filesystem::path & repo_path);
+
+    std::unique_ptr<libdnf::Base> new_base(const std::filesystem::path & cachedir);
+};
+
+
+#endif  // TEST_LIBDNF_PERFORMANCE_SYNTHETIC_REPO_HPP
@@ -19,12 +19,27 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "test_package_downloader.hpp"
 
+#include "repo/mirror_stats.hpp"
 #include "utils/string.hpp"
 
 #include "libdnf/base/base.hpp"
 #include "libdnf/repo/package_downloader.hpp"
 #include "libdnf/rpm/package_query.hpp"
 
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
 
 CPPUNIT_TEST_SUITE_REGISTRATION(PackageDownloaderTest);
 
@@ -62,6 +77,136 @@ public:
     int mirror_failure_cnt = 0;
 };
 
+namespace {
+
+// Minimal HTTP server serving files of a directory on a local port. A slow server sends only the first
+// `SLOW_SERVER_BYTES` of a package and stalls the rest of the transfer, like an overloaded mirror.
+class HttpServer {
+public:
+    static constexpr std::size_t SLOW_SERVER_BYTES = 100;
+
+    HttpServer(const std::filesystem::path & root, bool slow) : root(root), slow(slow) {
+        sock = socket(AF_INET, SOCK_STREAM, 0);
+        CPPUNIT_ASSERT(sock >= 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addr_len = sizeof(addr);
+        CPPUNIT_ASSERT_EQUAL(0, bind(sock, reinterpret_cast<sockaddr *>(&addr), addr_len));
+        CPPUNIT_ASSERT_EQUAL(0, listen(sock, 16));
+        CPPUNIT_ASSERT_EQUAL(0, getsockname(sock, reinterpret_cast<sockaddr *>(&addr), &addr_len));
+        port = ntohs(addr.sin_port);
+        acceptor = std::thread(&HttpServer::run, this);
+    }
+
+    ~HttpServer() {
+        stop = true;
+        acceptor.join();
+        for (auto & connection : connections) {
+            connection.join();
+        }
+        close(sock);
+    }
+
+    HttpServer(const HttpServer &) = delete;
+    HttpServer & operator=(const HttpServer &) = delete;
+
+    std::string get_url() const { return "http://127.0.0.1:" + std::to_string(port) + "/"; }
+
+private:
+    void run() {
+        while (!stop) {
+            pollfd pfd{sock, POLLIN, 0};
+            if (poll(&pfd, 1, 100) <= 0) {
+                continue;
+            }
+            int client = accept(sock, nullptr, nullptr);
+            if (client >= 0) {
+                connections.emplace_back(&HttpServer::serve, this, client);
+            }
+        }
+    }
+
+    void serve(int client) {
+        std::string request;
+        char buffer[4096];
+        while (request.find("\r\n\r\n") == std::string::npos) {
+            auto len = recv(client, buffer, sizeof(buffer), 0);
+            if (len <= 0) {
+                close(client);
+                return;
+            }
+            request.append(buffer, static_cast<std::size_t>(len));
+        }
+
+        // "GET /<path> HTTP/1.1"
+        std::istringstream request_line(request.substr(0, request.find("\r\n")));
+        std::string method;
+        std::string path;
+        request_line >> method >> path;
+        std::ifstream file(root / path.substr(1), std::ios::binary);
+        if (!file) {
+            send_all(client, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+            close(client);
+            return;
+        }
+        std::string content{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+        // resumed downloads request "Range: bytes=<offset>-"
+        std::size_t offset = 0;
+        auto range = request.find("Range: bytes=");
+        if (range != std::string::npos) {
+            offset = std::min(std::stoul(request.substr(range + 13)), content.size());
+        }
+
+        std::string header = offset > 0 ? "HTTP/1.1 206 Partial Content\r\n" : "HTTP/1.1 200 OK\r\n";
+        header += "Content-Length: " + std::to_string(content.size() - offset) + "\r\n";
+        if (offset > 0) {
+            header += "Content-Range: bytes " + std::to_string(offset) + "-" + std::to_string(content.size() - 1) +
+                      "/" + std::to_string(content.size()) + "\r\n";
+        }
+        header += "Connection: close\r\n\r\n";
+        send_all(client, header);
+
+        auto body = content.substr(offset);
+        if (slow && path.ends_with(".rpm") && body.size() > SLOW_SERVER_BYTES) {
+            send_all(client, body.substr(0, SLOW_SERVER_BYTES));
+            // stall until the client gives up
+            while (!stop) {
+                pollfd pfd{client, POLLIN, 0};
+                if (poll(&pfd, 1, 100) > 0 && recv(client, buffer, sizeof(buffer), 0) <= 0) {
+                    break;
+                }
+            }
+        } else {
+            send_all(client, body);
+        }
+        close(client);
+    }
+
+    static void send_all(int client, const std::string & data) {
+        std::size_t sent = 0;
+        while (sent < data.size()) {
+            auto len = send(client, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (len <= 0) {
+                return;
+            }
+            sent += static_cast<std::size_t>(len);
+        }
+    }
+
+    std::filesystem::path root;
+    bool slow;
+    int sock{-1};
+    uint16_t port{0};
+    std::atomic<bool> stop{false};
+    std::thread acceptor;
+    std::vector<std::thread> connections;  // accessed only by the acceptor thread until it is joined
+};
+
+}  // namespace
+
+
 void PackageDownloaderTest::test_package_downloader() {
     auto repo = add_repo_rpm("rpm-repo1");
 
@@ -88,3 +233,60 @@ void PackageDownloaderTest::test_package_downloader() {
     CPPUNIT_ASSERT_GREATEREQUAL(1, cbs->progress_cnt);
     CPPUNIT_ASSERT_EQUAL(0, cbs->mirror_failure_cnt);
 }
+
+
+void PackageDownloaderTest::test_package_downloader_mirrors() {
+    const std::filesystem::path repo_path = PROJECT_BINARY_DIR "/test/data/repos-rpm/rpm-repo1";
+    HttpServer slow_server(repo_path, true);
+    HttpServer fast_server(repo_path, false);
+
+    base.get_config().download_mirrors().set(2);
+
+    // the slow mirror is listed first, so it gets packages while the speed of the mirrors is unknown
+    auto repo = add_repo_rpm("rpm-repo1", false);
+    repo->get_config().baseurl().set(std::vector<std::string>{slow_server.get_url(), fast_server.get_url()});
+    repo->fetch_metadata();
+    repo->load();
+
+    libdnf::rpm::PackageQuery query(base);
+    query.filter_arch({"noarch"});
+    CPPUNIT_ASSERT_EQUAL((size_t)2, query.size());
+
+    auto cbs_unique_ptr = std::make_unique<DownloadCallbacks>();
+    auto cbs = cbs_unique_ptr.get();
+    base.set_download_callbacks(std::move(cbs_unique_ptr));
+
+    // the packages are spread across both mirrors, the stalled transfer is downloaded again from the fast one
+    auto downloader = libdnf::repo::PackageDownloader();
+    for (const auto & package : query) {
+        downloader.add(package);
+    }
+    downloader.download(true, true);
+
+    CPPUNIT_ASSERT_EQUAL(2, cbs->end_cnt);
+    CPPUNIT_ASSERT_EQUAL(DownloadCallbacks::TransferStatus::SUCCESSFUL, cbs->end_status);
+    CPPUNIT_ASSERT_GREATEREQUAL(1, cbs->mirror_failure_cnt);
+    CPPUNIT_ASSERT_GREATEREQUAL(int64_t(1), base.get_metrics()->get_counter("download.slow_transfers"));
+
+    // the statistics are persistent and rank the fast mirror first
+    const auto stats_path =
+        std::filesystem::path(base.get_config().cachedir().get_value()) / libdnf::repo::MIRROR_STATS_FILENAME;
+    CPPUNIT_ASSERT(std::filesystem::exists(stats_path));
+    libdnf::repo::MirrorStats stats(base.get_weak_ptr());
+    stats.load();
+    auto ranked = stats.rank({slow_server.get_url(), fast_server.get_url()});
+    CPPUNIT_ASSERT_EQUAL(fast_server.get_url(), ranked.front());
+
+    // the next download uses only the fast mirror
+    cbs->end_cnt = 0;
+    cbs->mirror_failure_cnt = 0;
+    auto second_downloader = libdnf::repo::PackageDownloader();
+    for (const auto & package : query) {
+        second_downloader.add(package, temp->get_path() / "second", nullptr);
+    }
+    second_downloader.download(true, true);
+
+    CPPUNIT_ASSERT_EQUAL(2, cbs->end_cnt);
+    CPPUNIT_ASSERT_EQUAL(DownloadCallbacks::TransferStatus::SUCCESSFUL, cbs->end_status);
+    CPPUNIT_ASSERT_EQUAL(0, cbs->mirror_failure_cnt);
+}
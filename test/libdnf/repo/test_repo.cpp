@@ -19,11 +19,27 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "test_repo.hpp"
 
+#include "base/base_impl.hpp"
+#include "private_accessor.hpp"
+#include "repo/repo_cache_private.hpp"
+#include "repo/solv_repo.hpp"
 #include "utils/string.hpp"
 
 #include "libdnf/base/base.hpp"
+#include "libdnf/conf/const.hpp"
+#include "libdnf/repo/repo_query.hpp"
+#include "libdnf/rpm/package_query.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION(RepoTest);
@@ -113,3 +129,253 @@ void RepoTest::test_load_repo_nonexistent() {
     auto repo = add_repo("nonexistent", "/path/thats/not/here", false);
     CPPUNIT_ASSERT_THROW(repo->fetch_metadata(), libdnf::repo::RepoDownloadError);
 }
+
+
+void RepoTest::test_create_repos_from_dir() {
+    const auto reposdir = temp->get_path() / "repos.d";
+    std::filesystem::create_directory(reposdir);
+    std::ofstream(reposdir / "a.repo") << "[repo-a-$arch]\nname=Repo A\nbaseurl=http://example.com/$arch\n";
+    std::ofstream(reposdir / "b.repo") << "[repo-b]\nenabled=0\nbaseurl=http://example.com/b\n";
+
+    // Creates repositories from the directory in a new Base sharing the cachedir (and the index) with `base`
+    auto create_repos = [&]() {
+        auto new_base = std::make_unique<libdnf::Base>();
+        new_base->get_config().installroot().set(base.get_config().installroot().get_value());
+        new_base->get_config().cachedir().set(base.get_config().cachedir().get_value());
+        new_base->get_vars()->set("arch", "x86_64");
+        new_base->setup();
+        new_base->get_repo_sack()->create_repos_from_dir(reposdir);
+        return new_base;
+    };
+
+    auto check_repos = [](libdnf::Base & repos_base, const std::string & repo_b_url) {
+        libdnf::repo::RepoQuery repos(repos_base);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), repos.size());
+        repos.filter_id("repo-a-x86_64");
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), repos.size());
+        auto repo_a = *repos.begin();
+        CPPUNIT_ASSERT_EQUAL(std::string("Repo A"), repo_a->get_name());
+        CPPUNIT_ASSERT(repo_a->is_enabled());
+        CPPUNIT_ASSERT_EQUAL(
+            std::vector<std::string>{"http://example.com/x86_64"}, repo_a->get_config().baseurl().get_value());
+
+        libdnf::repo::RepoQuery repos_b(repos_base);
+        repos_b.filter_id("repo-b");
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), repos_b.size());
+        auto repo_b = *repos_b.begin();
+        CPPUNIT_ASSERT_EQUAL(std::string("repo-b"), repo_b->get_name());
+        CPPUNIT_ASSERT(!repo_b->is_enabled());
+        CPPUNIT_ASSERT_EQUAL(std::vector<std::string>{repo_b_url}, repo_b->get_config().baseurl().get_value());
+    };
+
+    // the first run parses the files and writes the index, the second one uses the index
+    check_repos(*create_repos(), "http://example.com/b");
+    CPPUNIT_ASSERT(std::filesystem::exists(base.get_config().cachedir().get_value() + "/repo-config.index"));
+    check_repos(*create_repos(), "http://example.com/b");
+
+    // a changed file is parsed again
+    std::ofstream(reposdir / "b.repo") << "[repo-b]\nenabled=0\nbaseurl=http://example.com/changed\n";
+    check_repos(*create_repos(), "http://example.com/changed");
+}
+
+
+void RepoTest::test_solv_cache() {
+    // Loads the repository in a new Base sharing the cachedir with `base`. The solv files are written
+    // in the background, they are written at the latest when the Base is destroyed.
+    auto load_repo = [&](size_t & packages) {
+        libdnf::Base new_base;
+        new_base.get_config().installroot().set(base.get_config().installroot().get_value());
+        new_base.get_config().cachedir().set(base.get_config().cachedir().get_value());
+        new_base.get_vars()->set("arch", "x86_64");
+        new_base.setup();
+        auto repo = new_base.get_repo_sack()->create_repo("repomd-repo1");
+        repo->get_config().baseurl().set("file://" PROJECT_SOURCE_DIR "/test/data/repos-repomd/repomd-repo1");
+        repo->fetch_metadata();
+        repo->load();
+        packages = libdnf::rpm::PackageQuery(new_base).size();
+        return new_base.get_metrics()->get_spans();
+    };
+
+    auto count_spans = [](const std::vector<libdnf::base::MetricsSpan> & spans, const std::string & name) {
+        return static_cast<size_t>(
+            std::count_if(spans.begin(), spans.end(), [&](const auto & span) { return span.name == name; }));
+    };
+
+    // the first load parses the metadata
+    size_t parsed_packages{0};
+    auto spans = load_repo(parsed_packages);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), count_spans(spans, "repo.parse_primary"));
+
+    // the second load uses the solv files
+    size_t cached_packages{0};
+    spans = load_repo(cached_packages);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), count_spans(spans, "repo.parse_primary"));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), count_spans(spans, "repo.parse_ext"));
+    CPPUNIT_ASSERT(count_spans(spans, "repo.load_solv") > 0);
+    CPPUNIT_ASSERT_EQUAL(parsed_packages, cached_packages);
+}
+
+
+namespace {
+
+// Accessors of private Base::p_impl and Repo::solv_repo, see private_accessor.hpp
+create_private_getter_template;
+create_getter(priv_impl, &libdnf::Base::p_impl);
+create_getter(priv_solv_repo, &libdnf::repo::Repo::solv_repo);
+
+// Returns the results of the lookups reading the filelists and other metadata: the packages owning the files
+// and the changelogs of all the packages.
+std::pair<std::set<std::string>, std::map<std::string, std::vector<std::tuple<time_t, std::string, std::string>>>>
+lookup_ext_metadata(libdnf::Base & base) {
+    std::set<std::string> file_owners;
+    libdnf::rpm::PackageQuery files_query(base);
+    files_query.filter_file({"/etc/pkg.conf.d", "/etc/pkg.conf"});
+    for (const auto & package : files_query) {
+        file_owners.insert(package.get_full_nevra());
+    }
+
+    std::map<std::string, std::vector<std::tuple<time_t, std::string, std::string>>> changelogs;
+    for (const auto & package : libdnf::rpm::PackageQuery(base)) {
+        auto & package_changelogs = changelogs[package.get_full_nevra()];
+        for (const auto & changelog : package.get_changelogs()) {
+            package_changelogs.emplace_back(changelog.timestamp, changelog.author, changelog.text);
+        }
+    }
+
+    return {file_owners, changelogs};
+}
+
+
+// Removes the solv cache files of the `type` of all the repositories in `cachedir`.
+void remove_solvx_files(const std::string & cachedir, const std::string & type) {
+    std::vector<std::filesystem::path> paths;
+    for (const auto & entry : std::filesystem::recursive_directory_iterator(cachedir)) {
+        if (entry.path().filename().native().ends_with("-" + type + ".solvx")) {
+            paths.push_back(entry.path());
+        }
+    }
+    CPPUNIT_ASSERT(!paths.empty());
+    for (const auto & path : paths) {
+        std::filesystem::remove(path);
+    }
+}
+
+}  // namespace
+
+
+void RepoTest::test_release_metadata() {
+    auto repo = add_repo_repomd("repomd-repo1");
+    auto & solv_repo = *((*repo).*get(priv_solv_repo()));
+
+    const auto expected = lookup_ext_metadata(base);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), expected.first.size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), expected.second.at("pkg-0:1.2-3.x86_64").size());
+
+    // the parsed filelists and changelogs are held in memory until they are released
+    const auto memory_use = solv_repo.get_memory_use();
+    repo_sack->release_metadata({libdnf::METADATA_TYPE_FILELISTS, libdnf::METADATA_TYPE_OTHER});
+    const auto released = base.get_metrics()->get_counter("repo.released_metadata_bytes");
+    CPPUNIT_ASSERT(released > 0);
+    CPPUNIT_ASSERT(solv_repo.get_memory_use() < memory_use);
+
+    // the released extensions are read on demand, releasing them again saves nothing
+    repo_sack->release_metadata({libdnf::METADATA_TYPE_FILELISTS, libdnf::METADATA_TYPE_OTHER});
+    CPPUNIT_ASSERT_EQUAL(released, base.get_metrics()->get_counter("repo.released_metadata_bytes"));
+
+    // the released data are read from the solv cache files again
+    CPPUNIT_ASSERT(expected == lookup_ext_metadata(base));
+}
+
+
+void RepoTest::test_release_metadata_missing_cache() {
+    add_repo_repomd("repomd-repo1");
+    const auto cachedir = base.get_config().cachedir().get_value();
+
+    const auto expected = lookup_ext_metadata(base);
+
+    // the solv cache files are written in the background
+    (base.*get(priv_impl()))->get_solv_cache_writer().flush();
+
+    // the filelists without a cache file stay loaded
+    remove_solvx_files(cachedir, libdnf::METADATA_TYPE_FILELISTS);
+    repo_sack->release_metadata({libdnf::METADATA_TYPE_FILELISTS, libdnf::METADATA_TYPE_OTHER});
+
+    // the released other metadata are read from the cache file kept open even after it was removed
+    remove_solvx_files(cachedir, libdnf::METADATA_TYPE_OTHER);
+    CPPUNIT_ASSERT(expected == lookup_ext_metadata(base));
+}
+
+
+void RepoTest::test_load_repos_parsed_in_advance() {
+    // Loads the repositories by the repo sack in a new Base sharing the cachedir with `base`
+    auto load_repos = [&](std::set<std::string> & nevras) {
+        libdnf::Base new_base;
+        new_base.get_config().installroot().set(base.get_config().installroot().get_value());
+        new_base.get_config().cachedir().set(base.get_config().cachedir().get_value());
+        new_base.get_config().optional_metadata_types().set(libdnf::OPTIONAL_METADATA_TYPES);
+        new_base.get_vars()->set("arch", "x86_64");
+        new_base.setup();
+        for (const auto * repoid : {"repomd-repo1", "repomd-duplicate-pkgid"}) {
+            auto repo = new_base.get_repo_sack()->create_repo(repoid);
+            repo->get_config().baseurl().set(
+                std::string("file://" PROJECT_SOURCE_DIR "/test/data/repos-repomd/") + repoid);
+        }
+        libdnf::repo::RepoQuery repos(new_base);
+        new_base.get_repo_sack()->update_and_load_repos(repos);
+
+        for (const auto & package : libdnf::rpm::PackageQuery(new_base)) {
+            nevras.insert(package.get_repo_id() + ":" + package.get_full_nevra());
+        }
+        return std::make_pair(new_base.get_metrics()->get_spans(), lookup_ext_metadata(new_base));
+    };
+
+    auto count_spans = [](const std::vector<libdnf::base::MetricsSpan> & spans, const std::string & name) {
+        return static_cast<size_t>(
+            std::count_if(spans.begin(), spans.end(), [&](const auto & span) { return span.name == name; }));
+    };
+
+    // the primaries are parsed in private pools, the extensions are seeded with the parsed primaries
+    std::set<std::string> parsed_nevras;
+    auto [parsed_spans, parsed_ext] = load_repos(parsed_nevras);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), count_spans(parsed_spans, "repo.parse_primary"));
+
+    // the second load uses the solv files written by the first one
+    std::set<std::string> cached_nevras;
+    auto [cached_spans, cached_ext] = load_repos(cached_nevras);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), count_spans(cached_spans, "repo.parse_primary"));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), count_spans(cached_spans, "repo.parse_ext"));
+    CPPUNIT_ASSERT(!parsed_nevras.empty());
+    CPPUNIT_ASSERT(parsed_nevras == cached_nevras);
+    CPPUNIT_ASSERT(parsed_ext == cached_ext);
+}
+
+
+void RepoTest::test_lock_repo_cache_threads() {
+    using namespace std::chrono_literals;
+    auto & logger = *base.get_logger();
+    const auto path = std::filesystem::path(base.get_config().cachedir().get_value()) / "test.lock";
+
+    // the shared locks of the threads of one process do not exclude each other
+    bool waited;
+    auto shared_lock = libdnf::repo::lock_repo_cache(logger, path, false, waited);
+    CPPUNIT_ASSERT(!waited);
+    auto other_shared_lock = libdnf::repo::lock_repo_cache(logger, path, false, waited);
+    CPPUNIT_ASSERT(!waited);
+
+    // an exclusive lock waits for all of them, as it would for another process
+    std::atomic<bool> acquired{false};
+    bool exclusive_waited{false};
+    std::thread thread([&] {
+        auto exclusive_lock = libdnf::repo::lock_repo_cache(logger, path, true, exclusive_waited);
+        acquired = true;
+    });
+    std::this_thread::sleep_for(100ms);
+    CPPUNIT_ASSERT(!acquired);
+    shared_lock.reset();
+    std::this_thread::sleep_for(100ms);
+    CPPUNIT_ASSERT(!acquired);
+    other_shared_lock.reset();
+    thread.join();
+    CPPUNIT_ASSERT(acquired);
+    CPPUNIT_ASSERT(exclusive_waited);
+}
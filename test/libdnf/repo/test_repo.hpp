@@ -30,12 +30,24 @@ class RepoTest : public BaseTestCase {
     CPPUNIT_TEST(test_load_system_repo);
     CPPUNIT_TEST(test_load_repo);
     CPPUNIT_TEST(test_load_repo_nonexistent);
+    CPPUNIT_TEST(test_create_repos_from_dir);
+    CPPUNIT_TEST(test_solv_cache);
+    CPPUNIT_TEST(test_release_metadata);
+    CPPUNIT_TEST(test_release_metadata_missing_cache);
+    CPPUNIT_TEST(test_load_repos_parsed_in_advance);
+    CPPUNIT_TEST(test_lock_repo_cache_threads);
     CPPUNIT_TEST_SUITE_END();
 
 public:
     void test_load_system_repo();
     void test_load_repo();
     void test_load_repo_nonexistent();
+    void test_create_repos_from_dir();
+    void test_solv_cache();
+    void test_release_metadata();
+    void test_release_metadata_missing_cache();
+    void test_load_repos_parsed_in_advance();
+    void test_lock_repo_cache_threads();
 };
 
 #endif
@@ -0,0 +1,108 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_changelog_reader.hpp"
+
+#include "libdnf/conf/const.hpp"
+#include "libdnf/rpm/changelog_reader.hpp"
+#include "libdnf/rpm/package_query.hpp"
+
+#include <vector>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RpmChangelogReaderTest);
+
+
+namespace {
+
+void check_changelogs(const std::map<libdnf::rpm::Package, std::vector<libdnf::rpm::Changelog>> & changelogs) {
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), changelogs.size());
+    for (const auto & [package, package_changelogs] : changelogs) {
+        if (package.get_name() != "pkg") {
+            CPPUNIT_ASSERT(package_changelogs.empty());
+            continue;
+        }
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), package_changelogs.size());
+        CPPUNIT_ASSERT_EQUAL(static_cast<time_t>(1577836800), package_changelogs[0].timestamp);
+        CPPUNIT_ASSERT_EQUAL(std::string("John Doe <jdoe@example.com> - 1.2-2"), package_changelogs[0].author);
+        CPPUNIT_ASSERT_EQUAL(std::string("- Fix \"foo\" & bar"), package_changelogs[0].text);
+        CPPUNIT_ASSERT_EQUAL(static_cast<time_t>(1580515200), package_changelogs[1].timestamp);
+        CPPUNIT_ASSERT_EQUAL(std::string("John Doe <jdoe@example.com> - 1.2-3"), package_changelogs[1].author);
+        CPPUNIT_ASSERT_EQUAL(std::string("- Update to 1.2\n- Second line"), package_changelogs[1].text);
+    }
+}
+
+}  // namespace
+
+
+void RpmChangelogReaderTest::test_read_from_metadata() {
+    // "other" metadata are downloaded but not loaded into the sack
+    auto repo = add_repo_repomd("repomd-repo1", false);
+    repo->set_download_only_metadata_types({libdnf::METADATA_TYPE_OTHER});
+    repo->fetch_metadata();
+    repo->load();
+    CPPUNIT_ASSERT(!repo->get_metadata_path(libdnf::METADATA_TYPE_OTHER).empty());
+    CPPUNIT_ASSERT(get_pkg("pkg-1.2-3.x86_64").get_changelogs().empty());
+
+    check_changelogs(libdnf::rpm::read_changelogs(libdnf::rpm::PackageQuery(base)));
+}
+
+
+void RpmChangelogReaderTest::test_read_from_sack() {
+    base.get_config().optional_metadata_types().add_item(libdnf::METADATA_TYPE_OTHER);
+    add_repo_repomd("repomd-repo1");
+
+    check_changelogs(libdnf::rpm::read_changelogs(libdnf::rpm::PackageQuery(base)));
+}
+
+
+void RpmChangelogReaderTest::test_read_duplicate_pkgid() {
+    // the repository contains the same package twice, "other" metadata list its pkgid twice as well
+    auto repo = add_repo_repomd("repomd-duplicate-pkgid", false);
+    repo->set_download_only_metadata_types({libdnf::METADATA_TYPE_OTHER});
+    repo->fetch_metadata();
+    repo->load();
+
+    auto changelogs = libdnf::rpm::read_changelogs(libdnf::rpm::PackageQuery(base));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), changelogs.size());
+    for (const auto & [package, package_changelogs] : changelogs) {
+        // the first entry is used for all the packages
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), package_changelogs.size());
+        CPPUNIT_ASSERT_EQUAL(std::string("- Update to 1.2"), package_changelogs[0].text);
+    }
+}
+
+
+void RpmChangelogReaderTest::test_read_markup() {
+    // "other" metadata with comments and CDATA sections, they contain tags which must not be matched
+    auto repo = add_repo_repomd("repomd-changelog-markup", false);
+    repo->set_download_only_metadata_types({libdnf::METADATA_TYPE_OTHER});
+    repo->fetch_metadata();
+    repo->load();
+
+    auto changelogs = libdnf::rpm::read_changelogs(libdnf::rpm::PackageQuery(base));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), changelogs.size());
+    const auto & package_changelogs = changelogs.begin()->second;
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), package_changelogs.size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<time_t>(1577836800), package_changelogs[0].timestamp);
+    CPPUNIT_ASSERT_EQUAL(std::string("- Fix </changelog> & </package> parsing"), package_changelogs[0].text);
+    CPPUNIT_ASSERT_EQUAL(static_cast<time_t>(1580515200), package_changelogs[1].timestamp);
+    CPPUNIT_ASSERT_EQUAL(std::string("- Update <1.2>\n- Keep <this> &amp; as is"), package_changelogs[1].text);
+}
@@ -0,0 +1,46 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef TEST_LIBDNF_RPM_CHANGELOG_READER_HPP
+#define TEST_LIBDNF_RPM_CHANGELOG_READER_HPP
+
+
+#include "base_test_case.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class RpmChangelogReaderTest : public BaseTestCase {
+    CPPUNIT_TEST_SUITE(RpmChangelogReaderTest);
+    CPPUNIT_TEST(test_read_from_metadata);
+    CPPUNIT_TEST(test_read_from_sack);
+    CPPUNIT_TEST(test_read_duplicate_pkgid);
+    CPPUNIT_TEST(test_read_markup);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void test_read_from_metadata();
+    void test_read_from_sack();
+    void test_read_duplicate_pkgid();
+    void test_read_markup();
+};
+
+
+#endif  // TEST_LIBDNF_RPM_CHANGELOG_READER_HPP
@@ -0,0 +1,177 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_dependency_closure.hpp"
+
+#include "utils.hpp"
+
+#include "libdnf/rpm/dependency_closure.hpp"
+#include "libdnf/rpm/package_query.hpp"
+
+#include <vector>
+
+
+using libdnf::rpm::DependencyClosure;
+using libdnf::rpm::DependencyClosureSettings;
+using libdnf::rpm::Package;
+using libdnf::rpm::PackageQuery;
+using libdnf::rpm::PackageSet;
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RpmDependencyClosureTest);
+
+
+void RpmDependencyClosureTest::setUp() {
+    BaseTestCase::setUp();
+    add_repo_solv("solv-dependency-closure");
+}
+
+
+void RpmDependencyClosureTest::test_requires() {
+    DependencyClosure closure(PackageQuery(base), DependencyClosureSettings());
+
+    PackageSet roots(base);
+    roots.add(get_pkg("app-0:1-1.noarch"));
+    auto result = closure.compute(roots);
+
+    // the cycle between lib and base is visited only once
+    std::vector<Package> expected = {
+        get_pkg("app-0:1-1.noarch"), get_pkg("lib-0:1-1.noarch"), get_pkg("base-0:1-1.noarch")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(result));
+
+    CPPUNIT_ASSERT_EQUAL(std::vector<Package>{get_pkg("app-0:1-1.noarch")}, closure.get_roots());
+    CPPUNIT_ASSERT_EQUAL(
+        std::vector<Package>{get_pkg("lib-0:1-1.noarch")}, closure.get_children(get_pkg("app-0:1-1.noarch")));
+    CPPUNIT_ASSERT_EQUAL(
+        std::vector<Package>{get_pkg("base-0:1-1.noarch")}, closure.get_children(get_pkg("lib-0:1-1.noarch")));
+    CPPUNIT_ASSERT(closure.get_children(get_pkg("base-0:1-1.noarch")).empty());
+    CPPUNIT_ASSERT(closure.get_children(get_pkg("tool-0:1-1.noarch")).empty());
+}
+
+
+void RpmDependencyClosureTest::test_weak_deps() {
+    DependencyClosureSettings settings;
+    settings.with_recommends = true;
+    DependencyClosure closure(PackageQuery(base), settings);
+
+    PackageSet roots(base);
+    roots.add(get_pkg("app-0:1-1.noarch"));
+    auto result = closure.compute(roots);
+
+    std::vector<Package> expected = {
+        get_pkg("app-0:1-1.noarch"),
+        get_pkg("lib-0:1-1.noarch"),
+        get_pkg("base-0:1-1.noarch"),
+        get_pkg("extra-0:1-1.noarch")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(result));
+
+    expected = {get_pkg("lib-0:1-1.noarch"), get_pkg("extra-0:1-1.noarch")};
+    CPPUNIT_ASSERT_EQUAL(expected, closure.get_children(get_pkg("app-0:1-1.noarch")));
+}
+
+
+void RpmDependencyClosureTest::test_reverse() {
+    DependencyClosureSettings settings;
+    settings.reverse = true;
+    DependencyClosure closure(PackageQuery(base), settings);
+
+    PackageSet roots(base);
+    roots.add(get_pkg("base-0:1-1.noarch"));
+    auto result = closure.compute(roots);
+
+    std::vector<Package> expected = {
+        get_pkg("app-0:1-1.noarch"),
+        get_pkg("lib-0:1-1.noarch"),
+        get_pkg("base-0:1-1.noarch"),
+        get_pkg("tool-0:1-1.noarch")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(result));
+
+    CPPUNIT_ASSERT_EQUAL(
+        std::vector<Package>{get_pkg("lib-0:1-1.noarch")}, closure.get_children(get_pkg("base-0:1-1.noarch")));
+    expected = {get_pkg("app-0:1-1.noarch"), get_pkg("tool-0:1-1.noarch")};
+    CPPUNIT_ASSERT_EQUAL(expected, closure.get_children(get_pkg("lib-0:1-1.noarch")));
+
+    // the index of the dependants is reused by the next computation
+    settings.with_supplements = true;
+    DependencyClosure weak_closure(PackageQuery(base), settings);
+    roots.clear();
+    roots.add(get_pkg("app-0:1-1.noarch"));
+    expected = {get_pkg("app-0:1-1.noarch"), get_pkg("plugin-0:1-1.noarch")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(weak_closure.compute(roots)));
+    roots.clear();
+    roots.add(get_pkg("extra-0:1-1.noarch"));
+    CPPUNIT_ASSERT_EQUAL(std::vector<Package>{get_pkg("extra-0:1-1.noarch")}, to_vector(weak_closure.compute(roots)));
+    CPPUNIT_ASSERT(weak_closure.get_children(get_pkg("app-0:1-1.noarch")).empty());
+}
+
+
+void RpmDependencyClosureTest::test_max_depth() {
+    DependencyClosureSettings settings;
+    settings.reverse = true;
+    settings.max_depth = 1;
+    DependencyClosure closure(PackageQuery(base), settings);
+
+    PackageSet roots(base);
+    roots.add(get_pkg("base-0:1-1.noarch"));
+
+    std::vector<Package> expected = {get_pkg("lib-0:1-1.noarch"), get_pkg("base-0:1-1.noarch")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(closure.compute(roots)));
+}
+
+
+void RpmDependencyClosureTest::test_universe() {
+    PackageQuery universe(base);
+    universe.filter_name({"tool"}, libdnf::sack::QueryCmp::NEQ);
+
+    DependencyClosureSettings settings;
+    settings.reverse = true;
+    DependencyClosure closure(universe, settings);
+
+    PackageSet roots(base);
+    roots.add(get_pkg("base-0:1-1.noarch"));
+
+    std::vector<Package> expected = {
+        get_pkg("app-0:1-1.noarch"), get_pkg("lib-0:1-1.noarch"), get_pkg("base-0:1-1.noarch")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(closure.compute(roots)));
+}
+
+
+void RpmDependencyClosureTest::test_pool_grown() {
+    DependencyClosureSettings settings;
+    settings.reverse = true;
+    DependencyClosure closure(PackageQuery(base), settings);
+
+    PackageSet roots(base);
+    roots.add(get_pkg("base-0:1-1.noarch"));
+    closure.compute(roots);
+
+    // the packages added after the index was built are covered by the next computation
+    add_repo_solv("solv-repo1");
+    roots.add(get_pkg("pkg-0:1.2-3.x86_64"));
+
+    std::vector<Package> expected = {
+        get_pkg("app-0:1-1.noarch"),
+        get_pkg("lib-0:1-1.noarch"),
+        get_pkg("base-0:1-1.noarch"),
+        get_pkg("tool-0:1-1.noarch"),
+        get_pkg("pkg-0:1.2-3.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(closure.compute(roots)));
+    CPPUNIT_ASSERT(closure.get_children(get_pkg("pkg-0:1.2-3.x86_64")).empty());
+}
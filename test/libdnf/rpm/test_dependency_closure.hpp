@@ -0,0 +1,52 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef TEST_LIBDNF_RPM_DEPENDENCY_CLOSURE_HPP
+#define TEST_LIBDNF_RPM_DEPENDENCY_CLOSURE_HPP
+
+
+#include "base_test_case.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class RpmDependencyClosureTest : public BaseTestCase {
+    CPPUNIT_TEST_SUITE(RpmDependencyClosureTest);
+    CPPUNIT_TEST(test_requires);
+    CPPUNIT_TEST(test_weak_deps);
+    CPPUNIT_TEST(test_reverse);
+    CPPUNIT_TEST(test_max_depth);
+    CPPUNIT_TEST(test_universe);
+    CPPUNIT_TEST(test_pool_grown);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() override;
+
+    void test_requires();
+    void test_weak_deps();
+    void test_reverse();
+    void test_max_depth();
+    void test_universe();
+    void test_pool_grown();
+};
+
+
+#endif  // TEST_LIBDNF_RPM_DEPENDENCY_CLOSURE_HPP
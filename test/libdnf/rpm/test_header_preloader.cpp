@@ -0,0 +1,187 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_header_preloader.hpp"
+
+#include "rpm/header_preloader.hpp"
+#include "rpm/rpm_log_guard.hpp"
+#include "rpm/transaction.hpp"
+#include "utils.hpp"
+
+#include "libdnf/base/goal.hpp"
+#include "libdnf/logger/memory_buffer_logger.hpp"
+#include "libdnf/repo/package_downloader.hpp"
+
+#include <rpm/header.h>
+#include <rpm/rpmlog.h>
+
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HeaderPreloaderTest);
+
+
+namespace {
+
+const std::string RPMS_DIR = PROJECT_BINARY_DIR "/test/data/repos-rpm/";
+
+const std::vector<std::string> PACKAGES = {
+    RPMS_DIR + "rpm-repo1/one-1-1.noarch.rpm",
+    RPMS_DIR + "rpm-repo1/one-2-1.noarch.rpm",
+    RPMS_DIR + "rpm-repo2/two-2-2.noarch.rpm",
+};
+
+// Returns "name-version" of the header and frees it.
+std::string take_name_version(libdnf::rpm::HeaderPreloader & preloader, const std::string & path) {
+    Header header = preloader.take(path);
+    CPPUNIT_ASSERT(header != nullptr);
+    std::string name_version =
+        std::string(headerGetString(header, RPMTAG_NAME)) + "-" + headerGetString(header, RPMTAG_VERSION);
+    headerFree(header);
+    return name_version;
+}
+
+}  // namespace
+
+
+void HeaderPreloaderTest::setUp() {
+    BaseTestCase::setUp();
+    ts = rpmtsCreate();
+    rpmtsSetRootDir(ts, base.get_config().installroot().get_value().c_str());
+}
+
+
+void HeaderPreloaderTest::tearDown() {
+    rpmtsFree(ts);
+    BaseTestCase::tearDown();
+}
+
+
+void HeaderPreloaderTest::test_take_in_any_order() {
+    // the owner of the preloader, installs the rpm log callback
+    libdnf::rpm::Transaction rpm_transaction(base);
+    libdnf::rpm::HeaderPreloader preloader(base.get_weak_ptr(), ts);
+    preloader.start(PACKAGES);
+
+    // every header belongs to its path regardless of the order the workers read them in
+    CPPUNIT_ASSERT_EQUAL(std::string("two-2"), take_name_version(preloader, PACKAGES[2]));
+    CPPUNIT_ASSERT_EQUAL(std::string("one-1"), take_name_version(preloader, PACKAGES[0]));
+    CPPUNIT_ASSERT_EQUAL(std::string("one-2"), take_name_version(preloader, PACKAGES[1]));
+
+    // a taken header is read again synchronously, same as a path that was not scheduled
+    CPPUNIT_ASSERT_EQUAL(std::string("one-1"), take_name_version(preloader, PACKAGES[0]));
+}
+
+
+void HeaderPreloaderTest::test_errors() {
+    const auto corrupt_path = (temp->get_path() / "corrupt.rpm").native();
+    std::ofstream(corrupt_path) << "this is not an rpm package\n";
+    const auto missing_path = (temp->get_path() / "missing.rpm").native();
+
+    libdnf::rpm::Transaction rpm_transaction(base);
+    libdnf::rpm::HeaderPreloader preloader(base.get_weak_ptr(), ts);
+    preloader.start({PACKAGES[0], corrupt_path, missing_path, PACKAGES[1]});
+
+    // the errors are raised for their packages only, the other headers are still read
+    CPPUNIT_ASSERT_EQUAL(std::string("one-1"), take_name_version(preloader, PACKAGES[0]));
+    CPPUNIT_ASSERT_THROW(preloader.take(corrupt_path), libdnf::rpm::TransactionError);
+    CPPUNIT_ASSERT_THROW(preloader.take(missing_path), libdnf::rpm::TransactionError);
+    CPPUNIT_ASSERT_EQUAL(std::string("one-2"), take_name_version(preloader, PACKAGES[1]));
+}
+
+
+void HeaderPreloaderTest::test_unsigned() {
+    // the test packages are not signed, requiring a signature makes them fail the verification
+    rpmtsSetVfyLevel(ts, RPMSIG_SIGNATURE_TYPE);
+    libdnf::rpm::Transaction rpm_transaction(base);
+    libdnf::rpm::HeaderPreloader preloader(base.get_weak_ptr(), ts);
+    preloader.start(PACKAGES);
+
+    for (const auto & path : PACKAGES) {
+        CPPUNIT_ASSERT_THROW(preloader.take(path), libdnf::rpm::TransactionError);
+    }
+}
+
+
+void HeaderPreloaderTest::test_destroy_without_take() {
+    // the workers are stopped and the headers read meanwhile are freed
+    libdnf::rpm::Transaction rpm_transaction(base);
+    libdnf::rpm::HeaderPreloader preloader(base.get_weak_ptr(), ts);
+    preloader.start(PACKAGES);
+    CPPUNIT_ASSERT_EQUAL(std::string("one-2"), take_name_version(preloader, PACKAGES[1]));
+}
+
+
+void HeaderPreloaderTest::test_transaction_fill() {
+    add_repo_rpm("rpm-repo1");
+    add_repo_rpm("rpm-repo2");
+
+    libdnf::Goal goal(base);
+    goal.add_rpm_install("one");
+    goal.add_rpm_install("two");
+    auto transaction = goal.resolve();
+    CPPUNIT_ASSERT_EQUAL(libdnf::GoalProblem::NO_PROBLEM, transaction.get_problems());
+
+    libdnf::repo::PackageDownloader downloader;
+    for (auto & tspkg : transaction.get_transaction_packages()) {
+        downloader.add(tspkg.get_package());
+    }
+    downloader.download(true, true);
+
+    // the headers are read by the preloader of the transaction, under its rpm log guard
+    libdnf::rpm::Transaction rpm_transaction(base);
+    rpm_transaction.preload_headers(transaction);
+    rpm_transaction.fill(transaction);
+    CPPUNIT_ASSERT_EQUAL(0, rpm_transaction.run());
+}
+
+
+void HeaderPreloaderTest::test_rpm_log_capture() {
+    std::vector<libdnf::rpm::RpmLogCapture::Record> records;
+    std::vector<std::string> guard_logs;
+    {
+        // collects the records of the threads which do not capture them
+        libdnf::rpm::RpmLogGuardStrings rpm_log_guard;
+
+        std::thread thread([&records] {
+            libdnf::rpm::RpmLogCapture rpm_log_capture;
+            rpmlog(RPMLOG_WARNING, "captured warning\n");
+            records = rpm_log_capture.release_records();
+        });
+        thread.join();
+        rpmlog(RPMLOG_WARNING, "guard warning\n");
+
+        guard_logs = rpm_log_guard.get_rpm_logs();
+        rpmlogSetCallback(nullptr, nullptr);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(std::vector<std::string>{"guard warning"}, guard_logs);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), records.size());
+    CPPUNIT_ASSERT(records[0].level == libdnf::Logger::Level::WARNING);
+    CPPUNIT_ASSERT_EQUAL(std::string("captured warning"), records[0].message);
+
+    libdnf::MemoryBufferLogger logger(10);
+    libdnf::rpm::RpmLogCapture::log_records(logger, records);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), logger.get_items_count());
+    CPPUNIT_ASSERT_EQUAL(std::string("[rpm] captured warning"), logger.get_item(0).message);
+}
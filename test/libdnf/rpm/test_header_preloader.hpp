@@ -0,0 +1,56 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef TEST_LIBDNF_RPM_HEADER_PRELOADER_HPP
+#define TEST_LIBDNF_RPM_HEADER_PRELOADER_HPP
+
+#include "base_test_case.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <rpm/rpmts.h>
+
+
+class HeaderPreloaderTest : public BaseTestCase {
+    CPPUNIT_TEST_SUITE(HeaderPreloaderTest);
+    CPPUNIT_TEST(test_take_in_any_order);
+    CPPUNIT_TEST(test_errors);
+    CPPUNIT_TEST(test_unsigned);
+    CPPUNIT_TEST(test_destroy_without_take);
+    CPPUNIT_TEST(test_transaction_fill);
+    CPPUNIT_TEST(test_rpm_log_capture);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() override;
+    void tearDown() override;
+
+    void test_take_in_any_order();
+    void test_errors();
+    void test_unsigned();
+    void test_destroy_without_take();
+    void test_transaction_fill();
+    void test_rpm_log_capture();
+
+private:
+    rpmts ts{nullptr};
+};
+
+
+#endif  // TEST_LIBDNF_RPM_HEADER_PRELOADER_HPP
@@ -24,6 +24,8 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libdnf/rpm/nevra.hpp"
 
+#include <string>
+#include <string_view>
 #include <vector>
 
 
@@ -322,3 +324,53 @@ void RpmPackageTest::test_to_full_nevra_string() {
     auto pkg2 = get_pkg("pkg-libs-1:1.3-4.x86_64");
     CPPUNIT_ASSERT_EQUAL(std::string("pkg-libs-1:1.3-4.x86_64"), libdnf::rpm::to_full_nevra_string(pkg2));
 }
+
+
+void RpmPackageTest::test_string_views() {
+    // the views must match the copying getters
+    for (const auto & nevra : {"pkg-1.2-3.x86_64", "pkg-libs-1:1.3-4.x86_64", "unresolvable-1:2-3.noarch"}) {
+        auto pkg = get_pkg(nevra);
+        CPPUNIT_ASSERT_EQUAL(pkg.get_name(), std::string(pkg.get_name_view()));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_epoch(), std::string(pkg.get_epoch_view()));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_version(), std::string(pkg.get_version_view()));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_release(), std::string(pkg.get_release_view()));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_arch(), std::string(pkg.get_arch_view()));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_evr(), std::string(pkg.get_evr_view()));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_repo_id(), std::string(pkg.get_repo_id_view()));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_summary(), std::string(pkg.get_summary_view()));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_url(), std::string(pkg.get_url_view()));
+        CPPUNIT_ASSERT_EQUAL(pkg.get_license(), std::string(pkg.get_license_view()));
+    }
+
+    auto pkg = get_pkg("pkg-libs-1:1.3-4.x86_64");
+    CPPUNIT_ASSERT_EQUAL(std::string_view("1"), pkg.get_epoch_view());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("1.3"), pkg.get_version_view());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("4"), pkg.get_release_view());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("repomd-repo1"), pkg.get_repo_id_view());
+}
+
+
+void RpmPackageTest::test_append_nevra() {
+    std::string buffer("prefix ");
+    get_pkg("pkg-1.2-3.x86_64").append_nevra(buffer);
+    buffer.append(" ");
+    get_pkg("pkg-1.2-3.x86_64").append_full_nevra(buffer);
+    buffer.append(" ");
+    get_pkg("pkg-libs-1:1.3-4.x86_64").append_full_nevra(buffer);
+    CPPUNIT_ASSERT_EQUAL(std::string("prefix pkg-1.2-3.x86_64 pkg-0:1.2-3.x86_64 pkg-libs-1:1.3-4.x86_64"), buffer);
+}
+
+
+void RpmPackageTest::test_cmp_nevra() {
+    // the specializations for Package compare the pool strings, the result must match the generic comparators
+    auto pkg = get_pkg("pkg-1.2-3.x86_64");
+    auto pkg_libs = get_pkg("pkg-libs-1:1.3-4.x86_64");
+    auto unresolvable = get_pkg("unresolvable-1:2-3.noarch");
+
+    CPPUNIT_ASSERT(libdnf::rpm::cmp_nevra(pkg, pkg_libs));
+    CPPUNIT_ASSERT(!libdnf::rpm::cmp_nevra(pkg_libs, pkg));
+    CPPUNIT_ASSERT(!libdnf::rpm::cmp_nevra(pkg, pkg));
+    CPPUNIT_ASSERT(libdnf::rpm::cmp_naevr(pkg_libs, unresolvable));
+    CPPUNIT_ASSERT(!libdnf::rpm::cmp_naevr(unresolvable, pkg_libs));
+    CPPUNIT_ASSERT(!libdnf::rpm::cmp_naevr(unresolvable, unresolvable));
+}
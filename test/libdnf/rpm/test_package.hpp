@@ -75,6 +75,10 @@ class RpmPackageTest : public BaseTestCase {
 
     CPPUNIT_TEST(test_to_nevra_string);
     CPPUNIT_TEST(test_to_full_nevra_string);
+
+    CPPUNIT_TEST(test_string_views);
+    CPPUNIT_TEST(test_append_nevra);
+    CPPUNIT_TEST(test_cmp_nevra);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -126,6 +130,10 @@ public:
 
     void test_to_nevra_string();
     void test_to_full_nevra_string();
+
+    void test_string_views();
+    void test_append_nevra();
+    void test_cmp_nevra();
 };
 
 
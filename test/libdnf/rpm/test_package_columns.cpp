@@ -0,0 +1,116 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_package_columns.hpp"
+
+#include "utils.hpp"
+
+#include "libdnf/rpm/package_columns.hpp"
+#include "libdnf/rpm/package_formatter.hpp"
+#include "libdnf/rpm/package_query.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+using libdnf::rpm::PackageColumns;
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RpmPackageColumnsTest);
+
+
+void RpmPackageColumnsTest::setUp() {
+    BaseTestCase::setUp();
+    add_repo_repomd("repomd-repo1");
+}
+
+
+void RpmPackageColumnsTest::test_columns() {
+    libdnf::rpm::PackageQuery query(base);
+    PackageColumns columns(query, {"name", "evr", "arch", "repoid", "installsize", "name"});
+
+    // duplicate attributes are exported once
+    CPPUNIT_ASSERT_EQUAL(
+        std::vector<std::string>({"name", "evr", "arch", "repoid", "installsize"}), columns.get_attributes());
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(3), columns.size());
+
+    std::vector<int> expected_ids;
+    for (const auto & pkg : query) {
+        expected_ids.push_back(pkg.get_id().id);
+    }
+    CPPUNIT_ASSERT_EQUAL(expected_ids, columns.get_ids());
+
+    CPPUNIT_ASSERT_EQUAL(std::vector<std::string>({"pkg", "pkg-libs", "unresolvable"}), columns.get_strings("name"));
+    CPPUNIT_ASSERT_EQUAL(std::vector<uint32_t>({0, 1, 2}), columns.get_string_indexes("name"));
+    CPPUNIT_ASSERT_EQUAL(std::vector<std::string>({"1.2-3", "1:1.3-4", "1:2-3"}), columns.get_strings("evr"));
+
+    // repeated values are stored once
+    CPPUNIT_ASSERT_EQUAL(std::vector<std::string>({"x86_64", "noarch"}), columns.get_strings("arch"));
+    CPPUNIT_ASSERT_EQUAL(std::vector<uint32_t>({0, 0, 1}), columns.get_string_indexes("arch"));
+    CPPUNIT_ASSERT_EQUAL(std::vector<std::string>({"repomd-repo1"}), columns.get_strings("repoid"));
+    CPPUNIT_ASSERT_EQUAL(std::vector<uint32_t>({0, 0, 0}), columns.get_string_indexes("repoid"));
+
+    CPPUNIT_ASSERT(!columns.is_number("name"));
+    CPPUNIT_ASSERT(columns.is_number("installsize"));
+    CPPUNIT_ASSERT_EQUAL(std::vector<uint64_t>({222, 222, 222}), columns.get_numbers("installsize"));
+}
+
+
+void RpmPackageColumnsTest::test_all_attributes() {
+    // every string attribute has the same value as the query format tag of the same name
+    libdnf::rpm::PackageQuery query(base);
+    auto attributes = PackageColumns::get_string_attributes();
+    PackageColumns columns(query, attributes);
+    for (const auto & attribute : attributes) {
+        libdnf::rpm::PackageFormatter formatter("%{" + attribute + "}");
+        const auto & strings = columns.get_strings(attribute);
+        const auto & indexes = columns.get_string_indexes(attribute);
+        std::size_t row = 0;
+        for (const auto & pkg : query) {
+            CPPUNIT_ASSERT_EQUAL(formatter.format(pkg), strings[indexes[row++]]);
+        }
+    }
+
+    PackageColumns numbers(query, PackageColumns::get_number_attributes());
+    CPPUNIT_ASSERT_EQUAL(std::vector<uint64_t>({111, 111, 111}), numbers.get_numbers("downloadsize"));
+    CPPUNIT_ASSERT_EQUAL(std::vector<uint64_t>({456, 456, 456}), numbers.get_numbers("buildtime"));
+    CPPUNIT_ASSERT_EQUAL(std::vector<uint64_t>({0, 0, 0}), numbers.get_numbers("installtime"));
+
+    // the attributes are exactly the query format tags
+    auto number_attributes = PackageColumns::get_number_attributes();
+    attributes.insert(attributes.end(), number_attributes.begin(), number_attributes.end());
+    auto tags = libdnf::rpm::PackageFormatter::get_tags();
+    std::sort(attributes.begin(), attributes.end());
+    std::sort(tags.begin(), tags.end());
+    CPPUNIT_ASSERT_EQUAL(tags, attributes);
+}
+
+
+void RpmPackageColumnsTest::test_invalid_attribute() {
+    libdnf::rpm::PackageQuery query(base);
+    CPPUNIT_ASSERT_THROW(PackageColumns(query, {"unknown"}), libdnf::rpm::PackageColumnsError);
+
+    PackageColumns columns(query, {"name", "installsize"});
+    CPPUNIT_ASSERT_THROW(columns.get_strings("arch"), libdnf::rpm::PackageColumnsError);
+    CPPUNIT_ASSERT_THROW(columns.get_strings("installsize"), libdnf::rpm::PackageColumnsError);
+    CPPUNIT_ASSERT_THROW(columns.get_numbers("name"), libdnf::rpm::PackageColumnsError);
+}
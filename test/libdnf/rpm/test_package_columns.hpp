@@ -0,0 +1,46 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef TEST_LIBDNF_RPM_PACKAGE_COLUMNS_HPP
+#define TEST_LIBDNF_RPM_PACKAGE_COLUMNS_HPP
+
+
+#include "base_test_case.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class RpmPackageColumnsTest : public BaseTestCase {
+    CPPUNIT_TEST_SUITE(RpmPackageColumnsTest);
+    CPPUNIT_TEST(test_columns);
+    CPPUNIT_TEST(test_all_attributes);
+    CPPUNIT_TEST(test_invalid_attribute);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() override;
+
+    void test_columns();
+    void test_all_attributes();
+    void test_invalid_attribute();
+};
+
+
+#endif  // TEST_LIBDNF_RPM_PACKAGE_COLUMNS_HPP
@@ -0,0 +1,108 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_package_formatter.hpp"
+
+#include "libdnf/rpm/package_formatter.hpp"
+#include "libdnf/repo/repo.hpp"
+#include "libdnf/rpm/package_query.hpp"
+
+#include <sstream>
+
+
+using libdnf::rpm::PackageFormatter;
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RpmPackageFormatterTest);
+
+
+void RpmPackageFormatterTest::setUp() {
+    BaseTestCase::setUp();
+    add_repo_repomd("repomd-repo1");
+}
+
+
+void RpmPackageFormatterTest::test_tags() {
+    auto pkg = get_pkg("pkg-1.2-3.x86_64");
+
+    CPPUNIT_ASSERT_EQUAL(
+        std::string("pkg 0 1.2 3 x86_64 1.2-3 pkg-1.2-3.x86_64 pkg-0:1.2-3.x86_64"),
+        PackageFormatter("%{name} %{epoch} %{version} %{release} %{arch} %{evr} %{nevra} %{full_nevra}").format(pkg));
+    CPPUNIT_ASSERT_EQUAL(
+        std::string("repomd-repo1 111 222 456 pkg-1.2-3.src.rpm"),
+        PackageFormatter("%{repoid} %{downloadsize} %{installsize} %{buildtime} %{sourcerpm}").format(pkg));
+    // packages of available repositories have no install time
+    CPPUNIT_ASSERT_EQUAL(std::string("0"), PackageFormatter("%{installtime}").format(pkg));
+    CPPUNIT_ASSERT_EQUAL(
+        std::string("Summary|Description|http://example.com/|License|Packager|Vendor|Group|pkg-1.2-3.x86_64.rpm"),
+        PackageFormatter("%{summary}|%{description}|%{url}|%{license}|%{packager}|%{vendor}|%{group}|%{location}")
+            .format(pkg));
+    CPPUNIT_ASSERT_EQUAL(pkg.get_repo()->get_name(), PackageFormatter("%{reponame}").format(pkg));
+    // the translatable tags are looked up like the Package getters
+    CPPUNIT_ASSERT_EQUAL(pkg.get_summary(), PackageFormatter("%{summary}").format(pkg));
+    CPPUNIT_ASSERT_EQUAL(pkg.get_description(), PackageFormatter("%{description}").format(pkg));
+
+    CPPUNIT_ASSERT_EQUAL(
+        std::string("pkg-libs-1:1.3-4.x86_64 1"),
+        PackageFormatter("%{full_nevra} %{epoch}").format(get_pkg("pkg-libs-1:1.3-4.x86_64")));
+}
+
+
+void RpmPackageFormatterTest::test_width() {
+    auto pkg = get_pkg("pkg-1.2-3.x86_64");
+
+    CPPUNIT_ASSERT_EQUAL(std::string("[   pkg][pkg   ]"), PackageFormatter("[%6{name}][%-6{name}]").format(pkg));
+    // values longer than the width are not truncated
+    CPPUNIT_ASSERT_EQUAL(std::string("pkg-0:1.2-3.x86_64|"), PackageFormatter("%2{full_nevra}|").format(pkg));
+    CPPUNIT_ASSERT_EQUAL(std::string("  pkg-0:1.2-3.x86_64"), PackageFormatter("%20{full_nevra}").format(pkg));
+}
+
+
+void RpmPackageFormatterTest::test_escapes() {
+    auto pkg = get_pkg("pkg-1.2-3.x86_64");
+
+    CPPUNIT_ASSERT_EQUAL(std::string("pkg\t100%\\\n"), PackageFormatter("%{name}\\t100%%\\\\\\n").format(pkg));
+    CPPUNIT_ASSERT_EQUAL(std::string("\\x pkg"), PackageFormatter("\\x %{name}").format(pkg));
+
+    std::string output("prefix:");
+    PackageFormatter("%{name}").format(pkg, output);
+    CPPUNIT_ASSERT_EQUAL(std::string("prefix:pkg"), output);
+}
+
+
+void RpmPackageFormatterTest::test_invalid_format() {
+    CPPUNIT_ASSERT_THROW(PackageFormatter("%{unknown}"), libdnf::rpm::PackageFormatterError);
+    CPPUNIT_ASSERT_THROW(PackageFormatter("%{name"), libdnf::rpm::PackageFormatterError);
+    CPPUNIT_ASSERT_THROW(PackageFormatter("%name"), libdnf::rpm::PackageFormatterError);
+    CPPUNIT_ASSERT_THROW(PackageFormatter("%{name} %"), libdnf::rpm::PackageFormatterError);
+    // field widths over the maximum and over the range of the width
+    CPPUNIT_ASSERT_THROW(PackageFormatter("%4097{name}"), libdnf::rpm::PackageFormatterError);
+    CPPUNIT_ASSERT_THROW(PackageFormatter("%-99999999999999999999999{name}"), libdnf::rpm::PackageFormatterError);
+}
+
+
+void RpmPackageFormatterTest::test_format_package_set() {
+    libdnf::rpm::PackageQuery query(base);
+    query.filter_name({"pkg", "pkg-libs"});
+
+    std::ostringstream output;
+    PackageFormatter("%-10{name} %{evr}\\n").format(query, output);
+    CPPUNIT_ASSERT_EQUAL(std::string("pkg        1.2-3\npkg-libs   1:1.3-4\n"), output.str());
+}
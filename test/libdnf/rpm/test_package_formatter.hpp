@@ -0,0 +1,50 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef TEST_LIBDNF_RPM_PACKAGE_FORMATTER_HPP
+#define TEST_LIBDNF_RPM_PACKAGE_FORMATTER_HPP
+
+
+#include "base_test_case.hpp"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class RpmPackageFormatterTest : public BaseTestCase {
+    CPPUNIT_TEST_SUITE(RpmPackageFormatterTest);
+    CPPUNIT_TEST(test_tags);
+    CPPUNIT_TEST(test_width);
+    CPPUNIT_TEST(test_escapes);
+    CPPUNIT_TEST(test_invalid_format);
+    CPPUNIT_TEST(test_format_package_set);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() override;
+
+    void test_tags();
+    void test_width();
+    void test_escapes();
+    void test_invalid_format();
+    void test_format_package_set();
+};
+
+
+#endif  // TEST_LIBDNF_RPM_PACKAGE_FORMATTER_HPP
@@ -275,6 +275,99 @@ void RpmPackageQueryTest::test_filter_name() {
     CPPUNIT_ASSERT_EQUAL(expected, to_vector(query9));
 }
 
+void RpmPackageQueryTest::test_filter_text_attributes() {
+    // the repository is loaded from xml metadata, substring filters are served from its search index
+    add_repo_repomd("repomd-repo1");
+
+    std::vector<Package> all = {
+        get_pkg("pkg-0:1.2-3.x86_64"), get_pkg("pkg-libs-1:1.3-4.x86_64"), get_pkg("unresolvable-1:2-3.noarch")};
+    std::vector<Package> none = {};
+
+    // packages with Summary that contain "ummar"
+    PackageQuery query1(base);
+    query1.filter_summary({"ummar"}, libdnf::sack::QueryCmp::CONTAINS);
+    CPPUNIT_ASSERT_EQUAL(all, to_vector(query1));
+
+    // the index is case insensitive, case sensitive matches must still be verified
+    PackageQuery query2(base);
+    query2.filter_summary({"UMMAR"}, libdnf::sack::QueryCmp::CONTAINS);
+    CPPUNIT_ASSERT_EQUAL(none, to_vector(query2));
+
+    // packages with Summary that contain "UMMAR" - case insensitive match
+    PackageQuery query3(base);
+    query3.filter_summary({"UMMAR"}, libdnf::sack::QueryCmp::ICONTAINS);
+    CPPUNIT_ASSERT_EQUAL(all, to_vector(query3));
+
+    // packages with Description that contain "descriptions" - case insensitive match
+    PackageQuery query4(base);
+    query4.filter_description({"descriptions"}, libdnf::sack::QueryCmp::ICONTAINS);
+    CPPUNIT_ASSERT_EQUAL(none, to_vector(query4));
+
+    // pattern shorter than a gram
+    PackageQuery query5(base);
+    query5.filter_description({"on"}, libdnf::sack::QueryCmp::CONTAINS);
+    CPPUNIT_ASSERT_EQUAL(all, to_vector(query5));
+
+    // packages with Url that contain "example.com"
+    PackageQuery query6(base);
+    query6.filter_url({"example.com"}, libdnf::sack::QueryCmp::CONTAINS);
+    CPPUNIT_ASSERT_EQUAL(all, to_vector(query6));
+
+    // packages with Name that contain "resolv" - case insensitive match
+    PackageQuery query7(base);
+    query7.filter_name({"RESOLV"}, libdnf::sack::QueryCmp::ICONTAINS);
+    std::vector<Package> expected = {get_pkg("unresolvable-1:2-3.noarch")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query7));
+}
+
+void RpmPackageQueryTest::test_filter_file() {
+    // the repository is loaded with filelists, file filters are served from its file index
+    add_repo_repomd("repomd-repo1");
+
+    std::vector<Package> expected = {get_pkg("pkg-0:1.2-3.x86_64")};
+    std::vector<Package> none = {};
+
+    // exact path
+    PackageQuery query1(base);
+    query1.filter_file({"/etc/pkg.conf"});
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query1));
+
+    // a prefix of an existing path is not a match
+    PackageQuery query2(base);
+    query2.filter_file({"/etc/pkg"});
+    CPPUNIT_ASSERT_EQUAL(none, to_vector(query2));
+
+    // glob with a literal prefix, the candidates from the index must be verified
+    PackageQuery query3(base);
+    query3.filter_file({"/etc/pkg.conf.?"}, libdnf::sack::QueryCmp::GLOB);
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query3));
+
+    PackageQuery query4(base);
+    query4.filter_file({"/etc/pkg.conf.?x"}, libdnf::sack::QueryCmp::GLOB);
+    CPPUNIT_ASSERT_EQUAL(none, to_vector(query4));
+
+    // wildcards match '/' as well
+    PackageQuery query5(base);
+    query5.filter_file({"/e*.d"}, libdnf::sack::QueryCmp::GLOB);
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query5));
+
+    // glob without a literal prefix is not looked up in the index
+    PackageQuery query6(base);
+    query6.filter_file({"*/pkg.conf"}, libdnf::sack::QueryCmp::GLOB);
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query6));
+
+    PackageQuery query7(base);
+    query7.filter_file({"/etc/pkg.conf"}, libdnf::sack::QueryCmp::NEQ);
+    std::vector<Package> others = {get_pkg("pkg-libs-1:1.3-4.x86_64"), get_pkg("unresolvable-1:2-3.noarch")};
+    CPPUNIT_ASSERT_EQUAL(others, to_vector(query7));
+
+    // file spec resolution
+    PackageQuery query8(base);
+    libdnf::ResolveSpecSettings settings{.with_nevra = false, .with_provides = false};
+    CPPUNIT_ASSERT(query8.resolve_pkg_spec("/etc/pkg.conf.d", settings, false).first);
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query8));
+}
+
 void RpmPackageQueryTest::test_filter_name_packgset() {
     add_repo_solv("solv-repo1");
 
@@ -35,6 +35,8 @@ class RpmPackageQueryTest : public BaseTestCase {
     CPPUNIT_TEST(test_filter_latest_evr);
     CPPUNIT_TEST(test_filter_earliest_evr);
     CPPUNIT_TEST(test_filter_name);
+    CPPUNIT_TEST(test_filter_text_attributes);
+    CPPUNIT_TEST(test_filter_file);
     CPPUNIT_TEST(test_filter_name_packgset);
     CPPUNIT_TEST(test_filter_nevra_packgset);
     CPPUNIT_TEST(test_filter_name_arch);
@@ -67,6 +69,8 @@ public:
     void test_filter_latest_evr();
     void test_filter_earliest_evr();
     void test_filter_name();
+    void test_filter_text_attributes();
+    void test_filter_file();
     void test_filter_name_packgset();
     void test_filter_nevra_packgset();
     void test_filter_name_arch();
@@ -0,0 +1,186 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "test_scriptlet_output.hpp"
+
+#include "rpm/scriptlet_output.hpp"
+#include "utils/fs/file.hpp"
+
+#include "libdnf/logger/memory_buffer_logger.hpp"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ScriptletOutputTest);
+
+
+namespace {
+
+void write_all(int fd, const std::string & data) {
+    std::size_t pos = 0;
+    while (pos < data.size()) {
+        auto len = write(fd, data.data() + pos, data.size() - pos);
+        CPPUNIT_ASSERT(len > 0);
+        pos += static_cast<std::size_t>(len);
+    }
+}
+
+
+/// Collects the output passed to the handler of a scriptlet.
+class OutputCollector {
+public:
+    libdnf::rpm::ScriptletOutput::OutputHandler get_handler() {
+        return [this](std::string_view output) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                this->output.append(output);
+            }
+            output_received.notify_all();
+        };
+    }
+
+    std::string get_output() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return output;
+    }
+
+    /// Waits until the collected output is `expected`.
+    bool wait_for(const std::string & expected) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return output_received.wait_for(lock, std::chrono::seconds(10), [&] { return output == expected; });
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable output_received;
+    std::string output;
+};
+
+}  // namespace
+
+
+void ScriptletOutputTest::setUp() {
+    CppUnit::TestCase::setUp();
+    temp_dir = std::make_unique<libdnf::utils::fs::TempDir>("libdnf_test_scriptlet_output");
+}
+
+
+void ScriptletOutputTest::tearDown() {
+    temp_dir.reset();
+    CppUnit::TestCase::tearDown();
+}
+
+
+void ScriptletOutputTest::test_attribution() {
+    libdnf::MemoryBufferLogger logger(100);
+    auto log_path = temp_dir->get_path() / "log" / "scriptlets.log";
+    libdnf::rpm::ScriptletOutput output(logger, log_path);
+    auto fd = output.start();
+    CPPUNIT_ASSERT(fd != -1);
+
+    OutputCollector collector;
+    write_all(fd, "before\n");
+    output.script_start("post-install pkg-1.2-3.x86_64", collector.get_handler());
+    write_all(fd, "first\nsecond ");
+    write_all(fd, "line\nunterminated");
+    output.script_stop();
+    CPPUNIT_ASSERT_EQUAL(std::string("first\nsecond line\nunterminated\n"), collector.get_output());
+    write_all(fd, "after\n");
+    close(fd);
+    output.finish();
+
+    CPPUNIT_ASSERT_EQUAL(
+        std::string("[scriptlet] before\n"
+                    "[post-install pkg-1.2-3.x86_64] first\n"
+                    "[post-install pkg-1.2-3.x86_64] second line\n"
+                    "[post-install pkg-1.2-3.x86_64] unterminated\n"
+                    "[scriptlet] after\n"),
+        libdnf::utils::fs::File(log_path, "r").read());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), logger.get_items_count());
+}
+
+
+void ScriptletOutputTest::test_long_line() {
+    libdnf::MemoryBufferLogger logger(100);
+    libdnf::rpm::ScriptletOutput output(logger, temp_dir->get_path() / "scriptlets.log");
+    auto fd = output.start();
+    CPPUNIT_ASSERT(fd != -1);
+
+    // the line does not fit into the buffer, it is split
+    OutputCollector collector;
+    const std::string line(libdnf::rpm::ScriptletOutput::BUFFER_SIZE + 10, 'x');
+    output.script_start("post-install pkg-1.2-3.x86_64", collector.get_handler());
+    write_all(fd, line + "\n");
+    auto expected = line;
+    expected.insert(libdnf::rpm::ScriptletOutput::BUFFER_SIZE, 1, '\n');
+    expected.push_back('\n');
+    output.script_stop();
+    CPPUNIT_ASSERT(expected == collector.get_output());
+    close(fd);
+    output.finish();
+}
+
+
+void ScriptletOutputTest::test_log_to_logger() {
+    libdnf::MemoryBufferLogger logger(100);
+    libdnf::rpm::ScriptletOutput output(logger, "");
+    auto fd = output.start();
+    CPPUNIT_ASSERT(fd != -1);
+
+    OutputCollector collector;
+    output.script_start("pre-install pkg-1.2-3.x86_64", collector.get_handler());
+    write_all(fd, "message\n");
+    output.script_stop();
+    CPPUNIT_ASSERT_EQUAL(std::string("message\n"), collector.get_output());
+    close(fd);
+    output.finish();
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), logger.get_items_count());
+    CPPUNIT_ASSERT_EQUAL(std::string("[pre-install pkg-1.2-3.x86_64] message"), logger.get_item(0).message);
+}
+
+
+void ScriptletOutputTest::test_streaming() {
+    libdnf::MemoryBufferLogger logger(100);
+    libdnf::rpm::ScriptletOutput output(logger, temp_dir->get_path() / "scriptlets.log");
+    auto fd = output.start();
+    CPPUNIT_ASSERT(fd != -1);
+
+    // the output is passed to the handler by the reading thread while the scriptlet runs
+    OutputCollector collector;
+    output.script_start("post-install pkg-1.2-3.x86_64", collector.get_handler());
+    write_all(fd, "first\n");
+    CPPUNIT_ASSERT(collector.wait_for("first\n"));
+    write_all(fd, "second\n");
+    CPPUNIT_ASSERT(collector.wait_for("first\nsecond\n"));
+    output.script_stop();
+
+    // the output after the end of the scriptlet is not passed to its handler
+    write_all(fd, "after\n");
+    close(fd);
+    output.finish();
+    CPPUNIT_ASSERT_EQUAL(std::string("first\nsecond\n"), collector.get_output());
+}
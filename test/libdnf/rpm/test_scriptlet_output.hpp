@@ -0,0 +1,55 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+
+#ifndef TEST_LIBDNF_RPM_SCRIPTLET_OUTPUT_HPP
+#define TEST_LIBDNF_RPM_SCRIPTLET_OUTPUT_HPP
+
+#include "utils/fs/temp.hpp"
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <memory>
+
+
+class ScriptletOutputTest : public CppUnit::TestCase {
+    CPPUNIT_TEST_SUITE(ScriptletOutputTest);
+    CPPUNIT_TEST(test_attribution);
+    CPPUNIT_TEST(test_long_line);
+    CPPUNIT_TEST(test_log_to_logger);
+    CPPUNIT_TEST(test_streaming);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() override;
+    void tearDown() override;
+
+    void test_attribution();
+    void test_long_line();
+    void test_log_to_logger();
+    void test_streaming();
+
+private:
+    std::unique_ptr<libdnf::utils::fs::TempDir> temp_dir;
+};
+
+
+#endif  // TEST_LIBDNF_RPM_SCRIPTLET_OUTPUT_HPP
@@ -26,8 +26,15 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 #include "libdnf/base/goal.hpp"
 #include "libdnf/base/transaction_package.hpp"
 #include "libdnf/repo/package_downloader.hpp"
+#include "libdnf/rpm/package_query.hpp"
 #include "libdnf/rpm/transaction_callbacks.hpp"
 
+#include <json.h>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+
 
 CPPUNIT_TEST_SUITE_REGISTRATION(RpmTransactionTest);
 
@@ -117,3 +124,137 @@ void RpmTransactionTest::test_transaction() {
     CPPUNIT_ASSERT_EQUAL(libdnf::base::Transaction::TransactionRunResult::SUCCESS, res);
     // TODO(lukash) assert the packages were installed
 }
+
+
+namespace {
+
+std::size_t count_spans(const libdnf::base::Metrics & metrics, const std::string & name) {
+    auto spans = metrics.get_spans();
+    return static_cast<std::size_t>(std::count_if(spans.begin(), spans.end(), [&name](const auto & span) {
+        return span.finished && span.name == name;
+    }));
+}
+
+}  // namespace
+
+
+libdnf::base::Transaction::TransactionRunResult RpmTransactionTest::run_transaction(
+    const std::string & spec, bool install) {
+    libdnf::Goal goal(base);
+    if (install) {
+        goal.add_rpm_install(spec);
+    } else {
+        goal.add_rpm_remove(spec);
+    }
+    auto transaction = goal.resolve();
+    CPPUNIT_ASSERT_EQUAL(libdnf::GoalProblem::NO_PROBLEM, transaction.get_problems());
+
+    libdnf::repo::PackageDownloader downloader;
+    for (auto & tspkg : transaction.get_transaction_packages()) {
+        if (transaction_item_action_is_inbound(tspkg.get_action())) {
+            downloader.add(tspkg.get_package());
+        }
+    }
+    downloader.download(true, true);
+
+    auto res = transaction.run(std::make_unique<libdnf::rpm::TransactionCallbacks>(), spec, std::nullopt, std::nullopt);
+    repo_sack->update_system_repo(transaction);
+    return res;
+}
+
+
+void RpmTransactionTest::test_transaction_test_never() {
+    add_repo_rpm("rpm-repo1");
+    base.get_config().test_transaction().set(libdnf::Option::Priority::RUNTIME, "never");
+
+    auto res = run_transaction("one", true);
+
+    CPPUNIT_ASSERT_EQUAL(libdnf::base::Transaction::TransactionRunResult::SUCCESS, res);
+    auto & metrics = *base.get_metrics();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), count_spans(metrics, "transaction.test"));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), count_spans(metrics, "transaction.rpm"));
+}
+
+
+void RpmTransactionTest::test_update_system_repo() {
+    add_repo_rpm("rpm-repo1");
+    repo_sack->get_system_repo()->load();
+
+    // queries created before the update, their maps are sized to the old number of solvables
+    PackageQuery old_query(base);
+    PackageQuery old_installed(base);
+    old_installed.filter_installed();
+    CPPUNIT_ASSERT(old_installed.empty());
+    PackageQuery available_one(base);
+    available_one.filter_name({"one"});
+    const auto available = to_vector(available_one);
+
+    CPPUNIT_ASSERT_EQUAL(libdnf::base::Transaction::TransactionRunResult::SUCCESS, run_transaction("one", true));
+
+    // the installed package is added to the system repo, new queries see it
+    PackageQuery installed(base);
+    installed.filter_installed();
+    std::vector<Package> expected = {get_pkg("one-0:2-1.noarch", true)};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(installed));
+
+    // the old queries do not contain the new solvable, but can be filtered and combined with the new ones
+    PackageQuery old_filtered(old_query);
+    old_filtered.filter_installed();
+    CPPUNIT_ASSERT(old_filtered.empty());
+    old_filtered = old_query;
+    old_filtered.filter_name({"one"});
+    CPPUNIT_ASSERT_EQUAL(available, to_vector(old_filtered));
+    old_installed |= installed;
+    old_installed.filter_installed();
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(old_installed));
+
+    CPPUNIT_ASSERT_EQUAL(libdnf::base::Transaction::TransactionRunResult::SUCCESS, run_transaction("one", false));
+
+    // the solvable of the removed package is freed, neither new nor old queries match it
+    CPPUNIT_ASSERT_EQUAL(old_query.size(), PackageQuery(base).size());
+    PackageQuery query(base);
+    query.filter_installed();
+    CPPUNIT_ASSERT(query.empty());
+    query = PackageQuery(base);
+    query.filter_name({"one"});
+    CPPUNIT_ASSERT_EQUAL(available, to_vector(query));
+    installed.filter_installed();
+    CPPUNIT_ASSERT(installed.empty());
+    old_installed.filter_name({"one"});
+    old_installed.filter_installed();
+    CPPUNIT_ASSERT(old_installed.empty());
+}
+
+
+// Compares the wall time of install and remove transactions with the test run of the rpm transaction
+// done before the history record is started (the default) and skipped.
+void RpmTransactionTest::test_transaction_test_modes_performance() {
+    constexpr int ROUNDS = 20;
+
+    add_repo_rpm("rpm-repo1");
+    repo_sack->get_system_repo()->load();
+    auto & metrics = *base.get_metrics();
+
+    auto * root = json_object_new_object();
+    for (const char * mode : std::array{"always", "never"}) {
+        base.get_config().test_transaction().set(libdnf::Option::Priority::RUNTIME, mode);
+        metrics.clear();
+        for (int round = 0; round < ROUNDS; ++round) {
+            CPPUNIT_ASSERT_EQUAL(
+                libdnf::base::Transaction::TransactionRunResult::SUCCESS, run_transaction("one", true));
+            CPPUNIT_ASSERT_EQUAL(
+                libdnf::base::Transaction::TransactionRunResult::SUCCESS, run_transaction("one", false));
+        }
+
+        auto * result = json_object_new_object();
+        for (const char * span : {"transaction.run", "transaction.test", "transaction.rpm"}) {
+            json_object_object_add(result, span, json_object_new_int64(metrics.get_total_wall_us(span) / ROUNDS));
+        }
+        json_object_object_add(root, mode, result);
+    }
+
+    const auto results_path = PROJECT_BINARY_DIR "/test/libdnf/performance-test-transaction.json";
+    std::ofstream results(results_path);
+    results << json_object_to_json_string_ext(root, JSON_C_TO_STRING_PRETTY) << std::endl;
+    json_object_put(root);
+}
@@ -23,17 +23,38 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "base_test_case.hpp"
 
+#include "libdnf/base/transaction.hpp"
+
 #include <cppunit/TestCase.h>
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <string>
+
 
 class RpmTransactionTest : public BaseTestCase {
     CPPUNIT_TEST_SUITE(RpmTransactionTest);
+
+#ifndef WITH_PERFORMANCE_TESTS
     CPPUNIT_TEST(test_transaction);
+    CPPUNIT_TEST(test_transaction_test_never);
+    CPPUNIT_TEST(test_update_system_repo);
+#endif
+
+#ifdef WITH_PERFORMANCE_TESTS
+    CPPUNIT_TEST(test_transaction_test_modes_performance);
+#endif
+
     CPPUNIT_TEST_SUITE_END();
 
 public:
     void test_transaction();
+    void test_transaction_test_never();
+    void test_update_system_repo();
+    void test_transaction_test_modes_performance();
+
+private:
+    // Resolves the goal of installing (`install` is true) or removing `spec`, downloads the packages and runs it.
+    libdnf::base::Transaction::TransactionRunResult run_transaction(const std::string & spec, bool install);
 };
 
 #endif
@@ -0,0 +1,114 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_parallel_filter.hpp"
+
+#include "solv/parallel_filter.hpp"
+
+#include <atomic>
+#include <stdexcept>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ParallelFilterTest);
+
+
+namespace {
+
+bool is_selected(Id id) {
+    return static_cast<unsigned int>(id) * 2654435761U % 7 < 3;
+}
+
+void assert_same_maps(const libdnf::solv::SolvMap & expected, const libdnf::solv::SolvMap & result) {
+    CPPUNIT_ASSERT_EQUAL(expected.allocated_size(), result.allocated_size());
+    for (Id id = 0; id < expected.allocated_size(); ++id) {
+        CPPUNIT_ASSERT_EQUAL(expected.contains_unsafe(id), result.contains_unsafe(id));
+    }
+}
+
+}  // namespace
+
+
+void ParallelFilterTest::test_same_result() {
+    constexpr int SIZE = 100003;
+    libdnf::solv::SolvMap candidates(SIZE);
+    for (Id id = 0; id < SIZE; id += 3) {
+        candidates.add_unsafe(id);
+    }
+
+    // the result keeps the ids added before filtering
+    libdnf::solv::SolvMap expected(SIZE);
+    expected.add_unsafe(1);
+    for (Id id : candidates) {
+        if (is_selected(id)) {
+            expected.add_unsafe(id);
+        }
+    }
+
+    for (unsigned int threads : {1U, 2U, 3U, 8U, 64U}) {
+        std::atomic<std::size_t> calls{0};
+        libdnf::solv::SolvMap result(SIZE);
+        result.add_unsafe(1);
+        libdnf::solv::filter_parallel(candidates, result, threads, [&calls](Id id) {
+            ++calls;
+            return is_selected(id);
+        });
+        assert_same_maps(expected, result);
+        CPPUNIT_ASSERT_EQUAL(candidates.size(), calls.load());
+    }
+}
+
+
+void ParallelFilterTest::test_sparse_candidates() {
+    // all the candidates are in the last words of the map
+    constexpr int SIZE = 50000;
+    libdnf::solv::SolvMap candidates(SIZE);
+    for (Id id = SIZE - 10000; id < SIZE; ++id) {
+        candidates.add_unsafe(id);
+    }
+
+    libdnf::solv::SolvMap result(SIZE);
+    libdnf::solv::filter_parallel(candidates, result, 4, [](Id id) { return id % 2 == 0; });
+
+    libdnf::solv::SolvMap expected(SIZE);
+    for (Id id = SIZE - 10000; id < SIZE; id += 2) {
+        expected.add_unsafe(id);
+    }
+    assert_same_maps(expected, result);
+}
+
+
+void ParallelFilterTest::test_exception() {
+    constexpr int SIZE = 20000;
+    libdnf::solv::SolvMap candidates(SIZE);
+    candidates.set_all();
+    libdnf::solv::SolvMap result(SIZE);
+    CPPUNIT_ASSERT_THROW(
+        libdnf::solv::filter_parallel(
+            candidates,
+            result,
+            4,
+            [](Id id) {
+                if (id == SIZE - 1) {
+                    throw std::runtime_error("predicate failed");
+                }
+                return true;
+            }),
+        std::runtime_error);
+}
@@ -0,0 +1,47 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef TEST_LIBDNF_SOLV_PARALLEL_FILTER_HPP
+#define TEST_LIBDNF_SOLV_PARALLEL_FILTER_HPP
+
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class ParallelFilterTest : public CppUnit::TestCase {
+    CPPUNIT_TEST_SUITE(ParallelFilterTest);
+
+#ifndef WITH_PERFORMANCE_TESTS
+    CPPUNIT_TEST(test_same_result);
+    CPPUNIT_TEST(test_sparse_candidates);
+    CPPUNIT_TEST(test_exception);
+#endif
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void test_same_result();
+    void test_sparse_candidates();
+    void test_exception();
+};
+
+
+#endif  // TEST_LIBDNF_SOLV_PARALLEL_FILTER_HPP
@@ -0,0 +1,145 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "test_locker.hpp"
+
+#include "utils/locker.hpp"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <thread>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(UtilsLockerTest);
+
+
+namespace {
+
+// fcntl() locks do not exclude the holding process, the other side of the lock has to be a different process.
+// Runs `func` in a forked child process and returns its result (the exit status of the child).
+int run_in_child(const std::function<int()> & func) {
+    auto pid = fork();
+    CPPUNIT_ASSERT(pid != -1);
+    if (pid == 0) {
+        int result = 2;
+        try {
+            result = func();
+        } catch (...) {
+        }
+        _exit(result);
+    }
+    int status;
+    CPPUNIT_ASSERT_EQUAL(pid, waitpid(pid, &status, 0));
+    CPPUNIT_ASSERT(WIFEXITED(status));
+    return WEXITSTATUS(status);
+}
+
+}  // namespace
+
+
+void UtilsLockerTest::setUp() {
+    temp_dir = std::make_unique<libdnf::utils::fs::TempDir>("libdnf_unittest_locker");
+}
+
+
+void UtilsLockerTest::tearDown() {
+    temp_dir.reset();
+}
+
+
+void UtilsLockerTest::test_write_lock() {
+    const auto path = temp_dir->get_path() / "test.lock";
+    libdnf::utils::Locker locker(path);
+    CPPUNIT_ASSERT(locker.write_lock());
+
+    // another process can get neither a shared nor an exclusive lock
+    CPPUNIT_ASSERT_EQUAL(0, run_in_child([&path]() {
+        libdnf::utils::Locker other(path, false);
+        return other.read_lock() || other.write_lock() ? 1 : 0;
+    }));
+
+    // the lock file is removed by default
+    locker.unlock();
+    CPPUNIT_ASSERT(!std::filesystem::exists(path));
+}
+
+
+void UtilsLockerTest::test_read_lock() {
+    const auto path = temp_dir->get_path() / "test.lock";
+    libdnf::utils::Locker locker(path, false);
+    CPPUNIT_ASSERT(locker.read_lock());
+
+    // shared locks can be held by more processes, an exclusive lock is refused
+    CPPUNIT_ASSERT_EQUAL(0, run_in_child([&path]() {
+        libdnf::utils::Locker other(path, false);
+        return other.read_lock() && !other.write_lock() ? 0 : 1;
+    }));
+
+    // the held shared lock is converted to an exclusive one
+    CPPUNIT_ASSERT(locker.write_lock());
+    CPPUNIT_ASSERT_EQUAL(0, run_in_child([&path]() {
+        libdnf::utils::Locker other(path, false);
+        return other.read_lock() ? 1 : 0;
+    }));
+
+    // the lock file is kept for other processes
+    locker.unlock();
+    CPPUNIT_ASSERT(std::filesystem::exists(path));
+}
+
+
+void UtilsLockerTest::test_wait_for_lock() {
+    const auto path = temp_dir->get_path() / "test.lock";
+    const auto done_path = temp_dir->get_path() / "done";
+
+    // the child holds the lock for a while and creates the `done` file just before it releases it
+    auto pid = fork();
+    CPPUNIT_ASSERT(pid != -1);
+    if (pid == 0) {
+        libdnf::utils::Locker locker(path, false);
+        if (!locker.write_lock()) {
+            _exit(1);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        std::filesystem::create_directory(done_path);
+        _exit(0);
+    }
+
+    // wait until the child holds the lock
+    libdnf::utils::Locker probe(path, false);
+    while (probe.read_lock()) {
+        probe.unlock();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    libdnf::utils::Locker locker(path, false);
+    CPPUNIT_ASSERT(!locker.write_lock());
+    CPPUNIT_ASSERT(locker.write_lock(true));
+    CPPUNIT_ASSERT(std::filesystem::exists(done_path));
+
+    int status;
+    CPPUNIT_ASSERT_EQUAL(pid, waitpid(pid, &status, 0));
+    CPPUNIT_ASSERT(WIFEXITED(status));
+    CPPUNIT_ASSERT_EQUAL(0, WEXITSTATUS(status));
+}
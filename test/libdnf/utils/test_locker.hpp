@@ -0,0 +1,57 @@
+/*
+Copyright Contributors to the libdnf project.
+
+This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+
+Libdnf is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Libdnf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LIBDNF_TEST_UTILS_LOCKER_HPP
+#define LIBDNF_TEST_UTILS_LOCKER_HPP
+
+
+#include "utils/fs/temp.hpp"
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <memory>
+
+
+class UtilsLockerTest : public CppUnit::TestCase {
+    CPPUNIT_TEST_SUITE(UtilsLockerTest);
+
+#ifndef WITH_PERFORMANCE_TESTS
+    CPPUNIT_TEST(test_write_lock);
+    CPPUNIT_TEST(test_read_lock);
+    CPPUNIT_TEST(test_wait_for_lock);
+#endif
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() override;
+    void tearDown() override;
+
+    void test_write_lock();
+    void test_read_lock();
+    void test_wait_for_lock();
+
+private:
+    std::unique_ptr<libdnf::utils::fs::TempDir> temp_dir;
+};
+
+
+#endif  // LIBDNF_TEST_UTILS_LOCKER_HPP
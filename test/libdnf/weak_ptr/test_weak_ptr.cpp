@@ -21,8 +21,12 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "libdnf/common/weak_ptr.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(WeakPtrTest);
@@ -279,3 +283,121 @@ void WeakPtrTest::test_weak_ptr_is_owner() {
     CPPUNIT_ASSERT_THROW(static_cast<void>(*item4_weak_ptr->remote_data == "sack1_item1"), libdnf::AssertionError);
     CPPUNIT_ASSERT_THROW(static_cast<void>(*item6_weak_ptr->remote_data == "sack1_item2"), libdnf::AssertionError);
 }
+
+
+// A throwing copy of the owned resource must not leave a reference to the control block behind.
+void WeakPtrTest::test_weak_ptr_copy_throws() {
+    struct ThrowingItem {
+        explicit ThrowingItem(bool throw_on_copy) : throw_on_copy(throw_on_copy) {}
+        ThrowingItem(const ThrowingItem & src) : throw_on_copy(src.throw_on_copy) {
+            if (throw_on_copy) {
+                throw std::runtime_error("copy failed");
+            }
+        }
+        bool throw_on_copy;
+    };
+
+    libdnf::WeakPtrGuard<ThrowingItem, true> guard;
+    const libdnf::WeakPtr<ThrowingItem, true> throwing_ptr(new ThrowingItem(true), &guard);
+    libdnf::WeakPtr<ThrowingItem, true> item_ptr(new ThrowingItem(false), &guard);
+    CPPUNIT_ASSERT_EQUAL(guard.size(), static_cast<std::size_t>(2));
+
+    // test copy constructor
+    CPPUNIT_ASSERT_THROW(libdnf::WeakPtr<ThrowingItem, true> copy(throwing_ptr), std::runtime_error);
+    CPPUNIT_ASSERT_EQUAL(guard.size(), static_cast<std::size_t>(2));
+
+    // test copy assignment operator =, the target is left unchanged
+    CPPUNIT_ASSERT_THROW(item_ptr = throwing_ptr, std::runtime_error);
+    CPPUNIT_ASSERT_EQUAL(guard.size(), static_cast<std::size_t>(2));
+    CPPUNIT_ASSERT(item_ptr.is_valid());
+    CPPUNIT_ASSERT(!item_ptr->throw_on_copy);
+}
+
+
+// Copies and destroys WeakPtrs of the same guard in several threads while the guard is invalidated.
+void WeakPtrTest::test_weak_ptr_multithreaded() {
+    constexpr int num_threads = 8;
+    constexpr int num_copies = 20000;
+
+    std::string data("data");
+    libdnf::WeakPtrGuard<std::string, false> guard;
+    const libdnf::WeakPtr<std::string, false> weak_ptr(&data, &guard);
+    CPPUNIT_ASSERT_EQUAL(guard.size(), static_cast<std::size_t>(1));
+
+    // all threads work with valid pointers, the number of pointers returns back to the original one
+    std::atomic<int> invalid_count{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&]() {
+            for (int j = 0; j < num_copies; ++j) {
+                auto copy = weak_ptr;
+                libdnf::WeakPtr<std::string, false> another(&data, &guard);
+                another = copy;
+                if (!copy.is_valid() || !another.is_valid() || *another != "data") {
+                    ++invalid_count;
+                }
+            }
+        });
+    }
+    for (auto & thread : threads) {
+        thread.join();
+    }
+    CPPUNIT_ASSERT_EQUAL(invalid_count.load(), 0);
+    CPPUNIT_ASSERT_EQUAL(guard.size(), static_cast<std::size_t>(1));
+
+    // clear() in the middle of copying, the copies made from an invalidated pointer are invalid
+    std::atomic<bool> cleared{false};
+    threads.clear();
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&]() {
+            for (int j = 0; j < num_copies; ++j) {
+                const bool was_cleared = cleared.load();
+                auto copy = weak_ptr;
+                if (was_cleared && copy.is_valid()) {
+                    ++invalid_count;
+                }
+            }
+        });
+    }
+    guard.clear();
+    cleared = true;
+    for (auto & thread : threads) {
+        thread.join();
+    }
+    CPPUNIT_ASSERT_EQUAL(invalid_count.load(), 0);
+    CPPUNIT_ASSERT(!weak_ptr.is_valid());
+    CPPUNIT_ASSERT(guard.empty());
+
+    // the guard is usable after clear()
+    const libdnf::WeakPtr<std::string, false> new_weak_ptr(&data, &guard);
+    CPPUNIT_ASSERT(new_weak_ptr.is_valid());
+    CPPUNIT_ASSERT_EQUAL(guard.size(), static_cast<std::size_t>(1));
+}
+
+
+void WeakPtrTest::test_weak_ptr_copy_performance() {
+    constexpr int max = 10000000;
+    std::string data("data");
+    libdnf::WeakPtrGuard<std::string, false> guard;
+    const libdnf::WeakPtr<std::string, false> weak_ptr(&data, &guard);
+
+    // copy and destroy the pointers in the same way as a loop over packages does
+    const auto num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    std::atomic<std::size_t> total_length{0};
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&]() {
+            std::size_t length = 0;
+            for (int j = 0; j < max; ++j) {
+                auto copy = weak_ptr;
+                length += copy->size();
+            }
+            total_length += length;
+        });
+    }
+    for (auto & thread : threads) {
+        thread.join();
+    }
+    CPPUNIT_ASSERT_EQUAL(total_length.load(), static_cast<std::size_t>(max) * num_threads * data.size());
+    CPPUNIT_ASSERT_EQUAL(guard.size(), static_cast<std::size_t>(1));
+}
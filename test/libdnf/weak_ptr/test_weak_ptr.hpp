@@ -27,8 +27,18 @@ along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 class WeakPtrTest : public CppUnit::TestCase {
     CPPUNIT_TEST_SUITE(WeakPtrTest);
+
+#ifndef WITH_PERFORMANCE_TESTS
     CPPUNIT_TEST(test_weak_ptr);
     CPPUNIT_TEST(test_weak_ptr_is_owner);
+    CPPUNIT_TEST(test_weak_ptr_copy_throws);
+    CPPUNIT_TEST(test_weak_ptr_multithreaded);
+#endif
+
+#ifdef WITH_PERFORMANCE_TESTS
+    CPPUNIT_TEST(test_weak_ptr_copy_performance);
+#endif
+
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -37,6 +47,9 @@ public:
 
     void test_weak_ptr();
     void test_weak_ptr_is_owner();
+    void test_weak_ptr_copy_throws();
+    void test_weak_ptr_multithreaded();
+    void test_weak_ptr_copy_performance();
 
 private:
 };
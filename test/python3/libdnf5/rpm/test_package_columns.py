@@ -0,0 +1,51 @@
+# Copyright Contributors to the libdnf project.
+#
+# This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+#
+# Libdnf is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# Libdnf is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+import unittest
+
+import libdnf5
+
+import base_test_case
+
+
+class TestPackageColumns(base_test_case.BaseTestCase):
+    def setUp(self):
+        super().setUp()
+        self.add_repo_repomd("repomd-repo1")
+
+    def test_columns(self):
+        query = libdnf5.rpm.PackageQuery(self.base)
+        columns = libdnf5.rpm.PackageColumns(query, ["name", "arch", "installsize"])
+        self.assertEqual(columns.size(), 3)
+
+        names = columns.get_strings("name")
+        self.assertEqual([names[i] for i in columns.get_string_indexes("name")], ["pkg", "pkg-libs", "unresolvable"])
+        self.assertEqual(tuple(columns.get_strings("arch")), ("x86_64", "noarch"))
+        self.assertEqual(tuple(columns.get_numbers("installsize")), (222, 222, 222))
+        self.assertEqual(tuple(columns.get_ids()), tuple(pkg.get_id().id for pkg in query))
+
+    def test_buffers(self):
+        query = libdnf5.rpm.PackageQuery(self.base)
+        columns = libdnf5.rpm.PackageColumns(query, ["arch", "installsize"])
+        self.assertEqual(memoryview(columns.get_string_indexes_buffer("arch")).cast("I").tolist(), [0, 0, 1])
+        self.assertEqual(memoryview(columns.get_numbers_buffer("installsize")).cast("Q").tolist(), [222, 222, 222])
+        self.assertEqual(
+            memoryview(columns.get_ids_buffer()).cast("i").tolist(), [pkg.get_id().id for pkg in query])
+
+    def test_invalid_attribute(self):
+        query = libdnf5.rpm.PackageQuery(self.base)
+        self.assertRaises(RuntimeError, libdnf5.rpm.PackageColumns, query, ["unknown"])